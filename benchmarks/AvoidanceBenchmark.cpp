@@ -0,0 +1,200 @@
+// Measures local avoidance cost per physics tick with 1000 units crossing through each other in four groups.
+// Some units are destroyed as the groups close in, and are left behind as wrecks the others don't avoid, as in game.
+// Reports whether the avoidance stage fits in its per-tick budget, and how close units came to each other.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "JobSystem.h"
+#include "LocalAvoidance.h"
+#include "SpatialHash.h"
+#include "Vec.h"
+
+static const unsigned int UnitCount = 1000;
+static const unsigned int TickCount = 600;
+static const float UnitRadius = 1.0f;
+static const float UnitSpeed = 0.15f;
+
+// Every DestroyedUnitInterval'th unit is destroyed on DestroyTick.
+static const unsigned int DestroyedUnitInterval = 8;
+static const unsigned int DestroyTick = TickCount / 4;
+
+struct BenchmarkUnit
+{
+    vec::vec2 position;
+    vec::vec2 velocity;
+    vec::vec2 goal;
+    bool isDestroyed;
+};
+
+// Four square groups start on the sides of a square and head for the opposite side, meeting in the middle.
+static void CreateUnits(std::vector<BenchmarkUnit>& units)
+{
+    units.resize(UnitCount);
+    const unsigned int groupSize = UnitCount / 4;
+    const unsigned int groupWidth = (unsigned int)std::ceil(std::sqrt((float)groupSize));
+    const float spacing = UnitRadius * 3.0f;
+    const float startDistance = 80.0f;
+    for (unsigned int i = 0; i < UnitCount; i++)
+    {
+        unsigned int group = i / groupSize;
+        unsigned int slot = i % groupSize;
+        vec::vec2 offset(((float)(slot % groupWidth) - (float)groupWidth * 0.5f) * spacing, ((float)(slot / groupWidth) - (float)groupWidth * 0.5f) * spacing);
+
+        vec::vec2 start;
+        switch (group % 4)
+        {
+        case 0: start = vec::vec2(-startDistance, 0.0f); break;
+        case 1: start = vec::vec2(startDistance, 0.0f); break;
+        case 2: start = vec::vec2(0.0f, -startDistance); break;
+        default: start = vec::vec2(0.0f, startDistance); break;
+        }
+
+        units[i].position = start + offset;
+        units[i].goal = -start + offset;
+        units[i].velocity = vec::vec2(0.0f, 0.0f);
+        units[i].isDestroyed = false;
+    }
+}
+
+// Returns the closest distance between any two unit centers, counting pairs that overlap by more than a tenth of their combined radius.
+// ORCA allows slight overlaps when a unit is boxed in, so only deeper overlaps are counted. Destroyed units aren't in the hash.
+static float FindMinimumSeparation(const std::vector<BenchmarkUnit>& units, const SpatialHash& unitHash, unsigned int& overlapCount)
+{
+    std::vector<SpatialHashEntry> nearbyUnits;
+    float minimumSeparation = 1e30f;
+    overlapCount = 0;
+    for (unsigned int i = 0; i < units.size(); i++)
+    {
+        if (units[i].isDestroyed)
+        {
+            continue;
+        }
+
+        unitHash.RadiusQuery(vec::vec3(units[i].position.x, units[i].position.y, 0.0f), UnitRadius * 2.0f, nearbyUnits);
+        for (const SpatialHashEntry& nearbyUnit : nearbyUnits)
+        {
+            if (nearbyUnit.unitId > i)
+            {
+                vec::vec2 offset = units[nearbyUnit.unitId].position - units[i].position;
+                float separation = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+                minimumSeparation = std::min(minimumSeparation, separation);
+                if (separation < UnitRadius * 2.0f * 0.9f)
+                {
+                    ++overlapCount;
+                }
+            }
+        }
+    }
+
+    return minimumSeparation;
+}
+
+// Optionally takes the per-tick budget in milliseconds and the worker thread count.
+// The default budget is a tenth of the default 33 ms physics tick.
+int main(int argc, char* argv[])
+{
+    double budgetMs = argc > 1 ? atof(argv[1]) : 3.3;
+    unsigned int workerCount = argc > 2 ? (unsigned int)atoi(argv[2]) : JobSystem::DefaultWorkerCount();
+
+    JobSystem jobSystem;
+    jobSystem.Initialize(workerCount);
+    printf("Local avoidance: %u units, %u ticks, %u threads, %.2f ms budget.\n", UnitCount, TickCount, jobSystem.GetThreadCount(), budgetMs);
+
+    std::vector<BenchmarkUnit> units;
+    CreateUnits(units);
+
+    SpatialHash unitHash(2.0f);
+    LocalAvoidance localAvoidance;
+    for (unsigned int i = 0; i < units.size(); i++)
+    {
+        unitHash.UpdateEntry(0, i, vec::vec3(units[i].position.x, units[i].position.y, 0.0f), UnitRadius);
+    }
+
+    std::vector<double> tickTimes;
+    float minimumSeparation = 1e30f;
+    unsigned int maxOverlaps = 0;
+    for (unsigned int tick = 0; tick < TickCount; tick++)
+    {
+        if (tick == DestroyTick)
+        {
+            for (unsigned int i = 0; i < units.size(); i += DestroyedUnitInterval)
+            {
+                units[i].isDestroyed = true;
+                units[i].velocity = vec::vec2(0.0f, 0.0f);
+                unitHash.RemoveEntry(0, i);
+            }
+        }
+
+        std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+
+        localAvoidance.Clear();
+        AvoidanceAgent* agents = localAvoidance.AddPlayerAgents(0, UnitCount);
+        for (unsigned int i = 0; i < units.size(); i++)
+        {
+            // Destroyed units have no radius, so they're left out of avoidance.
+            agents[i].position = units[i].position;
+            agents[i].height = 0.0f;
+            if (units[i].isDestroyed)
+            {
+                agents[i].velocity = vec::vec2(0.0f, 0.0f);
+                agents[i].preferredVelocity = vec::vec2(0.0f, 0.0f);
+                agents[i].radius = 0.0f;
+                agents[i].maxSpeed = 0.0f;
+                continue;
+            }
+
+            vec::vec2 preferredVelocity = units[i].goal - units[i].position;
+            float preferredSpeed = std::sqrt(preferredVelocity.x * preferredVelocity.x + preferredVelocity.y * preferredVelocity.y);
+            if (preferredSpeed > UnitSpeed)
+            {
+                preferredVelocity = preferredVelocity * (UnitSpeed / preferredSpeed);
+            }
+
+            agents[i].velocity = units[i].velocity;
+            agents[i].preferredVelocity = preferredVelocity;
+            agents[i].radius = UnitRadius;
+            agents[i].maxSpeed = UnitSpeed;
+        }
+
+        localAvoidance.ComputeAvoidanceVelocities(jobSystem);
+        for (unsigned int i = 0; i < units.size(); i++)
+        {
+            if (units[i].isDestroyed)
+            {
+                continue;
+            }
+
+            units[i].velocity = localAvoidance.GetAgent(0, i).avoidanceVelocity;
+            units[i].position += units[i].velocity;
+            unitHash.UpdateEntry(0, i, vec::vec3(units[i].position.x, units[i].position.y, 0.0f), UnitRadius);
+        }
+
+        tickTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count());
+
+        unsigned int overlapCount;
+        minimumSeparation = std::min(minimumSeparation, FindMinimumSeparation(units, unitHash, overlapCount));
+        maxOverlaps = std::max(maxOverlaps, overlapCount);
+    }
+
+    double totalMs = 0.0;
+    for (double tickTime : tickTimes)
+    {
+        totalMs += tickTime;
+    }
+
+    std::sort(tickTimes.begin(), tickTimes.end());
+    double averageMs = totalMs / (double)tickTimes.size();
+    double worstMs = tickTimes.back();
+    double percentile99Ms = tickTimes[(tickTimes.size() * 99) / 100];
+
+    printf("%12s %12s %12s\n", "Average ms", "99% ms", "Worst ms");
+    printf("%12.3f %12.3f %12.3f\n", averageMs, percentile99Ms, worstMs);
+    printf("Minimum separation: %.3f (two radii is %.3f), most overlapping pairs in a tick: %u\n", minimumSeparation, UnitRadius * 2.0f, maxOverlaps);
+
+    bool withinBudget = percentile99Ms <= budgetMs;
+    printf(withinBudget ? "Avoidance fits within the tick budget.\n" : "ERROR: avoidance exceeds the tick budget!\n");
+    return withinBudget ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "MapInfo.h"
+#include "ModelLoader.h"
+
+// Setup shared by the benchmarks that run the simulation without any graphics.
+
+// Models are only referred to by ID in the simulation, so none are loaded.
+class HeadlessModelLoader : public ModelLoader
+{
+    public:
+        HeadlessModelLoader()
+        {
+            nextModelId = 1;
+        }
+
+        virtual unsigned int LoadModel(const char*)
+        {
+            return nextModelId++;
+        }
+
+    private:
+        unsigned int nextModelId;
+};
+
+// Allocates a map of the given size filled with air, for a benchmark to build its terrain in. Freed with MapManager::ClearMap.
+inline void CreateEmptyMap(MapInfo& mapInfo, unsigned int xSize, unsigned int ySize, unsigned int zSize)
+{
+    mapInfo.xSize = xSize;
+    mapInfo.ySize = ySize;
+    mapInfo.zSize = zSize;
+    mapInfo.blockType = new unsigned char[mapInfo.GetVoxelCount()];
+    mapInfo.blockOrientation = new unsigned char[mapInfo.GetVoxelCount()];
+    mapInfo.blockProperty = new unsigned char[mapInfo.GetVoxelCount()];
+    for (int i = 0; i < mapInfo.GetVoxelCount(); i++)
+    {
+        mapInfo.blockType[i] = MapInfo::VoxelTypes::AIR;
+        mapInfo.blockOrientation[i] = 0;
+        mapInfo.blockProperty[i] = 0;
+    }
+}
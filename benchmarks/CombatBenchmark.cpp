@@ -0,0 +1,136 @@
+// Measures combat resolution at 100,000 hits per second, spread over the physics ticks in that second.
+// The same hits are resolved twice, and both runs must produce identical armor and deaths.
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "CombatResolver.h"
+
+static const unsigned int PlayerCount = 2;
+static const unsigned int UnitsPerPlayer = 2500;
+static const unsigned int HitsPerSecond = 100000;
+static const unsigned int TicksPerSecond = 30;
+static const unsigned int SecondCount = 10;
+
+struct RunResult
+{
+    double worstTickMs;
+    double totalMs;
+    unsigned int deathCount;
+    unsigned int checksum;
+};
+
+// Small deterministic generator, so both runs see the same hits.
+static unsigned int NextRandom(unsigned int& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static RunResult RunCombat(const ArmorType& armorType)
+{
+    std::vector<Armor> armors(PlayerCount * UnitsPerPlayer);
+    for (unsigned int i = 0; i < armors.size(); i++)
+    {
+        armors[i].armorTypeId = 0;
+        armors[i].machineGunDamage = 0.0f;
+        armors[i].rocketDamage = 0.0f;
+        armors[i].cannonDamage = 0.0f;
+    }
+
+    std::vector<unsigned char> isDestroyed(armors.size(), 0);
+    std::vector<UnitDeath> unitDeaths;
+
+    const unsigned int hitsPerTick = HitsPerSecond / TicksPerSecond;
+    CombatResolver combatResolver;
+    combatResolver.Initialize(hitsPerTick);
+
+    RunResult result;
+    result.worstTickMs = 0.0;
+    result.totalMs = 0.0;
+
+    unsigned int randomState = 12345;
+    for (unsigned int tick = 0; tick < SecondCount * TicksPerSecond; tick++)
+    {
+        // Hits arrive in whatever order projectiles happened to be updated in.
+        combatResolver.Clear();
+        for (unsigned int i = 0; i < hitsPerTick; i++)
+        {
+            unsigned int target = NextRandom(randomState) % (unsigned int)armors.size();
+            DamageType damageType = (DamageType)(NextRandom(randomState) % 3);
+            float damage = damageType == MACHINE_GUN ? 0.5f : (damageType == ROCKET ? 1.0f : 0.25f);
+            combatResolver.AddHit(target / UnitsPerPlayer, target % UnitsPerPlayer, 1 - target / UnitsPerPlayer, damageType, damage);
+        }
+
+        std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+        combatResolver.SortHits();
+        auto applyFunction = [&](unsigned int playerId, unsigned int unitId, const CombatHit* hits, unsigned int hitCount)
+        {
+            unsigned int unitIndex = playerId * UnitsPerPlayer + unitId;
+            unsigned int destroyingHit;
+            if (!isDestroyed[unitIndex] && CombatResolver::ApplyHits(armors[unitIndex], armorType, hits, hitCount, &destroyingHit))
+            {
+                isDestroyed[unitIndex] = 1;
+
+                UnitDeath unitDeath;
+                unitDeath.playerId = playerId;
+                unitDeath.unitId = unitId;
+                unitDeath.killingPlayerId = hits[destroyingHit].firingPlayerId;
+                unitDeaths.push_back(unitDeath);
+            }
+        };
+
+        combatResolver.ForEachTarget(applyFunction);
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        result.totalMs += elapsedMs;
+        result.worstTickMs = elapsedMs > result.worstTickMs ? elapsedMs : result.worstTickMs;
+    }
+
+    // Hash the final armor state and the death order.
+    unsigned int hash = 2166136261u;
+    for (unsigned int i = 0; i < armors.size(); i++)
+    {
+        const float values[] = { armors[i].machineGunDamage, armors[i].rocketDamage, armors[i].cannonDamage };
+        unsigned char bytes[sizeof(values)];
+        memcpy(bytes, values, sizeof(values));
+        for (unsigned int j = 0; j < sizeof(bytes); j++)
+        {
+            hash = (hash ^ bytes[j]) * 16777619u;
+        }
+    }
+
+    for (unsigned int i = 0; i < unitDeaths.size(); i++)
+    {
+        hash = (hash ^ (unitDeaths[i].playerId * UnitsPerPlayer + unitDeaths[i].unitId)) * 16777619u;
+    }
+
+    result.deathCount = (unsigned int)unitDeaths.size();
+    result.checksum = hash;
+    return result;
+}
+
+int main()
+{
+    // Matches the armor in config/armors.txt, scaled up so units survive a few seconds of fire.
+    ArmorType armorType;
+    armorType.maxMachineGun = 100.0f;
+    armorType.maxRocket = 50.0f;
+    armorType.maxCannon = 10.0f;
+    armorType.maxMachineGunPenalty = 2.0f;
+    armorType.maxRocketPenalty = 4.0f;
+    armorType.maxCannonPenalty = 10.0f;
+
+    printf("Combat resolution: %u hits per second, %u ticks per second, %u units, %u seconds.\n", HitsPerSecond, TicksPerSecond, PlayerCount * UnitsPerPlayer, SecondCount);
+
+    RunResult firstRun = RunCombat(armorType);
+    RunResult secondRun = RunCombat(armorType);
+
+    printf("%12s %12s %14s %8s %12s\n", "ms/second", "Worst ms", "Hits/ms", "Deaths", "Checksum");
+    printf("%12.3f %12.3f %14.0f %8u %12.8x\n", firstRun.totalMs / (double)SecondCount, firstRun.worstTickMs,
+        (double)(HitsPerSecond * SecondCount) / firstRun.totalMs, firstRun.deathCount, firstRun.checksum);
+
+    bool isDeterministic = firstRun.checksum == secondRun.checksum && firstRun.deathCount == secondRun.deathCount;
+    printf(isDeterministic ? "Both runs produced identical results.\n" : "ERROR: runs produced different results!\n");
+    return isDeterministic ? 0 : 1;
+}
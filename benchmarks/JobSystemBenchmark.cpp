@@ -0,0 +1,165 @@
+// Measures how the physics job system scales from one thread to every core, using the game's unit update.
+// Each tick runs GameRound::UpdatePlayers: units follow their routes, avoid each other and update the spatial hash, as in a physics tick.
+// Each thread count must produce bit-identical unit positions, which verifies the parallel update stays deterministic.
+// Takes the directory holding the config folder and the maximum thread count to test as optional arguments,
+//  defaulting to the working directory and the number of cores.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BenchmarkFixtures.h"
+#include "BodyConfig.h"
+#include "GameRound.h"
+#include "JobSystem.h"
+#include "LocalAvoidance.h"
+#include "Logger.h"
+#include "MapManager.h"
+#include "MapSections.h"
+#include "MathOps.h"
+#include "SpatialHash.h"
+#include "TechConfig.h"
+#include "UnitRouter.h"
+#include "Vec.h"
+
+static const unsigned int UnitCount = 20000;
+static const unsigned int UnitColumns = 200;
+static const unsigned int TickCount = 200;
+static const float UnitSpacing = 2.5f;
+static const float MapMargin = 20.0f;
+
+// A flat field two voxels deep, large enough for every unit and its route.
+static void CreateMap(MapInfo& mapInfo)
+{
+    unsigned int xSize = (unsigned int)(((float)UnitColumns * UnitSpacing + MapMargin * 3.0f) / MapInfo::SPACING);
+    unsigned int ySize = (unsigned int)(((float)(UnitCount / UnitColumns) * UnitSpacing + MapMargin * 2.0f) / MapInfo::SPACING);
+    CreateEmptyMap(mapInfo, xSize, ySize, 4);
+
+    for (unsigned int x = 0; x < mapInfo.xSize; x++)
+    {
+        for (unsigned int y = 0; y < mapInfo.ySize; y++)
+        {
+            mapInfo.blockType[mapInfo.GetIndex(x, y, 0)] = MapInfo::VoxelTypes::CUBE;
+            mapInfo.blockType[mapInfo.GetIndex(x, y, 1)] = MapInfo::VoxelTypes::CUBE;
+        }
+    }
+}
+
+// Units start in a grid, each with its own winding route, so neighboring routes cross and units have to avoid each other.
+static void CreateUnits(const MapSections& mapSections, Player& player)
+{
+    std::vector<unsigned int> turretTypeIds;
+    vec::quaternion unitRotation = vec::quaternion::fromAxisAngle(MathOps::Radians(-90.0f), vec::vec3(1.0f, 0.0f, 0.0f));
+    for (unsigned int i = 0; i < UnitCount; i++)
+    {
+        std::vector<vec::vec3> route;
+        vec::vec3 point(MapMargin + (float)(i % UnitColumns) * UnitSpacing, MapMargin + (float)(i / UnitColumns) * UnitSpacing, 0.0f);
+        for (unsigned int j = 0; j < 64; j++)
+        {
+            point.z = mapSections.GetSurface().GetSurface(point).height + UnitRouter::GetHoverHeight();
+            route.push_back(point);
+            point += vec::vec3((float)((i + j) % 3) * 0.5f - 0.25f, (float)((i * 7 + j) % 5) * 0.25f - 0.5f, 0.0f);
+        }
+
+        player.AddUnit(Unit(0, 0, turretTypeIds, route[0], unitRotation));
+        player.UpdateUnitRoute(i, route);
+    }
+}
+
+// Hashes unit positions in index order, so any difference in results between runs shows up.
+static unsigned int Checksum(Player& player)
+{
+    unsigned int hash = 2166136261u;
+    for (unsigned int i = 0; i < UnitCount; i++)
+    {
+        vec::vec3 position = player.GetUnitPosition(i);
+        const float values[] = { position.x, position.y, position.z };
+        unsigned char bytes[sizeof(values)];
+        memcpy(bytes, values, sizeof(values));
+        for (unsigned int j = 0; j < sizeof(bytes); j++)
+        {
+            hash = (hash ^ bytes[j]) * 16777619u;
+        }
+    }
+
+    return hash;
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int maxThreads = argc > 2 ? (unsigned int)atoi(argv[2]) : std::thread::hardware_concurrency();
+    if (maxThreads == 0)
+    {
+        maxThreads = 1;
+    }
+
+    Logger::Setup();
+
+    // Players start with the first tech, and units use the first body.
+    std::string dataDirectory = argc > 1 ? std::string(argv[1]) + "/" : std::string();
+    std::string techConfigFile = dataDirectory + "config/technologies.txt";
+    std::string bodyConfigFile = dataDirectory + "config/bodies.txt";
+
+    HeadlessModelLoader modelLoader;
+    TechConfig techConfig(techConfigFile.c_str());
+    BodyConfig bodyConfig(&modelLoader, bodyConfigFile.c_str());
+    if (!techConfig.ReadConfiguration() || !bodyConfig.ReadConfiguration())
+    {
+        printf("ERROR: could not read the configuration from \"%s\". Pass the directory holding the config folder.\n", dataDirectory.empty() ? "." : dataDirectory.c_str());
+        Logger::Shutdown();
+        return 1;
+    }
+
+    GameRound gameRound;
+    CreateMap(gameRound.map);
+    MapSections mapSections;
+    mapSections.RecomputeMapSections(gameRound.map);
+
+    printf("Job system scaling: %u units, %u ticks, up to %u threads.\n", UnitCount, TickCount, maxThreads);
+    printf("%8s %12s %10s %12s\n", "Threads", "ms/tick", "Speedup", "Checksum");
+
+    double singleThreadedMs = 0.0;
+    unsigned int expectedChecksum = 0;
+    bool isDeterministic = true;
+    for (unsigned int threads = 1; threads <= maxThreads; threads++)
+    {
+        JobSystem jobSystem;
+        jobSystem.Initialize(threads - 1);
+
+        gameRound.players.clear();
+        gameRound.players.push_back(Player("Benchmark Player", 0));
+        CreateUnits(mapSections, gameRound.players[0]);
+
+        SpatialHash unitHash(MapInfo::SPACING);
+        LocalAvoidance localAvoidance;
+        std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+        for (unsigned int tick = 0; tick < TickCount; tick++)
+        {
+            gameRound.UpdatePlayers(jobSystem, unitHash, localAvoidance, mapSections, 0.0f);
+        }
+
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        double msPerTick = elapsedMs / (double)TickCount;
+        unsigned int checksum = Checksum(gameRound.players[0]);
+        if (threads == 1)
+        {
+            singleThreadedMs = msPerTick;
+            expectedChecksum = checksum;
+        }
+        else if (checksum != expectedChecksum)
+        {
+            isDeterministic = false;
+        }
+
+        printf("%8u %12.3f %9.2fx %12.8x\n", threads, msPerTick, singleThreadedMs / msPerTick, checksum);
+    }
+
+    MapManager mapManager;
+    mapManager.ClearMap(gameRound.map);
+    Logger::Shutdown();
+
+    printf(isDeterministic ? "Results are identical for every thread count.\n" : "ERROR: results differ between thread counts!\n");
+    return isDeterministic ? 0 : 1;
+}
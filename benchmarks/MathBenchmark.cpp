@@ -0,0 +1,449 @@
+// Times the vector, matrix, quaternion and physics math used in the simulation and rendering hot loops, one call per iteration.
+// Inputs cycle through small tables of varied values so the results can't be folded into constants.
+// The matrix and quaternion products are also timed with the scalar implementations, and checked against them before running.
+// Pass part of a benchmark name to only run the benchmarks containing it.
+#include <cmath>
+#include <cstdio>
+#include "Camera.h"
+#include "MatrixOps.h"
+#include "MicroBenchmark.h"
+#include "PhysicsOps.h"
+#include "Vec.h"
+
+static const unsigned int TableSize = 1024;
+static const unsigned int TableMask = TableSize - 1;
+
+static const float FovY = 50.0f;
+static const float Aspect = 1280.0f / 720.0f;
+static const float NearPlane = 0.1f;
+static const float FarPlane = 1000.0f;
+
+// Deterministic values in [-1, 1).
+static float GetValue(unsigned int seed)
+{
+    seed = seed * 2654435761u + 12345u;
+    return (float)((seed >> 8) % 65536) / 32768.0f - 1.0f;
+}
+
+struct Tables
+{
+    vec::vec2 vec2s[TableSize];
+    vec::vec2 screenPositions[TableSize];
+    vec::vec3 rays[TableSize];
+    vec::vec3 vec3s[TableSize];
+    vec::vec4 vec4s[TableSize];
+    vec::quaternion quaternions[TableSize];
+    vec::mat4 matrices[TableSize];
+    vec::mat4 results[TableSize];
+    float scalars[TableSize];
+
+    Tables()
+    {
+        for (unsigned int i = 0; i < TableSize; i++)
+        {
+            vec2s[i] = vec::vec2(GetValue(i * 8), GetValue(i * 8 + 1) + 2.0f);
+            screenPositions[i] = vec::vec2((GetValue(i * 8 + 11) + 1.0f) * 640.0f, (GetValue(i * 8 + 12) + 1.0f) * 360.0f);
+            vec3s[i] = vec::vec3(GetValue(i * 8 + 2), GetValue(i * 8 + 3), GetValue(i * 8 + 4) + 2.0f);
+            vec4s[i] = vec::vec4(GetValue(i * 8 + 5), GetValue(i * 8 + 6), GetValue(i * 8 + 7), 1.0f);
+            scalars[i] = GetValue(i * 8 + 9) + 2.0f;
+
+            quaternions[i] = vec::quaternion::fromAxisAngle(GetValue(i * 8 + 10) * 3.0f, vec::normalize(vec3s[i]));
+            matrices[i] = MatrixOps::Translate(vec3s[i]) * quaternions[i].asMatrix();
+        }
+    }
+};
+
+static Tables& GetTables()
+{
+    static Tables tables;
+    return tables;
+}
+
+static void Vec2Divide(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(tables.vec2s[i] / tables.vec2s[(i + 1) & TableMask]);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(Vec2Divide);
+
+static void Vec3Add(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(tables.vec3s[i] + tables.vec3s[(i + 1) & TableMask]);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(Vec3Add);
+
+// Moving a position along a velocity, as unit and projectile updates do.
+static void Vec3MultiplyAdd(micro::State& state)
+{
+    Tables& tables = GetTables();
+    vec::vec3 position(0.0f);
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        position += tables.vec3s[i] * tables.scalars[i];
+        micro::DoNotOptimize(position);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(Vec3MultiplyAdd);
+
+static void Vec3Normalize(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(vec::normalize(tables.vec3s[i]));
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(Vec3Normalize);
+
+// Sums the whole table each iteration, which the compiler can only unroll or vectorize when the operators are inlined.
+static void Vec3SumTable(micro::State& state)
+{
+    Tables& tables = GetTables();
+    while (state.KeepRunning())
+    {
+        vec::vec3 sum(0.0f);
+        for (unsigned int i = 0; i < TableSize; i++)
+        {
+            sum += tables.vec3s[i];
+        }
+
+        micro::DoNotOptimize(sum);
+    }
+}
+MICRO_BENCHMARK(Vec3SumTable);
+
+static void Vec4Multiply(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(tables.vec4s[i] * tables.vec4s[(i + 1) & TableMask]);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(Vec4Multiply);
+
+static void Vec4MatrixMultiply(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(tables.vec4s[i] * tables.matrices[(i + 1) & TableMask]);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(Vec4MatrixMultiply);
+
+static void Vec4MatrixMultiplyScalar(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(vec::scalar::Multiply(tables.vec4s[i], tables.matrices[(i + 1) & TableMask]));
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(Vec4MatrixMultiplyScalar);
+
+static void Mat4Multiply(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(tables.matrices[i] * tables.matrices[(i + 1) & TableMask]);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(Mat4Multiply);
+
+static void Mat4MultiplyScalar(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(vec::scalar::Multiply(tables.matrices[i], tables.matrices[(i + 1) & TableMask]));
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(Mat4MultiplyScalar);
+
+// Transforms the whole table by one parent each iteration.
+static void MultiplyBatch(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        MatrixOps::MultiplyBatch(tables.matrices[i], tables.matrices, tables.results, TableSize);
+        micro::DoNotOptimize(tables.results);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(MultiplyBatch);
+
+static void MultiplyBatchScalar(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        for (unsigned int j = 0; j < TableSize; j++)
+        {
+            tables.results[j] = vec::scalar::Multiply(tables.matrices[i], tables.matrices[j]);
+        }
+
+        micro::DoNotOptimize(tables.results);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(MultiplyBatchScalar);
+
+// Builds a model matrix for every table entry each iteration, using the vec3 table as both the positions and the scales.
+static void TranslateRotateScaleBatch(micro::State& state)
+{
+    Tables& tables = GetTables();
+    while (state.KeepRunning())
+    {
+        MatrixOps::TranslateRotateScaleBatch(tables.vec3s, tables.quaternions, tables.vec3s, tables.results, TableSize);
+        micro::DoNotOptimize(tables.results);
+    }
+}
+MICRO_BENCHMARK(TranslateRotateScaleBatch);
+
+// The same matrices, built by multiplying the translation, rotation and scale matrices.
+static void TranslateRotateScaleProducts(micro::State& state)
+{
+    Tables& tables = GetTables();
+    while (state.KeepRunning())
+    {
+        for (unsigned int j = 0; j < TableSize; j++)
+        {
+            tables.results[j] = MatrixOps::Translate(tables.vec3s[j]) * tables.quaternions[j].asMatrix() * MatrixOps::Scale(tables.vec3s[j]);
+        }
+
+        micro::DoNotOptimize(tables.results);
+    }
+}
+MICRO_BENCHMARK(TranslateRotateScaleProducts);
+
+static void MatrixInverse(micro::State& state)
+{
+    Tables& tables = GetTables();
+    vec::mat4 result;
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        MatrixOps::Inverse(tables.matrices[i], result);
+        micro::DoNotOptimize(result);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(MatrixInverse);
+
+static void QuaternionMultiply(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(tables.quaternions[i] * tables.quaternions[(i + 1) & TableMask]);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(QuaternionMultiply);
+
+static void QuaternionMultiplyScalar(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(vec::scalar::Multiply(tables.quaternions[i], tables.quaternions[(i + 1) & TableMask]));
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(QuaternionMultiplyScalar);
+
+static void QuaternionAsMatrix(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(tables.quaternions[i].asMatrix());
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(QuaternionAsMatrix);
+
+static void HitsPlane(micro::State& state)
+{
+    Tables& tables = GetTables();
+    vec::vec3 planeNormal(0.0f, 0.0f, 1.0f);
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        float intersectionFactor;
+        bool hit = PhysicsOps::HitsPlane(tables.vec3s[i], tables.vec3s[(i + 1) & TableMask], planeNormal, tables.vec3s[(i + 2) & TableMask], &intersectionFactor);
+        micro::DoNotOptimize(hit);
+        micro::DoNotOptimize(intersectionFactor);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(HitsPlane);
+
+static void HitsSphere(micro::State& state)
+{
+    Tables& tables = GetTables();
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        float intersectionFactor;
+        bool hit = PhysicsOps::HitsSphere(tables.vec3s[i], tables.vec3s[(i + 1) & TableMask], tables.vec3s[(i + 2) & TableMask], tables.scalars[i], &intersectionFactor);
+        micro::DoNotOptimize(hit);
+        micro::DoNotOptimize(intersectionFactor);
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(HitsSphere);
+
+static void ScreenRay(micro::State& state)
+{
+    Tables& tables = GetTables();
+    vec::mat4 perspectiveMatrix = MatrixOps::Perspective(FovY, Aspect, NearPlane, FarPlane);
+    vec::mat4 viewRotationMatrix = tables.quaternions[0].asMatrix();
+    vec::vec2 screenSize(1280.0f, 720.0f);
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(PhysicsOps::ScreenRay(tables.screenPositions[i], screenSize, perspectiveMatrix, viewRotationMatrix));
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(ScreenRay);
+
+static void CameraScreenRay(micro::State& state)
+{
+    Tables& tables = GetTables();
+    Camera camera;
+    camera.SetPerspective(FovY, Aspect, NearPlane, FarPlane);
+    camera.SetView(tables.vec3s[0], tables.quaternions[0]);
+    vec::vec2 screenSize(1280.0f, 720.0f);
+    unsigned int i = 0;
+    while (state.KeepRunning())
+    {
+        micro::DoNotOptimize(camera.ScreenRay(tables.screenPositions[i], screenSize));
+        i = (i + 1) & TableMask;
+    }
+}
+MICRO_BENCHMARK(CameraScreenRay);
+
+// Computes a ray for every screen position in the table each iteration.
+static void CameraScreenRays(micro::State& state)
+{
+    Tables& tables = GetTables();
+    Camera camera;
+    camera.SetPerspective(FovY, Aspect, NearPlane, FarPlane);
+    camera.SetView(tables.vec3s[0], tables.quaternions[0]);
+    vec::vec2 screenSize(1280.0f, 720.0f);
+    while (state.KeepRunning())
+    {
+        camera.ScreenRays(tables.screenPositions, tables.rays, TableSize, screenSize);
+        micro::DoNotOptimize(tables.rays);
+    }
+}
+MICRO_BENCHMARK(CameraScreenRays);
+
+static bool Matches(const vec::vec4& first, const vec::vec4& second)
+{
+    const float tolerance = 0.00001f;
+    for (int i = 0; i < 4; i++)
+    {
+        if (std::abs(first[i] - second[i]) > tolerance * (1.0f + std::abs(second[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool Matches(const vec::mat4& first, const vec::mat4& second)
+{
+    return Matches(first[0], second[0]) && Matches(first[1], second[1]) && Matches(first[2], second[2]) && Matches(first[3], second[3]);
+}
+
+// Counts the table entries where the SIMD products or the composed model matrices differ from the scalar products,
+//  or the camera's rays differ from PhysicsOps::ScreenRay.
+static unsigned int CountMismatches()
+{
+    Tables& tables = GetTables();
+    unsigned int mismatchCount = 0;
+
+    Camera camera;
+    camera.SetPerspective(FovY, Aspect, NearPlane, FarPlane);
+    camera.SetView(tables.vec3s[0], tables.quaternions[0]);
+    vec::mat4 perspectiveMatrix = MatrixOps::Perspective(FovY, Aspect, NearPlane, FarPlane);
+    vec::mat4 viewRotationMatrix = tables.quaternions[0].asMatrix();
+    vec::vec2 screenSize(1280.0f, 720.0f);
+    camera.ScreenRays(tables.screenPositions, tables.rays, TableSize, screenSize);
+
+    for (unsigned int i = 0; i < TableSize; i++)
+    {
+        const unsigned int j = (i + 1) & TableMask;
+        vec::quaternion product = tables.quaternions[i] * tables.quaternions[j];
+        vec::quaternion scalarProduct = vec::scalar::Multiply(tables.quaternions[i], tables.quaternions[j]);
+        vec::mat4 modelMatrix = MatrixOps::TranslateRotateScale(tables.vec3s[i], tables.quaternions[i], tables.vec3s[j]);
+        vec::mat4 scalarModelMatrix = vec::scalar::Multiply(
+            vec::scalar::Multiply(MatrixOps::Translate(tables.vec3s[i]), tables.quaternions[i].asMatrix()), MatrixOps::Scale(tables.vec3s[j]));
+        vec::vec3 ray = PhysicsOps::ScreenRay(tables.screenPositions[i], screenSize, perspectiveMatrix, viewRotationMatrix);
+
+        if (!Matches(tables.matrices[i] * tables.matrices[j], vec::scalar::Multiply(tables.matrices[i], tables.matrices[j])) ||
+            !Matches(tables.vec4s[i] * tables.matrices[j], vec::scalar::Multiply(tables.vec4s[i], tables.matrices[j])) ||
+            !Matches(vec::vec4(product.x, product.y, product.z, product.w), vec::vec4(scalarProduct.x, scalarProduct.y, scalarProduct.z, scalarProduct.w)) ||
+            !Matches(modelMatrix, scalarModelMatrix) ||
+            !Matches(vec::vec4(tables.rays[i].x, tables.rays[i].y, tables.rays[i].z, 0.0f), vec::vec4(ray.x, ray.y, ray.z, 0.0f)))
+        {
+            ++mismatchCount;
+        }
+    }
+
+    return mismatchCount;
+}
+
+int main(int argc, char* argv[])
+{
+#if defined(VEC_SIMD_SSE)
+    printf("Matrix and quaternion products use SSE.\n");
+#elif defined(VEC_SIMD_NEON)
+    printf("Matrix and quaternion products use NEON.\n");
+#else
+    printf("Matrix and quaternion products are scalar.\n");
+#endif
+
+    unsigned int mismatchCount = CountMismatches();
+    printf("%u of %u table entries differ from the scalar products or uncached screen rays.\n", mismatchCount, TableSize);
+
+    micro::RunBenchmarks(argc > 1 ? argv[1] : nullptr);
+    return mismatchCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Minimal Google Benchmark-style harness for timing small functions, so the benchmarks don't need any libraries beyond the simulation.
+// Each case is a function looping on State::KeepRunning(), registered with MICRO_BENCHMARK. Cases are rerun with more iterations
+//  (scaled from the last run, up to ten times as many) until a run takes at least MinimumRunSeconds. That many iterations are then run
+//  Repetitions times, and the fastest time per iteration is reported, as the others were slowed down by something else on the machine.
+namespace micro
+{
+    // Keeps the compiler from discarding a value that is never used. Only the address is passed, so large values aren't copied.
+    template <typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+#if defined(_MSC_VER)
+        static const void* volatile sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r"(&value) : "memory");
+#endif
+    }
+
+    class State
+    {
+    public:
+        State(unsigned long long iterations)
+            : remainingIterations(iterations)
+        {
+        }
+
+        // Returns true while the benchmark should run another iteration.
+        inline bool KeepRunning()
+        {
+            if (remainingIterations == 0)
+            {
+                return false;
+            }
+
+            --remainingIterations;
+            return true;
+        }
+
+    private:
+        unsigned long long remainingIterations;
+    };
+
+    typedef void(*BenchmarkFunction)(State& state);
+
+    struct Benchmark
+    {
+        const char* name;
+        BenchmarkFunction function;
+    };
+
+    inline std::vector<Benchmark>& GetBenchmarks()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    class Registration
+    {
+    public:
+        Registration(const char* name, BenchmarkFunction function)
+        {
+            Benchmark benchmark = { name, function };
+            GetBenchmarks().push_back(benchmark);
+        }
+    };
+
+    const double MinimumRunSeconds = 0.1;
+    const unsigned long long MaximumIterations = 1000000000ull;
+    const unsigned int Repetitions = 5;
+
+    // Returns the seconds the benchmark took to run the given number of iterations.
+    inline double TimeBenchmark(const Benchmark& benchmark, unsigned long long iterations)
+    {
+        State state(iterations);
+        std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+        benchmark.function(state);
+        return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    // Runs every benchmark with the filter in its name (or all of them without a filter), in the order they were registered.
+    inline void RunBenchmarks(const char* filter)
+    {
+        printf("%-28s %12s %14s\n", "Benchmark", "Time ns", "Iterations");
+        for (const Benchmark& benchmark : GetBenchmarks())
+        {
+            if (filter != nullptr && strstr(benchmark.name, filter) == nullptr)
+            {
+                continue;
+            }
+
+            unsigned long long iterations = 1;
+            while (true)
+            {
+                double seconds = TimeBenchmark(benchmark, iterations);
+                if (seconds >= MinimumRunSeconds || iterations >= MaximumIterations)
+                {
+                    break;
+                }
+
+                double multiplier = seconds > 0.0 ? MinimumRunSeconds * 1.4 / seconds : 10.0;
+                multiplier = multiplier > 10.0 ? 10.0 : (multiplier < 2.0 ? 2.0 : multiplier);
+                iterations = (unsigned long long)((double)iterations * multiplier);
+            }
+
+            double fastestSeconds = TimeBenchmark(benchmark, iterations);
+            for (unsigned int i = 1; i < Repetitions; i++)
+            {
+                double seconds = TimeBenchmark(benchmark, iterations);
+                fastestSeconds = seconds < fastestSeconds ? seconds : fastestSeconds;
+            }
+
+            printf("%-28s %12.2f %14llu\n", benchmark.name, fastestSeconds * 1000000000.0 / (double)iterations, iterations);
+        }
+    }
+}
+
+#define MICRO_BENCHMARK(function) static micro::Registration function##Registration(#function, function)
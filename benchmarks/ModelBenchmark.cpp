@@ -0,0 +1,317 @@
+// Times loading every OBJ model in the models folder with ObjParser, against the line-splitting loader it replaced (kept here as a reference),
+//  and through MeshCache both cold (parsing and baking the mesh) and warm (reading the baked mesh), checking all produce the same vertices, indices and bounds.
+// Baked meshes are written to benchmark-cache/models under the working directory.
+// Takes the directory holding the models folder as an optional argument, defaulting to the working directory.
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+#include "Logger.h"
+#include "MeshCache.h"
+#include "ObjParser.h"
+#include "StringUtils.h"
+#include "Vec.h"
+
+static const char* ModelFiles[] =
+{
+    "models/armors/inflatable.obj",
+    "models/bodies/starterBody.obj",
+    "models/scenery/ground.obj",
+    "models/sensors/torus.obj",
+    "models/turrets/pewpew.obj",
+    "models/voxels/voxel_0.obj",
+    "models/voxels/voxel_1.obj"
+};
+
+static const unsigned int Repetitions = 5;
+
+struct LoadedModel
+{
+    std::vector<vec::vec3> positions;
+    std::vector<vec::vec2> uvs;
+    std::vector<unsigned int> indices;
+    vec::vec3 minBounds;
+    vec::vec3 maxBounds;
+};
+
+// The loader ModelManager used before ObjParser: the file is split into lines, the lines into tokens, and face tokens on '/',
+//  with numbers parsed from the token strings and UV duplicates found through maps.
+class LegacyObjLoader
+{
+public:
+    bool LoadModel(const char* objFilename, LoadedModel& model)
+    {
+        std::string fileString;
+        if (!StringUtils::LoadStringFromFile(objFilename, fileString))
+        {
+            return false;
+        }
+
+        std::vector<std::string> fileLines;
+        StringUtils::Split(fileString, StringUtils::Newline, true, fileLines);
+
+        rawIndices.clear();
+        indexUvMap.clear();
+        rawUvs.clear();
+        for (std::string& line : fileLines)
+        {
+            // Files have Windows line endings, which are only converted when read on Windows.
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            std::vector<std::string> splitLine;
+            StringUtils::Split(line, StringUtils::Space, true, splitLine);
+            if (!ParseLine(splitLine, model))
+            {
+                return false;
+            }
+        }
+
+        uvVertexRemapping.clear();
+        model.minBounds = vec::vec3(std::numeric_limits<float>::max());
+        model.maxBounds = vec::vec3(std::numeric_limits<float>::min());
+        for (unsigned int i = 0; i < model.positions.size(); i++)
+        {
+            if (indexUvMap.find(i) == indexUvMap.end())
+            {
+                return false;
+            }
+
+            PosUvPair pair;
+            pair.positionId = i;
+            pair.uvId = indexUvMap[i];
+            model.uvs.push_back(rawUvs[pair.uvId]);
+            uvVertexRemapping[i] = std::vector<PosUvPair>();
+            uvVertexRemapping[i].push_back(pair);
+
+            for (int j = 0; j < 3; j++)
+            {
+                model.minBounds[j] = model.positions[i][j] < model.minBounds[j] ? model.positions[i][j] : model.minBounds[j];
+                model.maxBounds[j] = model.positions[i][j] > model.maxBounds[j] ? model.positions[i][j] : model.maxBounds[j];
+            }
+        }
+
+        for (const PosUvPair& pair : rawIndices)
+        {
+            model.indices.push_back(GetActualVertexIndex(pair.positionId, pair.uvId, model));
+        }
+
+        return true;
+    }
+
+private:
+    std::vector<vec::vec2> rawUvs;
+    std::vector<PosUvPair> rawIndices;
+    std::map<unsigned int, unsigned int> indexUvMap;
+    std::map<unsigned int, std::vector<PosUvPair>> uvVertexRemapping;
+
+    unsigned int GetActualVertexIndex(unsigned int positionIdx, unsigned int uvIdx, LoadedModel& model)
+    {
+        for (const PosUvPair& pair : uvVertexRemapping[positionIdx])
+        {
+            if (pair.uvId == uvIdx)
+            {
+                return pair.positionId;
+            }
+        }
+
+        PosUvPair newVertexRemapping;
+        newVertexRemapping.uvId = uvIdx;
+        newVertexRemapping.positionId = model.positions.size();
+        uvVertexRemapping[positionIdx].push_back(newVertexRemapping);
+
+        const PosUvPair& validMapping = uvVertexRemapping[positionIdx][0];
+        model.positions.push_back(model.positions[validMapping.positionId]);
+        model.uvs.push_back(rawUvs[uvIdx]);
+        return newVertexRemapping.positionId;
+    }
+
+    bool ParseLine(const std::vector<std::string>& line, LoadedModel& model)
+    {
+        if (line.size() < 3)
+        {
+            return true;
+        }
+
+        if (strncmp(line[0].c_str(), "v", 1) == 0 && line[0].size() == 1)
+        {
+            vec::vec3 vector;
+            if (line.size() != 4 || !StringUtils::ParseFloatFromString(line[1], vector.x) ||
+                !StringUtils::ParseFloatFromString(line[2], vector.y) || !StringUtils::ParseFloatFromString(line[3], vector.z))
+            {
+                return false;
+            }
+
+            model.positions.push_back(vector);
+        }
+        else if (strncmp(line[0].c_str(), "vt", 2) == 0 && line[0].size() == 2)
+        {
+            vec::vec2 vector;
+            if (line.size() != 3 || !StringUtils::ParseFloatFromString(line[1], vector.x) || !StringUtils::ParseFloatFromString(line[2], vector.y))
+            {
+                return false;
+            }
+
+            rawUvs.push_back(vector);
+        }
+        else if (strncmp(line[0].c_str(), "f", 1) == 0 && line[0].size() == 1)
+        {
+            if (line.size() != 4)
+            {
+                return false;
+            }
+
+            for (unsigned int i = 0; i < 3; i++)
+            {
+                std::vector<std::string> separatedIndices;
+                StringUtils::Split(line[i + 1], '/', true, separatedIndices);
+
+                int positionIndex, uvIndex;
+                if (separatedIndices.size() != 2 || !StringUtils::ParseIntFromString(separatedIndices[0], positionIndex) ||
+                    !StringUtils::ParseIntFromString(separatedIndices[1], uvIndex))
+                {
+                    return false;
+                }
+
+                PosUvPair pair;
+                pair.positionId = (unsigned int)(positionIndex - 1);
+                pair.uvId = (unsigned int)(uvIndex - 1);
+                rawIndices.push_back(pair);
+                indexUvMap[pair.positionId] = pair.uvId;
+            }
+        }
+
+        return true;
+    }
+};
+
+static bool SameFloats(const float* first, const float* second, size_t count)
+{
+    return count == 0 || memcmp(first, second, count * sizeof(float)) == 0;
+}
+
+static bool SameModels(const LoadedModel& first, const LoadedModel& second)
+{
+    return first.positions.size() == second.positions.size() && first.uvs.size() == second.uvs.size() && first.indices == second.indices &&
+        SameFloats(&first.positions[0].x, &second.positions[0].x, first.positions.size() * 3) &&
+        SameFloats(&first.uvs[0].x, &second.uvs[0].x, first.uvs.size() * 2) &&
+        SameFloats(&first.minBounds.x, &second.minBounds.x, 3) && SameFloats(&first.maxBounds.x, &second.maxBounds.x, 3);
+}
+
+// Loads the model through the mesh cache, splitting its interleaved vertices back out to compare against the parsers.
+static bool LoadCachedModel(MeshCache& meshCache, const char* objFilename, LoadedModel& model)
+{
+    std::vector<MeshVertex> vertices;
+    if (!meshCache.LoadModel(objFilename, vertices, model.indices, &model.minBounds, &model.maxBounds))
+    {
+        return false;
+    }
+
+    for (const MeshVertex& vertex : vertices)
+    {
+        model.positions.push_back(vertex.position);
+        model.uvs.push_back(vertex.uv);
+    }
+
+    return true;
+}
+
+// Returns the fastest time (in milliseconds) to load the model, leaving the model from the last load.
+template <typename Loader>
+static double TimeLoad(Loader load, LoadedModel& model, bool& succeeded)
+{
+    double fastestMs = 0.0;
+    for (unsigned int i = 0; i < Repetitions; i++)
+    {
+        model = LoadedModel();
+        std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+        succeeded = load(model);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        fastestMs = (i == 0 || ms < fastestMs) ? ms : fastestMs;
+    }
+
+    return fastestMs;
+}
+
+int main(int argc, char* argv[])
+{
+    Logger::Setup();
+
+    std::string dataDirectory = argc > 1 ? std::string(argv[1]) + "/" : std::string();
+
+    LegacyObjLoader legacyLoader;
+    ObjParser objParser;
+    MeshCache meshCache("benchmark-cache/models");
+    double legacyTotalMs = 0.0;
+    double parserTotalMs = 0.0;
+    double coldTotalMs = 0.0;
+    double warmTotalMs = 0.0;
+    unsigned int failureCount = 0;
+
+    printf("Model loading, fastest of %u loads.\n", Repetitions);
+    printf("%-32s %9s %9s %12s %12s %8s %10s %10s %8s\n", "Model", "Vertices", "Indices", "Legacy ms", "ObjParser ms", "Speedup",
+        "Cold ms", "Warm ms", "Speedup");
+    for (const char* modelFile : ModelFiles)
+    {
+        std::string filename = dataDirectory + modelFile;
+
+        LoadedModel legacyModel;
+        bool legacySucceeded;
+        double legacyMs = TimeLoad([&](LoadedModel& model) { return legacyLoader.LoadModel(filename.c_str(), model); }, legacyModel, legacySucceeded);
+
+        LoadedModel parsedModel;
+        bool parserSucceeded;
+        double parserMs = TimeLoad([&](LoadedModel& model)
+        {
+            return objParser.ParseFile(filename.c_str(), model.positions, model.uvs, model.indices, &model.minBounds, &model.maxBounds);
+        }, parsedModel, parserSucceeded);
+
+        // Cold loads remove the baked mesh first, so they parse the OBJ file and bake it again.
+        std::string bakedMeshPath = meshCache.GetBakedMeshPath(filename.c_str());
+        LoadedModel coldModel;
+        bool coldSucceeded;
+        double coldMs = TimeLoad([&](LoadedModel& model)
+        {
+            remove(bakedMeshPath.c_str());
+            return LoadCachedModel(meshCache, filename.c_str(), model);
+        }, coldModel, coldSucceeded);
+
+        unsigned int hitsBeforeWarm = meshCache.GetCacheHits();
+        LoadedModel warmModel;
+        bool warmSucceeded;
+        double warmMs = TimeLoad([&](LoadedModel& model)
+        {
+            return LoadCachedModel(meshCache, filename.c_str(), model);
+        }, warmModel, warmSucceeded);
+
+        if (!legacySucceeded || !parserSucceeded || !coldSucceeded || !warmSucceeded)
+        {
+            printf("ERROR: could not load \"%s\". Pass the directory holding the models folder.\n", filename.c_str());
+            ++failureCount;
+            continue;
+        }
+
+        // Every warm load must have come from the baked mesh, not a rebake.
+        bool isSame = SameModels(legacyModel, parsedModel) && SameModels(parsedModel, coldModel) && SameModels(parsedModel, warmModel) &&
+            meshCache.GetCacheHits() - hitsBeforeWarm == Repetitions;
+        failureCount += isSame ? 0 : 1;
+        legacyTotalMs += legacyMs;
+        parserTotalMs += parserMs;
+        coldTotalMs += coldMs;
+        warmTotalMs += warmMs;
+        printf("%-32s %9u %9u %12.3f %12.3f %7.1fx %10.3f %10.3f %7.1fx%s\n", modelFile, (unsigned int)parsedModel.positions.size(),
+            (unsigned int)parsedModel.indices.size(), legacyMs, parserMs, legacyMs / parserMs, coldMs, warmMs, coldMs / warmMs, isSame ? "" : "  MISMATCH");
+    }
+
+    printf("%-32s %9s %9s %12.3f %12.3f %7.1fx %10.3f %10.3f %7.1fx\n", "Total", "", "", legacyTotalMs, parserTotalMs,
+        parserTotalMs > 0.0 ? legacyTotalMs / parserTotalMs : 0.0, coldTotalMs, warmTotalMs, warmTotalMs > 0.0 ? coldTotalMs / warmTotalMs : 0.0);
+    printf("%u model(s) failed to load or differ between the loaders.\n", failureCount);
+
+    Logger::Shutdown();
+    return failureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// Measures projectile updates with thousands of machine gun rounds in flight over a walled map, between two armies of units.
+// Counts heap allocations during the timed ticks, which must be zero for the pool to be allocation-free in combat.
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "AllocationCounter.h"
+#include "BenchmarkFixtures.h"
+#include "Logger.h"
+#include "MapSections.h"
+#include "ProjectilePool.h"
+#include "SpatialHash.h"
+#include "Vec.h"
+
+static const unsigned int MapSize = 64;
+static const unsigned int UnitsPerPlayer = 500;
+static const unsigned int RoundsInFlight = 8000;
+static const unsigned int TickCount = 300;
+
+// A flat map two voxels deep, with a row of pillars across the middle for projectiles to hit.
+static void CreateMap(MapInfo& mapInfo)
+{
+    CreateEmptyMap(mapInfo, MapSize, MapSize, 4);
+
+    for (unsigned int x = 0; x < MapSize; x++)
+    {
+        for (unsigned int y = 0; y < MapSize; y++)
+        {
+            mapInfo.blockType[mapInfo.GetIndex(x, y, 0)] = MapInfo::VoxelTypes::CUBE;
+            mapInfo.blockType[mapInfo.GetIndex(x, y, 1)] = MapInfo::VoxelTypes::CUBE;
+            if (x == MapSize / 2 && y % 4 == 0)
+            {
+                mapInfo.blockType[mapInfo.GetIndex(x, y, 2)] = MapInfo::VoxelTypes::CUBE;
+                mapInfo.blockType[mapInfo.GetIndex(x, y, 3)] = MapInfo::VoxelTypes::CUBE;
+            }
+        }
+    }
+}
+
+// Player 0 is on the low X side of the map and player 1 is on the high X side.
+static vec::vec3 GetUnitPosition(unsigned int playerId, unsigned int unitId)
+{
+    float mapLength = (float)MapSize * MapInfo::SPACING;
+    float x = (float)(unitId % 10) * 2.5f + 4.0f;
+    float y = (float)(unitId / 10) * 2.5f + 2.0f;
+    return vec::vec3(playerId == 0 ? x : mapLength - x, y, 2.0f * MapInfo::SPACING + 1.0f);
+}
+
+// Each tick, units fire rounds at a unit on the other side until the target number of rounds is in flight.
+static void FireRounds(ProjectilePool& projectilePool, unsigned int tick, unsigned int& shotCount)
+{
+    while (projectilePool.GetCount() < RoundsInFlight)
+    {
+        unsigned int playerId = shotCount % 2;
+        unsigned int unitId = (shotCount / 2) % UnitsPerPlayer;
+        unsigned int targetId = (unitId * 7 + tick) % UnitsPerPlayer;
+
+        vec::vec3 start = GetUnitPosition(playerId, unitId);
+        vec::vec3 target = GetUnitPosition(1 - playerId, targetId);
+        vec::vec3 velocity = vec::normalize(target - start) * 1.5f + vec::vec3(0.0f, 0.0f, 0.3f);
+        projectilePool.Fire(playerId, start, velocity, MACHINE_GUN, 1.0f, 120);
+        ++shotCount;
+    }
+}
+
+int main()
+{
+    Logger::Setup();
+
+    MapInfo mapInfo;
+    CreateMap(mapInfo);
+
+    MapSections mapSections;
+    mapSections.RecomputeMapSections(mapInfo);
+
+    SpatialHash unitHash(MapInfo::SPACING);
+    for (unsigned int playerId = 0; playerId < 2; playerId++)
+    {
+        for (unsigned int unitId = 0; unitId < UnitsPerPlayer; unitId++)
+        {
+            unitHash.UpdateEntry(playerId, unitId, GetUnitPosition(playerId, unitId), 1.0f);
+        }
+    }
+
+    ProjectilePool projectilePool;
+    projectilePool.Initialize(RoundsInFlight);
+
+    std::vector<ProjectileHit> hits;
+    hits.reserve(RoundsInFlight);
+
+    std::vector<vec::vec4> visualData(RoundsInFlight);
+
+    // Warm up once, so any first-use allocations are excluded.
+    unsigned int shotCount = 0;
+    FireRounds(projectilePool, 0, shotCount);
+    projectilePool.Update(mapSections, unitHash, hits);
+    hits.clear();
+
+    unsigned int unitHitCount = 0;
+    unsigned int mapHitCount = 0;
+    double totalMs = 0.0;
+    double worstMs = 0.0;
+    unsigned long long startAllocations = AllocationCounter::GetThreadAllocations();
+    for (unsigned int tick = 0; tick < TickCount; tick++)
+    {
+        FireRounds(projectilePool, tick, shotCount);
+
+        std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+        hits.clear();
+        projectilePool.Update(mapSections, unitHash, hits);
+        projectilePool.CopyVisualData(&visualData[0], (unsigned int)visualData.size());
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        totalMs += elapsedMs;
+        worstMs = elapsedMs > worstMs ? elapsedMs : worstMs;
+        for (unsigned int i = 0; i < hits.size(); i++)
+        {
+            hits[i].hitUnit ? ++unitHitCount : ++mapHitCount;
+        }
+    }
+
+    unsigned long long combatAllocations = AllocationCounter::GetThreadAllocations() - startAllocations;
+
+    printf("Projectiles: %u rounds in flight, %u units, %u ticks.\n", RoundsInFlight, UnitsPerPlayer * 2, TickCount);
+    printf("%12s %12s %12s %12s\n", "Average ms", "Worst ms", "Unit hits", "Map hits");
+    printf("%12.3f %12.3f %12u %12u\n", totalMs / (double)TickCount, worstMs, unitHitCount, mapHitCount);
+    printf("Allocations during combat: %llu\n", combatAllocations);
+
+    Logger::Shutdown();
+    return combatAllocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,330 @@
+// Runs scripted rounds of the simulation headlessly, with the physics tick of the game but without any graphics, and reports tick-time percentiles.
+// Each round loads or generates a map, lines up two armies on opposite sides of it, orders them across, and times every tick as they fight.
+// Takes the directory holding the config and maps folders as an optional argument, defaulting to the working directory.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "ArmorConfig.h"
+#include "BenchmarkFixtures.h"
+#include "BodyConfig.h"
+#include "CombatResolver.h"
+#include "GameRound.h"
+#include "JobSystem.h"
+#include "LocalAvoidance.h"
+#include "Logger.h"
+#include "MapManager.h"
+#include "MapSections.h"
+#include "MathOps.h"
+#include "PhysicsConfig.h"
+#include "ProjectilePool.h"
+#include "SpatialHash.h"
+#include "TechConfig.h"
+#include "TurretConfig.h"
+#include "TurretTargeting.h"
+#include "UnitRouter.h"
+#include "Vec.h"
+
+static const unsigned int PlayerCount = 2;
+static const float UnitSpacing = 2.5f;
+
+// A scripted round. Generated maps are flat fields with a line of pillars across the middle, which have gaps where the lanes cross.
+struct RoundScript
+{
+    const char* name;
+
+    // Map file to load, relative to the data directory, or nullptr to generate a map of the given size.
+    const char* mapFile;
+    unsigned int mapSize;
+
+    // Each player's units are split into lanes across the map, with each lane moving as a block of the given width.
+    unsigned int unitsPerPlayer;
+    unsigned int laneCount;
+    unsigned int laneWidth;
+    unsigned int tickCount;
+};
+
+struct RoundResult
+{
+    bool succeeded;
+    double setupMs;
+    double p50Ms;
+    double p90Ms;
+    double p99Ms;
+    double worstMs;
+    unsigned int deathCount;
+    float averageTravel;
+};
+
+// Ground two voxels deep, with a pillar in every other column across the middle of the map except in the gaps the lanes travel through.
+static void CreateMap(const RoundScript& script, MapInfo& mapInfo)
+{
+    CreateEmptyMap(mapInfo, script.mapSize, script.mapSize, 4);
+
+    float laneSpacing = (float)script.mapSize / (float)(script.laneCount + 1);
+    float gapHalfWidth = ((float)script.laneWidth * UnitSpacing / MapInfo::SPACING) * 0.5f + 2.0f;
+    for (unsigned int x = 0; x < script.mapSize; x++)
+    {
+        for (unsigned int y = 0; y < script.mapSize; y++)
+        {
+            mapInfo.blockType[mapInfo.GetIndex(x, y, 0)] = MapInfo::VoxelTypes::CUBE;
+            mapInfo.blockType[mapInfo.GetIndex(x, y, 1)] = MapInfo::VoxelTypes::CUBE;
+
+            float laneOffset = std::fmod((float)y + 0.5f, laneSpacing);
+            bool inGap = std::min(laneOffset, laneSpacing - laneOffset) < gapHalfWidth;
+            if (x == script.mapSize / 2 && y % 2 == 0 && !inGap)
+            {
+                mapInfo.blockType[mapInfo.GetIndex(x, y, 2)] = MapInfo::VoxelTypes::CUBE;
+                mapInfo.blockType[mapInfo.GetIndex(x, y, 3)] = MapInfo::VoxelTypes::CUBE;
+            }
+        }
+    }
+}
+
+// Finds the route a lane travels along, from the voxel under the start to the voxel under the destination.
+static bool ComputeLaneRoute(GameRound& gameRound, MapSections& mapSections, UnitRouter& unitRouter, vec::vec3 start, vec::vec3 destination, std::vector<vec::vec3>& visualPath)
+{
+    start.z = mapSections.GetSurface().GetSurface(start).height + UnitRouter::GetHoverHeight();
+    destination.z = mapSections.GetSurface().GetSurface(destination).height + UnitRouter::GetHoverHeight();
+
+    vec::vec3i startVoxel;
+    vec::vec3i destinationVoxel;
+    std::vector<vec::vec3i> path;
+    if (!mapSections.GetVoxelUnderPosition(start, &startVoxel) || !mapSections.GetVoxelUnderPosition(destination, &destinationVoxel) ||
+        !mapSections.ComputeRoute(startVoxel, destinationVoxel, path) || path.size() == 0)
+    {
+        return false;
+    }
+
+    std::vector<vec::vec3i> refinedPath;
+    unitRouter.RefineRoute(&gameRound.map, mapSections.GetSubsections(), mapSections.GetSurface(), startVoxel, destinationVoxel, path, refinedPath, visualPath);
+    return visualPath.size() != 0;
+}
+
+// Lines up each player's lanes on their side of the map, ordering every lane across to the other side.
+// Units in a lane follow the lane's route, offset by where they are in the block, the same as a group move order.
+static bool SetupArmies(const RoundScript& script, GameRound& gameRound, MapSections& mapSections, const std::vector<unsigned int>& turretTypeIds)
+{
+    UnitRouter unitRouter;
+    float mapWidth = (float)gameRound.map.xSize * MapInfo::SPACING;
+    float laneSpacing = (float)gameRound.map.ySize * MapInfo::SPACING / (float)(script.laneCount + 1);
+    unsigned int unitsPerLane = (script.unitsPerPlayer + script.laneCount - 1) / script.laneCount;
+    unsigned int rowCount = (unitsPerLane + script.laneWidth - 1) / script.laneWidth;
+    float frontX = (float)rowCount * UnitSpacing + 2.0f * MapInfo::SPACING;
+
+    for (unsigned int player = 0; player < PlayerCount; player++)
+    {
+        // Player 1 mirrors player 0 from the other side of the map.
+        float direction = player == 0 ? 1.0f : -1.0f;
+        float startX = player == 0 ? frontX : mapWidth - frontX;
+        float rotation = player == 0 ? 0.0f : MathOps::Radians(180.0f);
+        vec::quaternion unitRotation = vec::quaternion::fromAxisAngle(rotation, vec::vec3(0.0f, 1.0f, 0.0f)) * vec::quaternion::fromAxisAngle(MathOps::Radians(-90.0f), vec::vec3(1.0f, 0.0f, 0.0f));
+
+        unsigned int unitId = 0;
+        for (unsigned int lane = 0; lane < script.laneCount && unitId < script.unitsPerPlayer; lane++)
+        {
+            float laneY = laneSpacing * (float)(lane + 1);
+            std::vector<vec::vec3> laneRoute;
+            if (!ComputeLaneRoute(gameRound, mapSections, unitRouter, vec::vec3(startX, laneY, 0.0f), vec::vec3(mapWidth - startX, laneY, 0.0f), laneRoute))
+            {
+                printf("ERROR: no route for lane %u of player %u.\n", lane, player);
+                return false;
+            }
+
+            for (unsigned int i = 0; i < unitsPerLane && unitId < script.unitsPerPlayer; i++, unitId++)
+            {
+                float column = (float)(i % script.laneWidth) - (float)(script.laneWidth - 1) * 0.5f;
+                float row = (float)(i / script.laneWidth);
+                vec::vec3 offset(-direction * row * UnitSpacing, column * UnitSpacing, 0.0f);
+
+                std::vector<vec::vec3> unitRoute(laneRoute.size());
+                for (unsigned int j = 0; j < laneRoute.size(); j++)
+                {
+                    unitRoute[j] = laneRoute[j] + offset;
+                }
+
+                gameRound.players[player].AddUnit(Unit(0, 0, turretTypeIds, unitRoute[0], unitRotation));
+                gameRound.players[player].UpdateUnitRoute(unitId, unitRoute);
+            }
+        }
+    }
+
+    return true;
+}
+
+static RoundResult RunRound(const RoundScript& script, const std::string& dataDirectory, JobSystem& jobSystem)
+{
+    RoundResult result = RoundResult();
+
+    std::chrono::high_resolution_clock::time_point setupStart = std::chrono::high_resolution_clock::now();
+    GameRound gameRound;
+    if (script.mapFile != nullptr)
+    {
+        MapManager mapManager;
+        if (!mapManager.ReadMap((dataDirectory + script.mapFile).c_str(), gameRound.map))
+        {
+            printf("ERROR: could not read the map %s.\n", script.mapFile);
+            return result;
+        }
+    }
+    else
+    {
+        CreateMap(script, gameRound.map);
+    }
+
+    MapSections mapSections;
+    mapSections.RecomputeMapSections(gameRound.map);
+
+    for (unsigned int i = 0; i < PlayerCount; i++)
+    {
+        gameRound.players.push_back(Player(i == 0 ? "Benchmark Player" : "Benchmark Opponent", (int)i));
+    }
+
+    // The local player researches the first tech available, so research progresses as it does in game.
+    for (unsigned int i = 0; i < TechConfig::Techs.size(); i++)
+    {
+        if (gameRound.players[0].SwitchResearch(i))
+        {
+            break;
+        }
+    }
+
+    std::vector<unsigned int> turretTypeIds;
+    turretTypeIds.push_back(0);
+    if (!SetupArmies(script, gameRound, mapSections, turretTypeIds))
+    {
+        return result;
+    }
+
+    gameRound.ResetVisibility(mapSections);
+
+    SpatialHash unitHash(MapInfo::SPACING);
+    LocalAvoidance localAvoidance;
+    TurretTargeting turretTargeting;
+    turretTargeting.Initialize(PhysicsConfig::TurretScanTicks < 1 ? 1 : (unsigned int)PhysicsConfig::TurretScanTicks);
+
+    ProjectilePool projectilePool;
+    projectilePool.Initialize(PhysicsConfig::MaxProjectiles);
+    std::vector<ProjectileHit> projectileHits;
+    projectileHits.reserve(PhysicsConfig::MaxProjectiles);
+    CombatResolver combatResolver;
+    combatResolver.Initialize(PhysicsConfig::MaxProjectiles);
+    std::vector<UnitDeath> unitDeaths;
+
+    std::vector<std::vector<vec::vec3>> startPositions(PlayerCount);
+    for (unsigned int player = 0; player < PlayerCount; player++)
+    {
+        for (unsigned int i = 0; i < script.unitsPerPlayer; i++)
+        {
+            startPositions[player].push_back(gameRound.players[player].GetUnitPosition(i));
+        }
+    }
+
+    result.setupMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - setupStart).count();
+
+    // The same stages, in the same order, as a physics tick of the game.
+    float tickSeconds = (float)PhysicsConfig::PhysicsThreadDelay / 1000.0f;
+    std::vector<double> tickTimes;
+    tickTimes.reserve(script.tickCount);
+    for (unsigned int tick = 0; tick < script.tickCount; tick++)
+    {
+        std::chrono::high_resolution_clock::time_point tickStart = std::chrono::high_resolution_clock::now();
+        gameRound.UpdatePlayers(jobSystem, unitHash, localAvoidance, mapSections, tickSeconds);
+        gameRound.UpdateVisibility(jobSystem, mapSections, PhysicsConfig::VisibilityBudget);
+        gameRound.UpdateTurrets(jobSystem, turretTargeting, mapSections, unitHash, projectilePool);
+
+        projectileHits.clear();
+        projectilePool.Update(mapSections, unitHash, projectileHits);
+
+        combatResolver.Clear();
+        combatResolver.AddHits(projectileHits);
+        unitDeaths.clear();
+        gameRound.ResolveCombat(combatResolver, unitDeaths);
+        tickTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tickStart).count());
+
+        result.deathCount += (unsigned int)unitDeaths.size();
+    }
+
+    std::sort(tickTimes.begin(), tickTimes.end());
+    result.p50Ms = tickTimes[tickTimes.size() / 2];
+    result.p90Ms = tickTimes[(tickTimes.size() * 90) / 100];
+    result.p99Ms = tickTimes[(tickTimes.size() * 99) / 100];
+    result.worstMs = tickTimes.back();
+
+    // How far units got shows the armies actually moved, rather than being stuck where they started.
+    double totalTravel = 0.0;
+    for (unsigned int player = 0; player < PlayerCount; player++)
+    {
+        for (unsigned int i = 0; i < script.unitsPerPlayer; i++)
+        {
+            totalTravel += vec::length(gameRound.players[player].GetUnitPosition(i) - startPositions[player][i]);
+        }
+    }
+
+    result.averageTravel = (float)(totalTravel / (double)(PlayerCount * script.unitsPerPlayer));
+    result.succeeded = true;
+
+    MapManager mapManager;
+    mapManager.ClearMap(gameRound.map);
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    Logger::Setup();
+
+    std::string dataDirectory = argc > 1 ? std::string(argv[1]) + "/" : std::string();
+    std::string physicsConfigFile = dataDirectory + "config/physics.txt";
+    std::string techConfigFile = dataDirectory + "config/technologies.txt";
+    std::string armorConfigFile = dataDirectory + "config/armors.txt";
+    std::string bodyConfigFile = dataDirectory + "config/bodies.txt";
+    std::string turretConfigFile = dataDirectory + "config/turrets.txt";
+
+    HeadlessModelLoader modelLoader;
+    PhysicsConfig physicsConfig(physicsConfigFile.c_str());
+    TechConfig techConfig(techConfigFile.c_str());
+    ArmorConfig armorConfig(&modelLoader, armorConfigFile.c_str());
+    BodyConfig bodyConfig(&modelLoader, bodyConfigFile.c_str());
+    TurretConfig turretConfig(&modelLoader, turretConfigFile.c_str());
+    if (!physicsConfig.ReadConfiguration() || !techConfig.ReadConfiguration() || !armorConfig.ReadConfiguration() ||
+        !bodyConfig.ReadConfiguration() || !turretConfig.ReadConfiguration())
+    {
+        printf("ERROR: could not read the configuration from \"%s\". Pass the directory holding the config folder.\n", dataDirectory.empty() ? "." : dataDirectory.c_str());
+        Logger::Shutdown();
+        return 1;
+    }
+
+    JobSystem jobSystem;
+    jobSystem.Initialize(PhysicsConfig::PhysicsWorkerThreads < 0 ? JobSystem::DefaultWorkerCount() : (unsigned int)PhysicsConfig::PhysicsWorkerThreads);
+
+    const RoundScript rounds[] =
+    {
+        { "Test map skirmish", "maps/test.txt", 0, 8, 1, 2, 300 },
+        { "Field, 2 x 250 units", nullptr, 96, 250, 5, 5, 900 },
+        { "Field, 2 x 1000 units", nullptr, 128, 1000, 8, 5, 900 },
+    };
+
+    printf("Simulation: %u thread(s), %d ms physics tick.\n", jobSystem.GetThreadCount(), PhysicsConfig::PhysicsThreadDelay);
+    printf("%-24s %7s %10s %9s %9s %9s %9s %7s %8s\n", "Round", "Ticks", "Setup ms", "P50 ms", "P90 ms", "P99 ms", "Worst ms", "Deaths", "Travel");
+
+    bool allSucceeded = true;
+    for (const RoundScript& script : rounds)
+    {
+        RoundResult result = RunRound(script, dataDirectory, jobSystem);
+        if (!result.succeeded)
+        {
+            printf("%-24s failed to set up.\n", script.name);
+            allSucceeded = false;
+            continue;
+        }
+
+        printf("%-24s %7u %10.1f %9.3f %9.3f %9.3f %9.3f %7u %8.1f\n", script.name, script.tickCount, result.setupMs,
+            result.p50Ms, result.p90Ms, result.p99Ms, result.worstMs, result.deathCount, result.averageTravel);
+    }
+
+    jobSystem.Shutdown();
+    Logger::Shutdown();
+    return allSucceeded ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// Measures surface height lookups on a 256x256 terraced map with ramps between the terraces, comparing
+//  UnitRouter::GetHeightForVoxel against the precomputed surface heightfield, and checks both agree.
+// Also times rebuilding the whole heightfield against updating the columns around a single voxel edit.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "BenchmarkFixtures.h"
+#include "Logger.h"
+#include "SurfaceHeightfield.h"
+#include "UnitRouter.h"
+#include "Vec.h"
+
+static const unsigned int MapSize = 256;
+static const unsigned int MapHeight = 8;
+static const unsigned int UnitCount = 1000;
+static const unsigned int LookupCount = 4000000;
+static const unsigned int EditCount = 1000;
+
+// Terraces stepping up along X every 8 voxels, each joined to the next by a row of ramps. Every fifth row has the ramps facing along Y instead.
+static void CreateMap(MapInfo& mapInfo)
+{
+    CreateEmptyMap(mapInfo, MapSize, MapSize, MapHeight);
+
+    for (unsigned int x = 0; x < MapSize; x++)
+    {
+        for (unsigned int y = 0; y < MapSize; y++)
+        {
+            unsigned int terraceHeight = (x / 8) % (MapHeight - 1) + 1;
+            for (unsigned int z = 0; z < terraceHeight; z++)
+            {
+                mapInfo.blockType[mapInfo.GetIndex(x, y, z)] = MapInfo::VoxelTypes::CUBE;
+            }
+
+            if (x % 8 == 7 && terraceHeight < MapHeight - 1)
+            {
+                mapInfo.blockType[mapInfo.GetIndex(x, y, terraceHeight)] = MapInfo::VoxelTypes::SLANT;
+                mapInfo.blockOrientation[mapInfo.GetIndex(x, y, terraceHeight)] = (unsigned char)(y % 5 == 0 ? 3 : 2);
+            }
+        }
+    }
+}
+
+// Lookups follow 1000 units wandering in circles, as unit movement looks up each unit once per tick.
+static vec::vec3 GetLookupPosition(unsigned int lookup)
+{
+    unsigned int unit = lookup % UnitCount;
+    unsigned int tick = lookup / UnitCount;
+    unsigned int seed = unit * 2654435761u;
+    float mapWidth = (float)MapSize * MapInfo::SPACING;
+    float wanderRadius = 8.0f * MapInfo::SPACING;
+    float centerX = (float)(seed % 65521) / 65521.0f * (mapWidth - 2.0f * wanderRadius) + wanderRadius;
+    float centerY = (float)((seed / 65521) % 65519) / 65519.0f * (mapWidth - 2.0f * wanderRadius) + wanderRadius;
+    float angle = (float)tick * 0.15f / wanderRadius + (float)unit;
+    return vec::vec3(centerX + std::cos(angle) * wanderRadius, centerY + std::sin(angle) * wanderRadius, 0.0f);
+}
+
+// Finds the top voxel of the position's column, as callers of GetHeightForVoxel had to.
+static vec::vec3i GetTopVoxel(const MapInfo& mapInfo, const vec::vec3& position)
+{
+    vec::vec3i voxelId((int)(position.x / MapInfo::SPACING), (int)(position.y / MapInfo::SPACING), (int)MapHeight - 1);
+    while (voxelId.z > 0 && mapInfo.GetType(voxelId) == MapInfo::VoxelTypes::AIR)
+    {
+        --voxelId.z;
+    }
+
+    return voxelId;
+}
+
+int main()
+{
+    Logger::Setup();
+
+    MapInfo mapInfo;
+    CreateMap(mapInfo);
+
+    SurfaceHeightfield surface;
+    std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+    surface.Rebuild(mapInfo);
+    double rebuildMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    // The voxels are found before timing, so only the height calculations are compared.
+    std::vector<vec::vec3> positions(LookupCount);
+    std::vector<vec::vec3i> voxelIds(LookupCount);
+    for (unsigned int i = 0; i < LookupCount; i++)
+    {
+        positions[i] = GetLookupPosition(i);
+        voxelIds[i] = GetTopVoxel(mapInfo, positions[i]);
+        positions[i].z = ((float)voxelIds[i].z + 0.5f) * MapInfo::SPACING;
+    }
+
+    std::vector<float> voxelHeights(LookupCount);
+    startTime = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < LookupCount; i++)
+    {
+        voxelHeights[i] = UnitRouter::GetHeightForVoxel(&mapInfo, voxelIds[i], positions[i]);
+    }
+
+    double voxelMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    std::vector<SurfaceSample> samples(LookupCount);
+    startTime = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < LookupCount; i++)
+    {
+        samples[i] = surface.GetSurface(positions[i]);
+    }
+
+    double surfaceMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    unsigned int mismatchCount = 0;
+    for (unsigned int i = 0; i < LookupCount; i++)
+    {
+        if (std::abs(voxelHeights[i] - samples[i].height) > 0.0001f)
+        {
+            ++mismatchCount;
+        }
+    }
+
+    // Edits raise a single voxel to a cube, which updates the 3x3 columns around it to match how map editing would be batched.
+    startTime = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < EditCount; i++)
+    {
+        vec::vec3 position = GetLookupPosition(i);
+        vec::vec3i voxelId = GetTopVoxel(mapInfo, position);
+        mapInfo.blockType[mapInfo.GetIndex(voxelId)] = MapInfo::VoxelTypes::CUBE;
+        surface.UpdateColumns(mapInfo, voxelId.x - 1, voxelId.y - 1, voxelId.x + 1, voxelId.y + 1);
+    }
+
+    double editMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    SurfaceHeightfield rebuiltSurface;
+    rebuiltSurface.Rebuild(mapInfo);
+    unsigned int editMismatchCount = 0;
+    for (unsigned int i = 0; i < LookupCount; i++)
+    {
+        if (std::abs(surface.GetSurface(positions[i]).height - rebuiltSurface.GetSurface(positions[i]).height) > 0.0001f)
+        {
+            ++editMismatchCount;
+        }
+    }
+
+    printf("Surface lookups: %ux%u map, %u lookups.\n", MapSize, MapSize, LookupCount);
+    printf("GetHeightForVoxel:  %8.3f ms (%.2f ns per lookup)\n", voxelMs, voxelMs * 1000000.0 / (double)LookupCount);
+    printf("Heightfield lookup: %8.3f ms (%.2f ns per lookup, including the normal)\n", surfaceMs, surfaceMs * 1000000.0 / (double)LookupCount);
+    printf("%u heights differ between the two.\n", mismatchCount);
+    printf("Full rebuild %.3f ms, %u single-voxel edits %.3f ms (%.3f us each), %u heights differ from a full rebuild after the edits.\n",
+        rebuildMs, EditCount, editMs, editMs * 1000.0 / (double)EditCount, editMismatchCount);
+
+    Logger::Shutdown();
+    return mismatchCount == 0 && editMismatchCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+// Measures turret targeting with 5000 turrets in two armies facing each other across a line of pillars.
+// Compares every turret rescanning each tick against staggered scans spread over several ticks, reporting the cost per tick.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "BenchmarkFixtures.h"
+#include "JobSystem.h"
+#include "Logger.h"
+#include "MapSections.h"
+#include "ProjectilePool.h"
+#include "SpatialHash.h"
+#include "TurretTargeting.h"
+#include "Vec.h"
+
+static const unsigned int MapSize = 128;
+static const unsigned int PlayerCount = 2;
+static const unsigned int UnitsPerPlayer = 2500;
+static const unsigned int ArmyColumns = 25;
+static const unsigned int TickCount = 300;
+static const unsigned int MaxProjectiles = 16384;
+
+struct RunResult
+{
+    double averageMs;
+    double worstMs;
+    double averageScans;
+    unsigned int worstScans;
+    unsigned int shotCount;
+};
+
+// A flat map two voxels deep, with a row of pillars down the middle that block some lines of sight.
+static void CreateMap(MapInfo& mapInfo)
+{
+    CreateEmptyMap(mapInfo, MapSize, MapSize, 4);
+
+    for (unsigned int x = 0; x < MapSize; x++)
+    {
+        for (unsigned int y = 0; y < MapSize; y++)
+        {
+            mapInfo.blockType[mapInfo.GetIndex(x, y, 0)] = MapInfo::VoxelTypes::CUBE;
+            mapInfo.blockType[mapInfo.GetIndex(x, y, 1)] = MapInfo::VoxelTypes::CUBE;
+            if (x == MapSize / 2 && y % 3 == 0)
+            {
+                mapInfo.blockType[mapInfo.GetIndex(x, y, 2)] = MapInfo::VoxelTypes::CUBE;
+                mapInfo.blockType[mapInfo.GetIndex(x, y, 3)] = MapInfo::VoxelTypes::CUBE;
+            }
+        }
+    }
+}
+
+// Player 0 lines up on the low X side of the pillars and player 1 on the high X side. Units sway sideways over time.
+static vec::vec3 GetUnitPosition(unsigned int playerId, unsigned int unitId, unsigned int tick)
+{
+    float center = (float)MapSize * MapInfo::SPACING * 0.5f;
+    float depth = (float)(unitId % ArmyColumns) * 2.5f + 4.0f;
+    float sway = std::sin((float)tick * 0.05f + (float)unitId) * 1.0f;
+    float y = (float)(unitId / ArmyColumns) * 2.5f + 3.0f + sway;
+    return vec::vec3(playerId == 0 ? center - depth : center + depth, y, 2.0f * MapInfo::SPACING + 1.0f);
+}
+
+static RunResult RunTargeting(JobSystem& jobSystem, const MapSections& mapSections, const TurretType& turretType, unsigned int scanInterval)
+{
+    SpatialHash unitHash(MapInfo::SPACING);
+    std::vector<Turret> turrets(PlayerCount * UnitsPerPlayer);
+    for (unsigned int i = 0; i < turrets.size(); i++)
+    {
+        turrets[i].turretTypeId = 0;
+        TurretTargeting::ResetTurret(turrets[i]);
+        unitHash.UpdateEntry(i / UnitsPerPlayer, i % UnitsPerPlayer, GetUnitPosition(i / UnitsPerPlayer, i % UnitsPerPlayer, 0), 1.0f);
+    }
+
+    TurretTargeting turretTargeting;
+    turretTargeting.Initialize(scanInterval);
+
+    ProjectilePool projectilePool;
+    projectilePool.Initialize(MaxProjectiles);
+    std::vector<ProjectileHit> hits;
+    hits.reserve(MaxProjectiles);
+
+    const vec::quaternion bodyRotation = vec::quaternion::fromAxisAngle(0.0f, vec::vec3(1, 0, 0));
+
+    RunResult result;
+    result.averageMs = 0.0;
+    result.worstMs = 0.0;
+    result.averageScans = 0.0;
+    result.worstScans = 0;
+    result.shotCount = 0;
+    for (unsigned int tick = 0; tick < TickCount; tick++)
+    {
+        for (unsigned int i = 0; i < turrets.size(); i++)
+        {
+            unitHash.UpdateEntry(i / UnitsPerPlayer, i % UnitsPerPlayer, GetUnitPosition(i / UnitsPerPlayer, i % UnitsPerPlayer, tick), 1.0f);
+        }
+
+        std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+        turretTargeting.BeginTick();
+        jobSystem.ParallelFor(0, (unsigned int)turrets.size(), 16, [&](unsigned int startIndex, unsigned int endIndex)
+        {
+            TurretTargeting::SearchBuffers searchBuffers;
+            for (unsigned int i = startIndex; i < endIndex; i++)
+            {
+                unsigned int playerId = i / UnitsPerPlayer;
+                unsigned int unitId = i % UnitsPerPlayer;
+                turretTargeting.UpdateTurret(turrets[i], turretType, playerId, unitId, 0,
+                    GetUnitPosition(playerId, unitId, tick), bodyRotation, mapSections, unitHash, nullptr, searchBuffers);
+            }
+        });
+
+        for (unsigned int i = 0; i < turrets.size(); i++)
+        {
+            unsigned int playerId = i / UnitsPerPlayer;
+            if (TurretTargeting::FireTurret(turrets[i], turretType, playerId, GetUnitPosition(playerId, i % UnitsPerPlayer, tick), bodyRotation, projectilePool))
+            {
+                ++result.shotCount;
+            }
+        }
+
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        result.averageMs += elapsedMs;
+        result.worstMs = elapsedMs > result.worstMs ? elapsedMs : result.worstMs;
+        result.averageScans += (double)turretTargeting.GetScanCount();
+        result.worstScans = turretTargeting.GetScanCount() > result.worstScans ? turretTargeting.GetScanCount() : result.worstScans;
+
+        // Projectiles aren't part of the timing, but must move so the pool doesn't fill up.
+        hits.clear();
+        projectilePool.Update(mapSections, unitHash, hits);
+    }
+
+    result.averageMs /= (double)TickCount;
+    result.averageScans /= (double)TickCount;
+    return result;
+}
+
+int main()
+{
+    Logger::Setup();
+
+    MapInfo mapInfo;
+    CreateMap(mapInfo);
+
+    MapSections mapSections;
+    mapSections.RecomputeMapSections(mapInfo);
+
+    TurretType turretType;
+    turretType.turretModelId = 0;
+    turretType.translationOffset = vec::vec3(0.0f, 0.0f, 1.0f);
+    turretType.rotationOffset = vec::quaternion::fromAxisAngle(0.0f, vec::vec3(1, 0, 0));
+    turretType.range = 24.0f;
+    turretType.slewRate = 6.0f * 3.14159265f / 180.0f;
+    turretType.reloadTicks = 10;
+    turretType.damageType = MACHINE_GUN;
+    turretType.damage = 0.5f;
+    turretType.projectileSpeed = 1.5f;
+
+    JobSystem jobSystem;
+    jobSystem.Initialize(JobSystem::DefaultWorkerCount());
+
+    printf("Turret targeting: %u turrets, %u ticks, %u thread(s).\n", PlayerCount * UnitsPerPlayer, TickCount, jobSystem.GetThreadCount());
+    printf("%14s %12s %12s %14s %12s %12s\n", "Scan interval", "Average ms", "Worst ms", "Average scans", "Worst scans", "Shots");
+
+    const unsigned int scanIntervals[] = { 1, 4, 8, 16 };
+    for (unsigned int scanInterval : scanIntervals)
+    {
+        RunResult result = RunTargeting(jobSystem, mapSections, turretType, scanInterval);
+        printf("%14u %12.3f %12.3f %14.1f %12u %12u\n", scanInterval, result.averageMs, result.worstMs, result.averageScans, result.worstScans, result.shotCount);
+    }
+
+    jobSystem.Shutdown();
+    Logger::Shutdown();
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Measures fog of war updates on a 512x512 hilly map, with two players of 1000 wandering units each.
+// For several time budgets, reports the time each player's visibility update (recomputing moved units) takes per tick and how many
+//  moved units are left waiting, then checks that the incrementally updated grid matches one computed from scratch once they catch up.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "BenchmarkFixtures.h"
+#include "Logger.h"
+#include "MapSections.h"
+#include "Vec.h"
+#include "VisibilityGrid.h"
+
+static const unsigned int MapSize = 512;
+static const unsigned int MapHeight = 12;
+static const unsigned int PlayerCount = 2;
+static const unsigned int UnitsPerPlayer = 1000;
+static const unsigned int TickCount = 300;
+static const float SensorRadius = 30.0f;
+
+// Units move at the maximum unit speed, in world units per tick.
+static const float UnitSpeed = 0.15f;
+
+struct RunResult
+{
+    double averageMs;
+    double p99Ms;
+    double worstMs;
+    double averageRecomputes;
+    unsigned int finalBacklog;
+    unsigned int mismatchCount;
+};
+
+// Rolling hills, with the ground between 2 and 10 voxels deep.
+static void CreateMap(MapInfo& mapInfo)
+{
+    CreateEmptyMap(mapInfo, MapSize, MapSize, MapHeight);
+
+    for (unsigned int x = 0; x < MapSize; x++)
+    {
+        for (unsigned int y = 0; y < MapSize; y++)
+        {
+            float hill = std::sin((float)x * 0.05f) * std::cos((float)y * 0.07f) + std::sin((float)(x + y) * 0.013f);
+            unsigned int groundHeight = (unsigned int)(6.0f + 2.0f * hill);
+            for (unsigned int z = 0; z < groundHeight; z++)
+            {
+                mapInfo.blockType[mapInfo.GetIndex(x, y, z)] = MapInfo::VoxelTypes::CUBE;
+            }
+        }
+    }
+}
+
+// Units wander in slow circles around spots spread over the map, standing on the highest the ground gets.
+static vec::vec3 GetUnitPosition(unsigned int playerId, unsigned int unitId, unsigned int tick)
+{
+    unsigned int seed = (playerId * UnitsPerPlayer + unitId) * 2654435761u;
+    float mapWidth = (float)MapSize * MapInfo::SPACING;
+    float centerX = (float)(seed % 10007) / 10007.0f * mapWidth * 0.9f + mapWidth * 0.05f;
+    float centerY = (float)((seed / 10007) % 10009) / 10009.0f * mapWidth * 0.9f + mapWidth * 0.05f;
+    float wanderRadius = 8.0f * MapInfo::SPACING;
+    float angle = (float)tick * UnitSpeed / wanderRadius + (float)unitId;
+    return vec::vec3(centerX + std::cos(angle) * wanderRadius, centerY + std::sin(angle) * wanderRadius, 10.0f * MapInfo::SPACING);
+}
+
+static RunResult RunVisibility(const MapSections& mapSections, float budgetMs)
+{
+    std::vector<VisibilityGrid> grids(PlayerCount);
+    for (unsigned int i = 0; i < PlayerCount; i++)
+    {
+        grids[i].Reset(mapSections);
+    }
+
+    // Every unit is added on the first tick, so the timing starts once they have all been recomputed.
+    for (unsigned int player = 0; player < PlayerCount; player++)
+    {
+        for (unsigned int unit = 0; unit < UnitsPerPlayer; unit++)
+        {
+            grids[player].UpdateViewer(unit, GetUnitPosition(player, unit, 0), SensorRadius);
+        }
+
+        while (!grids[player].Update(mapSections, budgetMs))
+        {
+        }
+    }
+
+    std::vector<double> updateTimes;
+    updateTimes.reserve(TickCount * PlayerCount);
+    unsigned int recomputeCount = 0;
+    for (unsigned int tick = 1; tick <= TickCount; tick++)
+    {
+        for (unsigned int player = 0; player < PlayerCount; player++)
+        {
+            for (unsigned int unit = 0; unit < UnitsPerPlayer; unit++)
+            {
+                grids[player].UpdateViewer(unit, GetUnitPosition(player, unit, tick), SensorRadius);
+            }
+
+            unsigned int pendingCount = grids[player].GetPendingViewerCount();
+            std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+            grids[player].Update(mapSections, budgetMs);
+            updateTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count());
+            recomputeCount += pendingCount - grids[player].GetPendingViewerCount();
+        }
+    }
+
+    RunResult result;
+    std::sort(updateTimes.begin(), updateTimes.end());
+    result.averageMs = 0.0;
+    for (double time : updateTimes)
+    {
+        result.averageMs += time;
+    }
+
+    result.averageMs /= (double)updateTimes.size();
+    result.p99Ms = updateTimes[(updateTimes.size() * 99) / 100];
+    result.worstMs = updateTimes.back();
+    result.averageRecomputes = (double)recomputeCount / (double)updateTimes.size();
+    result.finalBacklog = 0;
+    result.mismatchCount = 0;
+
+    // Catch up on everything deferred, then compare against grids computed from scratch at the final positions.
+    for (unsigned int player = 0; player < PlayerCount; player++)
+    {
+        result.finalBacklog += grids[player].GetPendingViewerCount();
+        while (!grids[player].Update(mapSections, budgetMs))
+        {
+        }
+
+        VisibilityGrid freshGrid;
+        freshGrid.Reset(mapSections);
+        for (unsigned int unit = 0; unit < UnitsPerPlayer; unit++)
+        {
+            freshGrid.UpdateViewer(unit, GetUnitPosition(player, unit, TickCount), SensorRadius);
+        }
+
+        while (!freshGrid.Update(mapSections, budgetMs))
+        {
+        }
+
+        const std::vector<unsigned char>& texels = grids[player].GetTexels();
+        const std::vector<unsigned char>& freshTexels = freshGrid.GetTexels();
+        for (unsigned int i = 0; i < texels.size(); i++)
+        {
+            // Cells seen earlier stay explored, so only compare what is visible now.
+            if ((texels[i] == VISIBLE) != (freshTexels[i] == VISIBLE))
+            {
+                ++result.mismatchCount;
+            }
+        }
+    }
+
+    return result;
+}
+
+int main()
+{
+    Logger::Setup();
+
+    MapInfo mapInfo;
+    CreateMap(mapInfo);
+
+    MapSections mapSections;
+    mapSections.RecomputeMapSections(mapInfo);
+
+    printf("Visibility: %ux%u map, %u players x %u units, sensor radius %.1f, %u ticks.\n",
+        MapSize, MapSize, PlayerCount, UnitsPerPlayer, SensorRadius, TickCount);
+    printf("%10s %12s %12s %12s %12s %12s %12s\n", "Budget ms", "Average ms", "P99 ms", "Worst ms", "Recomputes", "Backlog", "Mismatches");
+
+    const float budgets[] = { 0.5f, 1.0f, 2.0f };
+    unsigned int mismatchCount = 0;
+    for (float budgetMs : budgets)
+    {
+        RunResult result = RunVisibility(mapSections, budgetMs);
+        printf("%10.1f %12.3f %12.3f %12.3f %12.1f %12u %12u\n", budgetMs, result.averageMs, result.p99Ms, result.worstMs, result.averageRecomputes, result.finalBacklog, result.mismatchCount);
+        mismatchCount += result.mismatchCount;
+    }
+
+    Logger::Shutdown();
+    return mismatchCount == 0 ? 0 : 1;
+}
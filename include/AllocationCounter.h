@@ -0,0 +1,10 @@
+#pragma once
+
+// Counts heap allocations made through operator new, per thread, so code that shouldn't allocate (like per-frame updates) can be checked.
+// The global operator new and delete are replaced in AllocationCounter.cpp to do the counting.
+class AllocationCounter
+{
+public:
+    // Returns the number of allocations the calling thread has made. Take the difference of two calls to count the allocations in between.
+    static unsigned long long GetThreadAllocations();
+};
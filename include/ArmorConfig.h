@@ -2,17 +2,17 @@
 #include <vector>
 #include "ArmorInfo.h"
 #include "ConfigManager.h"
-#include "ModelManager.h"
+#include "ModelLoader.h"
 
 class ArmorConfig : public ConfigManager
 {
-    ModelManager* modelManager;
+    ModelLoader* modelLoader;
 
 	virtual bool LoadConfigValues(std::vector<std::string>& lines);
 	virtual void WriteConfigValues();
 public:
     static std::vector<ArmorType> Armors;
 
-	ArmorConfig(ModelManager* modelManager, const char* configName);
+	ArmorConfig(ModelLoader* modelLoader, const char* configName);
 };
 
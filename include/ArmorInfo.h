@@ -2,6 +2,14 @@
 #include <string>
 #include "Vec.h"
 
+// The types of damage weapons deal. Armor tracks the damage taken from each type separately.
+enum DamageType
+{
+    MACHINE_GUN = 0,
+    ROCKET = 1,
+    CANNON = 2
+};
+
 // Represents a type of armor with graphical settings.
 struct ArmorType
 {
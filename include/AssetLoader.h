@@ -0,0 +1,112 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Identifies a queued asset loading task, used to make later tasks depend on it.
+typedef unsigned int AssetTaskId;
+
+// Function run on any loading thread, given the index of that thread (0 is the GL thread, see GetThreadCount). Returns false on failure.
+typedef std::function<bool(unsigned int threadIndex)> AssetWorkFunction;
+
+// Function run on the GL thread, such as sending decoded data to OpenGL. Returns false on failure.
+typedef std::function<bool()> AssetUploadFunction;
+
+// Loads assets at startup with a pool of worker threads for the CPU work (file reads, image decoding, model parsing)
+//  and a queue of tasks that must run on the GL thread (texture and buffer creation).
+// A task only starts once every task it depends on has completed, and worker tasks start as soon as they are queued,
+//  so they overlap whatever the GL thread does before calling Finish.
+// Time spent is tracked by stage, a name shared by related tasks, so startup can be logged per stage.
+class AssetLoader
+{
+public:
+    AssetLoader();
+    ~AssetLoader();
+
+    // Starts the worker threads. With zero workers, worker tasks run on the GL thread in Finish.
+    void Initialize(unsigned int workerCount);
+
+    // Returns the number of threads that can run worker tasks (the workers and the GL thread), for per-thread scratch data.
+    unsigned int GetThreadCount() const;
+
+    // Queues a task for the worker threads.
+    AssetTaskId AddWorkTask(const char* stage, const AssetWorkFunction& workFunction, const std::vector<AssetTaskId>& dependencies);
+
+    // Queues a task for the GL thread, which is run during Finish.
+    AssetTaskId AddUploadTask(const char* stage, const AssetUploadFunction& uploadFunction, const std::vector<AssetTaskId>& dependencies);
+
+    // Runs the function on the GL thread right away, recording its time under the stage. Returns the function result.
+    bool RunStage(const char* stage, const std::function<bool()>& function);
+
+    // Runs GL thread tasks (and worker tasks, when the workers are busy) until every task has completed, then stops the workers.
+    // Returns false if any task failed, in which case tasks that hadn't started yet are skipped.
+    bool Finish();
+
+    // Stops the worker threads once their current tasks complete, leaving every task that hasn't started unrun. For abandoning loading after a failure.
+    void Cancel();
+
+    // Logs the task count, worker and GL thread time, and completion time of each stage, in the order the stages were first used.
+    void LogStageTimes() const;
+
+private:
+    struct Task
+    {
+        std::string stage;
+        AssetWorkFunction workFunction;
+        AssetUploadFunction uploadFunction;
+        bool isUpload;
+        bool isComplete;
+
+        // Dependencies that haven't completed yet, and tasks that depend on this one.
+        unsigned int remainingDependencies;
+        std::vector<AssetTaskId> dependents;
+    };
+
+    struct StageTime
+    {
+        std::string stage;
+        unsigned int taskCount;
+        double workerMs;
+        double glThreadMs;
+
+        // Time from Initialize until the last task of the stage completed.
+        double completedMs;
+    };
+
+    // Tasks are never removed, and a deque keeps running tasks in place as more are added.
+    std::deque<Task> tasks;
+    std::deque<AssetTaskId> readyWorkTasks;
+    std::deque<AssetTaskId> readyUploadTasks;
+    unsigned int incompleteTasks;
+    bool hasFailed;
+
+    std::vector<StageTime> stageTimes;
+    std::chrono::high_resolution_clock::time_point startTime;
+    unsigned int threadCount;
+
+    std::vector<std::thread> workers;
+    bool isRunning;
+
+    // Guards all of the above, and is waited on by idle threads.
+    mutable std::mutex taskMutex;
+    std::condition_variable taskCondition;
+
+    AssetTaskId AddTask(const char* stage, const AssetWorkFunction& workFunction, const AssetUploadFunction& uploadFunction,
+        bool isUpload, const std::vector<AssetTaskId>& dependencies);
+
+    // Runs the task (unless an earlier task failed) and completes it. Must be called without the lock held.
+    void RunTask(AssetTaskId taskId, unsigned int threadIndex);
+
+    // Marks the task as complete, queueing any dependents that are now ready. Must be called with the lock held.
+    void CompleteTask(AssetTaskId taskId, bool succeeded, double ms, bool onGlThread);
+
+    StageTime& GetStageTime(const std::string& stage);
+    double GetElapsedMs() const;
+    void WorkerLoop(unsigned int threadIndex);
+    void StopWorkers();
+};
@@ -2,17 +2,17 @@
 #include <vector>
 #include "BodyInfo.h"
 #include "ConfigManager.h"
-#include "ModelManager.h"
+#include "ModelLoader.h"
 
 class BodyConfig : public ConfigManager
 {
-    ModelManager* modelManager;
+    ModelLoader* modelLoader;
 
 	virtual bool LoadConfigValues(std::vector<std::string>& lines);
 	virtual void WriteConfigValues();
 public:
     static std::vector<BodyType> Bodies;
 
-	BodyConfig(ModelManager* modelManager, const char* configName);
+	BodyConfig(ModelLoader* modelLoader, const char* configName);
 };
 
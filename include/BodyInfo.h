@@ -15,6 +15,15 @@ struct BodyType
     //   Turret rotations are applied with respect to the unit rotation.
     float scale;
 
+    // Radius of the sphere bounding units with this body, in world units. Used for collisions, avoidance and selection.
+    float radius;
+
+    // How far units with this body can see, in world units.
+    float sensorRadius;
+
+    // How fast units with this body move, in world units per physics tick.
+    float maxSpeed;
+
     // Display name of the body.
     std::string name;
 };
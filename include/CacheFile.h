@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Helpers for files cached from source assets, such as baked meshes and compressed textures.
+// Cached files are named after their source file and hold a hash of its contents, so they are rebuilt when the source changes.
+class CacheFile
+{
+public:
+    // Returns a 64-bit hash of the data, FNV-1a taken a word at a time.
+    static unsigned long long HashContents(const char* data, size_t length);
+
+    // Returns the path of a file cached from the source file, named after the source file path with the given extension in place of its own.
+    static std::string GetCacheFilePath(const std::string& cacheDirectory, const char* sourceFilename, const char* cacheExtension);
+
+    // Creates the directory and any missing parent directories.
+    static bool CreateDirectories(const std::string& directory);
+
+    // Writes the header followed by the data to the file, replacing any existing one. Returns false if it couldn't be written.
+    // The file is written to a temporary file first, so an interrupted write never leaves a partial cached file behind.
+    static bool Write(const std::string& path, const void* header, size_t headerSize, const void* data, size_t dataSize);
+};
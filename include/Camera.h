@@ -0,0 +1,52 @@
+#pragma once
+#include "Vec.h"
+
+// Holds the view and projection of the viewer, along with the matrices derived from them.
+// The derived matrices (including the inverse projection used for picking) are only recomputed when requested after the view or projection changed.
+// Not thread-safe: the physics thread owns its camera and sends the view matrix to the GUI thread through the SyncBuffer.
+class Camera
+{
+public:
+    Camera();
+
+    // Sets the perspective projection, with the field of view in degrees.
+    void SetPerspective(float fovY, float aspect, float nearPlane, float farPlane);
+
+    // Sets where the viewer is and how it is rotated. Does nothing if neither changed.
+    void SetView(const vec::vec3& position, const vec::quaternion& orientation);
+
+    const vec::vec3& GetPosition() const;
+    const vec::mat4& GetProjectionMatrix() const;
+
+    // The view matrix, rotation * translation, and the rotation part on its own.
+    const vec::mat4& GetViewMatrix();
+    const vec::mat4& GetViewRotationMatrix();
+
+    const vec::mat4& GetInverseProjectionMatrix();
+    const vec::mat4& GetViewProjectionMatrix();
+
+    // Computes the normalized world-space direction of the ray from the viewer through the given window position.
+    // Matches PhysicsOps::ScreenRay, without inverting the projection matrix for every ray.
+    vec::vec3 ScreenRay(const vec::vec2& screenPosition, const vec::vec2& screenSize);
+
+    // Fills in rays[i] = ScreenRay(screenPositions[i], screenSize) for each of the count positions.
+    void ScreenRays(const vec::vec2* screenPositions, vec::vec3* rays, unsigned int count, const vec::vec2& screenSize);
+
+private:
+    vec::vec3 position;
+    vec::quaternion orientation;
+    vec::mat4 projectionMatrix;
+
+    vec::mat4 viewMatrix;
+    vec::mat4 viewRotationMatrix;
+    vec::mat4 inverseProjectionMatrix;
+    vec::mat4 viewProjectionMatrix;
+
+    // Set when the view or projection changed after the derived matrices were last computed.
+    bool viewDirty;
+    bool inverseProjectionDirty;
+    bool viewProjectionDirty;
+
+    void UpdateView();
+    vec::vec3 ComputeScreenRay(const vec::vec2& screenPosition, const vec::vec2& screenSize) const;
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <vector>
+#include "ArmorInfo.h"
+#include "ProjectilePool.h"
+
+// A hit on a unit, waiting for combat resolution.
+struct CombatHit
+{
+    unsigned int playerId;
+    unsigned int unitId;
+
+    // Order the hit was added in, so hits on a unit are always applied in the same order.
+    unsigned int sequence;
+
+    unsigned int firingPlayerId;
+    DamageType damageType;
+    float damage;
+};
+
+// A unit destroyed during combat resolution.
+struct UnitDeath
+{
+    unsigned int playerId;
+    unsigned int unitId;
+
+    // The player that fired the hit that destroyed the unit.
+    unsigned int killingPlayerId;
+};
+
+// Resolves the hits of a physics tick against unit armor in one pass. VALID FOR PHYSICS THREAD ONLY
+// Hits are collected into a flat buffer and sorted by target, so each unit's armor is loaded once and all its hits are applied together.
+class CombatResolver
+{
+public:
+    CombatResolver();
+
+    // Reserves storage for the given number of hits per tick.
+    void Initialize(unsigned int capacity);
+
+    // Removes all hits, keeping the allocated storage.
+    void Clear();
+
+    // Adds a hit on a unit.
+    void AddHit(unsigned int playerId, unsigned int unitId, unsigned int firingPlayerId, DamageType damageType, float damage);
+
+    // Adds the projectile hits that hit units.
+    void AddHits(const std::vector<ProjectileHit>& projectileHits);
+
+    // Sorts the hits by target unit, keeping the order hits were added in for each unit.
+    void SortHits();
+
+    // Calls the apply function once for each unit hit, with all of that unit's hits. Hits must be sorted.
+    // The function takes (playerId, unitId, hits, hitCount).
+    template <typename T>
+    void ForEachTarget(T& applyFunction) const;
+
+    unsigned int GetHitCount() const;
+
+    // Applies hits to armor, in order. Returns true (and fills in the index of the hit that destroyed the armor) if the armor was destroyed, false otherwise.
+    // Damage of a type that has maxed out is multiplied by that type's penalty and spread evenly (as a fraction of each maximum)
+    //  over the types that haven't maxed out. Armor is destroyed once every type has maxed out, and later hits are ignored.
+    static bool ApplyHits(Armor& armor, const ArmorType& armorType, const CombatHit* hits, unsigned int hitCount, unsigned int* destroyingHit);
+
+private:
+    std::vector<CombatHit> hits;
+};
+
+template <typename T>
+void CombatResolver::ForEachTarget(T& applyFunction) const
+{
+    unsigned int targetStart = 0;
+    while (targetStart < hits.size())
+    {
+        unsigned int targetEnd = targetStart + 1;
+        while (targetEnd < hits.size() && hits[targetEnd].playerId == hits[targetStart].playerId && hits[targetEnd].unitId == hits[targetStart].unitId)
+        {
+            ++targetEnd;
+        }
+
+        applyFunction(hits[targetStart].playerId, hits[targetStart].unitId, &hits[targetStart], targetEnd - targetStart);
+        targetStart = targetEnd;
+    }
+}
@@ -12,7 +12,7 @@ public:
         BAD_IMAGES = 3, BAD_SOUND = 4, BAD_MUSIC = 5,
         BAD_CONFIG = 6, BAD_GLEW = 7, BAD_STATS = 8, BAD_VOXEL_MAP = 9,
         BAD_MAP = 10, BAD_UI = 11, BAD_SCENERY = 12, BAD_ROUTER = 13,
-        BAD_THEME = 14 };
+        BAD_THEME = 14, BAD_PICKING = 15, BAD_ASSETS = 16 };
 
     // Graphics viewport settings
     static float FOV_Y;
@@ -23,5 +23,8 @@ public:
 
     // To support 144 Hz monitors.
     const static int MAX_FRAMERATE = 150;
+
+    // Pixels the mouse must move while held down for a click to become a drag-box selection.
+    const static int DRAG_SELECT_THRESHOLD = 5;
 };
 
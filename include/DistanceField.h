@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+
+// Generates signed distance fields from coverage bitmaps, such as glyphs rasterized by stb_truetype, with an exact Euclidean distance transform.
+// Distance fields can be scaled up and still give sharp edges, as the edge is found again from the interpolated distance when drawn.
+class DistanceField
+{
+public:
+    // Converts a coverage bitmap (128 and up is inside) rendered at `supersampling` times the field resolution into a signed distance field.
+    // Field texel (x, y) covers coverage pixels [x * supersampling, (x + 1) * supersampling), so the bitmap is fieldWidth * supersampling pixels wide (likewise high).
+    // The field is 128 on the edge, increasing inside, and reaches 0 or 255 `spread` texels away from the edge.
+    void Generate(const unsigned char* coverage, int fieldWidth, int fieldHeight, int supersampling, float spread, unsigned char* field);
+
+private:
+    // Squared distances from each coverage pixel to the nearest inside pixel, and to the nearest outside pixel, first within its column and then overall.
+    std::vector<float> distancesToInside;
+    std::vector<float> distancesToOutside;
+    std::vector<float> rowDistancesToInside;
+    std::vector<float> rowDistancesToOutside;
+    std::vector<float> texelDistances;
+
+    // Scratch space for the row transform, kept between glyphs.
+    std::vector<int> parabolaPositions;
+    std::vector<float> parabolaBounds;
+
+    // Fills in the squared distance from each pixel to the nearest inside (or outside) pixel in the same column.
+    void FindColumnDistances(const unsigned char* coverage, int width, int height, bool isInsideFeature, std::vector<float>& squaredDistances);
+
+    // Turns the column distances of a row into overall distances, from the lower envelope of the parabolas rooted at each pixel (Felzenszwalb and Huttenlocher).
+    void TransformRow(const float* columnDistances, int width, float* squaredDistances);
+};
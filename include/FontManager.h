@@ -1,13 +1,15 @@
 #pragma once
 #include <map>
 #include <string>
+#include <vector>
 #include <GL/glew.h>
 #include <stb/stb_truetype.h>
 #include <stb/stb_image.h>
 #include <stb/stb_image_write.h>
+#include "DistanceField.h"
+#include "GlyphAtlas.h"
 #include "ShaderManager.h"
 #include "TextInfo.h"
-#include "Vertex.h"
 #include "Vec.h"
 
 // Manages the in-game font. *Note that this only supports a single font.*
@@ -16,19 +18,49 @@ class FontManager
     // Maps characters to the TextInfo representing each character,
     std::map<int, TextInfo> fontData;
 
-    // Holds the font texture that is filled as necessary. This is bound to GL_TEXTURE0 for now, but probably should have it's own binding point.
-    GLuint fontTexture;
-    int width;
-    int height;
-
-    int usedWidth;
-    int usedHeight;
-    int lastMaxHeight;
+    // Holds the font texture pages that are filled as necessary. These are bound to GL_TEXTURE0 for now, but probably should have their own binding point.
+    GlyphAtlas glyphAtlas;
 
     // Holds our font shader information.
     GLuint fontShader;
-    GLint projLocation, mvLocation;
+    GLint projLocation;
 	GLint fontImageLocation;
+    GLint isDistanceFieldLocation;
+
+    // With distance field text, each character is rendered once, at this pixel height, and scaled to every size it is drawn at.
+    // The field extends this many texels beyond the character, and is found from a bitmap rendered at this many times the resolution.
+    static const int DISTANCE_FIELD_PIXEL_HEIGHT = 48;
+    static const int DISTANCE_FIELD_SPREAD = 6;
+    static const int DISTANCE_FIELD_SUPERSAMPLING = 4;
+
+    // Set from the graphics config when the font is loaded, as characters of both kinds can't share the glyph atlas.
+    bool isDistanceFieldText;
+    DistanceField distanceField;
+    std::vector<unsigned char> supersampledCharacter;
+
+    // Quads are indexed with 16-bit indices, so a single draw holds at most this many.
+    static const int MAX_QUADS_PER_DRAW = 65536 / 4;
+
+    // Every sentence rendered in a frame is drawn from one streaming vertex buffer, with a quad index buffer shared by all draws.
+    GLuint textVao;
+    GLuint vertexBuffer;
+    GLuint indexBuffer;
+    GLsizeiptr vertexBufferSize;
+    int indexedQuadCount;
+
+    // Sentences queued with RenderSentence, drawn by RenderSentences.
+    struct QueuedSentence
+    {
+        int sentenceId;
+        vec::mat4 mvMatrix;
+    };
+
+    std::vector<QueuedSentence> queuedSentences;
+
+    // The queued quads, transformed and grouped by glyph atlas page. Kept between frames so batching doesn't allocate.
+    std::vector<TextVertex> batchVertices;
+    std::vector<int> pageQuadCounts;
+    std::vector<int> pageFirstQuads;
 
     // Holds STB font info for loading in new font data as necessary
     stbtt_fontinfo fontInfo;
@@ -36,22 +68,40 @@ class FontManager
 
     const int verticesPerChar = 4;
     void AddToFontTexture(CharInfo& charInfo);
+    void RenderDistanceField(int character, CharInfo& charInfo);
     CharInfo& GetCharacterInfo(int fontPixelHeight, int character);
 
     // Sentence information
     int nextSentenceId;
     std::map<int, SentenceInfo> sentences;
 
+    // Where each character of the sentence being laid out starts, kept between layouts so they don't allocate.
+    std::vector<float> characterXPositions;
+
     int GetSentenceVertexCount(const std::string& sentence);
-    universalVertices AllocateSentenceVertices(const std::string& sentence, int pixelHeight, vec::vec3 textColor);
+    void LayoutSentence(SentenceInfo& sentenceInfo);
+
+    // Grows the quad index buffer to hold at least the given number of quads.
+    void IndexQuads(int quadCount);
 
 public:
     FontManager();
     bool LoadFont(ShaderManager* shaderManager, const char *fontName);
 
     int CreateNewSentence();
+
+    // Updates the sentence text, which is only laid out again if the text, height or color changed.
     void UpdateSentence(int sentenceId, const std::string& sentence, int pixelHeight, vec::vec3 textColor);
-    void RenderSentence(int sentenceId, vec::mat4& perpective, vec::mat4& mvMatrix);
+    void UpdateSentence(int sentenceId, const char* sentence, int pixelHeight, vec::vec3 textColor);
+
+    // Queues the sentence to be drawn by the next RenderSentences call.
+    void RenderSentence(int sentenceId, vec::mat4& mvMatrix);
+
+    // Draws every queued sentence, with one draw call per glyph atlas page used.
+    void RenderSentences(vec::mat4& perspective);
+
+    // Logs how much of the glyph atlas is in use.
+    void LogAtlasUsage() const;
 
     ~FontManager();
 };
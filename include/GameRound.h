@@ -1,10 +1,18 @@
 #pragma once
 #include <vector>
+#include "CombatResolver.h"
+#include "JobSystem.h"
+#include "LocalAvoidance.h"
 #include "MapInfo.h"
+#include "MapSections.h"
 #include "Player.h"
+#include "ProjectilePool.h"
+#include "SpatialHash.h"
+#include "TurretTargeting.h"
 
 // Holds the subset of information required for a game round.
 //  This is data that is heavily updated in the phyics thread and constantly displayed with the GUI. 
+// The per-tick updates don't lock anything, so the SyncBuffer locks the round around them. Without graphics, they can be called directly.
 class GameRound
 {
 public:
@@ -15,4 +23,22 @@ public:
 
     // Current map in the round.
     MapInfo map;
-};
\ No newline at end of file
+
+    // Updates the players, spreading the per-player and per-unit work across the job system.
+    // Units follow their routes while avoiding each other, staying on travellable voxels of the map sections.
+    // Afterwards, the unit spatial hash holds the new unit positions.
+    void UpdatePlayers(JobSystem& jobSystem, SpatialHash& unitHash, LocalAvoidance& localAvoidance, const MapSections& mapSections, float lastElapsedTime);
+
+    // Clears what every player has seen, sizing their visibility grids to the map.
+    void ResetVisibility(const MapSections& mapSections);
+
+    // Updates what each player can see in parallel, spending at most the given time (in milliseconds) per player on units that moved.
+    void UpdateVisibility(JobSystem& jobSystem, const MapSections& mapSections, float budgetMs);
+
+    // Aims unit turrets at enemy units, then fires the turrets that are ready into the projectile pool.
+    // Turrets are aimed in parallel, but fired serially as the projectile pool isn't thread-safe.
+    void UpdateTurrets(JobSystem& jobSystem, TurretTargeting& turretTargeting, const MapSections& mapSections, const SpatialHash& unitHash, ProjectilePool& projectilePool);
+
+    // Applies the combat hits of a physics tick to the units hit, adding the units destroyed to the death list.
+    void ResolveCombat(CombatResolver& combatResolver, std::vector<UnitDeath>& unitDeaths);
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <vector>
+#include <GL\glew.h>
+
+// Where a glyph was placed in the GlyphAtlas.
+struct GlyphLocation
+{
+    int page;
+    int x;
+    int y;
+
+    // The page generation the glyph was placed in. The glyph is gone once its page has been evicted, which starts a new generation.
+    unsigned int generation;
+};
+
+// Packs 8-bit glyph bitmaps into pages of single-channel (R8) textures, placing each glyph with a skyline (bottom-left) allocator.
+// New pages are added as pages fill up, and once the maximum page count is reached, the least-recently used page is evicted.
+// Glyphs are copied into a CPU copy of their page, and only sent to OpenGL by UploadChanges, once per changed page.
+class GlyphAtlas
+{
+public:
+    GlyphAtlas();
+
+    // Sets the size (width and height) of each page, and the maximum number of pages.
+    // Distance field glyphs need linear filtering, while bitmap glyphs keep the default (nearest when minified).
+    void Initialize(int pageSize, int maxPages, bool isLinearFiltered);
+
+    // Adds the glyph bitmap to the atlas, evicting a page if every page is full, and filling in where it was placed.
+    // Returns false if the glyph is larger than a page.
+    bool AddGlyph(const unsigned char* bitmap, int width, int height, GlyphLocation* location);
+
+    // Returns true if the glyph is still in the atlas, marking its page as used. False if the page was evicted since the glyph was added.
+    bool UseGlyph(const GlyphLocation& location);
+
+    // Marks the page as used, so it is evicted after pages that were used longer ago.
+    void UsePage(int page);
+
+    // Sends the glyphs added since the last call to OpenGL, with one texture update per changed page.
+    void UploadChanges();
+
+    int GetPageSize() const;
+    int GetPageCount() const;
+    GLuint GetPageTexture(int page) const;
+
+    // Returns how many pages have been evicted. Anything laid out with glyphs from an evicted page has to be laid out again.
+    unsigned int GetEvictionCount() const;
+
+    // Returns the fraction of the allocated pages covered by glyphs (including their padding), from 0 to 1.
+    float GetOccupancy() const;
+
+    // Logs the page count, occupancy, and evictions.
+    void LogUsage() const;
+
+    ~GlyphAtlas();
+
+private:
+    // The top of the packed glyphs from x to x + width.
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    struct Page
+    {
+        GLuint texture;
+        std::vector<unsigned char> pixels;
+        std::vector<SkylineNode> skyline;
+        int usedArea;
+        unsigned int lastUse;
+        unsigned int generation;
+
+        // The area changed since the last upload. Empty if the max is not past the min.
+        int dirtyMinX;
+        int dirtyMinY;
+        int dirtyMaxX;
+        int dirtyMaxY;
+    };
+
+    int pageSize;
+    int maxPages;
+    bool isLinearFiltered;
+    std::vector<Page> pages;
+    unsigned int useClock;
+    unsigned int evictionCount;
+
+    // Glyphs are padded, so texture filtering doesn't blend in their neighbors.
+    static const int GLYPH_PADDING = 1;
+
+    void AddPage();
+
+    // Clears the page, dropping all of its glyphs.
+    void ClearPage(Page& page);
+    void EvictPage(int page);
+
+    // Finds the lowest spot on the page the rectangle fits in, reserving it and filling in its position. Returns false if the page has no room for it.
+    bool Allocate(Page& page, int width, int height, int* x, int* y);
+
+    // Returns the y position the rectangle would sit at when its left edge is at the start of the skyline node, or -1 if it doesn't fit there.
+    int GetFitHeight(const Page& page, unsigned int nodeIndex, int width, int height) const;
+
+    // Raises the skyline over the newly-placed rectangle.
+    void AddSkylineLevel(Page& page, unsigned int nodeIndex, int x, int y, int width, int height);
+};
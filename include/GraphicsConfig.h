@@ -11,9 +11,20 @@ public:
 	static int ScreenHeight;
 
 	static int TextImageSize;
+	static int TextImagePages;
+
+	// Renders text from distance fields of one size of each character, instead of a bitmap for every character size.
+	static bool DistanceFieldText;
 
 	static int VoxelTypes;
-	static int VoxelsPerRow;
+
+	static bool HoverPicking;
+
+	// Stores model positions as normalized shorts and UVs as half-floats, instead of floats.
+	static bool PackedModelVertices;
+
+	// Stores textures loaded by the ImageManager compressed (BPTC, or S3TC on older GPUs), when the GPU supports it.
+	static bool CompressTextures;
 
 	GraphicsConfig(const char* configName);
 };
@@ -1,34 +1,67 @@
 #pragma once
 
 #include <map>
+#include <string>
 #include <stb\stb_image.h>
 #include <GL\glew.h>
 #include "ImageTexture.h"
 
 // Holds *all* of the texture images and communicates using 'stb_image'.
 // Note that this only supports PNG images, which can be changed by modifying stb_implementations.cpp
+// Textures are mipmapped, and with CompressTextures (see GraphicsConfig) compressed by the driver the first time they are loaded.
+//  Compressed textures are cached next to the baked meshes, so later loads skip decoding and compressing the image.
 class ImageManager
 {
     std::map<GLuint, ImageTexture> imageTextures;
+    size_t textureMemory;
 
-    // Sends the texture data to OpenGL, creating the texture and sending back that id.
-    GLuint CreateTexture(int width, int height, unsigned char* imageData);
+    // Sends the image to OpenGL as a mipmapped RGBA texture, returning the size of the texture.
+    static size_t SendImage(const DecodedImage& image);
+
+    // Sends the image to OpenGL, having the driver compress each mipmap level, and caches the compressed texture. Returns the size of the texture.
+    static size_t CompressImage(DecodedImage& image, GLenum compressedFormat);
+
+    // Sends the compressed mipmap levels of the image to OpenGL, returning the size of the texture.
+    static size_t SendCompressedImage(const DecodedImage& image);
+
+    // Reads the cached compressed texture of the image, returning false if it doesn't exist, is corrupt, or doesn't match the image file or format.
+    static bool ReadCompressedImage(GLenum compressedFormat, DecodedImage* image);
+
+    // Writes the compressed mipmap levels of the image to its cache path, replacing any existing file. Returns false if it couldn't be written.
+    static bool WriteCompressedImage(const DecodedImage& image);
+
+    // Logs an error if decoding the image failed, returning true if it succeeded.
+    static bool CheckDecodedImage(const char* filename, const DecodedImage& image);
 
 public:
     ImageManager();
-    GLuint AddImage(const char* filename);
+
+    // Adds an image to the list of tracked images, returning the texture ID of that image (0 on failure).
+    // The image data is freed once sent to OpenGL, unless it is kept for use with GetImage.
+    GLuint AddImage(const char* filename, bool keepImageData);
+
+    // Decodes the image file without touching OpenGL or the tracked images, so it can be called from any thread. Returns false on failure.
+    static bool DecodeImage(const char* filename, DecodedImage* image);
+
+    // Like DecodeImage, but reads the compressed texture from the cache instead when textures are compressed and the cache is up-to-date.
+    static bool ReadImage(const char* filename, DecodedImage* image);
+
+    // Frees the data of a decoded image that wasn't added to the tracked images.
+    static void FreeDecodedImage(DecodedImage* image);
+
+    // Adds a decoded image to the list of tracked images (which takes ownership of the image data), returning the texture ID of that image.
+    // The image data is freed once sent to OpenGL, unless it is kept, which needs an image from DecodeImage.
+    GLuint AddDecodedImage(DecodedImage& image, bool keepImageData);
     const ImageTexture& GetImage(GLuint textureId);
 
-    // Loads an empty image (RGB-pattern). NOTE: Requires a call to ResendToOpenGL to be visible after data changes!
-    GLuint LoadEmpty(int width, int height);
+    // Returns the compressed format textures are stored in, or 0 if they are stored uncompressed.
+    static GLenum GetCompressedFormat();
 
-    // Copies the source image into the destination image, writing it at the given x and y positions.
-    //  WARNING: Has no out-of-bounds prevention, only supports source moves that fully fit in the destination. (TODO fix this, return false).
-    void CopyToImage(GLuint srcImage, GLuint dstImage, int dstX, int dstY);
+    // Returns the number of mipmap levels for a full mip chain of the given size.
+    static int GetMipmapLevels(int width, int height);
 
-    // Resends data to OpenGL. Only useful when image data has changed.
-    void ResendToOpenGl(GLuint imageId);
+    // Returns the total size of the tracked textures on the GPU.
+    size_t GetTextureMemory() const;
 
     ~ImageManager();
 };
-
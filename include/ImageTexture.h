@@ -1,7 +1,9 @@
 #pragma once
+#include <string>
+#include <vector>
 #include <GL\glew.h>
 
-// Holds a pointer to image texture data in GL_RGBA32F fomat.
+// Holds a sent-to-OpenGL texture, along with its image data (in RGBA format) if that was kept.
 struct ImageTexture
 {
     GLuint textureId;
@@ -9,18 +11,58 @@ struct ImageTexture
     int width;
     int height;
 
-    // Image data as loaded in.
+    // Image data as loaded in, or nullptr if it was freed once sent to OpenGL.
     unsigned char* imageData;
 
-    // True if loaded from STB (file), false otherwise.
-    bool loadedFromStb;
+    // Size of the texture on the GPU, including all of its mipmap levels.
+    size_t textureBytes;
 
     ImageTexture()
     {
     }
 
-    ImageTexture(GLuint textureId, unsigned char* imageData, int width, int height)
-        : textureId(textureId), width(width), height(height), imageData(imageData), loadedFromStb(true)
+    ImageTexture(GLuint textureId, unsigned char* imageData, int width, int height, size_t textureBytes)
+        : textureId(textureId), width(width), height(height), imageData(imageData), textureBytes(textureBytes)
     {
     }
 };
+
+// RGBA image data decoded by 'stb_image', which hasn't been sent to OpenGL yet.
+// Images read from the compressed texture cache have their compressed mipmap levels instead of image data.
+struct DecodedImage
+{
+    int width;
+    int height;
+    unsigned char* imageData;
+
+    GLenum compressedFormat;
+    std::vector<unsigned char> compressedData;
+    std::vector<unsigned int> compressedLevelSizes;
+
+    // Where the compressed texture is cached, and the hash of the image file it is compressed from. The path is empty if it isn't cached.
+    std::string cachePath;
+    unsigned long long sourceHash;
+
+    DecodedImage()
+        : width(0), height(0), imageData(nullptr), compressedFormat(0), sourceHash(0)
+    {
+    }
+};
+
+// Start of every compressed texture (.tftex) file, followed by the compressed mipmap levels, largest first.
+struct CompressedImageHeader
+{
+    static const unsigned int MAX_LEVELS = 16;
+
+    char magic[4];
+    unsigned int version;
+
+    // Hash of the image file the texture was compressed from. The texture is compressed again if the image file no longer matches.
+    unsigned long long sourceHash;
+
+    GLenum format;
+    int width;
+    int height;
+    unsigned int levelCount;
+    unsigned int levelSizes[MAX_LEVELS];
+};
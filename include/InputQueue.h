@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include "SharedExclusiveLock.h"
+
+// Input from the GUI thread to be processed by the physics thread.
+// Positions are window coordinates, with the window size at the time of the input.
+struct InputEvent
+{
+    enum Type
+    {
+        LEFT_CLICK = 0,
+        DRAG_SELECT = 1
+    };
+
+    Type type;
+
+    // Click position, or the corner where the drag started.
+    int x;
+    int y;
+
+    // Corner where the drag ended. Unused for clicks.
+    int endX;
+    int endY;
+
+    int xSize;
+    int ySize;
+};
+
+// Thread-safe queue of input events, written by the GUI thread and drained by the physics thread.
+class InputQueue
+{
+public:
+    InputQueue();
+
+    // Adds an event to the end of the queue.
+    void QueueEvent(const InputEvent& inputEvent);
+
+    // Replaces the contents of events with all queued events (in order) and empties the queue.
+    void TakeEvents(std::vector<InputEvent>& events);
+
+private:
+    SharedExclusiveLock queueMutex;
+    std::vector<InputEvent> queuedEvents;
+};
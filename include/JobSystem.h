@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Function run over the [startIndex, endIndex) portion of a parallel-for range.
+typedef std::function<void(unsigned int startIndex, unsigned int endIndex)> RangeFunction;
+
+// Small work-stealing job system with a fixed pool of worker threads.
+// Each worker owns a deque of jobs. Workers pop from the back of their own deque and steal from the front of other deques when idle.
+// Parallel-for results are deterministic regardless of the thread count as long as each index only writes state owned by that index.
+class JobSystem
+{
+public:
+    JobSystem();
+    ~JobSystem();
+
+    // Starts the worker threads. With zero workers, all parallel-for loops run on the calling thread.
+    void Initialize(unsigned int workerCount);
+
+    // Stops and joins all worker threads.
+    void Shutdown();
+
+    // Returns the number of threads that participate in a parallel-for (the workers and the calling thread).
+    unsigned int GetThreadCount() const;
+
+    // Returns the index of the calling thread, below GetThreadCount. Workers are numbered from 1, and any other thread is 0.
+    // Lets parallel-for functions keep per-thread storage across calls, as a thread only runs one chunk of a range at a time.
+    unsigned int GetCurrentThreadIndex() const;
+
+    // Runs the function over [startIndex, endIndex), split into chunks of at most grainSize indices.
+    // The calling thread runs jobs too and returns once every chunk has completed. Parallel-for calls may be nested.
+    void ParallelFor(unsigned int startIndex, unsigned int endIndex, unsigned int grainSize, const RangeFunction& rangeFunction);
+
+    // Returns the default worker count for this machine, leaving one core for the calling thread.
+    static unsigned int DefaultWorkerCount();
+
+private:
+    // A chunk of a parallel-for range.
+    struct Job
+    {
+        const RangeFunction* rangeFunction;
+        unsigned int startIndex;
+        unsigned int endIndex;
+        std::atomic<unsigned int>* remainingJobs;
+    };
+
+    // Jobs owned by a single thread. Queue 0 is shared by all threads that are not workers.
+    struct JobQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<JobQueue>> jobQueues;
+    std::vector<std::thread> workers;
+
+    // Idle workers sleep until jobs are queued.
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<unsigned int> queuedJobs;
+    std::atomic<bool> isRunning;
+
+    unsigned int GetCurrentQueueIndex() const;
+    bool TryPopJob(unsigned int queueIndex, Job* job);
+    bool TryStealJob(unsigned int queueIndex, Job* job);
+    bool TryRunJob(unsigned int queueIndex);
+    void WorkerLoop(unsigned int queueIndex);
+};
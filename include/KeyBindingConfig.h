@@ -18,6 +18,10 @@ class KeyBindingConfig : public ConfigManager
         static sf::Keyboard::Key ToggleBuildingsWindow;
     protected:
     private:
+        // Keys are stored as their SFML key codes. Only the GUI reads keys, so they aren't part of ConfigManager.
+        bool ReadKey(std::vector<std::string>& configFileLines, sf::Keyboard::Key& key, const char* errorMessage);
+        void WriteKey(const char* itemName, sf::Keyboard::Key& key);
+
         virtual bool LoadConfigValues(std::vector<std::string>& lines);
         virtual void WriteConfigValues();
 };
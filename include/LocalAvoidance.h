@@ -0,0 +1,99 @@
+#pragma once
+#include <vector>
+#include "JobSystem.h"
+#include "Vec.h"
+
+// A unit taking part in local avoidance. Velocities are in world units per physics tick, in the XY plane.
+struct AvoidanceAgent
+{
+    vec::vec2 position;
+
+    // Height of the unit, so neighbors are found on the same level of the map.
+    float height;
+
+    // The velocity the unit moved with last tick, and the velocity it would like to move with to follow its route.
+    vec::vec2 velocity;
+    vec::vec2 preferredVelocity;
+
+    // Agents without a radius, such as destroyed units, are left out of avoidance. Other agents don't avoid them, and they keep their preferred velocity.
+    float radius;
+    float maxSpeed;
+
+    // Output of the avoidance stage: the collision-free velocity closest to the preferred velocity.
+    vec::vec2 avoidanceVelocity;
+};
+
+// Unit-to-unit local avoidance using optimal reciprocal collision avoidance (ORCA).
+// Each unit takes half the responsibility for avoiding each neighbor, so units pass by each other without oscillating.
+// Neighbors come from a grid of the agents rebuilt every tick and are capped per unit, which keeps the cost per tick fixed per unit.
+class LocalAvoidance
+{
+public:
+    // The most neighbors considered per unit. The closest neighbors are used.
+    static const unsigned int MaxNeighbors = 10;
+
+    // How far out to look for neighbors, in world units.
+    static float NeighborRadius;
+
+    // How many ticks ahead collisions are avoided.
+    static float TimeHorizon;
+
+    // Extra clearance units try to keep, as a fraction of their combined radius.
+    // Crowds too dense for every unit to avoid every neighbor give up some of this clearance before units overlap.
+    static float SeparationMargin;
+
+    LocalAvoidance();
+
+    // Removes all agents, keeping the allocated storage.
+    void Clear();
+
+    // Adds agents for each of a player's units, returning the first. Valid until the next call.
+    // Players must be added in ID order, and agents are indexed by unit ID.
+    AvoidanceAgent* AddPlayerAgents(unsigned int playerId, unsigned int unitCount);
+
+    // Returns the agent for a player's unit.
+    const AvoidanceAgent& GetAgent(unsigned int playerId, unsigned int unitId) const;
+
+    // Computes the avoidance velocity of every agent.
+    // Agents are processed in parallel. Each agent only writes its own output, so results don't depend on the thread count.
+    void ComputeAvoidanceVelocities(JobSystem& jobSystem);
+
+    // Computes the avoidance velocity for an agent given its neighbors.
+    static vec::vec2 ComputeAvoidanceVelocity(const AvoidanceAgent& agent, const AvoidanceAgent* const* neighbors, unsigned int neighborCount);
+
+private:
+    // Line bounding the allowed velocities, which are to the left of the direction.
+    struct OrcaLine
+    {
+        vec::vec2 point;
+        vec::vec2 direction;
+    };
+
+    std::vector<AvoidanceAgent> agents;
+    std::vector<unsigned int> playerOffsets;
+
+    // Grid over the area the agents cover, rebuilt every tick. Agents are counting sorted by cell, so the cells in a row of a query are a single range.
+    float gridCellSize;
+    vec::vec2i gridMinCell;
+    vec::vec2i gridSize;
+    std::vector<unsigned int> cellStarts;
+    std::vector<unsigned int> cellAgents;
+
+    // Neighbors found within range of an agent, per job system thread, kept across ticks so neighbor searches don't allocate.
+    std::vector<std::vector<std::pair<float, const AvoidanceAgent*>>> threadNeighborDistances;
+
+    // Returns the grid cell containing the position, which may be outside of the grid.
+    vec::vec2i GetCell(const vec::vec2& position) const;
+
+    // Sorts the agents into the grid.
+    void BuildAgentGrid();
+
+    // Finds the closest neighbors of an agent, returning how many were found.
+    unsigned int FindNeighbors(unsigned int agentIndex, std::vector<std::pair<float, const AvoidanceAgent*>>& neighborDistances,
+        const AvoidanceAgent** neighbors) const;
+
+    // Linear programs that find the velocity closest to the preferred velocity satisfying the ORCA lines, within the maximum speed.
+    static bool SolveOnLine(const OrcaLine* lines, unsigned int lineNumber, float radius, const vec::vec2& optimizationVelocity, bool directionOptimal, vec::vec2& result);
+    static unsigned int SolveWithinLines(const OrcaLine* lines, unsigned int lineCount, float radius, const vec::vec2& optimizationVelocity, bool directionOptimal, vec::vec2& result);
+    static void SolveLeastPenetration(const OrcaLine* lines, unsigned int lineCount, unsigned int failedLine, float radius, vec::vec2& result);
+};
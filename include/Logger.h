@@ -2,11 +2,11 @@
 #include <string>
 #include <sstream>
 #include <fstream>
-#include <SFML\System.hpp>
+#include <mutex>
 #include "Constants.h"
 
 // A simple class for logging program events out to a file.
-class Logger : sf::NonCopyable
+class Logger
 {
 public:
     enum LogType { INFO, WARN, ERR };
@@ -14,6 +14,8 @@ public:
 
     // Creates and logs the startup text
     Logger(const char* fileName);
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
 
     // Various convenient logging methods.
     template<typename T>
@@ -70,7 +72,7 @@ public:
 
 private:
     std::ofstream logFile;
-    sf::Mutex writeLock;
+    std::mutex writeLock;
 
     // Recursion finale.
     template<typename T>
@@ -1,6 +1,8 @@
 #pragma once
+#include <vector>
 #include "MapInfo.h"
 #include "PhysicsOps.h"
+#include "SurfaceHeightfield.h"
 #include "VoxelRoute.h"
 
 // Simplifies usages of the subsection map.
@@ -15,18 +17,52 @@ class MapSections
         // Recomputes the map sections to use for routing.
         void RecomputeMapSections(const MapInfo& mapInfo);
 
+        // Updates the solid voxels, column heights and surface of the columns from (minX, minY) to (maxX, maxY) inclusive, after the voxels within them were edited.
+        // The routing sections aren't updated, so edits that change where units can travel still need RecomputeMapSections.
+        void UpdateColumns(const MapInfo& mapInfo, int minX, int minY, int maxX, int maxY);
+
         // Computes a route between two points using the map sections. Returns true (and fills in the path) if a path was found, false otherwise.
         bool ComputeRoute(const vec::vec3i start, const vec::vec3i destination, std::vector<vec::vec3i>& path);
 
         // Accessor for the subsections.
         const voxelSubsectionsMap& GetSubsections() const;
 
+        // Returns true if there is a travellable voxel under a unit at the given position (and fills in the voxelId), false otherwise.
+        bool GetVoxelUnderPosition(const vec::vec3& position, vec::vec3i* voxelId) const;
+
+        // Returns true if a unit can move directly between the two positions, false otherwise.
+        // Units can only move to the voxel they are on or to its neighbors, as determined by the VoxelRouteRules.
+        bool CanTraverse(const vec::vec3& start, const vec::vec3& end) const;
+
+        // Returns true if the segment passes through a non-air voxel (and fills in how far along the segment the hit is, from 0 to 1), false otherwise.
+        // Slanted voxels are treated as full cubes. Safe to call from multiple threads.
+        bool TraceSegment(const vec::vec3& start, const vec::vec3& end, float* hitFactor) const;
+
+        // Returns the size of the map, in voxels.
+        const vec::vec3i& GetMapSize() const;
+
+        // Returns the height (in voxels) of the top of the highest non-air voxel in each column of the map, indexed by y * xSize + x.
+        // Slanted voxels count as full cubes, as they do for segment traces.
+        const std::vector<unsigned char>& GetColumnHeights() const;
+
+        // Returns the surface units travel on, for height and normal lookups.
+        const SurfaceHeightfield& GetSurface() const;
+
         // Returns true if a voxel has been hit by the ray (and fills in the voxelId), false otherwise.
         bool HitByRay(MapInfo* mapInfo, const vec::vec3& rayStart, const vec::vec3& rayVector, vec::vec3i* voxelId);
 
     private:
         voxelSubsectionsMap subsections;
 
+        // Which voxels of the map are solid, in MapInfo index order, so segments can be traced without the map itself.
+        vec::vec3i mapSize;
+        std::vector<unsigned char> solidVoxels;
+        std::vector<unsigned char> columnHeights;
+        SurfaceHeightfield surface;
+
+        // Updates the solid voxels and height of a single column.
+        void UpdateColumn(const MapInfo& mapInfo, int x, int y);
+
         // Performs a trace through the known voxels, given that we know which plane it hit.
         // Returns true if the trace hits a non-air voxel (and fills in the voxel ID), false otherwise.
         bool PerformVoxelTrace(MapInfo* mapInfo, const vec::vec3& rayStart, const vec::vec3& rayVector,
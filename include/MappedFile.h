@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+
+// A file mapped read-only into memory, so it can be read without copying it into a buffer first.
+class MappedFile
+{
+public:
+    MappedFile();
+
+    // Maps the file, unmapping any previously-mapped file. Returns false if the file couldn't be opened or mapped.
+    bool Open(const char* filename);
+
+    // Unmaps the file. Pointers into the data are invalid afterwards.
+    void Close();
+
+    // Returns the start of the file data, or nullptr if nothing is mapped or the file is empty.
+    const char* GetData() const;
+    size_t GetSize() const;
+
+    ~MappedFile();
+
+private:
+    const char* data;
+    size_t size;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
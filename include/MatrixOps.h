@@ -23,6 +23,19 @@ class MatrixOps
         static vec::mat4 Rotate(float angle, float x, float y, float z);
         static vec::mat4 Rotate(float angle, const vec::vec3& v);
 
+        // Computes a matrix that, applied after a projection, makes the pixel at (x, y) in window coordinates (Y down) fill the whole viewport.
+        // Used to render a single pixel into a 1x1 target, like gluPickMatrix.
+        static vec::mat4 PickMatrix(int x, int y, int screenWidth, int screenHeight);
+
         // Computes the inverse of the provided matrix, filling it into the result.
         static void Inverse(const vec::mat4& matrix, vec::mat4& result);
+
+        // Computes Translate(position) * rotation.asMatrix() * Scale(scale), filling in the columns directly instead of multiplying matrices.
+        static vec::mat4 TranslateRotateScale(const vec::vec3& position, const vec::quaternion& rotation, const vec::vec3& scale);
+
+        // Fills in results[i] = parent * matrices[i] for each of the count matrices.
+        static void MultiplyBatch(const vec::mat4& parent, const vec::mat4* matrices, vec::mat4* results, unsigned int count);
+
+        // Fills in results[i] = TranslateRotateScale(positions[i], rotations[i], scales[i]) for each of the count entries.
+        static void TranslateRotateScaleBatch(const vec::vec3* positions, const vec::quaternion* rotations, const vec::vec3* scales, vec::mat4* results, unsigned int count);
 };
@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "ObjParser.h"
+#include "Vec.h"
+
+// A vertex of a baked mesh, interleaved as it is sent to OpenGL.
+struct MeshVertex
+{
+    vec::vec3 position;
+    vec::vec2 uv;
+};
+
+// Start of every baked mesh (.tfmesh) file. The vertices follow the header, and the indices follow the vertices.
+struct MeshFileHeader
+{
+    char magic[4];
+    unsigned int version;
+
+    // Hash of the OBJ file the mesh was baked from. The mesh is rebaked if the OBJ file no longer matches.
+    unsigned long long sourceHash;
+
+    unsigned int vertexCount;
+    unsigned int indexCount;
+    vec::vec3 minBounds;
+    vec::vec3 maxBounds;
+};
+
+// Loads OBJ models through a cache of baked meshes, so OBJ files are only parsed the first time they are loaded (or after they change).
+// Baked meshes are memory-mapped, so loading one is a hash of the OBJ file and a copy out of the mapping.
+class MeshCache
+{
+public:
+    // Bumped whenever the file layout or ObjParser output changes, so older baked meshes are rebaked.
+    static const unsigned int MESH_FILE_VERSION = 1;
+
+    // Baked meshes are written to the given directory, which is created if it doesn't exist.
+    MeshCache(const char* cacheDirectory);
+
+    // Loads the OBJ model onto the end of the given vectors, from its baked mesh if there's one for the current OBJ file contents.
+    // Otherwise, parses the OBJ file and bakes it. Returns true on success.
+    bool LoadModel(const char* objFilename, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices, vec::vec3* minBounds, vec::vec3* maxBounds);
+
+    // Returns how many models were loaded from baked meshes, and how many had to be parsed.
+    unsigned int GetCacheHits() const;
+    unsigned int GetCacheMisses() const;
+
+    // Returns the path of the baked mesh for the OBJ file, named after the OBJ file path.
+    std::string GetBakedMeshPath(const char* objFilename) const;
+
+private:
+    std::string cacheDirectory;
+    ObjParser objParser;
+    std::vector<vec::vec3> parsedPositions;
+    std::vector<vec::vec2> parsedUvs;
+
+    unsigned int cacheHits;
+    unsigned int cacheMisses;
+
+    // The vertices and indices are assembled here before they are written, reused between models.
+    std::vector<char> bakedMeshData;
+
+    // Reads the baked mesh, returning false if it doesn't exist, is corrupt, or was baked from a different OBJ file.
+    bool ReadBakedMesh(const std::string& bakedMeshPath, unsigned long long sourceHash, std::vector<MeshVertex>& vertices,
+        std::vector<unsigned int>& indices, vec::vec3* minBounds, vec::vec3* maxBounds);
+
+    // Writes the vertices and indices from the given starting points as a baked mesh, replacing any existing one. Returns false if it couldn't be written.
+    bool WriteBakedMesh(const std::string& bakedMeshPath, unsigned long long sourceHash, const std::vector<MeshVertex>& vertices,
+        unsigned int firstVertex, const std::vector<unsigned int>& indices, unsigned int firstIndex, const vec::vec3& minBounds, const vec::vec3& maxBounds);
+};
@@ -1,19 +1,39 @@
 #pragma once
+#include <vector>
 #include <GL\glew.h>
-#include "Vertex.h"
+#include "MeshCache.h"
 #include "Vec.h"
 
+// A model vertex as stored in OpenGL when vertices are packed (see GraphicsConfig::PackedModelVertices).
+struct PackedModelVertex
+{
+    // Position within the model bounds as normalized shorts, from -1 at the minimum bounds to 1 at the maximum bounds. The last is padding.
+    GLshort position[4];
+
+    // Half-float UVs.
+    GLhalf uv[2];
+};
+
 // Holds data from a loaded, indexed UV textured model.
 struct TextureModel
 {
     // Texture to apply to the model.
     GLuint textureId;
 
-    // Vertex data -- only the position, uvs, and indices fields are expected to be filled.
-    universalVertices vertices;
+    // Interleaved vertex data and model-relative indices, as loaded.
+    // Released once sent to OpenGL, unless kept with ModelManager::RetainCollisionData.
+    std::vector<MeshVertex> vertices;
+    std::vector<unsigned int> indices;
+    bool retainVertices;
 
-    // Offset to apply to all the indicies in this model when sending to OpenGL and rendering.
+    // Where the model is in the shared model buffers, set when sending to OpenGL.
+    GLint baseVertex;
     GLuint indexOffset;
+    GLuint indexCount;
+
+    // Maps stored positions to model positions (position * positionScale + positionOffset), as packed positions are relative to the bounds.
+    vec::vec3 positionOffset;
+    vec::vec3 positionScale;
 
     // Model bounding box.
     vec::vec3 minBounds;
@@ -0,0 +1,12 @@
+#pragma once
+
+// Loads models by name for the unit configurations, which only need the resulting model IDs.
+// Implemented by the ModelManager, so configurations can also be read without any graphics.
+class ModelLoader
+{
+    public:
+        virtual ~ModelLoader() { }
+
+        // Loads a new model, returning the model ID. Returns 0 on failure.
+        virtual unsigned int LoadModel(const char* rootFilename) = 0;
+};
@@ -3,52 +3,78 @@
 #include <map>
 #include <string>
 #include <vector>
+#include "AssetLoader.h"
 #include "ImageManager.h"
+#include "ModelLoader.h"
+#include "MeshCache.h"
 #include "ShaderManager.h"
 #include "Model.h"
 #include "Vec.h"
 
-struct PosUvPair
-{
-    unsigned int positionId;
-    unsigned int uvId;
-};
-
 // Assists with loading in 3D models
-class ModelManager
+class ModelManager : public ModelLoader
 {
     public:
         // Clears the next model ID and initializes the local reference to the image manager.
         ModelManager(ImageManager* imageManager);
 
         // Loads a new textured OBJ model, returning the model ID. Returns 0 on failure.
-        unsigned int LoadModel(const char* rootFilename);
+        // While loads are queued, the model is loaded by the asset loader instead, and failures are reported when it finishes.
+        virtual unsigned int LoadModel(const char* rootFilename);
+
+        // Queues model loads on the asset loader, until EndQueuedLoading is called after the asset loader finishes.
+        void BeginQueuedLoading(AssetLoader* assetLoader);
+        void EndQueuedLoading();
+
+        // Adds the asset loader tasks that must complete before the queued model can be used.
+        void GetLoadTasks(unsigned int id, std::vector<AssetTaskId>& loadTasks) const;
 
         // Retrieves a 3D model, returning the model ID.
         const TextureModel& GetModel(unsigned int id);
 
+        // Keeps the model vertices and indices after they are sent to OpenGL, such as for collision checks. Must be called before ResetOpenGlModelData.
+        void RetainCollisionData(unsigned int id);
+
         unsigned int GetCurrentModelCount() const;
 
-        // Renders the specified model given by the ID.
-        void RenderModel(vec::mat4& projectionMatrix, unsigned int id, vec::mat4& mvMatrix, bool selected);
+        // Renders the specified model given by the ID. Selected models are highlighted more than hovered ones.
+        // The pick id is only used when rendering to the PickingBuffer.
+        void RenderModel(vec::mat4& projectionMatrix, unsigned int id, vec::mat4& mvMatrix, bool selected, bool hovered, unsigned int pickId);
 
         // Initializes the OpenGL resources
         bool InitializeOpenGlResources(ShaderManager& shaderManager);
 
-        // Sends in the model data to OpenGL.
+        // Sends in the model data to OpenGL, once every model has loaded. Releases the vertices and indices of models that don't retain them.
         void ResetOpenGlModelData();
 
         // Deletes all initialized OpenGL resources.
         ~ModelManager();
 
     private:
+        // A model being loaded by the asset loader.
+        struct QueuedModel
+        {
+            std::string objFilename;
+            std::string pngFilename;
+            DecodedImage image;
+
+            AssetTaskId meshTask;
+            AssetTaskId textureTask;
+        };
+
         ImageManager* imageManager;
+        AssetLoader* assetLoader;
+        std::map<unsigned int, QueuedModel> queuedModels;
+
+        // Queues the mesh and image decoding on worker threads, and the texture creation on the GL thread.
+        unsigned int QueueModel(const std::string& objFilename, const std::string& pngFilename);
 
         // Rendering data
         GLuint vao;
-        GLuint uvBuffer;
-        GLuint positionBuffer;
+        GLuint vertexBuffer;
         GLuint indexBuffer;
+        GLenum indexType;
+        GLsizei indexSize;
 
         GLuint modelRenderProgram;
 
@@ -56,24 +82,16 @@ class ModelManager
         GLuint mvLocation;
         GLuint projLocation;
         GLuint selectionFactorLocation;
+        GLuint pickIdLocation;
+        GLuint positionOffsetLocation;
+        GLuint positionScaleLocation;
 
         // Model data
         unsigned int nextModelId;
         std::map<unsigned int, TextureModel> models;
 
-        // Temporary loading structures.
-        std::vector<vec::vec2> rawUvs;
-        std::vector<PosUvPair> rawIndices;
-        std::map<unsigned int, unsigned int> indexUvMap; // [positionId] = UV Id. Maps rawIndices for faster loading access.
-        std::map<unsigned int, std::vector<PosUvPair>> uvVertexRemapping;
-
-        // Given a position index and UV coordinate index, returns the actual index to use.
-        unsigned int GetActualVertexIndex(unsigned int positionIdx, unsigned int uvIdx, universalVertices& vertices);
-
-        // Parses an individual line of an OBJ model file.
-        bool ParseLine(const std::vector<std::string>& line, universalVertices& vertices);
-
-        // Loads an OBJ model into the specified vertices, returning true on success.
+        // Loads OBJ models from their baked meshes, parsing (and baking) them only when the OBJ file is new or changed.
+        // There is one per asset loader thread, as each reuses its parsing structures between models.
         // Note that the OBJ model must fully specify all positions / UVs *before* any indices.
-        bool LoadModel(const char* objFilename, universalVertices& vertices, vec::vec3* minBounds, vec::vec3* maxBounds);
+        std::vector<MeshCache> meshCaches;
 };
@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include "Vec.h"
+
+struct PosUvPair
+{
+    unsigned int positionId;
+    unsigned int uvId;
+};
+
+// Parses textured OBJ models: 'v' positions, 'vt' UVs, and 'f' triangles giving a position and UV for each corner ('p/t', 'p/t/' or 'p/t/n').
+// Other lines (comments, groups, materials, normals) are ignored.
+// The text is parsed in a single pass with a cursor, so no lines or tokens are copied, and numbers are read without going through streams.
+// Positions used with more than one UV are duplicated, found through a flat hash table of (position, UV) pairs.
+class ObjParser
+{
+public:
+    ObjParser();
+
+    // Maps the OBJ file into memory and parses it. Returns true on success.
+    bool ParseFile(const char* objFilename, std::vector<vec::vec3>& positions, std::vector<vec::vec2>& uvs, std::vector<unsigned int>& indices,
+        vec::vec3* minBounds, vec::vec3* maxBounds);
+
+    // Parses OBJ text into vertices with one UV each, appending them to the given vectors. Returns true on success.
+    // Every position must be used by at least one face. The bounds are filled in with the bounding box of the positions.
+    bool Parse(const char* text, const char* textEnd, std::vector<vec::vec3>& positions, std::vector<vec::vec2>& uvs, std::vector<unsigned int>& indices,
+        vec::vec3* minBounds, vec::vec3* maxBounds);
+
+private:
+    // Temporary loading structures, kept between models so their memory is reused.
+    std::vector<vec::vec2> rawUvs;
+    std::vector<PosUvPair> rawIndices;
+
+    // [positionId] = the UV the position was last used with, which it keeps. Other UVs get duplicated positions.
+    std::vector<unsigned int> positionUvs;
+
+    // Where the positions of the model being parsed start, as they are appended to the given vertices.
+    unsigned int firstVertex;
+
+    // Open-addressing hash table of (position, UV) pairs to vertex indices, with linear probing. The size is always a power of two.
+    std::vector<unsigned long long> vertexKeys;
+    std::vector<unsigned int> vertexIndices;
+    unsigned int vertexHashShift;
+
+    // Readers for the single-pass parser. Each advances the cursor past what it read and returns false on malformed text.
+    static bool ReadFloat(const char*& cursor, const char* textEnd, float& value);
+    static bool ReadIndex(const char*& cursor, const char* textEnd, unsigned int& index);
+    static bool ReadFaceCorner(const char*& cursor, const char* textEnd, PosUvPair& corner);
+    static void SkipSpaces(const char*& cursor, const char* textEnd);
+    static bool AtLineEnd(const char* cursor, const char* textEnd);
+
+    // Empties the vertex hash table, sizing it to hold the given number of vertices.
+    void ResetVertexHash(size_t vertexCount);
+
+    // Returns the vertex index for the position and UV, adding the vertex if it hasn't been used yet.
+    unsigned int GetVertexIndex(const PosUvPair& pair, std::vector<vec::vec3>& positions, std::vector<vec::vec2>& uvs);
+};
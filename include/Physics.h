@@ -1,21 +1,21 @@
 #pragma once
 #include <vector>
+#include "Camera.h"
+#include "CombatResolver.h"
+#include "InputQueue.h"
+#include "JobSystem.h"
+#include "LocalAvoidance.h"
 #include "MapSections.h"
 #include "ModelManager.h"
 #include "Player.h"
+#include "ProjectilePool.h"
+#include "ScreenSelector.h"
+#include "SpatialHash.h"
 #include "SyncBuffer.h"
+#include "TurretTargeting.h"
 #include "UnitRouter.h"
 #include "Viewer.h"
 
-// Simple structure for where the mouse was clicked and the screen size at the time of clicking.
-struct MouseClickData
-{
-    int x;
-    int y;
-    int xSize;
-    int ySize;
-};
-
 // Manages physics.
 // Physics encompasses everything compuation-wise that should run on a separate thread to avoid frame lag.
 // Usually, events get sent from graphics (TemperFine) to physics, are processed here, and then updated remotely.
@@ -30,6 +30,9 @@ class Physics
         // Queues a mouse click for future processing.
         void QueueLeftMouseClick(int x, int y, int xSize, int ySize);
 
+        // Queues a drag-box selection from the start to the end corner for future processing.
+        void QueueDragSelect(int startX, int startY, int endX, int endY, int xSize, int ySize);
+
         // Runs actions on the physics thread.
         void Run();
 
@@ -46,18 +49,39 @@ class Physics
         SyncBuffer *syncBuffer;
 
         // Physics computation classes
+        JobSystem jobSystem;
         MapSections mapSections;
         UnitRouter unitRouter;
+        SpatialHash unitHash;
+        LocalAvoidance localAvoidance;
+
+        // Aims and fires unit turrets.
+        TurretTargeting turretTargeting;
+
+        // Projectiles in flight, and the hits from the current physics tick.
+        ProjectilePool projectilePool;
+        std::vector<ProjectileHit> projectileHits;
+
+        // Applies projectile hits to unit armor.
+        CombatResolver combatResolver;
+        std::vector<UnitDeath> unitDeaths;
 
         // Physics run state (includes sync buffer, above).
         Viewer viewer;
+
+        // The view and projection matrices for picking and selection, updated from the viewer.
+        Camera camera;
         
         // Physics operation state.
         bool isAlive;
         bool isPaused;
 
-        // Input events.
-        bool isLeftMouseClicked;
-        MouseClickData leftMouseClickData;
-        void HandleLeftMouseClicked();
+        // Input events from the GUI thread, and the events being processed by this thread.
+        InputQueue inputQueue;
+        std::vector<InputEvent> inputEvents;
+        void HandleLeftMouseClicked(const InputEvent& clickEvent);
+
+        // Drag-box selection.
+        ScreenSelector screenSelector;
+        void HandleDragSelect(const InputEvent& dragEvent);
 };
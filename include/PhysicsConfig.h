@@ -7,6 +7,10 @@ class PhysicsConfig : public ConfigManager
 	virtual void WriteConfigValues();
 public:
 	static int PhysicsThreadDelay;
+	static int PhysicsWorkerThreads;
+	static int MaxProjectiles;
+	static int TurretScanTicks;
+	static float VisibilityBudget;
 	static float ViewForwardsSpeed;
 	static float ViewSidewaysSpeed;
 
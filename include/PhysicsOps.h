@@ -34,7 +34,11 @@ class PhysicsOps
         // Determines if a given ray hits a sphere. Returns true if so, false otherwise.
         static bool HitsSphere(const vec::vec3& rayStart, const vec::vec3& ray, const vec::vec3& sphereCenter, float sphereRadius);
 
+        // Determines if a given normalized ray hits a sphere in front of the ray start. Returns true and fills in the distance to the first hit if so.
+        static bool HitsSphere(const vec::vec3& rayStart, const vec::vec3& ray, const vec::vec3& sphereCenter, float sphereRadius, float* intersectionFactor);
+
         // Computes a ray from the current mouse position into the scene.
+        // Inverts the perspective matrix on every call; Camera::ScreenRay keeps the inverse between calls instead.
         static vec::vec3 ScreenRay(vec::vec2 mouse, vec::vec2 screenSize, vec::mat4& perspectiveMatrix, vec::mat4& viewRotationMatrix);
 };
 
@@ -0,0 +1,61 @@
+#pragma once
+#include <GL\glew.h>
+#include "Vec.h"
+
+// Finds what is under the cursor every frame by rendering pick ids into a 1x1 unsigned integer target.
+// Only the pixel under the cursor is rendered (see MatrixOps::PickMatrix), and it is read back through pixel buffer objects,
+//  so the id is available a frame or two later without waiting on the GPU.
+// Shaders write pick ids to fragment output location 1, which is discarded when rendering to the screen.
+// Uses only OpenGL 3.2 core functionality, so it also runs on Mesa's software rasterizer.
+class PickingBuffer
+{
+public:
+    // Pick ids. 0 is nothing, voxels are their map index + 1, and units have the high bit set with the player id above the unit id.
+    static const unsigned int NO_PICK_ID = 0;
+    static const unsigned int UNIT_PICK_FLAG = 0x80000000u;
+    static const unsigned int UNIT_ID_BITS = 20;
+
+    static unsigned int GetVoxelPickId(int voxelIndex);
+    static unsigned int GetUnitPickId(int playerId, unsigned int unitId);
+
+    static bool IsVoxelPickId(unsigned int pickId);
+    static bool IsUnitPickId(unsigned int pickId);
+    static int GetVoxelIndex(unsigned int pickId);
+    static int GetPlayerId(unsigned int pickId);
+    static unsigned int GetUnitId(unsigned int pickId);
+
+    PickingBuffer();
+
+    // Creates the framebuffer and pixel buffer objects.
+    bool Initialize();
+
+    // Starts rendering the pixel under the cursor, given in window coordinates. Returns false (and the hovered id becomes NO_PICK_ID) if the cursor is outside the window.
+    // Otherwise fills in the pick matrix, which must be applied after the projection matrix when rendering the pickable objects.
+    bool Begin(int cursorX, int cursorY, int screenWidth, int screenHeight, vec::mat4* pickMatrix);
+
+    // Queues reading back the rendered id and restores the window framebuffer. Also picks up the id from an earlier frame, if the GPU is done with it.
+    void End(int screenWidth, int screenHeight);
+
+    // Returns the most recent id read back from the GPU.
+    unsigned int GetHoveredId() const;
+
+    ~PickingBuffer();
+
+private:
+    static const int READBACK_BUFFERS = 2;
+
+    GLuint framebuffer;
+    GLuint idRenderbuffer;
+    GLuint depthRenderbuffer;
+
+    // Readbacks in flight, each with the fence signalling the GPU has written the pixel buffer.
+    GLuint pixelBuffers[READBACK_BUFFERS];
+    GLsync fences[READBACK_BUFFERS];
+    int nextReadback;
+
+    unsigned int hoveredId;
+    bool isInitialized;
+
+    // Reads back the pixel buffer if its fence has been signalled, without waiting. Returns true if it did.
+    bool TryReadback(int readback);
+};
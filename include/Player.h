@@ -3,12 +3,19 @@
 #include <set>
 #include <vector>
 #include "Building.h"
-#include "ModelManager.h"
-#include "RouteVisual.h"
+#include "JobSystem.h"
+#include "LocalAvoidance.h"
+#include "MapSections.h"
+#include "ScreenSelector.h"
 #include "SharedExclusiveLock.h"
+#include "SpatialHash.h"
 #include "TechProgress.h"
 #include "Unit.h"
 #include "Vec.h"
+#include "VisibilityGrid.h"
+
+class ModelManager;
+class RouteVisual;
 
 // Represents an in-game player.
 class Player
@@ -20,26 +27,64 @@ class Player
         void AddUnit(const Unit& unit);
 
         // Performs updates on the GUI thread required for units.
+        // Rendering is implemented in PlayerRendering.cpp, which isn't part of the headless simulation library.
         void PerformUnitGuiUpdates(RouteVisual& routeVisuals);
 
-        // Renders the player's units.
-        void RenderUnits(ModelManager& modelManager, RouteVisual& routeVisual, vec::mat4& projectionMatrix);
+        // Renders the player's units, highlighting the unit with the given pick id (see PickingBuffer).
+        void RenderUnits(ModelManager& modelManager, RouteVisual& routeVisual, unsigned int hoveredPickId, vec::mat4& projectionMatrix);
+
+        // Renders the player's units into the PickingBuffer.
+        void RenderUnitPicking(ModelManager& modelManager, vec::mat4& projectionMatrix);
 
-        // Checks if the given world ray intersects with a unit.
-        // Returns the index of the unit if true, -1 if false.
-        int CollisionCheck(vec::vec3 cameraPos, vec::vec3 worldRay);
+        // Checks if the given world ray intersects with one of the player's units.
+        // Returns the index of the closest unit hit if true, -1 if false.
+        int CollisionCheck(const SpatialHash& unitHash, vec::vec3 cameraPos, vec::vec3 worldRay);
 
         // Either adds or removed the specified unit from the set of selected units.
         void ToggleUnitSelection(int unitId);
 
+        // Replaces the set of selected units with the units that project within the given window rectangle.
+        void SelectUnitsWithinRectangle(ScreenSelector& screenSelector, const vec::mat4& projectionMatrix, const vec::mat4& viewProjectionMatrix,
+            vec::vec2 firstCorner, vec::vec2 secondCorner, vec::vec2 screenSize);
+
         // Returns the players selected units. VALID FOR PHYSICS THREAD ONLY
         const std::set<int>& GetSelectedUnits() const;
 
+        // Returns the position of one of the player's units.
+        vec::vec3 GetUnitPosition(unsigned int unitId);
+
         // Updates a unit's route to the new given route.
         void UpdateUnitRoute(int unitId, const std::vector<vec::vec3>& route);
 
-        // Moves the player's units along their assigned routes.
-        void MoveUnits();
+        // Moves the player's units along their assigned routes, computing how each unit would like to move.
+        void MoveUnits(JobSystem& jobSystem);
+
+        // Adds the player's units to local avoidance.
+        void AddAvoidanceAgents(LocalAvoidance& localAvoidance);
+
+        // Moves the player's units with the velocities computed by local avoidance.
+        void ApplyAvoidance(JobSystem& jobSystem, const LocalAvoidance& localAvoidance, const MapSections& mapSections);
+
+        // Clears what the player has seen and sizes their visibility grid to the map.
+        void ResetVisibility(const MapSections& mapSections);
+
+        // Updates what the player can see from where their units are, spending at most the given time (in milliseconds) recomputing units that moved.
+        void UpdateVisibility(const MapSections& mapSections, float budgetMs);
+
+        // Returns what the player can see. VALID FOR PHYSICS THREAD ONLY
+        VisibilityGrid& GetVisibility();
+
+        // Aims the turrets of the player's units at enemy units the player can see.
+        void UpdateTurrets(JobSystem& jobSystem, TurretTargeting& turretTargeting, const MapSections& mapSections, const SpatialHash& unitHash);
+
+        // Fires the turrets of the player's units that are ready to fire. Returns the number of projectiles fired.
+        unsigned int FireTurrets(ProjectilePool& projectilePool);
+
+        // Updates the positions of the player's units in the spatial hash. Destroyed units are removed from the hash.
+        void UpdateSpatialHash(SpatialHash& unitHash);
+
+        // Applies combat hits to one of the player's units. Returns true (and fills in the player that destroyed the unit) if the unit was destroyed by the hits, false otherwise.
+        bool ApplyUnitHits(unsigned int unitId, const CombatHit* hits, unsigned int hitCount, unsigned int* killingPlayerId);
 
         // Attempts to switch the player's research to the given tech. Returns true on success, false otherwise.
         bool SwitchResearch(unsigned int techId);
@@ -64,6 +109,12 @@ class Player
         SharedExclusiveLock playerUnitVectorMutex;
         std::vector<Unit> units;
 
+        // What the player can see of the map. Only used from the physics thread.
+        VisibilityGrid visibility;
+
+        // Storage for turret target searches, per job system thread, kept across ticks so turret updates don't allocate.
+        std::vector<TurretTargeting::SearchBuffers> turretSearchBuffers;
+
         // Buildings the player has under their control.
         SharedExclusiveLock playerBuildingVectorMutex;
         std::vector<Building> buildings;
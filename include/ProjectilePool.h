@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include "ArmorInfo.h"
+#include "MapSections.h"
+#include "SpatialHash.h"
+#include "Vec.h"
+
+// A projectile that hit a unit or the map.
+struct ProjectileHit
+{
+    // The player that fired the projectile.
+    unsigned int firingPlayerId;
+
+    // The unit hit, if the projectile hit a unit instead of the map.
+    bool hitUnit;
+    unsigned int playerId;
+    unsigned int unitId;
+
+    vec::vec3 position;
+    DamageType damageType;
+    float damage;
+};
+
+// Fixed-capacity pool of ballistic projectiles, stored as a structure of arrays. VALID FOR PHYSICS THREAD ONLY
+// Storage is allocated up front, so firing and updating projectiles never allocates during combat.
+class ProjectilePool
+{
+public:
+    // Downwards acceleration of projectiles, in world units per physics tick per tick.
+    static float Gravity;
+
+    ProjectilePool();
+
+    // Allocates storage for the given number of projectiles, removing any existing projectiles.
+    void Initialize(unsigned int capacity);
+
+    // Fires a projectile with the given velocity (in world units per physics tick), which lasts up to the given number of ticks.
+    // Returns true on success, false if the pool is full (in which case the projectile is dropped).
+    bool Fire(unsigned int firingPlayerId, const vec::vec3& position, const vec::vec3& velocity, DamageType damageType, float damage, unsigned int lifetimeTicks);
+
+    // Moves every projectile by one physics tick, sweeping its path against the map and the units of other players.
+    // Projectiles that hit something or expire are removed. Hits are added to the list, which doesn't allocate if it has reserved the pool capacity.
+    // Uses spatial hash ray queries, so this can't run concurrently with other ray queries.
+    void Update(const MapSections& mapSections, const SpatialHash& unitHash, std::vector<ProjectileHit>& hits);
+
+    // Removes all projectiles.
+    void Clear();
+
+    unsigned int GetCount() const;
+    unsigned int GetCapacity() const;
+
+    // Copies up to maxCount projectiles for rendering, as the position with the damage type in w. Returns the number copied.
+    unsigned int CopyVisualData(vec::vec4* visualData, unsigned int maxCount) const;
+
+private:
+    unsigned int count;
+    unsigned int capacity;
+
+    std::vector<float> xPositions;
+    std::vector<float> yPositions;
+    std::vector<float> zPositions;
+    std::vector<float> xVelocities;
+    std::vector<float> yVelocities;
+    std::vector<float> zVelocities;
+    std::vector<unsigned int> firingPlayerIds;
+    std::vector<unsigned char> damageTypes;
+    std::vector<float> damages;
+    std::vector<unsigned int> remainingTicks;
+
+    // Reused for unit ray queries.
+    std::vector<SpatialHashRayHit> rayHits;
+
+    // Removes a projectile by moving the last projectile into its place.
+    void Remove(unsigned int index);
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+#include <GL\glew.h>
+#include "ShaderManager.h"
+#include "Vec.h"
+
+// Renders every live projectile with a single instanced draw.
+class ProjectileVisual
+{
+public:
+    ProjectileVisual();
+
+    // Initializes the projectile shader and allocates instance storage for the given number of projectiles.
+    bool Initialize(ShaderManager& shaderManager, unsigned int capacity);
+
+    // Renders the first count projectiles, each given as the position with the damage type in w.
+    void Render(const vec::mat4& projectionMatrix, const std::vector<vec::vec4>& projectiles, unsigned int count);
+
+    ~ProjectileVisual();
+
+private:
+    // OpenGL elements for projectile visualization.
+    GLuint projectileProgram;
+    GLuint projMatrixLocation;
+
+    GLuint vao;
+    GLuint shapeBuffer;
+    GLuint instanceBuffer;
+
+    GLsizei shapeVertexCount;
+    unsigned int capacity;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <GL\glew.h>
+#include "AssetLoader.h"
 #include "ModelManager.h"
 #include "ShaderManager.h"
 #include "Vec.h"
@@ -10,7 +11,8 @@ class Scenery
     public:
         Scenery(ModelManager* modelManager);
 
-        bool Initialize(ShaderManager& shaderManager);
+        // Creates the sky shader, queueing the ground model and sky image loads on the asset loader.
+        bool Initialize(ShaderManager& shaderManager, AssetLoader& assetLoader);
         void Render(vec::mat4& viewMatrix, vec::mat4& projectionMatrix);
 
         ~Scenery();
@@ -18,6 +20,8 @@ class Scenery
     protected:
     private:
         unsigned char* rawImage;
+        int rawImageWidth;
+        int rawImageHeight;
         bool GetRawImage(const char* filename, unsigned char** data, int* width, int* height);
         void FreeRawImage(unsigned char* imageData);
 
@@ -34,5 +38,8 @@ class Scenery
         GLuint skyCubeTexture;
 
         ModelManager* modelManager;
+
+        // Sends the decoded sky image to OpenGL as a cube map.
+        bool CreateSkyCube();
 };
 
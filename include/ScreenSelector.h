@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include "Vec.h"
+
+// Finds which bounding spheres land within a screen rectangle, for drag-box selection.
+// Spheres are stored as a structure of arrays and projected in one batched pass, four at a time with SSE when available.
+class ScreenSelector
+{
+public:
+    ScreenSelector();
+
+    // Removes all spheres, keeping the allocated storage.
+    void Clear();
+
+    // Adds a sphere to test, identified by the given id.
+    void AddSphere(unsigned int id, const vec::vec3& center, float radius);
+
+    // Projects every sphere through the view-projection matrix, filling in the ids of the spheres that overlap the rectangle.
+    // The rectangle corners are in window coordinates (and may be in any order), with the window size given by screenSize.
+    // The projection matrix is used to find the projected size of each sphere.
+    void FindWithinRectangle(const vec::mat4& projectionMatrix, const vec::mat4& viewProjectionMatrix,
+        vec::vec2 firstCorner, vec::vec2 secondCorner, vec::vec2 screenSize, std::vector<unsigned int>& selectedIds);
+
+private:
+    std::vector<unsigned int> ids;
+    std::vector<float> xPositions;
+    std::vector<float> yPositions;
+    std::vector<float> zPositions;
+    std::vector<float> radii;
+    std::vector<unsigned char> withinRectangle;
+};
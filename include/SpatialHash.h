@@ -0,0 +1,102 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include "Vec.h"
+
+// A unit tracked by the spatial hash.
+struct SpatialHashEntry
+{
+    unsigned int playerId;
+    unsigned int unitId;
+    vec::vec3 position;
+    float radius;
+};
+
+// A unit hit by a ray query, with the distance along the ray to the hit.
+struct SpatialHashRayHit
+{
+    unsigned int playerId;
+    unsigned int unitId;
+    float distance;
+};
+
+// Loose uniform grid of units over the XY plane, hashed by cell so units can go anywhere.
+// Units are stored in the cell containing their center and queries check neighboring cells to cover unit radii,
+//  so query cost depends on the unit density near the query instead of the total unit count.
+// Updated incrementally: an update only moves a unit between cells if it crossed a cell boundary. VALID FOR PHYSICS THREAD ONLY
+// Radius and box queries may run concurrently with each other (such as from job system workers), but not with updates or ray queries.
+class SpatialHash
+{
+public:
+    SpatialHash(float cellSize);
+
+    // Adds the unit if it isn't tracked, otherwise moves it to its new position.
+    void UpdateEntry(unsigned int playerId, unsigned int unitId, const vec::vec3& position, float radius);
+
+    // Stops tracking the unit. Does nothing if the unit isn't tracked.
+    void RemoveEntry(unsigned int playerId, unsigned int unitId);
+
+    // Removes all units.
+    void Clear();
+
+    // Returns true (and fills in the entry) if the unit is tracked, false otherwise. May run concurrently with other lookups and radius or box queries.
+    bool GetEntry(unsigned int playerId, unsigned int unitId, SpatialHashEntry* entry) const;
+
+    // Finds all units hit by the ray within maxDistance, sorted from closest to furthest. The ray must be normalized.
+    // Not safe to run concurrently with any other query.
+    void RayQuery(const vec::vec3& rayStart, const vec::vec3& rayVector, float maxDistance, std::vector<SpatialHashRayHit>& hits) const;
+
+    // Finds all units overlapping the sphere.
+    void RadiusQuery(const vec::vec3& center, float radius, std::vector<SpatialHashEntry>& results) const;
+
+    // Finds all units overlapping the axis-aligned box.
+    void BoxQuery(const vec::vec3& minPosition, const vec::vec3& maxPosition, std::vector<SpatialHashEntry>& results) const;
+
+    // Returns the number of tracked units.
+    unsigned int GetEntryCount() const;
+
+private:
+    // Tracked unit, along with where it is stored in its cell.
+    struct StoredEntry
+    {
+        SpatialHashEntry entry;
+        long long cellKey;
+        unsigned int cellSlot;
+    };
+
+    float cellSize;
+
+    std::vector<StoredEntry> entries;
+    std::unordered_map<long long, unsigned int> entryLookup;
+    std::unordered_map<long long, std::vector<unsigned int>> cells;
+
+    // Largest radius of any unit that has been tracked, which determines how many neighboring cells queries check.
+    float maxEntryRadius;
+
+    // Bounds of every cell that has held a unit, used to clip ray queries.
+    vec::vec2i minCell;
+    vec::vec2i maxCell;
+
+    // Marks entries already tested by the current query, so queries visiting overlapping cells don't test units twice.
+    mutable std::vector<unsigned int> queryStamps;
+    mutable unsigned int currentQueryStamp;
+
+    static long long GetEntryKey(unsigned int playerId, unsigned int unitId);
+    static long long GetCellKey(int x, int y);
+    vec::vec2i GetCell(const vec::vec3& position) const;
+    int GetCellMargin() const;
+
+    void AddToCell(unsigned int entryIndex);
+    void RemoveFromCell(unsigned int entryIndex);
+
+    // Starts a new query, returning the stamp used to mark tested entries.
+    unsigned int BeginQuery() const;
+
+    // Calls the test function for every untested entry within the margin of the given cell.
+    template <typename T>
+    void VisitCellNeighborhood(int x, int y, int margin, unsigned int stamp, T& testFunction) const;
+
+    // Calls the test function for every entry that could overlap the given (inclusive) range of cells.
+    template <typename T>
+    void VisitCellRange(const vec::vec2i& minRangeCell, const vec::vec2i& maxRangeCell, T& testFunction) const;
+};
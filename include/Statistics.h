@@ -17,19 +17,32 @@ class Statistics
         bool Initialize(FontManager* fontManager);
 
         void UpdateRunTime(float currentTime);
-        void UpdateViewPos(vec::vec3& position);
+        // Text is formatted into a fixed buffer, and the FontManager skips sentences that haven't changed, so these don't allocate when called every frame.
+        void UpdateViewPos(const vec::vec3& position);
         void UpdateTechLevelRange(int minLevel, int maxLevel);
         void UpdatePlayerDetails(std::string& playerName);
 
-        void RenderStats(vec::mat4& perspectiveMatrix);
+        // Shows the GPU memory used by the textures of the ImageManager.
+        void UpdateTextureMemory(size_t textureBytes);
+
+        // Shows how many heap allocations updating and rendering the statistics made, which should be none while nothing changes.
+        void UpdateOverlayAllocations(unsigned long long allocationCount);
+
+        // Queues the statistics sentences, which are drawn with the rest of the text by FontManager::RenderSentences.
+        void RenderStats();
 
     private:
         int textPixelHeight;
+
+        // Holds the text of the sentence being updated. Large enough for any of the statistics.
+        char textBuffer[64];
         vec::mat4 textScale;
 
         // Overall Details
         RenderableSentence playerCount;
         RenderableSentence runTime;
+        RenderableSentence textureMemory;
+        RenderableSentence overlayAllocations;
 
         // Current player details.
         RenderableSentence playerName;
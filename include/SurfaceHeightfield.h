@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include "MapInfo.h"
+#include "Vec.h"
+
+// The plane units travel on over a voxel or column, in world units: height = height + xSlope * dx + ySlope * dy,
+//  where dx and dy are measured from the minimum corner of the column. The normal points up, away from the surface.
+struct SurfacePlane
+{
+    float height;
+    float xSlope;
+    float ySlope;
+    vec::vec3 normal;
+};
+
+// The surface at a position, as returned by a heightfield lookup.
+struct SurfaceSample
+{
+    float height;
+    vec::vec3 normal;
+};
+
+// Precomputed top walkable surface of each (x, y) column of the map, so surface lookups don't depend on voxel types.
+// Lookups are branch-free: positions off the map are clamped to the nearest column edge. Columns without any voxels have a flat surface at zero height.
+// VALID FOR PHYSICS THREAD ONLY. Lookups may run concurrently with each other, but not with rebuilds.
+class SurfaceHeightfield
+{
+public:
+    SurfaceHeightfield();
+
+    // Rebuilds every column from the map.
+    void Rebuild(const MapInfo& mapInfo);
+
+    // Rebuilds the columns from (minX, minY) to (maxX, maxY) inclusive, after the voxels within them were edited. The range is clamped to the map.
+    void UpdateColumns(const MapInfo& mapInfo, int minX, int minY, int maxX, int maxY);
+
+    // Returns the height and normal of the surface under the position.
+    SurfaceSample GetSurface(const vec::vec3& position) const;
+
+    // Returns the plane on top of a single voxel of the given type and orientation, with the height relative to the voxel's minimum corner.
+    // Air voxels are treated as cubes.
+    static SurfacePlane GetVoxelPlane(int type, int orientation);
+
+private:
+    int xSize;
+    int ySize;
+
+    // One plane per column, indexed by y * xSize + x, with each plane's height relative to the world origin.
+    std::vector<SurfacePlane> columns;
+
+    void RebuildColumn(const MapInfo& mapInfo, int x, int y);
+};
@@ -1,9 +1,16 @@
 #pragma once
+#include "CombatResolver.h"
 #include "GameRound.h"
+#include "JobSystem.h"
+#include "LocalAvoidance.h"
 #include "MapSections.h"
 #include "ModelManager.h"
+#include "ProjectilePool.h"
+#include "ProjectileVisual.h"
 #include "RouteVisual.h"
 #include "SharedExclusiveLock.h"
+#include "SpatialHash.h"
+#include "TurretTargeting.h"
 #include "Unit.h"
 #include "UnitRouter.h"
 #include "Vec.h"
@@ -24,11 +31,42 @@ public:
     // Unlocks a player for direct thread use.
     void UnlockPlayer(unsigned int playerId);
 
-    // Renders the players
-    void RenderPlayers(ModelManager& modelManager, RouteVisual& routeVisuals, vec::mat4& projectionMatrix);
+    // Renders the players, highlighting the unit with the given pick id (see PickingBuffer).
+    void RenderPlayers(ModelManager& modelManager, RouteVisual& routeVisuals, unsigned int hoveredPickId, vec::mat4& projectionMatrix);
 
-    // Updates the players.
-    void UpdatePlayers(float lastElapsedTime);
+    // Renders the players' units into the PickingBuffer.
+    void RenderPlayerPicking(ModelManager& modelManager, vec::mat4& projectionMatrix);
+
+    // Updates the players, spreading the per-player and per-unit work across the job system.
+    // Units follow their routes while avoiding each other, staying on travellable voxels of the map sections.
+    // Afterwards, the unit spatial hash holds the new unit positions.
+    void UpdatePlayers(JobSystem& jobSystem, SpatialHash& unitHash, LocalAvoidance& localAvoidance, const MapSections& mapSections, float lastElapsedTime);
+
+    // Clears what every player has seen, sizing their visibility grids to the map.
+    void ResetVisibility(const MapSections& mapSections);
+
+    // Updates what each player can see, spending at most the given time (in milliseconds) per player on units that moved.
+    // Players are updated in parallel. Changes to what the local player can see are kept for the fog of war display.
+    void UpdateVisibility(JobSystem& jobSystem, const MapSections& mapSections, float budgetMs);
+
+    // Sends changes to what the local player can see to the voxel map. Returns true if an update was performed.
+    bool UpdateVisibilityDisplay(VoxelMap& voxelMap);
+
+    // Aims unit turrets at enemy units, then fires the turrets that are ready into the projectile pool.
+    // Turrets are aimed in parallel, but fired serially as the projectile pool isn't thread-safe.
+    void UpdateTurrets(JobSystem& jobSystem, TurretTargeting& turretTargeting, const MapSections& mapSections, const SpatialHash& unitHash, ProjectilePool& projectilePool);
+
+    // Applies the combat hits of a physics tick to the units hit, adding the units destroyed to the death list.
+    void ResolveCombat(CombatResolver& combatResolver, std::vector<UnitDeath>& unitDeaths);
+
+    // Allocates storage for rendering up to the given number of projectiles.
+    void InitializeProjectiles(unsigned int capacity);
+
+    // Copies the live projectiles for rendering. Storage is allocated when initialized, so this never allocates.
+    void UpdateProjectiles(const ProjectilePool& projectilePool);
+
+    // Renders the projectiles.
+    void RenderProjectiles(ProjectileVisual& projectileVisual, const vec::mat4& projectionMatrix);
 
     // Sets the round map.
     void SetRoundMap(const MapInfo& testMap);
@@ -40,14 +78,14 @@ public:
     bool HitByRay(MapSections& mapSections, const vec::vec3& rayStart, const vec::vec3& rayVector, vec::vec3i* voxelId);
 
     // Wrapper to UnitRouter's RefineRoute, locking and providing the map.
-    void RefineRoute(UnitRouter& unitRouter, const voxelSubsectionsMap& voxelSubsections, const vec::vec3i start, const vec::vec3i destination,
+    void RefineRoute(UnitRouter& unitRouter, const voxelSubsectionsMap& voxelSubsections, const SurfaceHeightfield& surface, const vec::vec3i start, const vec::vec3i destination,
         const std::vector<vec::vec3i>& givenPath, std::vector<vec::vec3i>& refinedPath, std::vector<vec::vec3>& visualPath);
 
     // Updates the round map display. Returns true if an update was performed.
     bool UpdateRoundMapDisplay(VoxelMap& voxelMap);
 
-    // Updates the view matrix given the viewer position and rotation.
-    void UpdateViewMatrix(const vec::vec3& position, const vec::quaternion& rotation);
+    // Updates the view matrix, as computed by the physics thread's camera.
+    void UpdateViewMatrix(const vec::mat4& viewMatrix);
 
     // Retrives a copy of the current view matrix.
     vec::mat4 GetViewMatrix();
@@ -68,6 +106,19 @@ private:
     // Mutex for updating the player vector. Acquire a WriteLock to add/remove players.
     SharedExclusiveLock playerVectorMutex;
     
+    // Projectile positions (with the damage type in w) for rendering.
+    SharedExclusiveLock projectileMutex;
+    std::vector<vec::vec4> projectileVisualData;
+    unsigned int projectileCount;
+
+    // What the local player can see, and the rows that changed since the last display update.
+    SharedExclusiveLock visibilityMutex;
+    std::vector<unsigned char> visibilityTexels;
+    int visibilityWidth;
+    int visibilityHeight;
+    int visibilityMinRow;
+    int visibilityMaxRow;
+
     SharedExclusiveLock mapUpdateMutex;
     bool roundMapUpdatedVisuals;
     bool roundMapUpdatedPhysics;
@@ -2,7 +2,6 @@
 #include <vector>
 #include "TechInfo.h"
 #include "ConfigManager.h"
-#include "ModelManager.h"
 
 class TechConfig : public ConfigManager
 {
@@ -20,7 +19,6 @@ private:
 
 public:
     static std::vector<Tech> Techs;
-    static sf::Image NoCurrentTechImage;
 
     TechConfig(const char* configName);
 };
@@ -0,0 +1,18 @@
+#pragma once
+#include <vector>
+#include <SFML\Graphics.hpp>
+
+// Holds the display images of the technologies, for the windows that show technologies.
+// Kept apart from TechConfig, so technologies can be loaded without any graphics.
+class TechImages
+{
+public:
+    // Display images of the technologies, indexed like TechConfig::Techs.
+    static std::vector<sf::Image> Images;
+
+    // Displayed when no technology is being researched.
+    static sf::Image NoCurrentTechImage;
+
+    // Loads the images for the technologies in TechConfig, which must already be loaded. Returns true on success.
+    static bool LoadImages();
+};
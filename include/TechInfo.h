@@ -1,5 +1,4 @@
 #pragma once
-#include <SFML\Graphics.hpp>
 #include <string>
 #include <vector>
 #include "TechConfig.h"
@@ -16,9 +15,6 @@ struct Tech
     // Display name of the technology. Varies based on the researched dependencies.
     std::vector<std::string> names;
 
-    // Display image of the technology.
-    sf::Image techImage;
-    
     // Time required to research this technology.
     int researchTimeSeconds;
 
@@ -4,6 +4,7 @@
 #include <SFGUI/Widgets.hpp>
 #include <vector>
 #include "ArmorConfig.h"
+#include "AssetLoader.h"
 #include "BodyConfig.h"
 #include "BuildingsWindow.h"
 #include "Constants.h"
@@ -18,6 +19,8 @@
 #include "Physics.h"
 #include "PhysicsConfig.h"
 #include "PhysicsOps.h"
+#include "PickingBuffer.h"
+#include "ProjectileVisual.h"
 #include "Player.h"
 #include "ResourcesWindow.h"
 #include "RouteVisual.h"
@@ -26,6 +29,7 @@
 #include "Statistics.h"
 #include "SyncBuffer.h"
 #include "TechConfig.h"
+#include "TechImages.h"
 #include "TechProgressWindow.h"
 #include "TechTreeWindow.h"
 #include "TurretConfig.h"
@@ -71,11 +75,22 @@ class TemperFine
     Viewer viewer;
     VoxelMap voxelMap;
     RouteVisual routeVisuals;
+    ProjectileVisual projectileVisual;
     Scenery scenery;
+
+    // Finds the voxel or unit under the cursor, if GraphicsConfig::HoverPicking is enabled.
+    PickingBuffer pickingBuffer;
     
     // Non-graphics threads
     sf::Thread physicsThread;
 
+    // Where the left mouse button was pressed, if it is held down. Used to distinguish clicks from drag-box selections.
+    bool isLeftMouseDown;
+    sf::Vector2i leftMouseDownPosition;
+
+    // Heap allocations made by the statistics overlay since its last update, shown by the overlay itself.
+    unsigned long long overlayAllocations;
+
     // Logs graphical settings so we have an idea of the OpenGL capabilities of the running machine.
     void LogGraphicsSettings();
 
@@ -91,6 +106,12 @@ class TemperFine
     // Renders the scene.
     void Render(sfg::Desktop& desktop, sf::RenderWindow& window, vec::mat4& viewMatrix);
 
+    // Renders the pick ids of the voxel map and units under the cursor into the picking buffer, and highlights whatever was last read back.
+    void RenderPicking(sf::RenderWindow& window, vec::mat4& viewMatrix);
+
+    // Runs the loading stages, which queue assets on the asset loader, then waits for every queued asset to load.
+    Constants::Status LoadQueuedAssets(AssetLoader& assetLoader);
+
 public:
     // Used just for data storage.
     static Constants Constant;
@@ -1,18 +1,22 @@
 #pragma once
 #include <map>
+#include <string>
+#include <vector>
 #include <GL/glew.h>
+#include "GlyphAtlas.h"
+#include "Vec.h"
 
 // Holds all of the bitmap data necessary for a character in the font.
 struct CharInfo
 {
-    // The texture X and Y locations where this character is stored.
-    int textureX;
-    int textureY;
+    // Where this character is stored in the glyph atlas, if it is drawn at all (spaces aren't, and neither are glyphs too large for the atlas).
+    GlyphLocation location;
+    bool isDrawn;
 
     // Amount that the unscaled parameters should be scaled by for this font.
     float scale;
 
-    // The character bitmap, in 8 bits-per-pixel format.
+    // The character bitmap, in 8 bits-per-pixel format. Kept so the character can be added back to the glyph atlas if it is evicted.
     unsigned char *characterBitmap;
 
     // Horizontal amount to advance for this character (unscaled)
@@ -21,6 +25,9 @@ struct CharInfo
     // Offset from the current horizontal position to the left edge of the character (unscaled)
     int leftSideBearing;
 
+    // Texels of distance around a distance field character, which aren't part of the character itself. Zero for bitmap characters.
+    int padding;
+
     // Character size and offsets.
     int width;
     int height;
@@ -38,15 +45,32 @@ struct TextInfo
     int ascent;
 };
 
-// Holds all the OpenGL information necessary to render a sentence
+// The characters of a sentence that are on a single glyph atlas page, which are drawn together.
+struct SentencePageRange
+{
+    int page;
+    GLsizei firstCharacter;
+    GLsizei characterCount;
+};
+
+// A vertex of a sentence quad, interleaved as it is sent to OpenGL.
+struct TextVertex
+{
+    vec::vec3 position;
+    vec::vec3 color;
+    vec::vec2 uv;
+};
+
+// Holds the laid out quads of a sentence, which are copied into the text batch each time it is rendered.
 struct SentenceInfo
 {
-    GLuint vao;
-    GLuint positionBuffer;
-    GLuint colorBuffer;
-    GLuint uvBuffer;
+    // Four vertices a character (spaces and the like have none), grouped by glyph atlas page. Positions are relative to the sentence.
+    std::vector<TextVertex> vertices;
+    std::vector<SentencePageRange> pageRanges;
 
-    GLsizei characterCount;
-    GLint *characterStartIndices;
-    GLsizei *characterVertexCounts;
+    // What the sentence was last updated with, so it can be laid out again once glyph atlas pages it uses have been evicted.
+    std::string text;
+    int pixelHeight;
+    vec::vec3 textColor;
+    unsigned int atlasEvictionCount;
 };
@@ -2,17 +2,17 @@
 #include <vector>
 #include "TurretInfo.h"
 #include "ConfigManager.h"
-#include "ModelManager.h"
+#include "ModelLoader.h"
 
 class TurretConfig : public ConfigManager
 {
-    ModelManager* modelManager;
+    ModelLoader* modelLoader;
 
 	virtual bool LoadConfigValues(std::vector<std::string>& lines);
 	virtual void WriteConfigValues();
 public:
     static std::vector<TurretType> Turrets;
 
-	TurretConfig(ModelManager* modelManager, const char* configName);
+	TurretConfig(ModelLoader* modelLoader, const char* configName);
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include "ArmorInfo.h"
 #include "Vec.h"
 
 // Represents a unit turret type
@@ -12,6 +13,20 @@ struct TurretType
     vec::vec3 translationOffset;
     vec::quaternion rotationOffset;
 
+    // How far away the turret can target units, in world units.
+    float range;
+
+    // How fast the turret turns, in radians per physics tick.
+    float slewRate;
+
+    // Physics ticks between shots.
+    unsigned int reloadTicks;
+
+    // What the turret fires, and how fast its projectiles leave the turret, in world units per physics tick.
+    DamageType damageType;
+    float damage;
+    float projectileSpeed;
+
     // Display name of the turret.
     std::string name;
 };
@@ -25,4 +40,17 @@ struct Turret
     // The current translation and rotation of the turret, w. r. t. the default location.
     vec::vec3 currentTranslation;
     vec::quaternion currentRotation;
+
+    // Rotation of the turret about its up axis, in radians. Zero points the turret forwards along the body.
+    float currentYaw;
+
+    // The unit the turret is targeting, and where that unit was last seen.
+    bool hasTarget;
+    unsigned int targetPlayerId;
+    unsigned int targetUnitId;
+    vec::vec3 targetPosition;
+
+    // Whether the turret has turned to face its target, and how many ticks until it can fire again.
+    bool isAimed;
+    unsigned int remainingReloadTicks;
 };
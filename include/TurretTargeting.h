@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <utility>
+#include <vector>
+#include "MapSections.h"
+#include "ProjectilePool.h"
+#include "SpatialHash.h"
+#include "TurretInfo.h"
+#include "Vec.h"
+#include "VisibilityGrid.h"
+
+// Aims unit turrets at enemy units and fires them. VALID FOR PHYSICS THREAD ONLY
+// Target acquisition (a spatial hash radius query over the units the player can see, followed by voxel line-of-sight checks) is time-sliced:
+//  each turret only rescans once every scan interval, in a slot staggered by its player, unit and turret index,
+//  so only a fixed fraction of turrets scan on any tick. Between scans, turrets cheaply track their current target.
+// Turrets can be updated in parallel, as each turret only writes its own state. Firing must happen serially.
+class TurretTargeting
+{
+public:
+    // The most candidates checked for line of sight per scan. The closest candidates are checked first.
+    static const unsigned int MaxLineOfSightChecks = 4;
+
+    // How close (in radians) a turret must be to facing its target to fire.
+    static float AimTolerance;
+
+    // Storage reused across turret updates. Each thread updating turrets needs its own.
+    struct SearchBuffers
+    {
+        std::vector<SpatialHashEntry> nearbyUnits;
+        std::vector<std::pair<float, unsigned int>> candidates;
+    };
+
+    TurretTargeting();
+
+    // Sets the number of ticks between each turret's target scans.
+    void Initialize(unsigned int scanInterval);
+
+    // Starts a new physics tick, moving on to the next scan slot.
+    void BeginTick();
+
+    // Returns true if the turret rescans for targets this tick.
+    bool IsScanTick(unsigned int playerId, unsigned int unitId, unsigned int turretIndex) const;
+
+    // Returns the number of target scans performed since the last BeginTick.
+    unsigned int GetScanCount() const;
+
+    // Sets up a new turret, facing forwards with no target.
+    static void ResetTurret(Turret& turret);
+
+    // Finds (on scan ticks) or tracks the turret's target, and turns the turret towards it. Also counts down the turret reload.
+    // The turret is placed on the body at the given position and rotation. New targets must be visible to the player, unless the visibility is null.
+    void UpdateTurret(Turret& turret, const TurretType& turretType, unsigned int playerId, unsigned int unitId, unsigned int turretIndex,
+        const vec::vec3& bodyPosition, const vec::quaternion& bodyRotation, const MapSections& mapSections, const SpatialHash& unitHash,
+        const VisibilityGrid* visibility, SearchBuffers& searchBuffers);
+
+    // Fires the turret if it's reloaded and aimed at a target, returning true if a projectile was fired.
+    // The projectile leaves along the turret's current heading, arcing to land at the target's distance.
+    static bool FireTurret(Turret& turret, const TurretType& turretType, unsigned int playerId,
+        const vec::vec3& bodyPosition, const vec::quaternion& bodyRotation, ProjectilePool& projectilePool);
+
+private:
+    unsigned int scanInterval;
+    unsigned int currentSlot;
+    std::atomic<unsigned int> scanCount;
+
+    // Returns the position projectiles leave the turret from.
+    static vec::vec3 GetTurretPosition(const Turret& turret, const TurretType& turretType, const vec::vec3& bodyPosition);
+
+    // Returns true if nothing on the map blocks the path between the two positions.
+    static bool HasLineOfSight(const MapSections& mapSections, const vec::vec3& start, const vec::vec3& end);
+
+    // Finds the closest visible enemy in range, returning true (and updating the turret target) if one was found.
+    static bool AcquireTarget(Turret& turret, const TurretType& turretType, unsigned int playerId, const vec::vec3& turretPosition,
+        const MapSections& mapSections, const SpatialHash& unitHash, const VisibilityGrid* visibility, SearchBuffers& searchBuffers);
+};
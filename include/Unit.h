@@ -2,12 +2,18 @@
 #include <vector>
 #include "ArmorInfo.h"
 #include "BodyInfo.h"
-#include "ModelManager.h"
+#include "CombatResolver.h"
+#include "LocalAvoidance.h"
+#include "MapSections.h"
+#include "ProjectilePool.h"
 #include "TurretInfo.h"
-#include "RouteVisual.h"
+#include "TurretTargeting.h"
 #include "SharedExclusiveLock.h"
 #include "Vec.h"
 
+class ModelManager;
+class RouteVisual;
+
 // Represents a physical unit.
 class Unit
 {
@@ -18,22 +24,54 @@ class Unit
         Unit(unsigned int armorTypeId, unsigned int bodyTypeId, std::vector<unsigned int> turretTypeIds, const vec::vec3 position, const vec::quaternion rotation);
         
         // Performs rendering updates that need to be done in the physics thread that don't draw anything.
+        // Rendering is implemented in UnitRendering.cpp, which isn't part of the headless simulation library.
         void PerformGuiThreadUpdates(RouteVisual& routeVisual);
 
         // Renders the unit.
-        void Render(ModelManager& modelManager, RouteVisual& unitRouter, bool isSelected, vec::mat4& projectionMatrix);
+        void Render(ModelManager& modelManager, RouteVisual& unitRouter, bool isSelected, bool isHovered, unsigned int pickId, vec::mat4& projectionMatrix);
+
+        // Renders only the unit models, for the PickingBuffer.
+        void RenderPicking(ModelManager& modelManager, unsigned int pickId, vec::mat4& projectionMatrix);
+
+        // Returns the physical location of the unit.
+        vec::vec3 GetPosition();
+
+        // Returns the radius of the sphere bounding the unit, used for collisions and selection.
+        float GetRadius() const;
 
-        // Returns true if the unit is currently in the path of the ray, false otherwise.
-        bool InRayPath(const vec::vec3& rayStart, const vec::vec3& rayVector);
+        // Returns how far the unit can see, in world units.
+        float GetSensorRadius() const;
 
         // Updates (or adds) an assigned route for a unit.
         void UpdateAssignedRoute(std::vector<vec::vec3> newAssignedRoute);
 
-        // Performs realistic unit motion.
+        // Advances the unit's target position along its route, updating the velocity the unit would like to move with.
+        // The unit itself is moved once local avoidance has run, in ApplyAvoidance.
         void MoveAlongRoute();
 
+        // Fills in the local avoidance state of the unit. Destroyed units are left out of avoidance.
+        void FillAvoidanceAgent(AvoidanceAgent& agent);
+
+        // Moves the unit with the velocity local avoidance computed for it.
+        // If that would take the unit off travellable voxels, the unit follows its route instead.
+        // The unit then hovers over the map surface, tilted to match any ramp it is on.
+        void ApplyAvoidance(const AvoidanceAgent& agent, const MapSections& mapSections);
+
+        // Aims the unit's turrets at enemy units, rescanning for targets on the turrets' scan ticks.
+        void UpdateTurrets(unsigned int playerId, unsigned int unitId, TurretTargeting& turretTargeting, const MapSections& mapSections,
+            const SpatialHash& unitHash, const VisibilityGrid& visibility, TurretTargeting::SearchBuffers& searchBuffers);
+
+        // Fires the unit's turrets that are reloaded and aimed. Returns the number of projectiles fired.
+        unsigned int FireTurrets(unsigned int playerId, ProjectilePool& projectilePool);
+
         // Moves the unit to the specified position.
         void Move(vec::vec3 pos);
+
+        // Applies combat hits to the unit's armor. Returns true (and fills in the player that destroyed the unit) if the unit was destroyed by the hits, false otherwise.
+        bool ApplyHits(const CombatHit* hits, unsigned int hitCount, unsigned int* killingPlayerId);
+
+        // Returns true if the unit has been destroyed. Destroyed units don't move, render, or take part in collisions.
+        bool IsDestroyed() const;
         
     private:
         SharedExclusiveLock unitPhysicsLock;
@@ -46,7 +84,16 @@ class Unit
         vec::vec3 position;
         vec::quaternion rotation;
 
-        // The route assigned to this unit.
+        // The rotation of the unit on flat ground. The unit rotation adds the tilt from the surface the unit is on.
+        vec::quaternion headingRotation;
+
+        // How the unit is moving. The preferred velocity follows the route, and the actual velocity includes avoiding other units.
+        vec::vec3 preferredVelocity;
+        vec::vec2 velocity;
+
+        // The route assigned to this unit, and where the unit should be on the route.
+        bool hasRoutePosition;
+        vec::vec3 routePosition;
         bool routeNeedsVisualUpdate;
         int routeVisualId;
         std::vector<vec::vec3> assignedRoute;
@@ -64,4 +111,8 @@ class Unit
 
         // The armor applied to this unit.
         Armor armor;
+        bool isDestroyed;
+
+        // Renders the body, armor, and turret models. The unit physics lock must be held.
+        void RenderModels(ModelManager& modelManager, bool isSelected, bool isHovered, unsigned int pickId, vec::mat4& projectionMatrix);
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include "MapInfo.h"
 #include "MapSections.h"
+#include "SurfaceHeightfield.h"
 
 // Performs unit routing refinement and visualization.
 class UnitRouter
@@ -9,12 +10,17 @@ class UnitRouter
         UnitRouter();
 
         // Refines a route among the voxels to minimize 'zig zags' and travel in a nice, constant path (or rotary path) to the final destination.
-        void RefineRoute(MapInfo* mapInfo, const voxelSubsectionsMap& voxelSubsections, const vec::vec3i start, const vec::vec3i destination,
+        // The route heights come from the surface heightfield.
+        void RefineRoute(MapInfo* mapInfo, const voxelSubsectionsMap& voxelSubsections, const SurfaceHeightfield& surface, const vec::vec3i start, const vec::vec3i destination,
             const std::vector<vec::vec3i>& givenPath, std::vector<vec::vec3i>& refinedPath, std::vector<vec::vec3>& visualPath);
 
         // Determines the height of a given voxel at the provided position for a unit.
+        // Prefer the surface heightfield, which only covers the top of each column but doesn't need to look at the voxel.
         static float GetHeightForVoxel(MapInfo* voxelMap, const vec::vec3i& voxelId, const vec::vec3& position);
 
+        // Returns how far above the surface routes (and the units following them) are.
+        static float GetHoverHeight();
+
     private:
         // Returns true if the average distance of the given points (excluding the start and end point) is > restingDistance * (1.0f + maxPercentage);
         bool IsStretchedPercentage(float restingDistanceAvg, const std::vector<vec::vec3>& currentPoints, float maxPercentage);
@@ -1,11 +1,20 @@
 #pragma once
 #include <cmath>
 
+// Matrix and quaternion multiplication use SSE or NEON where available. Define VEC_NO_SIMD to always use the scalar implementations.
+#if !defined(VEC_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define VEC_SIMD_SSE
+#include <xmmintrin.h>
+#elif !defined(VEC_NO_SIMD) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define VEC_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 // Holds basic vector, matrix and quaternion operations.
 // For more complicated operations, see MathOps, MatrixOps, PhysicsOps, and VecOps.
 namespace vec
 {
-    // 2-element vector. Supports float and int data types, using strong-template binding in the CPP.
+    // 2-element vector. Supports float and int data types, defined inline so hot loops can inline and vectorize the operators.
     template <typename T>
     class vec2T
     {
@@ -14,50 +23,114 @@ namespace vec
         T y;
 
         // Uninitialized
-        vec2T() { }
+        vec2T() = default;
 
         // Copy constructor
-        vec2T(const vec2T& other);
+        vec2T(const vec2T& other) = default;
 
         // Assignment operator
-        vec2T& operator=(const vec2T& other);
+        vec2T& operator=(const vec2T& other) = default;
 
         // Dual-value construction.
-        vec2T(T x, T y);
+        constexpr vec2T(T x, T y)
+            : x(x), y(y)
+        {
+        }
 
         // Single-value construction.
-        vec2T(T value);
+        constexpr vec2T(T value)
+            : x(value), y(value)
+        {
+        }
 
         // Overridden +-= operators
-        vec2T& operator+=(const vec2T& other);
-        vec2T& operator-=(const vec2T& other);
+        inline vec2T& operator+=(const vec2T& other)
+        {
+            x += other.x;
+            y += other.y;
+            return *this;
+        }
+
+        inline vec2T& operator-=(const vec2T& other)
+        {
+            x -= other.x;
+            y -= other.y;
+            return *this;
+        }
 
         // Overridden +- operators
-        vec2T operator+(const vec2T& other) const;
-        vec2T operator-() const;
-        vec2T operator-(const vec2T& other) const;
+        constexpr vec2T operator+(const vec2T& other) const
+        {
+            return vec2T(x + other.x, y + other.y);
+        }
+
+        constexpr vec2T operator-() const
+        {
+            return vec2T(-x, -y);
+        }
+
+        constexpr vec2T operator-(const vec2T& other) const
+        {
+            return vec2T(x - other.x, y - other.y);
+        }
 
         // Overridden * operators
-        vec2T operator*(const vec2T& other) const;
-        vec2T operator*(const T& other) const;
+        constexpr vec2T operator*(const vec2T& other) const
+        {
+            return vec2T(x * other.x, y * other.y);
+        }
+
+        constexpr vec2T operator*(const T& other) const
+        {
+            return vec2T(x * other, y * other);
+        }
 
         // Overridden *= operators
-        vec2T& operator*=(const vec2T& other);
-        vec2T& operator*=(const T& other);
+        inline vec2T& operator*=(const vec2T& other)
+        {
+            x *= other.x;
+            y *= other.y;
+            return *this;
+        }
+
+        inline vec2T& operator*=(const T& other)
+        {
+            x *= other;
+            y *= other;
+            return *this;
+        }
 
         // Overridden / operators.
-        vec2T operator/(const vec2T& other) const;
-        vec2T operator/(const T& other) const;
+        constexpr vec2T operator/(const vec2T& other) const
+        {
+            return vec2T(x / other.x, y / other.y);
+        }
+
+        constexpr vec2T operator/(const T& other) const
+        {
+            return vec2T(x / other, y / other);
+        }
 
         // Overridden /= operators.
-        vec2T& operator/=(const vec2T& other);
-        vec2T& operator/=(const T& other);
+        inline vec2T& operator/=(const vec2T& other)
+        {
+            x /= other.x;
+            y /= other.y;
+            return *this;
+        }
+
+        inline vec2T& operator/=(const T& other)
+        {
+            x /= other;
+            y /= other;
+            return *this;
+        }
     };
 
     typedef vec2T<float> vec2;
     typedef vec2T<int> vec2i;
 
-    // 3-element vector. Supports float and int data types, using strong-template binding in the CPP.
+    // 3-element vector. Supports float and int data types, defined inline like vec2T.
     template <typename T>
     class vec3T
     {
@@ -67,49 +140,118 @@ namespace vec
         T z;
 
         // Uninitialized
-        vec3T() { }
+        vec3T() = default;
 
         // Copy constructor
-        vec3T(const vec3T& other);
+        vec3T(const vec3T& other) = default;
 
         // Assignment operator
-        vec3T& operator=(const vec3T& other);
+        vec3T& operator=(const vec3T& other) = default;
 
         // Triple-value construction.
-        vec3T(T x, T y, T z);
+        constexpr vec3T(T x, T y, T z)
+            : x(x), y(y), z(z)
+        {
+        }
 
         // Single-value construction.
-        vec3T(T value);
+        constexpr vec3T(T value)
+            : x(value), y(value), z(value)
+        {
+        }
 
         // Direct-access operators. Dangerous, but useful for high-speed operations.
-        // Not stored in the C++ file as this is specific to vecT items.
         inline T& operator[](int n) { return *(&x + n); }
         inline const T& operator[](int n) const { return *(&x + n); }
 
         // Overridden +-= operators
-        vec3T& operator+=(const vec3T& other);
-        vec3T& operator-=(const vec3T& other);
+        inline vec3T& operator+=(const vec3T& other)
+        {
+            x += other.x;
+            y += other.y;
+            z += other.z;
+            return *this;
+        }
+
+        inline vec3T& operator-=(const vec3T& other)
+        {
+            x -= other.x;
+            y -= other.y;
+            z -= other.z;
+            return *this;
+        }
 
         // Overridden +- operators
-        vec3T operator+(const vec3T& other) const;
-        vec3T operator-() const;
-        vec3T operator-(const vec3T& other) const;
+        constexpr vec3T operator+(const vec3T& other) const
+        {
+            return vec3T(x + other.x, y + other.y, z + other.z);
+        }
+
+        constexpr vec3T operator-() const
+        {
+            return vec3T(-x, -y, -z);
+        }
+
+        constexpr vec3T operator-(const vec3T& other) const
+        {
+            return vec3T(x - other.x, y - other.y, z - other.z);
+        }
 
         // Overridden * operators
-        vec3T operator*(const vec3T& other) const;
-        vec3T operator*(const T& other) const;
+        constexpr vec3T operator*(const vec3T& other) const
+        {
+            return vec3T(x * other.x, y * other.y, z * other.z);
+        }
+
+        constexpr vec3T operator*(const T& other) const
+        {
+            return vec3T(x * other, y * other, z * other);
+        }
 
         // Overridden *= operators
-        vec3T& operator*=(const vec3T& other);
-        vec3T& operator*=(const T& other);
+        inline vec3T& operator*=(const vec3T& other)
+        {
+            x *= other.x;
+            y *= other.y;
+            z *= other.z;
+            return *this;
+        }
+
+        inline vec3T& operator*=(const T& other)
+        {
+            x *= other;
+            y *= other;
+            z *= other;
+            return *this;
+        }
 
         // Overridden / operators.
-        vec3T operator/(const vec3T& other) const;
-        vec3T operator/(const T& other) const;
+        constexpr vec3T operator/(const vec3T& other) const
+        {
+            return vec3T(x / other.x, y / other.y, z / other.z);
+        }
+
+        constexpr vec3T operator/(const T& other) const
+        {
+            return vec3T(x / other, y / other, z / other);
+        }
 
         // Overridden /= operators.
-        vec3T& operator/=(const vec3T& other);
-        vec3T& operator/=(const T& other);
+        inline vec3T& operator/=(const vec3T& other)
+        {
+            x /= other.x;
+            y /= other.y;
+            z /= other.z;
+            return *this;
+        }
+
+        inline vec3T& operator/=(const T& other)
+        {
+            x /= other;
+            y /= other;
+            z /= other;
+            return *this;
+        }
     };
 
     typedef vec3T<float> vec3;
@@ -129,11 +271,10 @@ namespace vec
         }
     };
 
-    // 4-element vector. Supports float and int data types, using strong-template binding in the CPP.
+    // 4-element vector. Supports float and int data types, defined inline like vec2T.
     template <typename T>
     class vec4T
     {
-    public:
     public:
         T x;
         T y;
@@ -141,49 +282,124 @@ namespace vec
         T w;
 
         // Uninitialized
-        vec4T() { }
+        vec4T() = default;
 
         // Copy constructor
-        vec4T(const vec4T& other);
+        vec4T(const vec4T& other) = default;
 
         // Assignment operator
-        vec4T& operator=(const vec4T& other);
+        vec4T& operator=(const vec4T& other) = default;
 
         // Quad-value construction.
-        vec4T(T x, T y, T z, T w);
+        constexpr vec4T(T x, T y, T z, T w)
+            : x(x), y(y), z(z), w(w)
+        {
+        }
 
         // Single-value construction.
-        vec4T(T value);
+        constexpr vec4T(T value)
+            : x(value), y(value), z(value), w(value)
+        {
+        }
 
         // Direct-access operators. Dangerous, but useful for high-speed operations.
-        // Not stored in the C++ file as this is specific to vecT items.
         inline T& operator[](int n) { return *(&x + n); }
         inline const T& operator[](int n) const { return *(&x + n); }
 
         // Overridden +-= operators
-        vec4T& operator+=(const vec4T& other);
-        vec4T& operator-=(const vec4T& other);
+        inline vec4T& operator+=(const vec4T& other)
+        {
+            x += other.x;
+            y += other.y;
+            z += other.z;
+            w += other.w;
+            return *this;
+        }
+
+        inline vec4T& operator-=(const vec4T& other)
+        {
+            x -= other.x;
+            y -= other.y;
+            z -= other.z;
+            w -= other.w;
+            return *this;
+        }
 
         // Overridden +- operators
-        vec4T operator+(const vec4T& other) const;
-        vec4T operator-() const;
-        vec4T operator-(const vec4T& other) const;
+        constexpr vec4T operator+(const vec4T& other) const
+        {
+            return vec4T(x + other.x, y + other.y, z + other.z, w + other.w);
+        }
+
+        constexpr vec4T operator-() const
+        {
+            return vec4T(-x, -y, -z, -w);
+        }
+
+        constexpr vec4T operator-(const vec4T& other) const
+        {
+            return vec4T(x - other.x, y - other.y, z - other.z, w - other.w);
+        }
 
         // Overridden * operators
-        vec4T operator*(const vec4T& other) const;
-        vec4T operator*(const T& other) const;
+        constexpr vec4T operator*(const vec4T& other) const
+        {
+            return vec4T(x * other.x, y * other.y, z * other.z, w * other.w);
+        }
+
+        constexpr vec4T operator*(const T& other) const
+        {
+            return vec4T(x * other, y * other, z * other, w * other);
+        }
 
         // Overridden *= operators
-        vec4T& operator*=(const vec4T& other);
-        vec4T& operator*=(const T& other);
+        inline vec4T& operator*=(const vec4T& other)
+        {
+            x *= other.x;
+            y *= other.y;
+            z *= other.z;
+            w *= other.w;
+            return *this;
+        }
+
+        inline vec4T& operator*=(const T& other)
+        {
+            x *= other;
+            y *= other;
+            z *= other;
+            w *= other;
+            return *this;
+        }
 
         // Overridden / operators.
-        vec4T operator/(const vec4T& other) const;
-        vec4T operator/(const T& other) const;
+        constexpr vec4T operator/(const vec4T& other) const
+        {
+            return vec4T(x / other.x, y / other.y, z / other.z, w / other.w);
+        }
+
+        constexpr vec4T operator/(const T& other) const
+        {
+            return vec4T(x / other, y / other, z / other, w / other);
+        }
 
         // Overridden /= operators.
-        vec4T& operator/=(const vec4T& other);
-        vec4T& operator/=(const T& other);
+        inline vec4T& operator/=(const vec4T& other)
+        {
+            x /= other.x;
+            y /= other.y;
+            z /= other.z;
+            w /= other.w;
+            return *this;
+        }
+
+        inline vec4T& operator/=(const T& other)
+        {
+            x /= other;
+            y /= other;
+            z /= other;
+            w /= other;
+            return *this;
+        }
     };
 
     typedef vec4T<float> vec4;
@@ -232,12 +448,10 @@ namespace vec
     class mat4
     {
     public:
-        mat4()
-        {
-        }
+        mat4() = default;
 
         // Copy constructor
-        mat4(const mat4& other);
+        mat4(const mat4& other) = default;
 
         mat4(const vec4& v0,
              const vec4& v1,
@@ -248,7 +462,7 @@ namespace vec
         mat4(const vec4& v);
 
         // Assignment operator
-        mat4& operator=(const mat4& other);
+        mat4& operator=(const mat4& other) = default;
 
         // Addition and substraction with other matrixes.
         mat4 operator+(const mat4& other) const;
@@ -281,21 +495,6 @@ namespace vec
         vec4 data[4];
     };
 
-    // Matrix-Vector multiplication. Results in a vector.
-    static inline vec4 operator*(const vec4& vec, const mat4& mat)
-    {
-        vec4 result = vec4(0.0f);
-        for (int m = 0; m < 4; m++)
-        {
-            for (int n = 0; n < 4; n++)
-            {
-                result[n] += vec[m] * mat[n][m];
-            }
-        }
-
-        return result;
-    }
-
     const vec3 DEFAULT_FORWARD_VECTOR = vec3(0, 0, -1.0f);
     const vec3 DEFAULT_UP_VECTOR = vec3(0, -1.0f, 0);
     const float NORMALIZE_TOLERANCE = 0.00001f;
@@ -309,18 +508,19 @@ namespace vec
         float z;
         float w;
 
-        quaternion()
-        {
-        }
+        quaternion() = default;
 
         // Assignment operator
-        quaternion& operator=(const quaternion& other);
+        quaternion& operator=(const quaternion& other) = default;
 
         // Copy operator
-        quaternion(const quaternion& other);
+        quaternion(const quaternion& other) = default;
 
         // Quad-assignment setup.
-        quaternion(float x, float y, float z, float w);
+        constexpr quaternion(float x, float y, float z, float w)
+            : x(x), y(y), z(z), w(w)
+        {
+        }
 
         // Performs special quaternion multiplication.
         quaternion operator*(const quaternion& q) const;
@@ -346,4 +546,154 @@ namespace vec
         // Returns the quaternion as a rotation matrix.
         mat4 asMatrix() const;
     };
+
+    // Scalar matrix and quaternion multiplication. Used when SIMD isn't available, and to check the SIMD results against.
+    namespace scalar
+    {
+        static inline mat4 Multiply(const mat4& first, const mat4& second)
+        {
+            mat4 result;
+            for (int j = 0; j < 4; j++)
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    float sum = 0.0f;
+                    for (int n = 0; n < 4; n++)
+                    {
+                        sum += first[n][i] * second[j][n];
+                    }
+
+                    result[j][i] = sum;
+                }
+            }
+
+            return result;
+        }
+
+        static inline vec4 Multiply(const vec4& vec, const mat4& mat)
+        {
+            vec4 result = vec4(0.0f);
+            for (int m = 0; m < 4; m++)
+            {
+                for (int n = 0; n < 4; n++)
+                {
+                    result[n] += vec[m] * mat[n][m];
+                }
+            }
+
+            return result;
+        }
+
+        static inline quaternion Multiply(const quaternion& first, const quaternion& second)
+        {
+            return quaternion(
+                first.w * second.x + first.x * second.w + first.y * second.z - first.z * second.y,
+                first.w * second.y + first.y * second.w + first.z * second.x - first.x * second.z,
+                first.w * second.z + first.z * second.w + first.x * second.y - first.y * second.x,
+                first.w * second.w - first.x * second.x - first.y * second.y - first.z * second.z);
+        }
+    }
+
+    // The SIMD versions add the products in the same order as the scalar versions and don't fuse multiplies with adds, so their results are identical.
+    // Matrix multiplication. Each result column is the sum of this matrix's columns, weighted by the other matrix's column.
+    inline mat4 mat4::operator*(const mat4& other) const
+    {
+#if defined(VEC_SIMD_SSE)
+        const __m128 column0 = _mm_loadu_ps(&data[0].x);
+        const __m128 column1 = _mm_loadu_ps(&data[1].x);
+        const __m128 column2 = _mm_loadu_ps(&data[2].x);
+        const __m128 column3 = _mm_loadu_ps(&data[3].x);
+
+        mat4 result;
+        for (int j = 0; j < 4; j++)
+        {
+            __m128 sum = _mm_mul_ps(column0, _mm_set1_ps(other.data[j].x));
+            sum = _mm_add_ps(sum, _mm_mul_ps(column1, _mm_set1_ps(other.data[j].y)));
+            sum = _mm_add_ps(sum, _mm_mul_ps(column2, _mm_set1_ps(other.data[j].z)));
+            sum = _mm_add_ps(sum, _mm_mul_ps(column3, _mm_set1_ps(other.data[j].w)));
+            _mm_storeu_ps(&result.data[j].x, sum);
+        }
+
+        return result;
+#elif defined(VEC_SIMD_NEON)
+        const float32x4_t column0 = vld1q_f32(&data[0].x);
+        const float32x4_t column1 = vld1q_f32(&data[1].x);
+        const float32x4_t column2 = vld1q_f32(&data[2].x);
+        const float32x4_t column3 = vld1q_f32(&data[3].x);
+
+        mat4 result;
+        for (int j = 0; j < 4; j++)
+        {
+            float32x4_t sum = vmulq_n_f32(column0, other.data[j].x);
+            sum = vaddq_f32(sum, vmulq_n_f32(column1, other.data[j].y));
+            sum = vaddq_f32(sum, vmulq_n_f32(column2, other.data[j].z));
+            sum = vaddq_f32(sum, vmulq_n_f32(column3, other.data[j].w));
+            vst1q_f32(&result.data[j].x, sum);
+        }
+
+        return result;
+#else
+        return scalar::Multiply(*this, other);
+#endif
+    }
+
+    // Matrix-Vector multiplication. Results in a vector.
+    static inline vec4 operator*(const vec4& vec, const mat4& mat)
+    {
+#if defined(VEC_SIMD_SSE)
+        // Transposing lets each vector element scale a row, instead of taking a dot product with each column.
+        __m128 row0 = _mm_loadu_ps(&mat[0].x);
+        __m128 row1 = _mm_loadu_ps(&mat[1].x);
+        __m128 row2 = _mm_loadu_ps(&mat[2].x);
+        __m128 row3 = _mm_loadu_ps(&mat[3].x);
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+        __m128 sum = _mm_mul_ps(row0, _mm_set1_ps(vec.x));
+        sum = _mm_add_ps(sum, _mm_mul_ps(row1, _mm_set1_ps(vec.y)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(row2, _mm_set1_ps(vec.z)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(row3, _mm_set1_ps(vec.w)));
+
+        vec4 result;
+        _mm_storeu_ps(&result.x, sum);
+        return result;
+#elif defined(VEC_SIMD_NEON)
+        // The de-interleaving load transposes the matrix into rows.
+        const float32x4x4_t rows = vld4q_f32(&mat[0].x);
+        float32x4_t sum = vmulq_n_f32(rows.val[0], vec.x);
+        sum = vaddq_f32(sum, vmulq_n_f32(rows.val[1], vec.y));
+        sum = vaddq_f32(sum, vmulq_n_f32(rows.val[2], vec.z));
+        sum = vaddq_f32(sum, vmulq_n_f32(rows.val[3], vec.w));
+
+        vec4 result;
+        vst1q_f32(&result.x, sum);
+        return result;
+#else
+        return scalar::Multiply(vec, mat);
+#endif
+    }
+
+    // Performs special quaternion multiplication.
+    inline quaternion quaternion::operator*(const quaternion& q) const
+    {
+#if defined(VEC_SIMD_SSE)
+        // Each column of the scalar version becomes a shuffled product, with the signs of the w terms flipped where the scalar version subtracts.
+        const __m128 first = _mm_loadu_ps(&x);
+        const __m128 second = _mm_loadu_ps(&q.x);
+        const __m128 negateW = _mm_set_ps(-0.0f, 0.0f, 0.0f, 0.0f);
+
+        __m128 sum = _mm_mul_ps(_mm_shuffle_ps(first, first, _MM_SHUFFLE(3, 3, 3, 3)), second);
+        sum = _mm_add_ps(sum, _mm_xor_ps(negateW,
+            _mm_mul_ps(_mm_shuffle_ps(first, first, _MM_SHUFFLE(0, 2, 1, 0)), _mm_shuffle_ps(second, second, _MM_SHUFFLE(0, 3, 3, 3)))));
+        sum = _mm_add_ps(sum, _mm_xor_ps(negateW,
+            _mm_mul_ps(_mm_shuffle_ps(first, first, _MM_SHUFFLE(1, 0, 2, 1)), _mm_shuffle_ps(second, second, _MM_SHUFFLE(1, 1, 0, 2)))));
+        sum = _mm_sub_ps(sum,
+            _mm_mul_ps(_mm_shuffle_ps(first, first, _MM_SHUFFLE(2, 1, 0, 2)), _mm_shuffle_ps(second, second, _MM_SHUFFLE(2, 0, 2, 1))));
+
+        quaternion result;
+        _mm_storeu_ps(&result.x, sum);
+        return result;
+#else
+        return scalar::Multiply(*this, q);
+#endif
+    }
 };
@@ -0,0 +1,111 @@
+#pragma once
+#include <vector>
+#include "MapSections.h"
+#include "Vec.h"
+
+// Fog of war state of a map column, as stored in the visibility texture.
+enum VisibilityState
+{
+    UNEXPLORED = 0,
+    EXPLORED = 128,
+    VISIBLE = 255
+};
+
+// What a player can see of the map, as one cell per (x, y) column of voxels. VALID FOR PHYSICS THREAD ONLY
+// Each of the player's units is a viewer that sees the columns within its sensor radius that aren't hidden behind taller terrain.
+// Cells count how many viewers see them, so a viewer that moves only removes what it saw before and adds what it sees now.
+// Viewers are only recomputed once they move to another column or height, and recomputation is capped by a time budget per update.
+class VisibilityGrid
+{
+public:
+    VisibilityGrid();
+
+    // Sizes the grid to the map, removing all viewers and marking every cell as unexplored.
+    void Reset(const MapSections& mapSections);
+
+    // Moves a viewer (adding it if it isn't in the grid yet). The sensor radius is in world units.
+    void UpdateViewer(unsigned int viewerId, const vec::vec3& position, float sensorRadius);
+
+    // Removes a viewer, along with everything only it could see. Does nothing if the viewer isn't in the grid.
+    void RemoveViewer(unsigned int viewerId);
+
+    // Recomputes what moved viewers see, in the order they moved, until the time budget (in milliseconds) runs out.
+    // Viewers that don't fit in the budget are recomputed on later updates. Returns true if no viewers are left waiting.
+    bool Update(const MapSections& mapSections, float budgetMs);
+
+    // Returns true if the world position is within a column the player can currently see.
+    bool IsVisible(const vec::vec3& position) const;
+
+    // Returns the number of viewers waiting to be recomputed.
+    unsigned int GetPendingViewerCount() const;
+
+    // Size of the grid, in cells.
+    int GetWidth() const;
+    int GetHeight() const;
+
+    // Returns the VisibilityState of each cell, indexed by y * width + x, for use as a texture.
+    const std::vector<unsigned char>& GetTexels() const;
+
+    // Returns true (and fills in the inclusive range of rows) if any texels changed since the last call, false otherwise.
+    bool TakeChangedRows(int* minRow, int* maxRow);
+
+private:
+    struct Viewer
+    {
+        bool isActive;
+        bool isPending;
+
+        // Where the viewer is now. The height is in voxels.
+        vec::vec2i column;
+        float eyeHeight;
+        int sensorCells;
+
+        // The cells the viewer saw when it was last recomputed.
+        std::vector<unsigned int> visibleCells;
+    };
+
+    // A cell along a ray, relative to the viewer, with the inverse of its distance from the viewer in cells
+    //  and its index within the square around the sensor radius.
+    struct RayStep
+    {
+        int xOffset;
+        int yOffset;
+        float inverseDistance;
+        unsigned int squareIndex;
+    };
+
+    int width;
+    int height;
+
+    std::vector<Viewer> viewers;
+    std::vector<unsigned int> pendingViewers;
+
+    // Number of viewers that see each cell, and the resulting texels.
+    std::vector<unsigned short> viewerCounts;
+    std::vector<unsigned char> texels;
+    int changedMinRow;
+    int changedMaxRow;
+
+    // Marks cells already added by the viewer being recomputed, so rays that overlap don't add a cell twice.
+    // Covers the square around the sensor radius, so it stays small enough to remain in cache.
+    std::vector<unsigned int> cellStamps;
+    unsigned int currentStamp;
+
+    // What the viewer being recomputed saw before, which is removed after adding what it sees now
+    //  so cells seen both times never drop to zero viewers.
+    std::vector<unsigned int> previousCells;
+
+    // The steps of every ray for a sensor radius (in cells), with rays stored one after another. Rebuilt if the radius changes.
+    std::vector<RayStep> raySteps;
+    std::vector<unsigned int> rayEnds;
+    int raySensorCells;
+
+    void QueueViewer(unsigned int viewerId);
+    void BuildRays(int sensorCells);
+    void AddRay(int xOffset, int yOffset, int sensorCells);
+    void RecomputeViewer(Viewer& viewer, const std::vector<unsigned char>& columnHeights);
+    void CastRay(Viewer& viewer, unsigned int rayStart, unsigned int rayEnd, const std::vector<unsigned char>& columnHeights);
+    void AddVisibleCell(Viewer& viewer, int x, int y, unsigned int squareIndex);
+    void RemoveCells(const std::vector<unsigned int>& cells);
+    void SetTexel(unsigned int cell, VisibilityState state);
+};
@@ -1,28 +1,46 @@
 #pragma once
 #include <GL\glew.h>
 #include <vector>
+#include "AssetLoader.h"
 #include "ImageManager.h"
 #include "MapInfo.h"
 #include "ModelManager.h"
 #include "ShaderManager.h"
-#include "Vertex.h"
 #include "Vec.h"
 
+// Per-instance data for a single voxel, computed on the CPU when the map is set up so the vertex shader only needs to orient and translate each vertex.
+struct VoxelInstance
+{
+    // Center of the voxel, in world coordinates.
+    vec::vec3 translation;
+
+    // Voxel x, y, and z indices, followed by the orientation (0-7, see voxelMapRender.vs).
+    GLshort indexOrientation[4];
+};
+
 // The game map of voxels.
 class VoxelMap
 {
     public:
         VoxelMap();
 
-        // Sets up the voxel map OpenGL data and compiles the associated shader. Note we only use the model manager to get at UV data easily.
-        bool Initialize(ImageManager& imageManager, ModelManager& modelManager, ShaderManager& shaderManager);
+        // Compiles the associated shader and queues the voxel textures and models on the asset loader, setting up the voxel map OpenGL data
+        //  once they have loaded. Note we only use the model manager to get at the vertex data easily.
+        bool Initialize(ModelManager& modelManager, ShaderManager& shaderManager, AssetLoader& assetLoader);
 
         // Sets up the VoxelMap from the provided map info.
         void SetupFromMap(const MapInfo& mapInfo);
 
+        // Updates the given rows of the fog of war from the visibility grid texels (see VisibilityState).
+        // Returns false if the visibility grid doesn't match the current map, true otherwise.
+        bool UpdateVisibility(const unsigned char* visibilityTexels, int width, int height, int minRow, int maxRow);
+
         // Sets the currently-selected voxel, which renders specially.
         void SetSelectedVoxel(const vec::vec3i& selectedVoxel);
 
+        // Sets the map index of the voxel under the cursor (or -1 for none), which is highlighted less than the selected voxel.
+        void SetHoveredVoxel(int hoveredVoxelIndex);
+
         // Renders the voxel map, using the current viewer position matrix.
         void Render(const vec::mat4& projectionMatrix);
 
@@ -33,43 +51,60 @@ class VoxelMap
         bool CreateVoxelShader(ShaderManager& shaderManager);
         void InitOpenGl();
 
-        // Loads voxel textures, returning the ImageManager ID of the textures.
-        std::vector<GLuint> LoadVoxelTextures(ImageManager& imageManager);
+        // Queues decoding the voxel textures, adding the tasks that decode them.
+        void QueueVoxelTextures(AssetLoader& assetLoader, std::vector<AssetTaskId>& loadTasks);
+
+        // Sends the decoded voxel textures to OpenGL as the layers of one mipmapped texture array, then frees the decoded images.
+        bool CreateVoxelTextureArray();
+
+        // Combines the loaded voxel models into one set of buffers.
+        bool CombineVoxels(ModelManager& modelManager, const std::vector<int>& voxelModelIds);
 
         // Loads models, returning the ModelManager ID of the models.
         std::vector<int> LoadModels(ModelManager& modelManager);
 
+        // Points the instance attributes at the instances starting at the given offset.
+        void BindInstances(int instanceOffset);
+
         // Minimal map data required for rendering. The rest of the data is stored in the texture.
         bool hasValidMap;
         int xMapSize;
         int yMapSize;
-        int totalVoxelSize;
 
-        // The textures for all of the voxels in a single nicely-packed image.
-        GLuint voxelTextureId;
+        // The textures for all of the voxels, with one layer per voxel model.
+        GLuint voxelTextureArray;
+
+        // Each voxel texture as decoded, until it has been sent to the texture array.
+        std::vector<DecodedImage> voxelImages;
 
         // The Voxel rendering program and locations of textures we need within it.
         GLuint voxelMapRenderProgram;
         GLuint projLocation;
         GLuint xyLengthsLocation;
-        GLuint currentVoxelIdLocation;
 
         GLuint selectedIndexLocation;
         vec::vec3i selectedVoxel;
 
+        GLuint hoveredIndexLocation;
+        int hoveredVoxelIndex;
+
         GLuint textureLocation;
-        GLuint voxelTopTextureLocation;
+        GLuint textureLayerLocation;
+        GLuint visibilityTextureLocation;
 
-        // Actual texture for voxel type, orientation, and property
-        GLuint voxelTopTexture;
+        // Fog of war, as one texel per (x, y) column of the map.
+        GLuint visibilityTexture;
 
-        // Vertices and associated OpenGL functionality
-        universalVertices voxelVertices;
+        // Where each voxel model is in the index buffer, and associated OpenGL functionality
         std::vector<int> voxelIndexOffsets;
         std::vector<int> voxelIndexCounts;
 
         GLuint vao;
-        GLuint positionBuffer;
+        GLuint vertexBuffer;
         GLuint indexBuffer;
-        GLuint uvBuffer;
+
+        // Instances of the non-air voxels, grouped by voxel type so each voxel model is drawn only for its own voxels.
+        GLuint instanceBuffer;
+        std::vector<int> voxelInstanceOffsets;
+        std::vector<int> voxelInstanceCounts;
 };
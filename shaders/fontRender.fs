@@ -1,6 +1,7 @@
 #version 400 core
 
 uniform sampler2D fontimage;
+uniform bool isDistanceField;
 
 out vec4 color;
 
@@ -12,6 +13,14 @@ in VS_OUT
 
 void main(void)
 {
-    // Scale each color of the provided object by the given color.
-    color = fs_in.color * texture2D(fontimage, fs_in.texPos);
+    // Scale each color of the provided object by the given color. The font image is single-channel coverage, or distance for distance fields.
+    float coverage = texture(fontimage, fs_in.texPos).r;
+    if (isDistanceField)
+    {
+        // The edge is at 0.5, and is smoothed over about a pixel on screen whatever size the text is drawn at.
+        float edgeWidth = 0.7 * fwidth(coverage);
+        coverage = smoothstep(0.5 - edgeWidth, 0.5 + edgeWidth, coverage);
+    }
+
+    color = fs_in.color * vec4(coverage);
 }
\ No newline at end of file
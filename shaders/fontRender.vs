@@ -10,14 +10,13 @@ out VS_OUT
     vec2 texPos;
 } vs_out;
 
-uniform mat4 mv_matrix;
 uniform mat4 proj_matrix;
 
-// Perform our position and projection transformations, and pass-through the color / texture data
+// Perform our projection transformation (positions are already transformed by the sentence), and pass-through the color / texture data
 void main(void)
 {
     vs_out.color = vec4(color.x, color.y, color.z, 1);
     vs_out.texPos = texPos;
     
-    gl_Position = proj_matrix * mv_matrix * vec4(position, 1);
+    gl_Position = proj_matrix * vec4(position, 1);
 }
\ No newline at end of file
@@ -2,8 +2,12 @@
 
 uniform sampler2D modelTexture;
 uniform float selectionFactor;
+uniform uint modelPickId;
 
-out vec4 color;
+layout (location = 0) out vec4 color;
+
+// Only written when rendering to the PickingBuffer.
+layout (location = 1) out uint pickId;
 
 in VS_OUT
 {
@@ -14,4 +18,5 @@ void main(void)
 {
     // Scale each color of the provided object by the given color.
     color = texture2D(modelTexture, fs_in.uvPos) + vec4(selectionFactor, selectionFactor, selectionFactor, 0.0f);
+    pickId = modelPickId;
 }
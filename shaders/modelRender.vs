@@ -11,9 +11,13 @@ out VS_OUT
 uniform mat4 mvMatrix;
 uniform mat4 projMatrix;
 
+// Positions may be packed relative to the model bounds, see ModelManager::ResetOpenGlModelData.
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+
 // Perform our position and projection transformations, and pass-through the color / texture data
 void main(void)
 {
     vs_out.uvPos = uvPos;
-    gl_Position = projMatrix * mvMatrix * vec4(position, 1);
+    gl_Position = projMatrix * mvMatrix * vec4(position * positionScale + positionOffset, 1);
 }
\ No newline at end of file
@@ -0,0 +1,13 @@
+#version 400 core
+
+out vec4 color;
+
+in VS_OUT
+{
+    vec3 color;
+} fs_in;
+
+void main(void)
+{
+    color = vec4(fs_in.color, 1.0f);
+}
\ No newline at end of file
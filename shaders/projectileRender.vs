@@ -0,0 +1,33 @@
+#version 400
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec4 projectile;
+
+out VS_OUT
+{
+    vec3 color;
+} vs_out;
+
+uniform mat4 projMatrix;
+
+// Sizes and colors each projectile by its damage type (stored in w), then moves it to the projectile position.
+void main(void)
+{
+    int damageType = int(projectile.w + 0.5f);
+    float size = 0.06f;
+    vs_out.color = vec3(1.0f, 0.9f, 0.4f);
+    if (damageType == 1)
+    {
+        // Rocket
+        size = 0.20f;
+        vs_out.color = vec3(1.0f, 0.4f, 0.1f);
+    }
+    else if (damageType == 2)
+    {
+        // Cannon
+        size = 0.14f;
+        vs_out.color = vec3(0.6f, 0.6f, 0.6f);
+    }
+
+    gl_Position = projMatrix * vec4(projectile.xyz + position * size, 1);
+}
\ No newline at end of file
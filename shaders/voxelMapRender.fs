@@ -1,16 +1,26 @@
 #version 400 core
 
-uniform sampler2D voxelTextures;
+// One layer per voxel model, with the layer of the voxel model being drawn.
+uniform sampler2DArray voxelTextures;
+uniform int voxelTextureLayer;
 
-out vec4 color;
+layout (location = 0) out vec4 color;
+
+// Only written when rendering to the PickingBuffer.
+layout (location = 1) out uint pickId;
 
 in GS_OUT
 {
     vec2 uvPos;
     vec3 color;
+    float visibility;
+    flat uint pickId;
 } fs_in;
 
 void main(void)
 {
-    color = texture2D(voxelTextures, fs_in.uvPos) + vec4(fs_in.color, 0.0f);
+    // Unexplored areas are nearly black, and explored areas that can't be seen are dimmed.
+    float fogFactor = 0.1f + 0.9f * fs_in.visibility;
+    color = (texture(voxelTextures, vec3(fs_in.uvPos, voxelTextureLayer)) + vec4(fs_in.color, 0.0f)) * vec4(vec3(fogFactor), 1.0f);
+    pickId = fs_in.pickId;
 }
@@ -7,39 +7,51 @@ layout (max_vertices = 3) out;
 in VS_OUT
 {
     vec2 uvPos;
-    uint voxelId;
     ivec3 xyzIndex;
+    float visibility;
 } colorUV [];
 
 out GS_OUT
 {
     vec2 uvPos;
     vec3 color;
+    float visibility;
+    flat uint pickId;
 } colorUVOut;
 
-uniform uint currentVoxelId;
 uniform ivec3 selectedIndex;
+uniform ivec2 xyLengths;
+
+// Map index of the voxel under the cursor, or -1.
+uniform int hoveredIndex;
 
 void main(void)
 {
-    // Only draw the current voxel ID.
-    if (colorUV[0].voxelId == currentVoxelId)
+    ivec3 xyzIndex = colorUV[0].xyzIndex;
+    int voxelIndex = xyzIndex.x + xyLengths.x * (xyzIndex.y + xyLengths.y * xyzIndex.z);
+
+    vec3 selectionFactor = vec3(0.0f);
+    if (selectedIndex == xyzIndex)
+    {
+        selectionFactor = vec3(0.40f);
+    }
+    else if (hoveredIndex == voxelIndex)
+    {
+        selectionFactor = vec3(0.20f);
+    }
+
+    for (int i = 0; i < gl_in.length(); i++)
     {
-        vec3 selectionFactor = vec3(0.0f);
-        if (selectedIndex == colorUV[0].xyzIndex)
-        {
-            selectionFactor = vec3(0.40f);
-        }
-
-        for (int i = 0; i < gl_in.length(); i++)
-        {
-            gl_Position = gl_in[i].gl_Position;
-
-            colorUVOut.color = selectionFactor;
-            colorUVOut.uvPos = colorUV[i].uvPos;
-            EmitVertex();
-        }
-
-        EndPrimitive();
+        gl_Position = gl_in[i].gl_Position;
+
+        colorUVOut.color = selectionFactor;
+        colorUVOut.uvPos = colorUV[i].uvPos;
+        colorUVOut.visibility = colorUV[i].visibility;
+
+        // Matches PickingBuffer::GetVoxelPickId.
+        colorUVOut.pickId = uint(voxelIndex) + 1u;
+        EmitVertex();
     }
+
+    EndPrimitive();
 }
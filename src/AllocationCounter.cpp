@@ -0,0 +1,70 @@
+#include <cstdlib>
+#include <new>
+#include "AllocationCounter.h"
+
+// Per thread, so allocations on the physics and loading threads don't show up in counts taken on the GUI thread.
+static thread_local unsigned long long threadAllocations = 0;
+
+unsigned long long AllocationCounter::GetThreadAllocations()
+{
+    return threadAllocations;
+}
+
+void* operator new(std::size_t size)
+{
+    ++threadAllocations;
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    ++threadAllocations;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+// C++14 compilers call the sized versions when the size is known, which would otherwise go to the default delete and its allocator.
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
@@ -79,7 +79,7 @@ bool ArmorConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
         // Finally, given the model name, load in the armor model.
         std::stringstream armorFileName;
         armorFileName << "models/armors/" << modelLines[0];
-        armorType.armorModelId = modelManager->LoadModel(armorFileName.str().c_str());
+        armorType.armorModelId = modelLoader->LoadModel(armorFileName.str().c_str());
         if (armorType.armorModelId == 0)
         {
             Logger::Log("Armor model loading failed!");
@@ -99,7 +99,7 @@ void ArmorConfig::WriteConfigValues()
 	// Cannot write to unit-type configuration files.
 }
 
-ArmorConfig::ArmorConfig(ModelManager *modelManager, const char* configName)
-	: ConfigManager(configName), modelManager(modelManager)
+ArmorConfig::ArmorConfig(ModelLoader* modelLoader, const char* configName)
+	: ConfigManager(configName), modelLoader(modelLoader)
 {
 }
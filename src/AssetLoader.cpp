@@ -0,0 +1,262 @@
+#include "AssetLoader.h"
+#include "Logger.h"
+
+AssetLoader::AssetLoader()
+    : incompleteTasks(0), hasFailed(false), startTime(std::chrono::high_resolution_clock::now()), threadCount(1), isRunning(false)
+{
+}
+
+AssetLoader::~AssetLoader()
+{
+    StopWorkers();
+}
+
+void AssetLoader::Initialize(unsigned int workerCount)
+{
+    StopWorkers();
+
+    startTime = std::chrono::high_resolution_clock::now();
+    threadCount = workerCount + 1;
+    isRunning = true;
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        workers.push_back(std::thread(&AssetLoader::WorkerLoop, this, i + 1));
+    }
+}
+
+unsigned int AssetLoader::GetThreadCount() const
+{
+    return threadCount;
+}
+
+AssetTaskId AssetLoader::AddWorkTask(const char* stage, const AssetWorkFunction& workFunction, const std::vector<AssetTaskId>& dependencies)
+{
+    return AddTask(stage, workFunction, AssetUploadFunction(), false, dependencies);
+}
+
+AssetTaskId AssetLoader::AddUploadTask(const char* stage, const AssetUploadFunction& uploadFunction, const std::vector<AssetTaskId>& dependencies)
+{
+    return AddTask(stage, AssetWorkFunction(), uploadFunction, true, dependencies);
+}
+
+AssetTaskId AssetLoader::AddTask(const char* stage, const AssetWorkFunction& workFunction, const AssetUploadFunction& uploadFunction,
+    bool isUpload, const std::vector<AssetTaskId>& dependencies)
+{
+    std::lock_guard<std::mutex> lock(taskMutex);
+
+    AssetTaskId taskId = (AssetTaskId)tasks.size();
+    tasks.push_back(Task());
+
+    Task& task = tasks.back();
+    task.stage = stage;
+    task.workFunction = workFunction;
+    task.uploadFunction = uploadFunction;
+    task.isUpload = isUpload;
+    task.isComplete = false;
+    task.remainingDependencies = 0;
+
+    for (AssetTaskId dependency : dependencies)
+    {
+        if (!tasks[dependency].isComplete)
+        {
+            ++task.remainingDependencies;
+            tasks[dependency].dependents.push_back(taskId);
+        }
+    }
+
+    ++GetStageTime(task.stage).taskCount;
+    ++incompleteTasks;
+    if (task.remainingDependencies == 0)
+    {
+        (isUpload ? readyUploadTasks : readyWorkTasks).push_back(taskId);
+        taskCondition.notify_all();
+    }
+
+    return taskId;
+}
+
+bool AssetLoader::RunStage(const char* stage, const std::function<bool()>& function)
+{
+    std::chrono::high_resolution_clock::time_point stageStartTime = std::chrono::high_resolution_clock::now();
+    bool succeeded = function();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - stageStartTime).count();
+
+    std::lock_guard<std::mutex> lock(taskMutex);
+    StageTime& stageTime = GetStageTime(stage);
+    ++stageTime.taskCount;
+    stageTime.glThreadMs += ms;
+    stageTime.completedMs = GetElapsedMs();
+    return succeeded;
+}
+
+bool AssetLoader::Finish()
+{
+    while (true)
+    {
+        AssetTaskId taskId;
+        {
+            std::unique_lock<std::mutex> lock(taskMutex);
+            taskCondition.wait(lock, [this] { return incompleteTasks == 0 || !readyUploadTasks.empty() || !readyWorkTasks.empty(); });
+
+            // Uploads first, as only this thread can run them, while worker tasks can be left to the workers.
+            if (!readyUploadTasks.empty())
+            {
+                taskId = readyUploadTasks.front();
+                readyUploadTasks.pop_front();
+            }
+            else if (!readyWorkTasks.empty())
+            {
+                taskId = readyWorkTasks.front();
+                readyWorkTasks.pop_front();
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        RunTask(taskId, 0);
+    }
+
+    StopWorkers();
+
+    std::lock_guard<std::mutex> lock(taskMutex);
+    return !hasFailed;
+}
+
+void AssetLoader::LogStageTimes() const
+{
+    std::lock_guard<std::mutex> lock(taskMutex);
+    for (const StageTime& stageTime : stageTimes)
+    {
+        Logger::Log(stageTime.stage, ": ", stageTime.taskCount, " task(s), ", stageTime.workerMs, " ms on workers, ", stageTime.glThreadMs,
+            " ms on the GL thread, done ", stageTime.completedMs, " ms into loading.");
+    }
+
+    Logger::Log("Assets loaded in ", GetElapsedMs(), " ms with ", threadCount, " thread(s).");
+}
+
+void AssetLoader::RunTask(AssetTaskId taskId, unsigned int threadIndex)
+{
+    // Once a task fails, startup is abandoned, so remaining tasks complete without running.
+    // The task stays in place as tasks are added, but the deque itself can only be indexed with the lock held.
+    Task* task;
+    bool shouldRun;
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        task = &tasks[taskId];
+        shouldRun = !hasFailed;
+    }
+
+    bool succeeded = true;
+    double ms = 0.0;
+    if (shouldRun)
+    {
+        std::chrono::high_resolution_clock::time_point taskStartTime = std::chrono::high_resolution_clock::now();
+        succeeded = task->isUpload ? task->uploadFunction() : task->workFunction(threadIndex);
+        ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - taskStartTime).count();
+    }
+
+    std::lock_guard<std::mutex> lock(taskMutex);
+    if (!succeeded)
+    {
+        Logger::LogError("Asset loading failed in the '", task->stage, "' stage.");
+    }
+
+    CompleteTask(taskId, succeeded, ms, threadIndex == 0);
+}
+
+void AssetLoader::CompleteTask(AssetTaskId taskId, bool succeeded, double ms, bool onGlThread)
+{
+    Task& task = tasks[taskId];
+    task.isComplete = true;
+    hasFailed = hasFailed || !succeeded;
+
+    StageTime& stageTime = GetStageTime(task.stage);
+    (onGlThread ? stageTime.glThreadMs : stageTime.workerMs) += ms;
+    stageTime.completedMs = GetElapsedMs();
+
+    for (AssetTaskId dependentId : task.dependents)
+    {
+        Task& dependent = tasks[dependentId];
+        --dependent.remainingDependencies;
+        if (dependent.remainingDependencies == 0)
+        {
+            (dependent.isUpload ? readyUploadTasks : readyWorkTasks).push_back(dependentId);
+        }
+    }
+
+    // The functions may hold onto loading data, which isn't needed once the task has run.
+    task.workFunction = AssetWorkFunction();
+    task.uploadFunction = AssetUploadFunction();
+
+    --incompleteTasks;
+    taskCondition.notify_all();
+}
+
+AssetLoader::StageTime& AssetLoader::GetStageTime(const std::string& stage)
+{
+    for (StageTime& stageTime : stageTimes)
+    {
+        if (stageTime.stage == stage)
+        {
+            return stageTime;
+        }
+    }
+
+    StageTime stageTime;
+    stageTime.stage = stage;
+    stageTime.taskCount = 0;
+    stageTime.workerMs = 0.0;
+    stageTime.glThreadMs = 0.0;
+    stageTime.completedMs = 0.0;
+    stageTimes.push_back(stageTime);
+    return stageTimes.back();
+}
+
+double AssetLoader::GetElapsedMs() const
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void AssetLoader::WorkerLoop(unsigned int threadIndex)
+{
+    while (true)
+    {
+        AssetTaskId taskId;
+        {
+            std::unique_lock<std::mutex> lock(taskMutex);
+            taskCondition.wait(lock, [this] { return !isRunning || !readyWorkTasks.empty(); });
+            if (readyWorkTasks.empty())
+            {
+                return;
+            }
+
+            taskId = readyWorkTasks.front();
+            readyWorkTasks.pop_front();
+        }
+
+        RunTask(taskId, threadIndex);
+    }
+}
+
+void AssetLoader::Cancel()
+{
+    StopWorkers();
+}
+
+void AssetLoader::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        isRunning = false;
+    }
+
+    taskCondition.notify_all();
+    for (unsigned int i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    workers.clear();
+}
@@ -25,17 +25,20 @@ bool BodyConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
         std::vector<std::string> modelLines;
 
         StringUtils::Split(configFileLines[lineCounter + 1], StringUtils::Space, true, modelLines);
-        if (modelLines.size() != 3)
+        if (modelLines.size() != 6)
         {
-            Logger::LogError("Expected 3 elements for a model body configuration line.");
+            Logger::LogError("Expected 6 elements for a model body configuration line.");
             return false;
         }
 
         int maxTurrets;
         if (!StringUtils::ParseIntFromString(modelLines[1], maxTurrets) ||
-            !StringUtils::ParseFloatFromString(modelLines[2], bodyType.scale))
+            !StringUtils::ParseFloatFromString(modelLines[2], bodyType.scale) ||
+            !StringUtils::ParseFloatFromString(modelLines[3], bodyType.radius) ||
+            !StringUtils::ParseFloatFromString(modelLines[4], bodyType.sensorRadius) ||
+            !StringUtils::ParseFloatFromString(modelLines[5], bodyType.maxSpeed))
         {
-            Logger::LogError("Error parsing the body max turrets and scale offsets.");
+            Logger::LogError("Error parsing the body max turrets, scale offsets, radius, sensor radius, and max speed.");
             return false;
         }
 
@@ -44,7 +47,7 @@ bool BodyConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
         // Finally, given the model name, load in the turret model.
         std::stringstream bodyFileName;
         bodyFileName << "models/bodies/" << modelLines[0];
-        bodyType.bodyModelId = modelManager->LoadModel(bodyFileName.str().c_str());
+        bodyType.bodyModelId = modelLoader->LoadModel(bodyFileName.str().c_str());
         if (bodyType.bodyModelId == 0)
         {
             Logger::Log("Body model loading failed!");
@@ -64,7 +67,7 @@ void BodyConfig::WriteConfigValues()
 	// Cannot write to unit-type configuration files.
 }
 
-BodyConfig::BodyConfig(ModelManager *modelManager, const char* configName)
-	: ConfigManager(configName), modelManager(modelManager)
+BodyConfig::BodyConfig(ModelLoader* modelLoader, const char* configName)
+	: ConfigManager(configName), modelLoader(modelLoader)
 {
 }
@@ -0,0 +1,98 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include "CacheFile.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+unsigned long long CacheFile::HashContents(const char* data, size_t length)
+{
+    // FNV-1a, but mixing in eight bytes at a time, as hashing larger source files byte by byte takes longer than reading what was cached from them.
+    unsigned long long hash = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + sizeof(unsigned long long) <= length; i += sizeof(unsigned long long))
+    {
+        unsigned long long word;
+        memcpy(&word, data + i, sizeof(unsigned long long));
+        hash = (hash ^ word) * 1099511628211ull;
+        hash ^= hash >> 32;
+    }
+
+    for (; i < length; i++)
+    {
+        hash = (hash ^ (unsigned char)data[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+std::string CacheFile::GetCacheFilePath(const std::string& cacheDirectory, const char* sourceFilename, const char* cacheExtension)
+{
+    // models/voxels/voxel_0.obj is baked to <cache directory>/models_voxels_voxel_0.tfmesh
+    std::string cacheName(sourceFilename);
+    while (cacheName.compare(0, 2, "./") == 0 || cacheName.compare(0, 2, ".\\") == 0)
+    {
+        cacheName.erase(0, 2);
+    }
+
+    size_t extensionStart = cacheName.find_last_of('.');
+    if (extensionStart != std::string::npos && extensionStart != 0 && cacheName.find_first_of("/\\", extensionStart) == std::string::npos)
+    {
+        cacheName.resize(extensionStart);
+    }
+
+    for (char& character : cacheName)
+    {
+        character = (character == '/' || character == '\\' || character == ':') ? '_' : character;
+    }
+
+    return cacheDirectory + "/" + cacheName + cacheExtension;
+}
+
+bool CacheFile::CreateDirectories(const std::string& directory)
+{
+    for (size_t i = 1; i <= directory.size(); i++)
+    {
+        if (i == directory.size() || directory[i] == '/' || directory[i] == '\\')
+        {
+            std::string parentDirectory = directory.substr(0, i);
+#ifdef _WIN32
+            int result = _mkdir(parentDirectory.c_str());
+#else
+            int result = mkdir(parentDirectory.c_str(), 0755);
+#endif
+            if (result != 0 && errno != EEXIST)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool CacheFile::Write(const std::string& path, const void* header, size_t headerSize, const void* data, size_t dataSize)
+{
+    std::string temporaryPath = path + ".tmp";
+    FILE* file = fopen(temporaryPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    bool isWritten = fwrite(header, 1, headerSize, file) == headerSize && fwrite(data, 1, dataSize, file) == dataSize;
+    isWritten = fclose(file) == 0 && isWritten;
+
+    remove(path.c_str());
+    if (!isWritten || rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        remove(temporaryPath.c_str());
+        return false;
+    }
+
+    return true;
+}
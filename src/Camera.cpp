@@ -0,0 +1,116 @@
+#include "Camera.h"
+#include "MatrixOps.h"
+
+Camera::Camera()
+    : position(0.0f), orientation(0.0f, 0.0f, 0.0f, 1.0f), projectionMatrix(vec::mat4::identity()),
+      viewDirty(true), inverseProjectionDirty(true), viewProjectionDirty(true)
+{
+}
+
+void Camera::SetPerspective(float fovY, float aspect, float nearPlane, float farPlane)
+{
+    projectionMatrix = MatrixOps::Perspective(fovY, aspect, nearPlane, farPlane);
+    inverseProjectionDirty = true;
+    viewProjectionDirty = true;
+}
+
+void Camera::SetView(const vec::vec3& position, const vec::quaternion& orientation)
+{
+    if (position.x == this->position.x && position.y == this->position.y && position.z == this->position.z &&
+        orientation.x == this->orientation.x && orientation.y == this->orientation.y && orientation.z == this->orientation.z && orientation.w == this->orientation.w)
+    {
+        return;
+    }
+
+    this->position = position;
+    this->orientation = orientation;
+    viewDirty = true;
+    viewProjectionDirty = true;
+}
+
+const vec::vec3& Camera::GetPosition() const
+{
+    return position;
+}
+
+const vec::mat4& Camera::GetProjectionMatrix() const
+{
+    return projectionMatrix;
+}
+
+const vec::mat4& Camera::GetViewMatrix()
+{
+    UpdateView();
+    return viewMatrix;
+}
+
+const vec::mat4& Camera::GetViewRotationMatrix()
+{
+    UpdateView();
+    return viewRotationMatrix;
+}
+
+const vec::mat4& Camera::GetInverseProjectionMatrix()
+{
+    if (inverseProjectionDirty)
+    {
+        MatrixOps::Inverse(projectionMatrix, inverseProjectionMatrix);
+        inverseProjectionDirty = false;
+    }
+
+    return inverseProjectionMatrix;
+}
+
+const vec::mat4& Camera::GetViewProjectionMatrix()
+{
+    if (viewProjectionDirty)
+    {
+        viewProjectionMatrix = projectionMatrix * GetViewMatrix();
+        viewProjectionDirty = false;
+    }
+
+    return viewProjectionMatrix;
+}
+
+vec::vec3 Camera::ScreenRay(const vec::vec2& screenPosition, const vec::vec2& screenSize)
+{
+    GetInverseProjectionMatrix();
+    UpdateView();
+    return ComputeScreenRay(screenPosition, screenSize);
+}
+
+void Camera::ScreenRays(const vec::vec2* screenPositions, vec::vec3* rays, unsigned int count, const vec::vec2& screenSize)
+{
+    GetInverseProjectionMatrix();
+    UpdateView();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        rays[i] = ComputeScreenRay(screenPositions[i], screenSize);
+    }
+}
+
+void Camera::UpdateView()
+{
+    if (viewDirty)
+    {
+        viewRotationMatrix = orientation.asMatrix();
+        viewMatrix = viewRotationMatrix * MatrixOps::Translate(-position);
+        viewDirty = false;
+    }
+}
+
+// Expects the inverse projection and view rotation to be up-to-date.
+vec::vec3 Camera::ComputeScreenRay(const vec::vec2& screenPosition, const vec::vec2& screenSize) const
+{
+    // Scale from -1.0 to 1.0, and invert Y
+    vec::vec2 deviceCoords = (screenPosition * 2.0f - screenSize) / screenSize;
+    deviceCoords.y = -deviceCoords.y;
+
+    // Point the ray away from us, then undo the projection and view rotation to end up with a world ray.
+    vec::vec4 eyeRay = vec::vec4(deviceCoords.x, deviceCoords.y, -1.0f, 1.0f) * inverseProjectionMatrix;
+    eyeRay.z = -1.0f;
+    eyeRay.w = 0.0f;
+
+    vec::vec4 worldRay = eyeRay * viewRotationMatrix;
+    return vec::normalize(vec::vec3(worldRay.x, worldRay.y, worldRay.z));
+}
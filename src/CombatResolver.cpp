@@ -0,0 +1,125 @@
+#include <algorithm>
+#include "CombatResolver.h"
+
+CombatResolver::CombatResolver()
+{
+}
+
+void CombatResolver::Initialize(unsigned int capacity)
+{
+    hits.reserve(capacity);
+}
+
+void CombatResolver::Clear()
+{
+    hits.clear();
+}
+
+void CombatResolver::AddHit(unsigned int playerId, unsigned int unitId, unsigned int firingPlayerId, DamageType damageType, float damage)
+{
+    CombatHit hit;
+    hit.playerId = playerId;
+    hit.unitId = unitId;
+    hit.sequence = (unsigned int)hits.size();
+    hit.firingPlayerId = firingPlayerId;
+    hit.damageType = damageType;
+    hit.damage = damage;
+    hits.push_back(hit);
+}
+
+void CombatResolver::AddHits(const std::vector<ProjectileHit>& projectileHits)
+{
+    for (unsigned int i = 0; i < projectileHits.size(); i++)
+    {
+        if (projectileHits[i].hitUnit)
+        {
+            AddHit(projectileHits[i].playerId, projectileHits[i].unitId, projectileHits[i].firingPlayerId, projectileHits[i].damageType, projectileHits[i].damage);
+        }
+    }
+}
+
+void CombatResolver::SortHits()
+{
+    // The sequence makes every key unique, so the unstable (but allocation-free) sort still gives a deterministic order.
+    std::sort(hits.begin(), hits.end(), [](const CombatHit& first, const CombatHit& second)
+    {
+        if (first.playerId != second.playerId)
+        {
+            return first.playerId < second.playerId;
+        }
+
+        if (first.unitId != second.unitId)
+        {
+            return first.unitId < second.unitId;
+        }
+
+        return first.sequence < second.sequence;
+    });
+}
+
+unsigned int CombatResolver::GetHitCount() const
+{
+    return (unsigned int)hits.size();
+}
+
+bool CombatResolver::ApplyHits(Armor& armor, const ArmorType& armorType, const CombatHit* hits, unsigned int hitCount, unsigned int* destroyingHit)
+{
+    // Indexed by damage type.
+    float damageTaken[3] = { armor.machineGunDamage, armor.rocketDamage, armor.cannonDamage };
+    const float maxDamage[3] = { armorType.maxMachineGun, armorType.maxRocket, armorType.maxCannon };
+    const float maxPenalty[3] = { armorType.maxMachineGunPenalty, armorType.maxRocketPenalty, armorType.maxCannonPenalty };
+
+    bool isDestroyed = false;
+    for (unsigned int i = 0; i < hitCount && !isDestroyed; i++)
+    {
+        int damageType = (int)hits[i].damageType;
+
+        // Damage first goes to its own type, until that maxes out.
+        float appliedDamage = std::min(hits[i].damage, std::max(maxDamage[damageType] - damageTaken[damageType], 0.0f));
+        damageTaken[damageType] += appliedDamage;
+        float overflowDamage = hits[i].damage - appliedDamage;
+
+        // The rest is penalized and spread over the types that haven't maxed out. Spreading can max out more types, so repeat until it's all applied.
+        float overflowFraction = maxDamage[damageType] > 0.0f ? overflowDamage * maxPenalty[damageType] / maxDamage[damageType] : overflowDamage * maxPenalty[damageType];
+        while (overflowFraction > 0.0f)
+        {
+            int remainingTypes = 0;
+            for (int j = 0; j < 3; j++)
+            {
+                if (damageTaken[j] < maxDamage[j])
+                {
+                    ++remainingTypes;
+                }
+            }
+
+            if (remainingTypes == 0)
+            {
+                break;
+            }
+
+            float typeFraction = overflowFraction / (float)remainingTypes;
+            overflowFraction = 0.0f;
+            for (int j = 0; j < 3; j++)
+            {
+                if (damageTaken[j] < maxDamage[j])
+                {
+                    float spreadDamage = typeFraction * maxDamage[j];
+                    float spreadApplied = std::min(spreadDamage, maxDamage[j] - damageTaken[j]);
+                    damageTaken[j] += spreadApplied;
+                    overflowFraction += (spreadDamage - spreadApplied) / maxDamage[j];
+                }
+            }
+        }
+
+        isDestroyed = damageTaken[0] >= maxDamage[0] && damageTaken[1] >= maxDamage[1] && damageTaken[2] >= maxDamage[2];
+        if (isDestroyed)
+        {
+            *destroyingHit = i;
+        }
+    }
+
+    armor.machineGunDamage = damageTaken[0];
+    armor.rocketDamage = damageTaken[1];
+    armor.cannonDamage = damageTaken[2];
+    return isDestroyed;
+}
@@ -41,16 +41,6 @@ bool ConfigManager::ReadFloat(std::vector<std::string>& configFileLines, float&
 
     return true;
 }
-bool ConfigManager::ReadKey(std::vector<std::string>& configFileLines, sf::Keyboard::Key& key, const char* errorMessage)
-{
-	if (!ConversionUtils::LoadKey(configFileLines[++lineCounter], key))
-	{
-		Logger::Log(errorMessage);
-		return false;
-	}
-
-    return true;
-}
 
 bool ConfigManager::ReadVector(std::vector<std::string>& configFileLines, vec::vec3& vector, const char* errorMessage)
 {
@@ -86,13 +76,6 @@ void ConfigManager::WriteFloat(const char* itemName, float& floatingPoint)
     outputLines.push_back(tempOutput.str());
 }
 
-void ConfigManager::WriteKey(const char* itemName, sf::Keyboard::Key& key)
-{
-    std::stringstream tempOutput;
-    tempOutput << itemName << StringUtils::Space << (int)key;
-    outputLines.push_back(tempOutput.str());
-}
-
 void ConfigManager::WriteVector(const char* itemName, vec::vec3& vector)
 {
 	std::stringstream tempOutput;
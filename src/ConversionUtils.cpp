@@ -22,19 +22,6 @@ bool ConversionUtils::LoadFloat(const std::string& line, float& floatingPoint)
     return !(!StringUtils::SplitAndGrabSecondary(line, tempInput) || !StringUtils::ParseFloatFromString(tempInput, floatingPoint));
 }
 
-// Loads in an SFML keyboard key.
-bool ConversionUtils::LoadKey(const std::string& line, sf::Keyboard::Key& key)
-{
-    int keyInt;
-    if (!LoadInt(line, keyInt))
-    {
-        return false;
-    }
-
-    key = (sf::Keyboard::Key)keyInt;
-    return true;
-}
-
 // Loads in a 3-valued floating point vector.
 bool ConversionUtils::LoadVector(const std::string& line, vec::vec3& vector)
 {
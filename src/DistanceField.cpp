@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cmath>
+#include "DistanceField.h"
+
+// Stands in for infinity, as actual infinities turn into NaNs in the parabola intersections.
+static const float FarDistance = 1e20f;
+
+void DistanceField::Generate(const unsigned char* coverage, int fieldWidth, int fieldHeight, int supersampling, float spread, unsigned char* field)
+{
+    int width = fieldWidth * supersampling;
+    int height = fieldHeight * supersampling;
+    FindColumnDistances(coverage, width, height, true, distancesToInside);
+    FindColumnDistances(coverage, width, height, false, distancesToOutside);
+
+    rowDistancesToInside.resize(width);
+    rowDistancesToOutside.resize(width);
+    parabolaPositions.resize(width);
+    parabolaBounds.resize(width + 1);
+    texelDistances.resize(fieldWidth);
+
+    // Each texel averages the distances of the coverage pixels at its center (the middle two by two pixels, for even supersampling),
+    //  so the row transform is only needed for the center rows.
+    // The edge lies halfway between an inside pixel and the nearest outside pixel, so distances are half a pixel shorter than between pixel centers.
+    int firstCenter = (supersampling - 1) / 2;
+    int lastCenter = supersampling / 2;
+    float centerCount = (float)((lastCenter - firstCenter + 1) * (lastCenter - firstCenter + 1));
+    float valuesPerTexel = 127.0f / spread;
+    for (int y = 0; y < fieldHeight; y++)
+    {
+        std::fill(texelDistances.begin(), texelDistances.end(), 0.0f);
+        for (int pixelY = y * supersampling + firstCenter; pixelY <= y * supersampling + lastCenter; pixelY++)
+        {
+            TransformRow(&distancesToInside[pixelY * width], width, &rowDistancesToInside[0]);
+            TransformRow(&distancesToOutside[pixelY * width], width, &rowDistancesToOutside[0]);
+            for (int x = 0; x < fieldWidth; x++)
+            {
+                for (int pixelX = x * supersampling + firstCenter; pixelX <= x * supersampling + lastCenter; pixelX++)
+                {
+                    texelDistances[x] += rowDistancesToInside[pixelX] != 0.0f ?
+                        std::sqrt(rowDistancesToInside[pixelX]) - 0.5f : 0.5f - std::sqrt(rowDistancesToOutside[pixelX]);
+                }
+            }
+        }
+
+        for (int x = 0; x < fieldWidth; x++)
+        {
+            float texelDistance = texelDistances[x] / (centerCount * (float)supersampling);
+            float value = 128.0f - texelDistance * valuesPerTexel;
+            field[x + y * fieldWidth] = (unsigned char)std::min(std::max(value + 0.5f, 0.0f), 255.0f);
+        }
+    }
+}
+
+void DistanceField::FindColumnDistances(const unsigned char* coverage, int width, int height, bool isInsideFeature, std::vector<float>& squaredDistances)
+{
+    // The coverage is only inside or outside, so the nearest pixel in a column is found by sweeping down and then back up, a row at a time.
+    squaredDistances.resize(width * height);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int pixel = x + y * width;
+            if ((coverage[pixel] >= 128) == isInsideFeature)
+            {
+                squaredDistances[pixel] = 0.0f;
+            }
+            else
+            {
+                squaredDistances[pixel] = y == 0 ? FarDistance : squaredDistances[pixel - width] + 1.0f;
+            }
+        }
+    }
+
+    for (int y = height - 2; y >= 0; y--)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int pixel = x + y * width;
+            squaredDistances[pixel] = std::min(squaredDistances[pixel], squaredDistances[pixel + width] + 1.0f);
+        }
+    }
+
+    // The sweeps find distances, which are squared for the row transform. Pixels with nothing in their column stay far.
+    for (float& distance : squaredDistances)
+    {
+        distance = distance >= FarDistance ? FarDistance : distance * distance;
+    }
+}
+
+void DistanceField::TransformRow(const float* columnDistances, int width, float* squaredDistances)
+{
+    // Find the parabolas making up the lower envelope, and where each one takes over from the last.
+    int parabola = 0;
+    parabolaPositions[0] = 0;
+    parabolaBounds[0] = -FarDistance;
+    parabolaBounds[1] = FarDistance;
+    for (int q = 1; q < width; q++)
+    {
+        // Parabolas this one hides are dropped. It can't hide the first one, which starts at the (far) left bound.
+        int v = parabolaPositions[parabola];
+        float intersection = ((columnDistances[q] + (float)(q * q)) - (columnDistances[v] + (float)(v * v))) / (float)(2 * q - 2 * v);
+        while (intersection <= parabolaBounds[parabola])
+        {
+            --parabola;
+            v = parabolaPositions[parabola];
+            intersection = ((columnDistances[q] + (float)(q * q)) - (columnDistances[v] + (float)(v * v))) / (float)(2 * q - 2 * v);
+        }
+
+        ++parabola;
+        parabolaPositions[parabola] = q;
+        parabolaBounds[parabola] = intersection;
+        parabolaBounds[parabola + 1] = FarDistance;
+    }
+
+    // Then read the distances off the envelope.
+    parabola = 0;
+    for (int q = 0; q < width; q++)
+    {
+        while (parabolaBounds[parabola + 1] < (float)q)
+        {
+            ++parabola;
+        }
+
+        int v = parabolaPositions[parabola];
+        squaredDistances[q] = (float)((q - v) * (q - v)) + columnDistances[v];
+    }
+}
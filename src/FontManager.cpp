@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <vector>
@@ -9,10 +13,14 @@
 FontManager::FontManager()
 {
     loadedFontFile = nullptr;
-    usedWidth = 0;
-    usedHeight = 0;
-    lastMaxHeight = 0;
     nextSentenceId = 0;
+    isDistanceFieldText = false;
+
+    textVao = 0;
+    vertexBuffer = 0;
+    indexBuffer = 0;
+    vertexBufferSize = 0;
+    indexedQuadCount = 0;
 }
 
 bool FontManager::LoadFont(ShaderManager *shaderManager, const char *fontName)
@@ -24,9 +32,9 @@ bool FontManager::LoadFont(ShaderManager *shaderManager, const char *fontName)
         return false;
     }
 
-    mvLocation = glGetUniformLocation(fontShader, "mv_matrix");
     projLocation = glGetUniformLocation(fontShader, "proj_matrix");
 	fontImageLocation = glGetUniformLocation(fontShader, "fontimage");
+    isDistanceFieldLocation = glGetUniformLocation(fontShader, "isDistanceField");
 
     /// Load in the font file
     std::ifstream file(fontName, std::ios::binary | std::ios::ate);
@@ -48,49 +56,119 @@ bool FontManager::LoadFont(ShaderManager *shaderManager, const char *fontName)
     loadedFontFile = new unsigned char[(unsigned int)fileLength];
     memcpy(loadedFontFile, &buffer[0], (size_t)fileLength);
 
-    // Initialize the font and generic OpenGL info.
+    // Initialize the font and generic OpenGL info. Texture pages are added as characters are.
     stbtt_InitFont(&fontInfo, loadedFontFile, 0);
+    isDistanceFieldText = GraphicsConfig::DistanceFieldText;
+    glyphAtlas.Initialize(GraphicsConfig::TextImageSize, GraphicsConfig::TextImagePages, isDistanceFieldText);
+
+    // Setup the text batch. The vertex buffer is sized on the first frame with text.
+    glGenVertexArrays(1, &textVao);
+    glBindVertexArray(textVao);
+
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (const void*)offsetof(TextVertex, position));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (const void*)offsetof(TextVertex, color));
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (const void*)offsetof(TextVertex, uv));
+
+    glGenBuffers(1, &indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    IndexQuads(256);
+
+    // Distance field characters serve every text size, so the printable ASCII ones are rendered now instead of when they're first drawn.
+    if (isDistanceFieldText)
+    {
+        for (int character = ' '; character <= '~'; character++)
+        {
+            GetCharacterInfo(DISTANCE_FIELD_PIXEL_HEIGHT, character);
+        }
+    }
 
-    // Create a new texture for the image.
-    glGenTextures(1, &fontTexture);
+    return true;
+}
 
-    // Bind the texture and prepare to send in image data.
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, fontTexture);
+void FontManager::IndexQuads(int quadCount)
+{
+    quadCount = std::min(quadCount, MAX_QUADS_PER_DRAW);
+    if (quadCount <= indexedQuadCount)
+    {
+        return;
+    }
 
-	width = GraphicsConfig::TextImageSize;
-	height = GraphicsConfig::TextImageSize;
-	glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    // Two triangles a quad, wound the same way as the quad vertices: start, +y, +x+y, +x.
+    std::vector<GLushort> indices(quadCount * 6);
+    for (int i = 0; i < quadCount; i++)
+    {
+        GLushort firstVertex = (GLushort)(i * verticesPerChar);
+        indices[i * 6] = firstVertex;
+        indices[i * 6 + 1] = firstVertex + 1;
+        indices[i * 6 + 2] = firstVertex + 2;
+        indices[i * 6 + 3] = firstVertex;
+        indices[i * 6 + 4] = firstVertex + 2;
+        indices[i * 6 + 5] = firstVertex + 3;
+    }
 
-    return true;
+    // The index buffer is part of the VAO, which must be bound.
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), &indices[0], GL_STATIC_DRAW);
+    indexedQuadCount = quadCount;
 }
 
 // Adds the specified font to the font texture, loading the character position information into the provided structure.
 void FontManager::AddToFontTexture(CharInfo& charInfo)
 {
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, fontTexture);
+    // Glyphs too large for the atlas are left out of sentences.
+    charInfo.isDrawn = glyphAtlas.AddGlyph(charInfo.characterBitmap, charInfo.width, charInfo.height, &charInfo.location);
+}
 
-    // Move down a row if we need to.
-    if (usedWidth + charInfo.width > width)
+// Renders the character as a distance field, for DISTANCE_FIELD_PIXEL_HEIGHT text.
+void FontManager::RenderDistanceField(int character, CharInfo& charInfo)
+{
+    charInfo.scale = stbtt_ScaleForPixelHeight(&fontInfo, (float)DISTANCE_FIELD_PIXEL_HEIGHT);
+    charInfo.characterBitmap = nullptr;
+    charInfo.padding = DISTANCE_FIELD_SPREAD;
+
+    float supersampledScale = charInfo.scale * (float)DISTANCE_FIELD_SUPERSAMPLING;
+    int x0, y0, x1, y1;
+    stbtt_GetCodepointBitmapBox(&fontInfo, character, supersampledScale, supersampledScale, &x0, &y0, &x1, &y1);
+    if (x1 <= x0 || y1 <= y0)
     {
-        usedWidth = 0;
-        usedHeight += lastMaxHeight;
-        lastMaxHeight = 0;
+        // Nothing to draw, such as a space.
+        charInfo.width = 0;
+        charInfo.height = 0;
+        charInfo.xOffset = 0;
+        charInfo.yOffset = 0;
+        return;
     }
 
-    // Store the image and move around our current position.
-    glTexSubImage2D(GL_TEXTURE_2D, 0, usedWidth, usedHeight, charInfo.width, charInfo.height, GL_RGBA, GL_UNSIGNED_BYTE, charInfo.characterBitmap);
-    charInfo.textureX = usedWidth;
-    charInfo.textureY = usedHeight;
-
-    usedWidth += charInfo.width + 1; // 1 px buffer space
-    lastMaxHeight = (int)std::max((float)lastMaxHeight, (float)(charInfo.height + 1));
+    // The field covers whole texels around the character, plus the spread on each side.
+    charInfo.xOffset = (int)std::floor((float)x0 / (float)DISTANCE_FIELD_SUPERSAMPLING) - DISTANCE_FIELD_SPREAD;
+    charInfo.yOffset = (int)std::floor((float)y0 / (float)DISTANCE_FIELD_SUPERSAMPLING) - DISTANCE_FIELD_SPREAD;
+    charInfo.width = (int)std::ceil((float)x1 / (float)DISTANCE_FIELD_SUPERSAMPLING) + DISTANCE_FIELD_SPREAD - charInfo.xOffset;
+    charInfo.height = (int)std::ceil((float)y1 / (float)DISTANCE_FIELD_SUPERSAMPLING) + DISTANCE_FIELD_SPREAD - charInfo.yOffset;
+
+    int supersampledWidth = charInfo.width * DISTANCE_FIELD_SUPERSAMPLING;
+    int supersampledHeight = charInfo.height * DISTANCE_FIELD_SUPERSAMPLING;
+    supersampledCharacter.assign(supersampledWidth * supersampledHeight, 0);
+    int characterStart = (x0 - charInfo.xOffset * DISTANCE_FIELD_SUPERSAMPLING) + (y0 - charInfo.yOffset * DISTANCE_FIELD_SUPERSAMPLING) * supersampledWidth;
+    stbtt_MakeCodepointBitmap(&fontInfo, &supersampledCharacter[characterStart], x1 - x0, y1 - y0, supersampledWidth, supersampledScale, supersampledScale, character);
+
+    // Allocated like the stb_truetype bitmaps, so both are freed with stbtt_FreeBitmap.
+    charInfo.characterBitmap = (unsigned char*)malloc(charInfo.width * charInfo.height);
+    distanceField.Generate(&supersampledCharacter[0], charInfo.width, charInfo.height, DISTANCE_FIELD_SUPERSAMPLING, (float)DISTANCE_FIELD_SPREAD, charInfo.characterBitmap);
 }
 
 // Returns the character info pertaining to the specified font pixel height and character
 CharInfo& FontManager::GetCharacterInfo(int fontPixelHeight, int character)
 {
+    // Distance field characters are shared by every size.
+    if (isDistanceFieldText)
+    {
+        fontPixelHeight = DISTANCE_FIELD_PIXEL_HEIGHT;
+    }
+
     if (fontData.count(character) == 0)
     {
         // There is no characters at all loaded of the specific type, perform a load of generic text information.
@@ -104,32 +182,37 @@ CharInfo& FontManager::GetCharacterInfo(int fontPixelHeight, int character)
     {
         // We need to add to the mapping of character sizes this new character size.
         CharInfo charInfo;
-        charInfo.scale = stbtt_ScaleForPixelHeight(&fontInfo, (float)fontPixelHeight);
         stbtt_GetCodepointHMetrics(&fontInfo, character, &charInfo.advanceWidth, &charInfo.leftSideBearing);
-        charInfo.characterBitmap = stbtt_GetCodepointBitmap(&fontInfo, 0, charInfo.scale, character, &charInfo.width, &charInfo.height, &charInfo.xOffset, &charInfo.yOffset);
+        if (isDistanceFieldText)
+        {
+            RenderDistanceField(character, charInfo);
+        }
+        else
+        {
+            charInfo.scale = stbtt_ScaleForPixelHeight(&fontInfo, (float)fontPixelHeight);
+            charInfo.padding = 0;
+            charInfo.characterBitmap = stbtt_GetCodepointBitmap(&fontInfo, 0, charInfo.scale, character, &charInfo.width, &charInfo.height, &charInfo.xOffset, &charInfo.yOffset);
+        }
 
-        // Make this an RGBA bitmap image.
-        unsigned char* extraStorage = new unsigned char[charInfo.width*charInfo.height * 4];
-        for (int j = 0; j < charInfo.height; j++)
+        // The atlas is single-channel, so the bitmap is stored as-is.
+        charInfo.isDrawn = charInfo.characterBitmap != nullptr && charInfo.width != 0 && charInfo.height != 0;
+        if (charInfo.isDrawn)
         {
-            for (int i = 0; i < charInfo.width; i++)
-            {
-                extraStorage[(i + j*charInfo.width) * 4 + 0] = charInfo.characterBitmap[i + j*charInfo.width];
-                extraStorage[(i + j*charInfo.width) * 4 + 1] = charInfo.characterBitmap[i + j*charInfo.width];
-                extraStorage[(i + j*charInfo.width) * 4 + 2] = charInfo.characterBitmap[i + j*charInfo.width];
-                extraStorage[(i + j*charInfo.width) * 4 + 3] = charInfo.characterBitmap[i + j*charInfo.width];
-            }
+            AddToFontTexture(charInfo);
         }
 
-        stbtt_FreeBitmap(charInfo.characterBitmap, nullptr);
-        charInfo.characterBitmap = extraStorage;
+        fontData[character].characterSizes[fontPixelHeight] = charInfo;
+        return fontData[character].characterSizes[fontPixelHeight];
+    }
 
+    // Characters whose atlas page has been evicted are added back.
+    CharInfo& charInfo = fontData[character].characterSizes[fontPixelHeight];
+    if (charInfo.isDrawn && !glyphAtlas.UseGlyph(charInfo.location))
+    {
         AddToFontTexture(charInfo);
-
-        fontData[character].characterSizes[fontPixelHeight] = charInfo;
     }
 
-    return fontData[character].characterSizes[fontPixelHeight];
+    return charInfo;
 }
 
 int FontManager::GetSentenceVertexCount(const std::string& sentence)
@@ -138,172 +221,300 @@ int FontManager::GetSentenceVertexCount(const std::string& sentence)
     return sentence.size() * verticesPerChar;
 }
 
-// Given a sentence, allocates the vertexes corresponding to the sentence.
+// Lays out the quads of the sentence text, grouped by the glyph atlas page of each character.
 // The vertexes start at (0, 0, 0) and go in the X-direction, with 1 unit == pixelHeight.
-universalVertices FontManager::AllocateSentenceVertices(const std::string& sentence, int pixelHeight, vec::vec3 textColor)
+void FontManager::LayoutSentence(SentenceInfo& sentenceInfo)
 {
+    const std::string& sentence = sentenceInfo.text;
+    int pixelHeight = sentenceInfo.pixelHeight;
+    vec::vec3 textColor = sentenceInfo.textColor;
+
     float lastZPos = 0.0f;
     float lastXPos = 0.0f;
 
-    float vertScale = 1.0f;
-
-    // Scale the vertical scale according to the tallest character.
-    int maxHeight;
-    for (int i = 0; i < (int)sentence.size(); i++)
+    // Scale the vertical scale according to the tallest character. This also puts every character in the glyph atlas,
+    //  which is repeated if adding a character evicted the page of an earlier one.
+    int maxHeight = 0;
+    unsigned int evictionCount;
+    int attempts = 0;
+    do
     {
-        CharInfo& charInfo = GetCharacterInfo(pixelHeight, sentence[i]);
-        if (i == 0)
-        {
-            vertScale = 1.0f / (float)charInfo.height;
-            maxHeight = charInfo.height;
-        }
-        else if (charInfo.height > maxHeight)
+        evictionCount = glyphAtlas.GetEvictionCount();
+        for (int i = 0; i < (int)sentence.size(); i++)
         {
-            vertScale = 1.0f / (float)charInfo.height;
-            maxHeight = charInfo.height;
+            CharInfo& charInfo = GetCharacterInfo(pixelHeight, sentence[i]);
+            maxHeight = std::max(maxHeight, charInfo.height - 2 * charInfo.padding);
         }
-    }
 
-    // Render out all our characters
-    universalVertices vertices;
+        ++attempts;
+    } while (evictionCount != glyphAtlas.GetEvictionCount() && attempts < GraphicsConfig::TextImagePages);
+
+    float vertScale = maxHeight != 0 ? 1.0f / (float)maxHeight : 1.0f;
+
+    // Find where each character starts.
+    characterXPositions.resize(sentence.size());
     for (int i = 0; i < (int)sentence.size(); i++)
     {
         CharInfo& charInfo = GetCharacterInfo(pixelHeight, sentence[i]);
+        characterXPositions[i] = lastXPos;
+        lastXPos += vertScale * (float)charInfo.advanceWidth * (float)charInfo.scale;
+    }
 
-        // Character vertex positions.
-        float effectiveWidth = vertScale * (float)charInfo.width;
-        float advanceWidth = vertScale * (float)charInfo.advanceWidth * (float)charInfo.scale;
-        float leftSideBearing = vertScale * (float)charInfo.leftSideBearing * (float)charInfo.scale;
-
-        float xStart = lastXPos + leftSideBearing;
-        float xDepth = effectiveWidth + xStart;
-
-        float yStart = vertScale * (float)charInfo.yOffset;
-        float yDepth = vertScale * (float)charInfo.height + yStart;
-
-        // Character texture vertex positions.
-        float textureX = (float)charInfo.textureX / (float)width;
-        float textureY = (float)charInfo.textureY / (float)height;
-        float textureXEnd = (float)(charInfo.textureX + charInfo.width) / (float)width;
-        float textureYEnd = (float)(charInfo.textureY + charInfo.height) / (float)height;
+    // Render out all our characters, a page at a time. The vectors are reused, so updating a sentence doesn't allocate once it has been this long.
+    std::vector<TextVertex>& vertices = sentenceInfo.vertices;
+    vertices.clear();
+    sentenceInfo.pageRanges.clear();
+    float pageSize = (float)glyphAtlas.GetPageSize();
+    for (int page = 0; page < glyphAtlas.GetPageCount(); page++)
+    {
+        SentencePageRange pageRange;
+        pageRange.page = page;
+        pageRange.firstCharacter = (GLsizei)(vertices.size() / verticesPerChar);
+        pageRange.characterCount = 0;
+        for (int i = 0; i < (int)sentence.size(); i++)
+        {
+            CharInfo& charInfo = GetCharacterInfo(pixelHeight, sentence[i]);
+            if (!charInfo.isDrawn || charInfo.location.page != page)
+            {
+                continue;
+            }
 
-        // Triangle fan. First position is at start, then +x, +x+y, +y
-        vertices.AddColorTextureVertex(vec::vec3(xStart, -yStart, lastZPos), vec::vec3(textColor.x, textColor.y, textColor.z), vec::vec2(textureX, textureY));
-        vertices.AddColorTextureVertex(vec::vec3(xStart, -yDepth, lastZPos), vec::vec3(textColor.x, textColor.y, textColor.z), vec::vec2(textureX, textureYEnd));
-        vertices.AddColorTextureVertex(vec::vec3(xDepth, -yDepth, lastZPos), vec::vec3(textColor.x, textColor.y, textColor.z), vec::vec2(textureXEnd, textureYEnd));
-        vertices.AddColorTextureVertex(vec::vec3(xDepth, -yStart, lastZPos), vec::vec3(textColor.x, textColor.y, textColor.z), vec::vec2(textureXEnd, textureY));
+            // Character vertex positions.
+            float effectiveWidth = vertScale * (float)charInfo.width;
+            float leftSideBearing = vertScale * (float)charInfo.leftSideBearing * (float)charInfo.scale;
+
+            // Distance field characters start at their exact offset, which includes their padding.
+            float xStart = characterXPositions[i] + (charInfo.padding == 0 ? leftSideBearing : vertScale * (float)charInfo.xOffset);
+            float xDepth = effectiveWidth + xStart;
+
+            float yStart = vertScale * (float)charInfo.yOffset;
+            float yDepth = vertScale * (float)charInfo.height + yStart;
+
+            // Character texture vertex positions.
+            float textureX = (float)charInfo.location.x / pageSize;
+            float textureY = (float)charInfo.location.y / pageSize;
+            float textureXEnd = (float)(charInfo.location.x + charInfo.width) / pageSize;
+            float textureYEnd = (float)(charInfo.location.y + charInfo.height) / pageSize;
+
+            // Quad. First position is at start, then +y, +x+y, +x
+            TextVertex vertex;
+            vertex.color = textColor;
+            vertex.position = vec::vec3(xStart, -yStart, lastZPos);
+            vertex.uv = vec::vec2(textureX, textureY);
+            vertices.push_back(vertex);
+
+            vertex.position = vec::vec3(xStart, -yDepth, lastZPos);
+            vertex.uv = vec::vec2(textureX, textureYEnd);
+            vertices.push_back(vertex);
+
+            vertex.position = vec::vec3(xDepth, -yDepth, lastZPos);
+            vertex.uv = vec::vec2(textureXEnd, textureYEnd);
+            vertices.push_back(vertex);
+
+            vertex.position = vec::vec3(xDepth, -yStart, lastZPos);
+            vertex.uv = vec::vec2(textureXEnd, textureY);
+            vertices.push_back(vertex);
+            ++pageRange.characterCount;
+        }
 
-        lastXPos += advanceWidth;
+        if (pageRange.characterCount != 0)
+        {
+            sentenceInfo.pageRanges.push_back(pageRange);
+        }
     }
 
-    return vertices;
+    // If pages were still being evicted, some of these glyphs may be gone, so the sentence is left stale to be laid out again.
+    if (evictionCount == glyphAtlas.GetEvictionCount())
+    {
+        sentenceInfo.atlasEvictionCount = evictionCount;
+    }
 }
 
 // Creates a new sentence that can be referenced for drawing.
 int FontManager::CreateNewSentence()
 {
-    // Loads in the OpenGL components for this sentence.
     SentenceInfo sentenceInfo;
-    glGenVertexArrays(1, &sentenceInfo.vao);
-    glBindVertexArray(sentenceInfo.vao);
-
-    glGenBuffers(1, &sentenceInfo.positionBuffer);
-    glGenBuffers(1, &sentenceInfo.colorBuffer);
-    glGenBuffers(1, &sentenceInfo.uvBuffer);
-
-    sentenceInfo.characterCount = 0;
-    sentenceInfo.characterStartIndices = nullptr;
-    sentenceInfo.characterVertexCounts = nullptr;
+    sentenceInfo.pixelHeight = 0;
+    sentenceInfo.textColor = vec::vec3(0.0f, 0.0f, 0.0f);
+    sentenceInfo.atlasEvictionCount = glyphAtlas.GetEvictionCount();
     sentences[nextSentenceId] = sentenceInfo;
     ++nextSentenceId;
 
     return nextSentenceId - 1;
 }
 
-// Updates the graphical components of a sentence so it can be drawn.
+// Updates the text of a sentence, laying it out so it can be drawn.
 void FontManager::UpdateSentence(int sentenceId, const std::string& sentence, int pixelHeight, vec::vec3 textColor)
 {
+    UpdateSentence(sentenceId, sentence.c_str(), pixelHeight, textColor);
+}
+
+void FontManager::UpdateSentence(int sentenceId, const char* sentence, int pixelHeight, vec::vec3 textColor)
+{
+    // Sentences are often updated every frame with the same text, which doesn't need to be laid out again.
     SentenceInfo& sentenceInfo = sentences[sentenceId];
+    if (sentenceInfo.text == sentence && sentenceInfo.pixelHeight == pixelHeight &&
+        sentenceInfo.textColor.x == textColor.x && sentenceInfo.textColor.y == textColor.y && sentenceInfo.textColor.z == textColor.z)
+    {
+        return;
+    }
 
-    // Parse our the text textures
-    sentenceInfo.characterCount = sentence.size();
-    universalVertices vertices = AllocateSentenceVertices(sentence, pixelHeight, textColor);
+    // Assigning keeps the existing capacity, so this only allocates when the text gets longer than it has been.
+    sentenceInfo.text = sentence;
+    sentenceInfo.pixelHeight = pixelHeight;
+    sentenceInfo.textColor = textColor;
+    LayoutSentence(sentenceInfo);
+}
 
-    // Send that data to OpenGL
-    glBindVertexArray(sentenceInfo.vao);
-    vertices.TransferPositionToOpenGl(sentenceInfo.positionBuffer);
-    vertices.TransferColorToOpenGl(sentenceInfo.colorBuffer);
-    vertices.TransferUvsToOpenGl(sentenceInfo.uvBuffer);
+// Queues the specified sentence for rendering.
+void FontManager::RenderSentence(int sentenceId, vec::mat4& mvMatrix)
+{
+    QueuedSentence queuedSentence;
+    queuedSentence.sentenceId = sentenceId;
+    queuedSentence.mvMatrix = mvMatrix;
+    queuedSentences.push_back(queuedSentence);
+}
 
-    // Update our character indices and vertex counts so we can do a multi-element drawing scheme.
-    if (sentenceInfo.characterStartIndices != nullptr)
+// Renders all of the queued sentences.
+void FontManager::RenderSentences(vec::mat4& perspective)
+{
+    if (queuedSentences.empty())
     {
-        delete[] sentenceInfo.characterStartIndices;
+        return;
     }
 
-    if (sentenceInfo.characterVertexCounts != nullptr)
+    // Once glyph atlas pages have been evicted, sentences may be using glyphs that are gone. Laying a sentence out again
+    //  may evict pages that other queued sentences use, so this repeats until none are stale (within reason, if they don't all fit).
+    bool hasStaleSentences = true;
+    for (int attempt = 0; hasStaleSentences && attempt <= GraphicsConfig::TextImagePages; attempt++)
     {
-        delete[] sentenceInfo.characterVertexCounts;
+        hasStaleSentences = false;
+        for (const QueuedSentence& queuedSentence : queuedSentences)
+        {
+            SentenceInfo& sentenceInfo = sentences[queuedSentence.sentenceId];
+            if (sentenceInfo.atlasEvictionCount != glyphAtlas.GetEvictionCount())
+            {
+                LayoutSentence(sentenceInfo);
+                hasStaleSentences = true;
+            }
+        }
     }
 
-    GLint* startingElements = new GLint[sentenceInfo.characterCount];
-    GLsizei* elementCounts = new GLsizei[sentenceInfo.characterCount];
-    for (int i = 0; i < sentenceInfo.characterCount; i++)
+    // Count the quads on each page, so each page's quads can be written next to each other.
+    // Sentences still stale couldn't fit in the atlas alongside the rest, so they're skipped this frame rather than drawn with the wrong glyphs.
+    int pageCount = glyphAtlas.GetPageCount();
+    pageQuadCounts.assign(pageCount, 0);
+    pageFirstQuads.assign(pageCount, 0);
+    for (const QueuedSentence& queuedSentence : queuedSentences)
     {
-        startingElements[i] = i * verticesPerChar;
-        elementCounts[i] = verticesPerChar;
+        const SentenceInfo& sentenceInfo = sentences[queuedSentence.sentenceId];
+        if (sentenceInfo.atlasEvictionCount != glyphAtlas.GetEvictionCount())
+        {
+            continue;
+        }
+
+        for (const SentencePageRange& pageRange : sentenceInfo.pageRanges)
+        {
+            pageQuadCounts[pageRange.page] += pageRange.characterCount;
+        }
     }
 
-    sentenceInfo.characterStartIndices = startingElements;
-    sentenceInfo.characterVertexCounts = elementCounts;
-}
+    int quadCount = 0;
+    for (int page = 0; page < pageCount; page++)
+    {
+        pageFirstQuads[page] = quadCount;
+        quadCount += pageQuadCounts[page];
+    }
 
-// Renders the specified sentence.
-void FontManager::RenderSentence(int sentenceId, vec::mat4& perpective, vec::mat4& mvMatrix)
-{
-    const SentenceInfo sentenceInfo = sentences[sentenceId];
-    if (sentenceInfo.characterStartIndices == nullptr)
+    if (quadCount == 0)
     {
-        // No sentence data to render, exit early.
+        queuedSentences.clear();
         return;
     }
 
-    glUseProgram(fontShader);
-    glUniform1i(fontImageLocation, 0);
+    // Move each quad into place, applying the sentence model-view matrix here so every sentence can share a draw.
+    // Sentence matrices are affine (translations, rotations and scales), so W is always 1.
+    batchVertices.resize(quadCount * verticesPerChar);
+    for (const QueuedSentence& queuedSentence : queuedSentences)
+    {
+        const SentenceInfo& sentenceInfo = sentences[queuedSentence.sentenceId];
+        if (sentenceInfo.atlasEvictionCount != glyphAtlas.GetEvictionCount())
+        {
+            continue;
+        }
 
-    // Bind in the texture and vertices we're using.
-    glBindVertexArray(sentenceInfo.vao);
+        const vec::mat4& mvMatrix = queuedSentence.mvMatrix;
+        for (const SentencePageRange& pageRange : sentenceInfo.pageRanges)
+        {
+            const TextVertex* sentenceVertex = &sentenceInfo.vertices[pageRange.firstCharacter * verticesPerChar];
+            TextVertex* batchVertex = &batchVertices[pageFirstQuads[pageRange.page] * verticesPerChar];
+            for (int i = 0; i < pageRange.characterCount * verticesPerChar; i++)
+            {
+                const vec::vec3& position = sentenceVertex[i].position;
+                vec::vec4 transformed = mvMatrix[0] * position.x + mvMatrix[1] * position.y + mvMatrix[2] * position.z + mvMatrix[3];
+                batchVertex[i].position = vec::vec3(transformed.x, transformed.y, transformed.z);
+                batchVertex[i].color = sentenceVertex[i].color;
+                batchVertex[i].uv = sentenceVertex[i].uv;
+            }
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, fontTexture);
+            pageFirstQuads[pageRange.page] += pageRange.characterCount;
+        }
+    }
 
-    glUniformMatrix4fv(projLocation, 1, GL_FALSE, perpective);
-    glUniformMatrix4fv(mvLocation, 1, GL_FALSE, mvMatrix);
+    queuedSentences.clear();
 
-    // Draw the text
-    glMultiDrawArrays(GL_TRIANGLE_FAN, sentenceInfo.characterStartIndices, sentenceInfo.characterVertexCounts, sentenceInfo.characterCount);
-}
+    // Sends every character added since the last frame at once.
+    glActiveTexture(GL_TEXTURE0);
+    glyphAtlas.UploadChanges();
 
-FontManager::~FontManager()
-{
-    // Free all of our loaded OpenGL resources
-    for (std::map<int, SentenceInfo>::iterator iterator = sentences.begin(); iterator != sentences.end(); iterator++)
+    glUseProgram(fontShader);
+    glUniform1i(fontImageLocation, 0);
+    glUniform1i(isDistanceFieldLocation, isDistanceFieldText ? 1 : 0);
+    glUniformMatrix4fv(projLocation, 1, GL_FALSE, perspective);
+
+    // The buffer is orphaned each frame, so the driver doesn't wait on last frame's draws before it's written.
+    glBindVertexArray(textVao);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    GLsizeiptr batchSize = (GLsizeiptr)(batchVertices.size() * sizeof(TextVertex));
+    vertexBufferSize = std::max(vertexBufferSize, batchSize);
+    glBufferData(GL_ARRAY_BUFFER, vertexBufferSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, batchSize, &batchVertices[0]);
+
+    // Draw the text, a glyph atlas page at a time. The page quads end where the next page's start, after the loop above.
+    for (int page = 0; page < pageCount; page++)
     {
-        glDeleteVertexArrays(1, &iterator->second.vao);
-        glDeleteBuffers(1, &iterator->second.positionBuffer);
-        glDeleteBuffers(1, &iterator->second.colorBuffer);
-        glDeleteBuffers(1, &iterator->second.uvBuffer);
-
-        if (iterator->second.characterStartIndices != nullptr)
+        if (pageQuadCounts[page] == 0)
         {
-            delete[] iterator->second.characterStartIndices;
+            continue;
         }
 
-        if (iterator->second.characterVertexCounts != nullptr)
+        int firstQuad = pageFirstQuads[page] - pageQuadCounts[page];
+        IndexQuads(pageQuadCounts[page]);
+
+        glyphAtlas.UsePage(page);
+        glBindTexture(GL_TEXTURE_2D, glyphAtlas.GetPageTexture(page));
+        for (int drawnQuads = 0; drawnQuads < pageQuadCounts[page]; drawnQuads += MAX_QUADS_PER_DRAW)
         {
-            delete[] iterator->second.characterVertexCounts;
+            int drawQuadCount = std::min(pageQuadCounts[page] - drawnQuads, MAX_QUADS_PER_DRAW);
+            glDrawElementsBaseVertex(GL_TRIANGLES, drawQuadCount * 6, GL_UNSIGNED_SHORT, nullptr, (firstQuad + drawnQuads) * verticesPerChar);
         }
     }
+}
+
+void FontManager::LogAtlasUsage() const
+{
+    glyphAtlas.LogUsage();
+}
+
+FontManager::~FontManager()
+{
+    // Free all of our loaded OpenGL resources
+    if (textVao != 0)
+    {
+        glDeleteVertexArrays(1, &textVao);
+        glDeleteBuffers(1, &vertexBuffer);
+        glDeleteBuffers(1, &indexBuffer);
+    }
 
     // Free all of the loaded font bitmaps at program end.
     for (std::map<int, TextInfo>::iterator iterator = fontData.begin(); iterator != fontData.end(); iterator++)
@@ -311,7 +522,7 @@ FontManager::~FontManager()
         std::map<int, CharInfo>& charSizes = iterator->second.characterSizes;
         for (std::map<int, CharInfo>::iterator charIterator = charSizes.begin(); charIterator != charSizes.end(); charIterator++)
         {
-            delete[] charIterator->second.characterBitmap;
+            stbtt_FreeBitmap(charIterator->second.characterBitmap, nullptr);
         }
     }
 
@@ -320,6 +531,4 @@ FontManager::~FontManager()
     {
         delete[] loadedFontFile;
     }
-
-    glDeleteTextures(1, &fontTexture);
 }
@@ -3,4 +3,95 @@
 GameRound::GameRound()
 {
 
-}
\ No newline at end of file
+}
+
+void GameRound::UpdatePlayers(JobSystem& jobSystem, SpatialHash& unitHash, LocalAvoidance& localAvoidance, const MapSections& mapSections, float lastElapsedTime)
+{
+    // Current player receives a technology update.
+    players[0].UpdateResearchProgress(lastElapsedTime);
+
+    // Move units along their routes. Players only touch their own units, so they can be updated in parallel.
+    jobSystem.ParallelFor(0, (unsigned int)players.size(), 1, [&](unsigned int startIndex, unsigned int endIndex)
+    {
+        for (unsigned int i = startIndex; i < endIndex; i++)
+        {
+            players[i].MoveUnits(jobSystem);
+        }
+    });
+
+    // Avoid other units.
+    localAvoidance.Clear();
+    for (unsigned int i = 0; i < players.size(); i++)
+    {
+        players[i].AddAvoidanceAgents(localAvoidance);
+    }
+
+    localAvoidance.ComputeAvoidanceVelocities(jobSystem);
+    jobSystem.ParallelFor(0, (unsigned int)players.size(), 1, [&](unsigned int startIndex, unsigned int endIndex)
+    {
+        for (unsigned int i = startIndex; i < endIndex; i++)
+        {
+            players[i].ApplyAvoidance(jobSystem, localAvoidance, mapSections);
+        }
+    });
+
+    // The spatial hash isn't thread-safe, but updates are cheap as most units stay within their cell.
+    for (unsigned int i = 0; i < players.size(); i++)
+    {
+        players[i].UpdateSpatialHash(unitHash);
+    }
+}
+
+void GameRound::ResetVisibility(const MapSections& mapSections)
+{
+    for (unsigned int i = 0; i < players.size(); i++)
+    {
+        players[i].ResetVisibility(mapSections);
+    }
+}
+
+void GameRound::UpdateVisibility(JobSystem& jobSystem, const MapSections& mapSections, float budgetMs)
+{
+    jobSystem.ParallelFor(0, (unsigned int)players.size(), 1, [&](unsigned int startIndex, unsigned int endIndex)
+    {
+        for (unsigned int i = startIndex; i < endIndex; i++)
+        {
+            players[i].UpdateVisibility(mapSections, budgetMs);
+        }
+    });
+}
+
+void GameRound::UpdateTurrets(JobSystem& jobSystem, TurretTargeting& turretTargeting, const MapSections& mapSections, const SpatialHash& unitHash, ProjectilePool& projectilePool)
+{
+    turretTargeting.BeginTick();
+    jobSystem.ParallelFor(0, (unsigned int)players.size(), 1, [&](unsigned int startIndex, unsigned int endIndex)
+    {
+        for (unsigned int i = startIndex; i < endIndex; i++)
+        {
+            players[i].UpdateTurrets(jobSystem, turretTargeting, mapSections, unitHash);
+        }
+    });
+
+    for (unsigned int i = 0; i < players.size(); i++)
+    {
+        players[i].FireTurrets(projectilePool);
+    }
+}
+
+void GameRound::ResolveCombat(CombatResolver& combatResolver, std::vector<UnitDeath>& unitDeaths)
+{
+    combatResolver.SortHits();
+
+    auto applyFunction = [&](unsigned int playerId, unsigned int unitId, const CombatHit* hits, unsigned int hitCount)
+    {
+        UnitDeath unitDeath;
+        if (playerId < players.size() && players[playerId].ApplyUnitHits(unitId, hits, hitCount, &unitDeath.killingPlayerId))
+        {
+            unitDeath.playerId = playerId;
+            unitDeath.unitId = unitId;
+            unitDeaths.push_back(unitDeath);
+        }
+    };
+
+    combatResolver.ForEachTarget(applyFunction);
+}
@@ -0,0 +1,333 @@
+#include <algorithm>
+#include <cstring>
+#include "GlyphAtlas.h"
+#include "Logger.h"
+
+GlyphAtlas::GlyphAtlas()
+{
+    pageSize = 0;
+    maxPages = 0;
+    isLinearFiltered = false;
+    useClock = 0;
+    evictionCount = 0;
+}
+
+void GlyphAtlas::Initialize(int pageSize, int maxPages, bool isLinearFiltered)
+{
+    this->pageSize = pageSize;
+    this->maxPages = std::max(maxPages, 1);
+    this->isLinearFiltered = isLinearFiltered;
+}
+
+bool GlyphAtlas::AddGlyph(const unsigned char* bitmap, int width, int height, GlyphLocation* location)
+{
+    int paddedWidth = width + GLYPH_PADDING;
+    int paddedHeight = height + GLYPH_PADDING;
+    if (paddedWidth > pageSize || paddedHeight > pageSize)
+    {
+        Logger::LogWarn("A ", width, "x", height, " glyph doesn't fit on a ", pageSize, "x", pageSize, " glyph atlas page.");
+        return false;
+    }
+
+    // Try the existing pages (most recently added first, as older pages tend to be full), then a new page, then evict the least-recently used page.
+    int x = 0;
+    int y = 0;
+    int pageIndex = -1;
+    for (int i = (int)pages.size() - 1; i >= 0 && pageIndex == -1; i--)
+    {
+        if (Allocate(pages[i], paddedWidth, paddedHeight, &x, &y))
+        {
+            pageIndex = i;
+        }
+    }
+
+    if (pageIndex == -1)
+    {
+        if ((int)pages.size() < maxPages)
+        {
+            AddPage();
+            pageIndex = (int)pages.size() - 1;
+        }
+        else
+        {
+            pageIndex = 0;
+            for (unsigned int i = 1; i < pages.size(); i++)
+            {
+                pageIndex = pages[i].lastUse < pages[pageIndex].lastUse ? i : pageIndex;
+            }
+
+            EvictPage(pageIndex);
+        }
+
+        Allocate(pages[pageIndex], paddedWidth, paddedHeight, &x, &y);
+    }
+
+    Page& page = pages[pageIndex];
+    for (int row = 0; row < height; row++)
+    {
+        memcpy(&page.pixels[(y + row) * pageSize + x], bitmap + row * width, width);
+    }
+
+    page.usedArea += paddedWidth * paddedHeight;
+    page.dirtyMinX = std::min(page.dirtyMinX, x);
+    page.dirtyMinY = std::min(page.dirtyMinY, y);
+    page.dirtyMaxX = std::max(page.dirtyMaxX, x + width);
+    page.dirtyMaxY = std::max(page.dirtyMaxY, y + height);
+    UsePage(pageIndex);
+
+    location->page = pageIndex;
+    location->x = x;
+    location->y = y;
+    location->generation = page.generation;
+    return true;
+}
+
+bool GlyphAtlas::UseGlyph(const GlyphLocation& location)
+{
+    if (location.page < 0 || location.page >= (int)pages.size() || pages[location.page].generation != location.generation)
+    {
+        return false;
+    }
+
+    UsePage(location.page);
+    return true;
+}
+
+void GlyphAtlas::UsePage(int page)
+{
+    pages[page].lastUse = ++useClock;
+}
+
+void GlyphAtlas::UploadChanges()
+{
+    bool setUnpacking = false;
+    for (Page& page : pages)
+    {
+        if (page.dirtyMaxX <= page.dirtyMinX || page.dirtyMaxY <= page.dirtyMinY)
+        {
+            continue;
+        }
+
+        // Rows are a single byte per texel, and only part of each row is sent.
+        if (!setUnpacking)
+        {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, pageSize);
+            setUnpacking = true;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, page.texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, page.dirtyMinX, page.dirtyMinY, page.dirtyMaxX - page.dirtyMinX, page.dirtyMaxY - page.dirtyMinY,
+            GL_RED, GL_UNSIGNED_BYTE, &page.pixels[page.dirtyMinY * pageSize + page.dirtyMinX]);
+
+        page.dirtyMinX = pageSize;
+        page.dirtyMinY = pageSize;
+        page.dirtyMaxX = 0;
+        page.dirtyMaxY = 0;
+    }
+
+    if (setUnpacking)
+    {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+}
+
+int GlyphAtlas::GetPageSize() const
+{
+    return pageSize;
+}
+
+int GlyphAtlas::GetPageCount() const
+{
+    return (int)pages.size();
+}
+
+GLuint GlyphAtlas::GetPageTexture(int page) const
+{
+    return pages[page].texture;
+}
+
+unsigned int GlyphAtlas::GetEvictionCount() const
+{
+    return evictionCount;
+}
+
+float GlyphAtlas::GetOccupancy() const
+{
+    if (pages.empty())
+    {
+        return 0.0f;
+    }
+
+    long long usedArea = 0;
+    for (const Page& page : pages)
+    {
+        usedArea += page.usedArea;
+    }
+
+    return (float)usedArea / ((float)pages.size() * (float)pageSize * (float)pageSize);
+}
+
+void GlyphAtlas::LogUsage() const
+{
+    Logger::Log("Glyph atlas: ", pages.size(), " of ", maxPages, " ", pageSize, "x", pageSize, " page(s), ", (int)(GetOccupancy() * 100.0f), "% occupied, ",
+        evictionCount, " eviction(s).");
+}
+
+void GlyphAtlas::AddPage()
+{
+    Page page;
+    glGenTextures(1, &page.texture);
+    glBindTexture(GL_TEXTURE_2D, page.texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, pageSize, pageSize);
+    if (isLinearFiltered)
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+    page.generation = 0;
+    ClearPage(page);
+    pages.push_back(page);
+    LogUsage();
+}
+
+void GlyphAtlas::EvictPage(int pageIndex)
+{
+    ClearPage(pages[pageIndex]);
+    ++evictionCount;
+
+    // Evictions can happen every frame once the atlas is full, so only the first is logged. The total is logged with the usage on exit.
+    if (evictionCount == 1)
+    {
+        Logger::LogWarn("The glyph atlas is full, so its least recently used pages are being evicted.");
+    }
+}
+
+void GlyphAtlas::ClearPage(Page& page)
+{
+    // The whole page is cleared, so old glyphs don't show through the padding of new ones.
+    page.pixels.assign(pageSize * pageSize, 0);
+    page.skyline.assign(1, SkylineNode());
+    page.skyline[0].x = 0;
+    page.skyline[0].y = 0;
+    page.skyline[0].width = pageSize;
+    page.usedArea = 0;
+    page.lastUse = useClock;
+    ++page.generation;
+
+    page.dirtyMinX = 0;
+    page.dirtyMinY = 0;
+    page.dirtyMaxX = pageSize;
+    page.dirtyMaxY = pageSize;
+}
+
+bool GlyphAtlas::Allocate(Page& page, int width, int height, int* x, int* y)
+{
+    // Bottom-left: the lowest spot wins, and ties go to the narrowest skyline node, which leaves the fewest gaps.
+    int bestNode = -1;
+    int bestBottom = pageSize + 1;
+    int bestWidth = pageSize + 1;
+    for (unsigned int i = 0; i < page.skyline.size(); i++)
+    {
+        int fitY = GetFitHeight(page, i, width, height);
+        if (fitY != -1 && (fitY + height < bestBottom || (fitY + height == bestBottom && page.skyline[i].width < bestWidth)))
+        {
+            bestNode = (int)i;
+            bestBottom = fitY + height;
+            bestWidth = page.skyline[i].width;
+            *x = page.skyline[i].x;
+            *y = fitY;
+        }
+    }
+
+    if (bestNode == -1)
+    {
+        return false;
+    }
+
+    AddSkylineLevel(page, (unsigned int)bestNode, *x, *y, width, height);
+    return true;
+}
+
+int GlyphAtlas::GetFitHeight(const Page& page, unsigned int nodeIndex, int width, int height) const
+{
+    if (page.skyline[nodeIndex].x + width > pageSize)
+    {
+        return -1;
+    }
+
+    // The rectangle sits on the highest skyline node it spans.
+    int y = 0;
+    int remainingWidth = width;
+    while (remainingWidth > 0)
+    {
+        if (nodeIndex == page.skyline.size())
+        {
+            return -1;
+        }
+
+        y = std::max(y, page.skyline[nodeIndex].y);
+        if (y + height > pageSize)
+        {
+            return -1;
+        }
+
+        remainingWidth -= page.skyline[nodeIndex].width;
+        ++nodeIndex;
+    }
+
+    return y;
+}
+
+void GlyphAtlas::AddSkylineLevel(Page& page, unsigned int nodeIndex, int x, int y, int width, int height)
+{
+    SkylineNode node;
+    node.x = x;
+    node.y = y + height;
+    node.width = width;
+    page.skyline.insert(page.skyline.begin() + nodeIndex, node);
+
+    // Shrink or remove the nodes the new one now covers.
+    for (unsigned int i = nodeIndex + 1; i < page.skyline.size(); )
+    {
+        const SkylineNode& previous = page.skyline[i - 1];
+        int overlap = previous.x + previous.width - page.skyline[i].x;
+        if (overlap <= 0)
+        {
+            break;
+        }
+
+        page.skyline[i].x += overlap;
+        page.skyline[i].width -= overlap;
+        if (page.skyline[i].width > 0)
+        {
+            break;
+        }
+
+        page.skyline.erase(page.skyline.begin() + i);
+    }
+
+    // Merge neighbors at the same height.
+    for (unsigned int i = 0; i + 1 < page.skyline.size(); )
+    {
+        if (page.skyline[i].y == page.skyline[i + 1].y)
+        {
+            page.skyline[i].width += page.skyline[i + 1].width;
+            page.skyline.erase(page.skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    for (Page& page : pages)
+    {
+        glDeleteTextures(1, &page.texture);
+    }
+}
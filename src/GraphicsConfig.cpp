@@ -6,8 +6,13 @@ int GraphicsConfig::ScreenWidth;
 int GraphicsConfig::ScreenHeight;
 
 int GraphicsConfig::TextImageSize;
+int GraphicsConfig::TextImagePages;
+bool GraphicsConfig::DistanceFieldText;
 int GraphicsConfig::VoxelTypes;
-int GraphicsConfig::VoxelsPerRow;
+
+bool GraphicsConfig::HoverPicking;
+bool GraphicsConfig::PackedModelVertices;
+bool GraphicsConfig::CompressTextures;
 
 bool GraphicsConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
 {
@@ -15,8 +20,12 @@ bool GraphicsConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
             ReadInt(configFileLines, ScreenWidth, "Error reading in the screen width!") &&
             ReadInt(configFileLines, ScreenHeight, "Error reading in the screen height!") &&
             ReadInt(configFileLines, TextImageSize, "Error reading in the text image size!")&&
+            ReadInt(configFileLines, TextImagePages, "Error reading in the text image page count!") &&
+            ReadBool(configFileLines, DistanceFieldText, "Error decoding the distance field text toggle!") &&
             ReadInt(configFileLines, VoxelTypes, "Error reading in the voxel types!") &&
-            ReadInt(configFileLines, VoxelsPerRow, "Error reading in the voxel textures per row!"));
+            ReadBool(configFileLines, HoverPicking, "Error decoding the hover picking toggle!") &&
+            ReadBool(configFileLines, PackedModelVertices, "Error decoding the packed model vertices toggle!") &&
+            ReadBool(configFileLines, CompressTextures, "Error decoding the texture compression toggle!"));
 }
 
 void GraphicsConfig::WriteConfigValues()
@@ -26,8 +35,13 @@ void GraphicsConfig::WriteConfigValues()
 	WriteInt("ScreenHeight", ScreenHeight);
 
 	WriteInt("TextImageSize", TextImageSize);
+	WriteInt("TextImagePages", TextImagePages);
+	WriteBool("DistanceFieldText", DistanceFieldText);
 	WriteInt("VoxelTypes", VoxelTypes);
-	WriteInt("VoxelsPerRow", VoxelsPerRow);
+
+	WriteBool("HoverPicking", HoverPicking);
+	WriteBool("PackedModelVertices", PackedModelVertices);
+	WriteBool("CompressTextures", CompressTextures);
 }
 
 GraphicsConfig::GraphicsConfig(const char* configName)
@@ -1,12 +1,47 @@
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <sstream>
 #include <GL\glew.h>
+#include "CacheFile.h"
+#include "GraphicsConfig.h"
 #include "Logger.h"
 #include "ImageManager.h"
+#include "MappedFile.h"
+
+static const char* TextureCacheDirectory = "cache/textures";
+static const char CompressedImageMagic[4] = { 'T', 'F', 'T', 'X' };
+
+// Bumped whenever the compressed texture file layout changes, so older compressed textures are compressed again.
+static const unsigned int CompressedImageVersion = 1;
+
+// Halves the RGBA image (rounding down, but not below 1), averaging each 2x2 block of pixels.
+static void DownsampleImage(const unsigned char* imageData, int width, int height, std::vector<unsigned char>& downsampledData)
+{
+    int downsampledWidth = std::max(width / 2, 1);
+    int downsampledHeight = std::max(height / 2, 1);
+    downsampledData.resize(downsampledWidth * downsampledHeight * 4);
+    for (int y = 0; y < downsampledHeight; y++)
+    {
+        int y0 = std::min(y * 2, height - 1);
+        int y1 = std::min(y * 2 + 1, height - 1);
+        for (int x = 0; x < downsampledWidth; x++)
+        {
+            int x0 = std::min(x * 2, width - 1);
+            int x1 = std::min(x * 2 + 1, width - 1);
+            for (int i = 0; i < 4; i++)
+            {
+                int sum = imageData[(y0 * width + x0) * 4 + i] + imageData[(y0 * width + x1) * 4 + i] +
+                    imageData[(y1 * width + x0) * 4 + i] + imageData[(y1 * width + x1) * 4 + i];
+                downsampledData[(y * downsampledWidth + x) * 4 + i] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+}
 
 ImageManager::ImageManager()
 {
+    textureMemory = 0;
 }
 
 // Gets additional image data given the texture ID.
@@ -16,96 +51,316 @@ const ImageTexture& ImageManager::GetImage(GLuint textureId)
 }
 
 // Adds an image to the list of tracked images, returning the texture ID of that image.
-GLuint ImageManager::AddImage(const char* filename)
+GLuint ImageManager::AddImage(const char* filename, bool keepImageData)
+{
+    // Kept images need their image data, so they can't be read from the compressed texture cache.
+    DecodedImage image;
+    if (!(keepImageData ? DecodeImage(filename, &image) : ReadImage(filename, &image)))
+    {
+        return 0;
+    }
+
+    return AddDecodedImage(image, keepImageData);
+}
+
+bool ImageManager::DecodeImage(const char* filename, DecodedImage* image)
 {
     // Load in the image
-    int width = 0;
-    int height = 0;
     int channels = 0;
-    unsigned char* imageData = stbi_load(filename, &width, &height, &channels, STBI_rgb_alpha);
-    if (imageData && width && height)
+    image->imageData = stbi_load(filename, &image->width, &image->height, &channels, STBI_rgb_alpha);
+    return CheckDecodedImage(filename, *image);
+}
+
+bool ImageManager::ReadImage(const char* filename, DecodedImage* image)
+{
+    GLenum compressedFormat = GetCompressedFormat();
+    if (compressedFormat == 0)
     {
-        return CreateTexture(width, height, imageData);
+        return DecodeImage(filename, image);
     }
-    else
+
+    MappedFile imageFile;
+    if (!imageFile.Open(filename))
     {
-        std::stringstream errStream;
-        errStream << "Failed to load image:" << stbi_failure_reason();
-        Logger::LogError(errStream.str().c_str());
+        Logger::LogError("Failed to load image ", filename, ": could not read the file.");
+        return false;
     }
 
-    return 0;
+    image->sourceHash = CacheFile::HashContents(imageFile.GetData(), imageFile.GetSize());
+    image->cachePath = CacheFile::GetCacheFilePath(TextureCacheDirectory, filename, ".tftex");
+    if (ReadCompressedImage(compressedFormat, image))
+    {
+        return true;
+    }
+
+    // The image file is already mapped, so it is decoded from memory instead of being read again.
+    int channels = 0;
+    image->imageData = stbi_load_from_memory((const stbi_uc*)imageFile.GetData(), (int)imageFile.GetSize(), &image->width, &image->height, &channels, STBI_rgb_alpha);
+    return CheckDecodedImage(filename, *image);
 }
 
-GLuint ImageManager::LoadEmpty(int width, int height)
+bool ImageManager::CheckDecodedImage(const char* filename, const DecodedImage& image)
 {
-    unsigned char* data = new unsigned char[width * height * 4];
-    for (unsigned int i = 0; i < (unsigned int)(width * height); i++)
+    if (image.imageData && image.width && image.height)
     {
-        unsigned char redFactor = (i % 3 == 0) ? 255 : 0;
-        unsigned char greenFactor = (i % 3 == 1) ? 255 : 0;
-        unsigned char blueFactor = (i % 3 == 2) ? 255 : 0;
-
-        data[i * 4] = redFactor;
-        data[i * 4 + 1] = greenFactor;
-        data[i * 4 + 2] = blueFactor;
-        data[i * 4 + 3] = 255;
+        return true;
+    }
+    else
+    {
+        std::stringstream errStream;
+        errStream << "Failed to load image " << filename << ":" << stbi_failure_reason();
+        Logger::LogError(errStream.str().c_str());
     }
 
-    GLuint imageId = CreateTexture(width, height, data);
-    imageTextures[imageId].loadedFromStb = false;
-
-    return imageId;
+    return false;
 }
 
-void ImageManager::CopyToImage(GLuint srcImage, GLuint dstImage, int dstX, int dstY)
+void ImageManager::FreeDecodedImage(DecodedImage* image)
 {
-    // We have to copy over data in scanlines because the destination image is likely a different size.
-    int scanlineSize = imageTextures[srcImage].width * 4;
-    for (int i = 0; i < imageTextures[srcImage].height; i++)
+    if (image->imageData != nullptr)
     {
-        const unsigned char* startingLocation = imageTextures[srcImage].imageData + i * scanlineSize;
-        unsigned char* destinationLocation = imageTextures[dstImage].imageData + (dstX * 4) + (dstY + i) * 4 * imageTextures[dstImage].width;
-        memcpy(destinationLocation, startingLocation, sizeof(unsigned char) * scanlineSize);
+        stbi_image_free(image->imageData);
+        image->imageData = nullptr;
     }
+
+    std::vector<unsigned char>().swap(image->compressedData);
 }
 
-GLuint ImageManager::CreateTexture(int width, int height, unsigned char* imageData)
+GLuint ImageManager::AddDecodedImage(DecodedImage& image, bool keepImageData)
 {
     // Create a new texture for the image.
     GLuint newTextureId;
     glGenTextures(1, &newTextureId);
+    glBindTexture(GL_TEXTURE_2D, newTextureId);
+
+    size_t textureBytes;
+    GLenum compressedFormat = GetCompressedFormat();
+    if (!image.compressedData.empty())
+    {
+        textureBytes = SendCompressedImage(image);
+    }
+    else if (compressedFormat != 0)
+    {
+        textureBytes = CompressImage(image, compressedFormat);
+    }
+    else
+    {
+        textureBytes = SendImage(image);
+    }
 
-    imageTextures[newTextureId] = ImageTexture(newTextureId, imageData, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    // Bind the texture and send in image data
-    glBindTexture(GL_TEXTURE_2D, newTextureId);
-    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
-    ResendToOpenGl(newTextureId);
+    // OpenGL has its own copy now.
+    imageTextures[newTextureId] = ImageTexture(newTextureId, keepImageData ? image.imageData : nullptr, image.width, image.height, textureBytes);
+    if (keepImageData)
+    {
+        image.imageData = nullptr;
+    }
 
+    FreeDecodedImage(&image);
+    textureMemory += textureBytes;
     return newTextureId;
 }
 
-void ImageManager::ResendToOpenGl(GLuint imageId)
+size_t ImageManager::SendImage(const DecodedImage& image)
 {
-    const ImageTexture& image = imageTextures[imageId];
+    int mipmapLevels = GetMipmapLevels(image.width, image.height);
+    glTexStorage2D(GL_TEXTURE_2D, mipmapLevels, GL_RGBA8, image.width, image.height);
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.width, image.height, GL_RGBA, GL_UNSIGNED_BYTE, image.imageData);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    size_t textureBytes = 0;
+    for (int i = 0; i < mipmapLevels; i++)
+    {
+        textureBytes += (size_t)std::max(image.width >> i, 1) * std::max(image.height >> i, 1) * 4;
+    }
+
+    return textureBytes;
+}
+
+size_t ImageManager::CompressImage(DecodedImage& image, GLenum compressedFormat)
+{
+    // The mipmaps are made here instead of by OpenGL, which can't generate mipmaps of every compressed format,
+    //  and the driver compresses each level as it is sent.
+    int mipmapLevels = GetMipmapLevels(image.width, image.height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmapLevels - 1);
+
+    std::vector<unsigned char> levelData;
+    std::vector<unsigned char> nextLevelData;
+    const unsigned char* levelPixels = image.imageData;
+    bool isCompressed = true;
+    size_t textureBytes = 0;
+    image.compressedLevelSizes.clear();
+    for (int i = 0; i < mipmapLevels; i++)
+    {
+        int levelWidth = std::max(image.width >> i, 1);
+        int levelHeight = std::max(image.height >> i, 1);
+        glTexImage2D(GL_TEXTURE_2D, i, compressedFormat, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, levelPixels);
+
+        GLint isLevelCompressed = GL_FALSE;
+        GLint levelSize = levelWidth * levelHeight * 4;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_COMPRESSED, &isLevelCompressed);
+        if (isLevelCompressed == GL_TRUE)
+        {
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &levelSize);
+        }
+
+        isCompressed = isCompressed && isLevelCompressed == GL_TRUE;
+        image.compressedLevelSizes.push_back((unsigned int)levelSize);
+        textureBytes += levelSize;
+
+        if (i + 1 < mipmapLevels)
+        {
+            DownsampleImage(levelPixels, levelWidth, levelHeight, nextLevelData);
+            levelData.swap(nextLevelData);
+            levelPixels = &levelData[0];
+        }
+    }
+
+    // Read back what the driver compressed, so later loads can send it as-is.
+    if (isCompressed && !image.cachePath.empty())
+    {
+        image.compressedFormat = compressedFormat;
+        image.compressedData.resize(textureBytes);
+
+        size_t levelOffset = 0;
+        for (int i = 0; i < mipmapLevels; i++)
+        {
+            glGetCompressedTexImage(GL_TEXTURE_2D, i, &image.compressedData[levelOffset]);
+            levelOffset += image.compressedLevelSizes[i];
+        }
+
+        // A texture that can't be cached still loaded fine, it'll just be compressed again next time.
+        if (!WriteCompressedImage(image))
+        {
+            Logger::LogWarn("Could not write the compressed texture ", image.cachePath, ".");
+        }
+    }
+
+    return textureBytes;
+}
+
+size_t ImageManager::SendCompressedImage(const DecodedImage& image)
+{
+    int mipmapLevels = (int)image.compressedLevelSizes.size();
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmapLevels - 1);
+
+    size_t levelOffset = 0;
+    for (int i = 0; i < mipmapLevels; i++)
+    {
+        glCompressedTexImage2D(GL_TEXTURE_2D, i, image.compressedFormat, std::max(image.width >> i, 1), std::max(image.height >> i, 1), 0,
+            image.compressedLevelSizes[i], &image.compressedData[levelOffset]);
+        levelOffset += image.compressedLevelSizes[i];
+    }
+
+    return levelOffset;
+}
+
+bool ImageManager::ReadCompressedImage(GLenum compressedFormat, DecodedImage* image)
+{
+    MappedFile compressedImageFile;
+    if (!compressedImageFile.Open(image->cachePath.c_str()) || compressedImageFile.GetSize() < sizeof(CompressedImageHeader))
+    {
+        return false;
+    }
+
+    CompressedImageHeader header;
+    memcpy(&header, compressedImageFile.GetData(), sizeof(CompressedImageHeader));
+    if (memcmp(header.magic, CompressedImageMagic, sizeof(CompressedImageMagic)) != 0 || header.version != CompressedImageVersion ||
+        header.sourceHash != image->sourceHash || header.format != compressedFormat || header.width <= 0 || header.height <= 0 ||
+        header.levelCount != (unsigned int)GetMipmapLevels(header.width, header.height) || header.levelCount > CompressedImageHeader::MAX_LEVELS)
+    {
+        return false;
+    }
+
+    size_t dataSize = 0;
+    for (unsigned int i = 0; i < header.levelCount; i++)
+    {
+        dataSize += header.levelSizes[i];
+    }
+
+    if (compressedImageFile.GetSize() != sizeof(CompressedImageHeader) + dataSize)
+    {
+        return false;
+    }
+
+    const unsigned char* data = (const unsigned char*)compressedImageFile.GetData() + sizeof(CompressedImageHeader);
+    image->width = header.width;
+    image->height = header.height;
+    image->compressedFormat = header.format;
+    image->compressedLevelSizes.assign(header.levelSizes, header.levelSizes + header.levelCount);
+    image->compressedData.assign(data, data + dataSize);
+    return true;
+}
+
+bool ImageManager::WriteCompressedImage(const DecodedImage& image)
+{
+    if (image.compressedLevelSizes.size() > CompressedImageHeader::MAX_LEVELS || !CacheFile::CreateDirectories(TextureCacheDirectory))
+    {
+        return false;
+    }
+
+    CompressedImageHeader header;
+    memset(&header, 0, sizeof(CompressedImageHeader));
+    memcpy(header.magic, CompressedImageMagic, sizeof(CompressedImageMagic));
+    header.version = CompressedImageVersion;
+    header.sourceHash = image.sourceHash;
+    header.format = image.compressedFormat;
+    header.width = image.width;
+    header.height = image.height;
+    header.levelCount = (unsigned int)image.compressedLevelSizes.size();
+    std::copy(image.compressedLevelSizes.begin(), image.compressedLevelSizes.end(), header.levelSizes);
+
+    return CacheFile::Write(image.cachePath, &header, sizeof(CompressedImageHeader), image.compressedData.data(), image.compressedData.size());
+}
+
+GLenum ImageManager::GetCompressedFormat()
+{
+    if (!GraphicsConfig::CompressTextures)
+    {
+        return 0;
+    }
+
+    // BPTC keeps more detail than S3TC at the same size, but older GPUs only support S3TC.
+    if (GLEW_ARB_texture_compression_bptc)
+    {
+        return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }
+    else if (GLEW_EXT_texture_compression_s3tc)
+    {
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    }
+
+    return 0;
+}
+
+int ImageManager::GetMipmapLevels(int width, int height)
+{
+    int mipmapLevels = 1;
+    while ((std::max(width, height) >> mipmapLevels) != 0)
+    {
+        ++mipmapLevels;
+    }
+
+    return mipmapLevels;
+}
+
+size_t ImageManager::GetTextureMemory() const
+{
+    return textureMemory;
 }
 
 ImageManager::~ImageManager()
 {
-    // Free all of the loaded textures and in-memory image data at program end.
+    // Free all of the loaded textures and any kept image data at program end.
     for (std::map<GLuint, ImageTexture>::iterator iterator = imageTextures.begin(); iterator != imageTextures.end(); iterator++)
     {
         glDeleteTextures(1, &iterator->first);
 
-        if (iterator->second.loadedFromStb)
+        if (iterator->second.imageData != nullptr)
         {
             stbi_image_free(iterator->second.imageData);
         }
-        else
-        {
-            delete[] iterator->second.imageData;
-        }
     }
 }
@@ -0,0 +1,20 @@
+#include "InputQueue.h"
+
+InputQueue::InputQueue()
+{
+}
+
+void InputQueue::QueueEvent(const InputEvent& inputEvent)
+{
+    WriteLock writeLock(queueMutex);
+    queuedEvents.push_back(inputEvent);
+}
+
+void InputQueue::TakeEvents(std::vector<InputEvent>& events)
+{
+    events.clear();
+
+    // Swapping keeps both vectors' storage around, so steady-state input doesn't allocate.
+    WriteLock writeLock(queueMutex);
+    events.swap(queuedEvents);
+}
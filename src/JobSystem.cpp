@@ -0,0 +1,188 @@
+#include "JobSystem.h"
+
+// The job system and queue the current thread works from, if it is a worker thread.
+static thread_local const JobSystem* currentJobSystem = nullptr;
+static thread_local unsigned int currentQueueIndex = 0;
+
+JobSystem::JobSystem()
+    : queuedJobs(0), isRunning(false)
+{
+    jobQueues.push_back(std::unique_ptr<JobQueue>(new JobQueue()));
+}
+
+JobSystem::~JobSystem()
+{
+    Shutdown();
+}
+
+void JobSystem::Initialize(unsigned int workerCount)
+{
+    Shutdown();
+
+    isRunning = true;
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        jobQueues.push_back(std::unique_ptr<JobQueue>(new JobQueue()));
+    }
+
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        workers.push_back(std::thread(&JobSystem::WorkerLoop, this, i + 1));
+    }
+}
+
+void JobSystem::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        isRunning = false;
+    }
+
+    sleepCondition.notify_all();
+    for (unsigned int i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    workers.clear();
+    jobQueues.resize(1);
+}
+
+unsigned int JobSystem::GetThreadCount() const
+{
+    return (unsigned int)workers.size() + 1;
+}
+
+unsigned int JobSystem::GetCurrentThreadIndex() const
+{
+    return GetCurrentQueueIndex();
+}
+
+unsigned int JobSystem::DefaultWorkerCount()
+{
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void JobSystem::ParallelFor(unsigned int startIndex, unsigned int endIndex, unsigned int grainSize, const RangeFunction& rangeFunction)
+{
+    if (startIndex >= endIndex)
+    {
+        return;
+    }
+
+    if (grainSize == 0)
+    {
+        grainSize = 1;
+    }
+
+    // Small ranges (or no workers) aren't worth the queueing overhead.
+    if (workers.size() == 0 || endIndex - startIndex <= grainSize)
+    {
+        rangeFunction(startIndex, endIndex);
+        return;
+    }
+
+    unsigned int jobCount = (endIndex - startIndex + grainSize - 1) / grainSize;
+    std::atomic<unsigned int> remainingJobs(jobCount);
+
+    unsigned int queueIndex = GetCurrentQueueIndex();
+    queuedJobs += jobCount;
+    {
+        JobQueue& jobQueue = *jobQueues[queueIndex];
+        std::lock_guard<std::mutex> lock(jobQueue.mutex);
+        for (unsigned int i = startIndex; i < endIndex; i += grainSize)
+        {
+            Job job;
+            job.rangeFunction = &rangeFunction;
+            job.startIndex = i;
+            job.endIndex = endIndex - i > grainSize ? i + grainSize : endIndex;
+            job.remainingJobs = &remainingJobs;
+            jobQueue.jobs.push_back(job);
+        }
+    }
+
+    // Taking the sleep mutex ensures a worker can't miss the wakeup between checking for jobs and sleeping.
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+
+    sleepCondition.notify_all();
+
+    // Help out until our range is done. Any job may be run here, which is what allows parallel-for calls to nest.
+    while (remainingJobs.load() != 0)
+    {
+        if (!TryRunJob(queueIndex))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+unsigned int JobSystem::GetCurrentQueueIndex() const
+{
+    return currentJobSystem == this ? currentQueueIndex : 0;
+}
+
+// Pops the most-recently queued job from the back of our own queue.
+bool JobSystem::TryPopJob(unsigned int queueIndex, Job* job)
+{
+    JobQueue& jobQueue = *jobQueues[queueIndex];
+    std::lock_guard<std::mutex> lock(jobQueue.mutex);
+    if (jobQueue.jobs.empty())
+    {
+        return false;
+    }
+
+    *job = jobQueue.jobs.back();
+    jobQueue.jobs.pop_back();
+    return true;
+}
+
+// Steals the oldest job from the front of another thread's queue.
+bool JobSystem::TryStealJob(unsigned int queueIndex, Job* job)
+{
+    unsigned int queueCount = (unsigned int)jobQueues.size();
+    for (unsigned int i = 1; i < queueCount; i++)
+    {
+        JobQueue& jobQueue = *jobQueues[(queueIndex + i) % queueCount];
+        std::lock_guard<std::mutex> lock(jobQueue.mutex);
+        if (!jobQueue.jobs.empty())
+        {
+            *job = jobQueue.jobs.front();
+            jobQueue.jobs.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::TryRunJob(unsigned int queueIndex)
+{
+    Job job;
+    if (!TryPopJob(queueIndex, &job) && !TryStealJob(queueIndex, &job))
+    {
+        return false;
+    }
+
+    --queuedJobs;
+    (*job.rangeFunction)(job.startIndex, job.endIndex);
+    --(*job.remainingJobs);
+    return true;
+}
+
+void JobSystem::WorkerLoop(unsigned int queueIndex)
+{
+    currentJobSystem = this;
+    currentQueueIndex = queueIndex;
+
+    while (isRunning)
+    {
+        if (!TryRunJob(queueIndex))
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait(lock, [this] { return queuedJobs.load() != 0 || !isRunning; });
+        }
+    }
+}
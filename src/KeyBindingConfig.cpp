@@ -1,3 +1,7 @@
+#include <sstream>
+#include "ConversionUtils.h"
+#include "Logger.h"
+#include "StringUtils.h"
 #include "KeyBindingConfig.h"
 
 sf::Keyboard::Key KeyBindingConfig::MoveLeft;
@@ -10,6 +14,26 @@ sf::Keyboard::Key KeyBindingConfig::ToggleTechTreeWindow;
 sf::Keyboard::Key KeyBindingConfig::ToggleResourcesWindow;
 sf::Keyboard::Key KeyBindingConfig::ToggleBuildingsWindow;;
 
+bool KeyBindingConfig::ReadKey(std::vector<std::string>& configFileLines, sf::Keyboard::Key& key, const char* errorMessage)
+{
+    int keyInt;
+    if (!ConversionUtils::LoadInt(configFileLines[++lineCounter], keyInt))
+    {
+        Logger::Log(errorMessage);
+        return false;
+    }
+
+    key = (sf::Keyboard::Key)keyInt;
+    return true;
+}
+
+void KeyBindingConfig::WriteKey(const char* itemName, sf::Keyboard::Key& key)
+{
+    std::stringstream tempOutput;
+    tempOutput << itemName << StringUtils::Space << (int)key;
+    outputLines.push_back(tempOutput.str());
+}
+
 bool KeyBindingConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
 {
     return (ReadKey(configFileLines, MoveLeft, "Error decoding the move left key!") &&
@@ -0,0 +1,428 @@
+#include <algorithm>
+#include <cmath>
+#include "LocalAvoidance.h"
+
+const unsigned int LocalAvoidance::MaxNeighbors;
+float LocalAvoidance::NeighborRadius = 5.0f;
+float LocalAvoidance::TimeHorizon = 10.0f;
+float LocalAvoidance::SeparationMargin = 0.2f;
+
+static const float Epsilon = 0.00001f;
+
+// The most cells the neighbor grid always allows, so small agent counts still get small cells.
+static const unsigned int MinGridCells = 4096;
+
+static inline float Dot(const vec::vec2& first, const vec::vec2& second)
+{
+    return first.x * second.x + first.y * second.y;
+}
+
+// 2D cross product, positive if the second vector is counter-clockwise from the first.
+static inline float Determinant(const vec::vec2& first, const vec::vec2& second)
+{
+    return first.x * second.y - first.y * second.x;
+}
+
+static inline vec::vec2 Normalize(const vec::vec2& vector)
+{
+    return vector / std::sqrt(Dot(vector, vector));
+}
+
+LocalAvoidance::LocalAvoidance()
+{
+    gridCellSize = NeighborRadius;
+    gridMinCell = vec::vec2i(0, 0);
+    gridSize = vec::vec2i(0, 0);
+}
+
+void LocalAvoidance::Clear()
+{
+    agents.clear();
+    playerOffsets.clear();
+}
+
+AvoidanceAgent* LocalAvoidance::AddPlayerAgents(unsigned int playerId, unsigned int unitCount)
+{
+    // Players without units still need an offset, so later players line up with their IDs.
+    while (playerOffsets.size() <= playerId)
+    {
+        playerOffsets.push_back((unsigned int)agents.size());
+    }
+
+    agents.resize(agents.size() + unitCount);
+    return agents.data() + playerOffsets[playerId];
+}
+
+const AvoidanceAgent& LocalAvoidance::GetAgent(unsigned int playerId, unsigned int unitId) const
+{
+    return agents[playerOffsets[playerId] + unitId];
+}
+
+vec::vec2i LocalAvoidance::GetCell(const vec::vec2& position) const
+{
+    return vec::vec2i((int)std::floor(position.x / gridCellSize), (int)std::floor(position.y / gridCellSize));
+}
+
+void LocalAvoidance::BuildAgentGrid()
+{
+    // Agents without a radius aren't avoided, so they're left out of the grid.
+    unsigned int gridAgentCount = 0;
+    vec::vec2 minPosition;
+    vec::vec2 maxPosition;
+    for (unsigned int i = 0; i < agents.size(); i++)
+    {
+        if (agents[i].radius <= 0.0f)
+        {
+            continue;
+        }
+
+        if (gridAgentCount == 0)
+        {
+            minPosition = agents[i].position;
+            maxPosition = agents[i].position;
+        }
+
+        minPosition = vec::vec2(std::min(minPosition.x, agents[i].position.x), std::min(minPosition.y, agents[i].position.y));
+        maxPosition = vec::vec2(std::max(maxPosition.x, agents[i].position.x), std::max(maxPosition.y, agents[i].position.y));
+        ++gridAgentCount;
+    }
+
+    if (gridAgentCount == 0)
+    {
+        gridSize = vec::vec2i(0, 0);
+        return;
+    }
+
+    // Cells half as wide as the neighbor radius check less area outside of the radius than cells as wide as it.
+    // Agents spread far apart use larger cells instead, so the grid stays within a few cells per agent.
+    const unsigned int maxCellCount = std::max(MinGridCells, gridAgentCount * 16);
+
+    gridCellSize = NeighborRadius * 0.5f;
+    while (true)
+    {
+        gridMinCell = GetCell(minPosition);
+        gridSize = GetCell(maxPosition) - gridMinCell + vec::vec2i(1, 1);
+        if ((unsigned long long)gridSize.x * (unsigned long long)gridSize.y <= maxCellCount)
+        {
+            break;
+        }
+
+        gridCellSize *= 2.0f;
+    }
+
+    // Agents are added in index order, so each cell lists its agents in index order.
+    cellStarts.assign(gridSize.x * gridSize.y + 1, 0);
+    cellAgents.resize(gridAgentCount);
+    for (unsigned int i = 0; i < agents.size(); i++)
+    {
+        if (agents[i].radius <= 0.0f)
+        {
+            continue;
+        }
+
+        vec::vec2i cell = GetCell(agents[i].position) - gridMinCell;
+        ++cellStarts[cell.y * gridSize.x + cell.x + 1];
+    }
+
+    for (unsigned int i = 1; i < cellStarts.size(); i++)
+    {
+        cellStarts[i] += cellStarts[i - 1];
+    }
+
+    for (unsigned int i = 0; i < agents.size(); i++)
+    {
+        if (agents[i].radius <= 0.0f)
+        {
+            continue;
+        }
+
+        vec::vec2i cell = GetCell(agents[i].position) - gridMinCell;
+        cellAgents[cellStarts[cell.y * gridSize.x + cell.x]++] = i;
+    }
+
+    // Filling in the agents moved each cell start to the start of the next cell.
+    for (unsigned int i = (unsigned int)cellStarts.size() - 1; i > 0; i--)
+    {
+        cellStarts[i] = cellStarts[i - 1];
+    }
+
+    cellStarts[0] = 0;
+}
+
+unsigned int LocalAvoidance::FindNeighbors(unsigned int agentIndex, std::vector<std::pair<float, const AvoidanceAgent*>>& neighborDistances,
+    const AvoidanceAgent** neighbors) const
+{
+    const AvoidanceAgent& agent = agents[agentIndex];
+    vec::vec2i minCell = GetCell(agent.position - vec::vec2(NeighborRadius, NeighborRadius)) - gridMinCell;
+    vec::vec2i maxCell = GetCell(agent.position + vec::vec2(NeighborRadius, NeighborRadius)) - gridMinCell;
+    minCell = vec::vec2i(std::max(minCell.x, 0), std::max(minCell.y, 0));
+    maxCell = vec::vec2i(std::min(maxCell.x, gridSize.x - 1), std::min(maxCell.y, gridSize.y - 1));
+
+    // Avoidance happens in the XY plane, so compare distances in that plane. Units on another level of the map are skipped.
+    neighborDistances.clear();
+    for (int y = minCell.y; y <= maxCell.y; y++)
+    {
+        unsigned int rowEnd = cellStarts[y * gridSize.x + maxCell.x + 1];
+        for (unsigned int i = cellStarts[y * gridSize.x + minCell.x]; i < rowEnd; i++)
+        {
+            if (cellAgents[i] == agentIndex)
+            {
+                continue;
+            }
+
+            const AvoidanceAgent& neighbor = agents[cellAgents[i]];
+            vec::vec2 offset = neighbor.position - agent.position;
+            float distanceSquared = Dot(offset, offset);
+            if (distanceSquared < NeighborRadius * NeighborRadius && std::abs(neighbor.height - agent.height) <= NeighborRadius + neighbor.radius)
+            {
+                neighborDistances.push_back(std::make_pair(distanceSquared, &neighbor));
+            }
+        }
+    }
+
+    // Keep only the closest neighbors, breaking ties by agent order so the result is deterministic.
+    unsigned int neighborCount = std::min((unsigned int)neighborDistances.size(), MaxNeighbors);
+    std::partial_sort(neighborDistances.begin(), neighborDistances.begin() + neighborCount, neighborDistances.end());
+    for (unsigned int i = 0; i < neighborCount; i++)
+    {
+        neighbors[i] = neighborDistances[i].second;
+    }
+
+    return neighborCount;
+}
+
+void LocalAvoidance::ComputeAvoidanceVelocities(JobSystem& jobSystem)
+{
+    BuildAgentGrid();
+    threadNeighborDistances.resize(jobSystem.GetThreadCount());
+    jobSystem.ParallelFor(0, (unsigned int)agents.size(), 32, [&](unsigned int startIndex, unsigned int endIndex)
+    {
+        std::vector<std::pair<float, const AvoidanceAgent*>>& neighborDistances = threadNeighborDistances[jobSystem.GetCurrentThreadIndex()];
+        const AvoidanceAgent* neighbors[MaxNeighbors];
+
+        for (unsigned int i = startIndex; i < endIndex; i++)
+        {
+            if (agents[i].radius <= 0.0f)
+            {
+                agents[i].avoidanceVelocity = agents[i].preferredVelocity;
+                continue;
+            }
+
+            unsigned int neighborCount = FindNeighbors(i, neighborDistances, neighbors);
+            agents[i].avoidanceVelocity = ComputeAvoidanceVelocity(agents[i], neighbors, neighborCount);
+        }
+    });
+}
+
+// Adapted from the RVO2 library (van den Berg et al.), restricted to unit-unit avoidance.
+vec::vec2 LocalAvoidance::ComputeAvoidanceVelocity(const AvoidanceAgent& agent, const AvoidanceAgent* const* neighbors, unsigned int neighborCount)
+{
+    OrcaLine lines[MaxNeighbors] = {};
+    unsigned int lineCount = std::min(neighborCount, MaxNeighbors);
+
+    const float inverseTimeHorizon = 1.0f / TimeHorizon;
+    for (unsigned int i = 0; i < lineCount; i++)
+    {
+        const AvoidanceAgent& neighbor = *neighbors[i];
+        vec::vec2 relativePosition = neighbor.position - agent.position;
+        vec::vec2 relativeVelocity = agent.velocity - neighbor.velocity;
+        float distanceSquared = Dot(relativePosition, relativePosition);
+        float combinedRadius = (agent.radius + neighbor.radius) * (1.0f + SeparationMargin);
+        float combinedRadiusSquared = combinedRadius * combinedRadius;
+
+        OrcaLine& line = lines[i];
+        vec::vec2 u;
+        if (distanceSquared > combinedRadiusSquared)
+        {
+            // No collision yet. Find the closest point on the truncated velocity obstacle cone.
+            vec::vec2 w = relativeVelocity - relativePosition * inverseTimeHorizon;
+            float wLengthSquared = Dot(w, w);
+            float wDotPosition = Dot(w, relativePosition);
+
+            if (wDotPosition < 0.0f && wDotPosition * wDotPosition > combinedRadiusSquared * wLengthSquared)
+            {
+                // Project on the cutoff circle.
+                float wLength = std::sqrt(wLengthSquared);
+                vec::vec2 unitW = w / wLength;
+                line.direction = vec::vec2(unitW.y, -unitW.x);
+                u = unitW * (combinedRadius * inverseTimeHorizon - wLength);
+            }
+            else
+            {
+                // Project on the legs of the cone.
+                float leg = std::sqrt(distanceSquared - combinedRadiusSquared);
+                if (Determinant(relativePosition, w) > 0.0f)
+                {
+                    line.direction = vec::vec2(relativePosition.x * leg - relativePosition.y * combinedRadius,
+                        relativePosition.x * combinedRadius + relativePosition.y * leg) / distanceSquared;
+                }
+                else
+                {
+                    line.direction = -vec::vec2(relativePosition.x * leg + relativePosition.y * combinedRadius,
+                        -relativePosition.x * combinedRadius + relativePosition.y * leg) / distanceSquared;
+                }
+
+                u = line.direction * Dot(relativeVelocity, line.direction) - relativeVelocity;
+            }
+        }
+        else
+        {
+            // Already overlapping, so push apart within a single tick.
+            vec::vec2 w = relativeVelocity - relativePosition;
+            float wLength = std::sqrt(Dot(w, w));
+            vec::vec2 unitW = wLength > Epsilon ? w / wLength : vec::vec2(1.0f, 0.0f);
+            line.direction = vec::vec2(unitW.y, -unitW.x);
+            u = unitW * (combinedRadius - wLength);
+        }
+
+        line.point = agent.velocity + u * 0.5f;
+    }
+
+    vec::vec2 result = agent.preferredVelocity;
+    unsigned int failedLine = SolveWithinLines(lines, lineCount, agent.maxSpeed, agent.preferredVelocity, false, result);
+    if (failedLine < lineCount)
+    {
+        SolveLeastPenetration(lines, lineCount, failedLine, agent.maxSpeed, result);
+    }
+
+    return result;
+}
+
+// Finds the best velocity on the given line that satisfies all prior lines. Returns false if there is none.
+bool LocalAvoidance::SolveOnLine(const OrcaLine* lines, unsigned int lineNumber, float radius, const vec::vec2& optimizationVelocity, bool directionOptimal, vec::vec2& result)
+{
+    const OrcaLine& line = lines[lineNumber];
+    float dotProduct = Dot(line.point, line.direction);
+    float discriminant = dotProduct * dotProduct + radius * radius - Dot(line.point, line.point);
+    if (discriminant < 0.0f)
+    {
+        // The maximum speed circle doesn't reach the line.
+        return false;
+    }
+
+    float discriminantRoot = std::sqrt(discriminant);
+    float tLeft = -dotProduct - discriminantRoot;
+    float tRight = -dotProduct + discriminantRoot;
+    for (unsigned int i = 0; i < lineNumber; i++)
+    {
+        float denominator = Determinant(line.direction, lines[i].direction);
+        float numerator = Determinant(lines[i].direction, line.point - lines[i].point);
+        if (std::abs(denominator) <= Epsilon)
+        {
+            // Parallel lines.
+            if (numerator < 0.0f)
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        float t = numerator / denominator;
+        if (denominator >= 0.0f)
+        {
+            tRight = std::min(tRight, t);
+        }
+        else
+        {
+            tLeft = std::max(tLeft, t);
+        }
+
+        if (tLeft > tRight)
+        {
+            return false;
+        }
+    }
+
+    if (directionOptimal)
+    {
+        result = line.point + line.direction * (Dot(optimizationVelocity, line.direction) > 0.0f ? tRight : tLeft);
+    }
+    else
+    {
+        float t = Dot(line.direction, optimizationVelocity - line.point);
+        result = line.point + line.direction * std::min(std::max(t, tLeft), tRight);
+    }
+
+    return true;
+}
+
+// Finds the velocity closest to the optimization velocity satisfying all lines.
+// Returns the line count on success, or the index of the line that couldn't be satisfied.
+unsigned int LocalAvoidance::SolveWithinLines(const OrcaLine* lines, unsigned int lineCount, float radius, const vec::vec2& optimizationVelocity, bool directionOptimal, vec::vec2& result)
+{
+    if (directionOptimal)
+    {
+        // The optimization velocity is a unit direction.
+        result = optimizationVelocity * radius;
+    }
+    else if (Dot(optimizationVelocity, optimizationVelocity) > radius * radius)
+    {
+        result = Normalize(optimizationVelocity) * radius;
+    }
+    else
+    {
+        result = optimizationVelocity;
+    }
+
+    for (unsigned int i = 0; i < lineCount; i++)
+    {
+        if (Determinant(lines[i].direction, lines[i].point - result) > 0.0f)
+        {
+            // The current result violates this line.
+            vec::vec2 previousResult = result;
+            if (!SolveOnLine(lines, i, radius, optimizationVelocity, directionOptimal, result))
+            {
+                result = previousResult;
+                return i;
+            }
+        }
+    }
+
+    return lineCount;
+}
+
+// When the lines can't all be satisfied (the unit is boxed in), finds the velocity that minimizes the worst violation.
+void LocalAvoidance::SolveLeastPenetration(const OrcaLine* lines, unsigned int lineCount, unsigned int failedLine, float radius, vec::vec2& result)
+{
+    OrcaLine projectedLines[MaxNeighbors];
+    float distance = 0.0f;
+    for (unsigned int i = failedLine; i < lineCount; i++)
+    {
+        if (Determinant(lines[i].direction, lines[i].point - result) > distance)
+        {
+            unsigned int projectedLineCount = 0;
+            for (unsigned int j = 0; j < i; j++)
+            {
+                OrcaLine projectedLine;
+                float determinant = Determinant(lines[i].direction, lines[j].direction);
+                if (std::abs(determinant) <= Epsilon)
+                {
+                    if (Dot(lines[i].direction, lines[j].direction) > 0.0f)
+                    {
+                        // Same direction.
+                        continue;
+                    }
+
+                    projectedLine.point = (lines[i].point + lines[j].point) * 0.5f;
+                }
+                else
+                {
+                    projectedLine.point = lines[i].point + lines[i].direction * (Determinant(lines[j].direction, lines[i].point - lines[j].point) / determinant);
+                }
+
+                projectedLine.direction = Normalize(lines[j].direction - lines[i].direction);
+                projectedLines[projectedLineCount++] = projectedLine;
+            }
+
+            vec::vec2 previousResult = result;
+            if (SolveWithinLines(projectedLines, projectedLineCount, radius, vec::vec2(-lines[i].direction.y, lines[i].direction.x), true, result) < projectedLineCount)
+            {
+                // Can only happen due to floating point error, in which case the previous result is kept.
+                result = previousResult;
+            }
+
+            distance = Determinant(lines[i].direction, lines[i].point - result);
+        }
+    }
+}
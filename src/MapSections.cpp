@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <set>
 #include <queue>
@@ -17,6 +18,22 @@ void MapSections::RecomputeMapSections(const MapInfo& mapInfo)
     int nextSubsectionId = 0;
 
     subsections.clear();
+    mapSize = vec::vec3i((int)mapInfo.xSize, (int)mapInfo.ySize, (int)mapInfo.zSize);
+    solidVoxels.resize(mapInfo.GetVoxelCount());
+    columnHeights.assign(mapInfo.xSize * mapInfo.ySize, 0);
+    for (int i = 0; i < mapInfo.GetVoxelCount(); i++)
+    {
+        solidVoxels[i] = mapInfo.blockType[i] != MapInfo::VoxelTypes::AIR ? 1 : 0;
+        if (solidVoxels[i] != 0)
+        {
+            // Voxels are stored by increasing z, so the last solid voxel in a column is the highest.
+            int column = i % (int)(mapInfo.xSize * mapInfo.ySize);
+            columnHeights[column] = (unsigned char)(i / (int)(mapInfo.xSize * mapInfo.ySize) + 1);
+        }
+    }
+
+    surface.Rebuild(mapInfo);
+
     for (unsigned int z = 0; z < mapInfo.zSize; z++)
     {
         for (unsigned int y = 0; y < mapInfo.ySize; y++)
@@ -84,6 +101,45 @@ void MapSections::RecomputeMapSections(const MapInfo& mapInfo)
     }
 }
 
+void MapSections::UpdateColumns(const MapInfo& mapInfo, int minX, int minY, int maxX, int maxY)
+{
+    if (solidVoxels.empty())
+    {
+        // There's no map to update yet.
+        return;
+    }
+
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, mapSize.x - 1);
+    maxY = std::min(maxY, mapSize.y - 1);
+    for (int y = minY; y <= maxY; y++)
+    {
+        for (int x = minX; x <= maxX; x++)
+        {
+            UpdateColumn(mapInfo, x, y);
+        }
+    }
+
+    surface.UpdateColumns(mapInfo, minX, minY, maxX, maxY);
+}
+
+void MapSections::UpdateColumn(const MapInfo& mapInfo, int x, int y)
+{
+    unsigned char columnHeight = 0;
+    for (int z = 0; z < mapSize.z; z++)
+    {
+        int index = mapInfo.GetIndex(x, y, z);
+        solidVoxels[index] = mapInfo.blockType[index] != MapInfo::VoxelTypes::AIR ? 1 : 0;
+        if (solidVoxels[index] != 0)
+        {
+            columnHeight = (unsigned char)(z + 1);
+        }
+    }
+
+    columnHeights[y * mapSize.x + x] = columnHeight;
+}
+
 // Computes a route between two points using the map sections. Returns true (and fills in the path) if a path was found, false otherwise.
 bool MapSections::ComputeRoute(const vec::vec3i start, const vec::vec3i destination, std::vector<vec::vec3i>& path)
 {
@@ -162,6 +218,153 @@ const voxelSubsectionsMap& MapSections::GetSubsections() const
     return subsections;
 }
 
+bool MapSections::GetVoxelUnderPosition(const vec::vec3& position, vec::vec3i* voxelId) const
+{
+    // Units hover over the top of the voxel they're on, so check both the voxel the unit is in and the one below it.
+    vec::vec3i candidate = vec::vec3i((int)std::floor(position.x / MapInfo::SPACING), (int)std::floor(position.y / MapInfo::SPACING), (int)std::floor(position.z / MapInfo::SPACING));
+    for (int i = 0; i < 2; i++)
+    {
+        if (subsections.find(candidate) != subsections.end())
+        {
+            *voxelId = candidate;
+            return true;
+        }
+
+        candidate.z--;
+    }
+
+    return false;
+}
+
+bool MapSections::CanTraverse(const vec::vec3& start, const vec::vec3& end) const
+{
+    vec::vec3i startVoxel, endVoxel;
+    if (!GetVoxelUnderPosition(start, &startVoxel) || !GetVoxelUnderPosition(end, &endVoxel))
+    {
+        return false;
+    }
+
+    if (startVoxel.x == endVoxel.x && startVoxel.y == endVoxel.y && startVoxel.z == endVoxel.z)
+    {
+        return true;
+    }
+
+    const std::vector<vec::vec3i>& neighbors = subsections.find(startVoxel)->second.neighbors;
+    for (unsigned int i = 0; i < neighbors.size(); i++)
+    {
+        if (neighbors[i].x == endVoxel.x && neighbors[i].y == endVoxel.y && neighbors[i].z == endVoxel.z)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const vec::vec3i& MapSections::GetMapSize() const
+{
+    return mapSize;
+}
+
+const std::vector<unsigned char>& MapSections::GetColumnHeights() const
+{
+    return columnHeights;
+}
+
+const SurfaceHeightfield& MapSections::GetSurface() const
+{
+    return surface;
+}
+
+bool MapSections::TraceSegment(const vec::vec3& start, const vec::vec3& end, float* hitFactor) const
+{
+    if (solidVoxels.empty())
+    {
+        return false;
+    }
+
+    // Clip the segment to the map, as nothing outside of it can be hit.
+    vec::vec3 segment = end - start;
+    vec::vec3 mapMax = MapInfo::SPACING * vec::vec3((float)mapSize.x, (float)mapSize.y, (float)mapSize.z);
+    float entryFactor = 0.0f;
+    float exitFactor = 1.0f;
+    for (int i = 0; i < 3; i++)
+    {
+        if (segment[i] == 0.0f)
+        {
+            if (start[i] < 0.0f || start[i] >= mapMax[i])
+            {
+                return false;
+            }
+        }
+        else
+        {
+            float firstFactor = -start[i] / segment[i];
+            float secondFactor = (mapMax[i] - start[i]) / segment[i];
+            entryFactor = std::max(entryFactor, std::min(firstFactor, secondFactor));
+            exitFactor = std::min(exitFactor, std::max(firstFactor, secondFactor));
+        }
+    }
+
+    if (entryFactor > exitFactor)
+    {
+        return false;
+    }
+
+    // Step voxel-by-voxel along the segment (Amanatides and Woo), tracking the segment factor where each axis next crosses a voxel boundary.
+    vec::vec3 entryPoint = start + segment * entryFactor;
+    vec::vec3i voxel;
+    vec::vec3i step;
+    vec::vec3 nextBoundaryFactor;
+    vec::vec3 boundaryFactorStep;
+    for (int i = 0; i < 3; i++)
+    {
+        voxel[i] = std::min(std::max((int)std::floor(entryPoint[i] / MapInfo::SPACING), 0), mapSize[i] - 1);
+        if (segment[i] > 0.0f)
+        {
+            step[i] = 1;
+            nextBoundaryFactor[i] = ((float)(voxel[i] + 1) * MapInfo::SPACING - start[i]) / segment[i];
+            boundaryFactorStep[i] = MapInfo::SPACING / segment[i];
+        }
+        else if (segment[i] < 0.0f)
+        {
+            step[i] = -1;
+            nextBoundaryFactor[i] = ((float)voxel[i] * MapInfo::SPACING - start[i]) / segment[i];
+            boundaryFactorStep[i] = -MapInfo::SPACING / segment[i];
+        }
+        else
+        {
+            step[i] = 0;
+            nextBoundaryFactor[i] = 2.0f;
+            boundaryFactorStep[i] = 0.0f;
+        }
+    }
+
+    float currentFactor = entryFactor;
+    while (currentFactor <= exitFactor)
+    {
+        if (solidVoxels[MapInfo::GetIndex(voxel.x, voxel.y, voxel.z, mapSize.x, mapSize.y)] != 0)
+        {
+            *hitFactor = currentFactor;
+            return true;
+        }
+
+        int axis = nextBoundaryFactor.x < nextBoundaryFactor.y ?
+            (nextBoundaryFactor.x < nextBoundaryFactor.z ? 0 : 2) : (nextBoundaryFactor.y < nextBoundaryFactor.z ? 1 : 2);
+
+        currentFactor = nextBoundaryFactor[axis];
+        voxel[axis] += step[axis];
+        if (voxel[axis] < 0 || voxel[axis] >= mapSize[axis])
+        {
+            return false;
+        }
+
+        nextBoundaryFactor[axis] += boundaryFactorStep[axis];
+    }
+
+    return false;
+}
+
 bool MapSections::HitByRay(MapInfo* mapInfo, const vec::vec3& rayStart, const vec::vec3& rayVector, vec::vec3i* voxelId)
 {
     // First, figure out if the ray will hit the voxel area.
@@ -0,0 +1,143 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+    data = nullptr;
+    size = 0;
+
+#ifdef _WIN32
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = nullptr;
+#else
+    fileDescriptor = -1;
+#endif
+}
+
+bool MappedFile::Open(const char* filename)
+{
+    Close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize))
+    {
+        Close();
+        return false;
+    }
+
+    size = (size_t)fileSize.QuadPart;
+    if (size == 0)
+    {
+        // Empty files can't be mapped, but are still valid to read.
+        return true;
+    }
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+    fileDescriptor = open(filename, O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    size = (size_t)fileStatus.st_size;
+    if (size == 0)
+    {
+        // Empty files can't be mapped, but are still valid to read.
+        return true;
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    data = mapping == MAP_FAILED ? nullptr : (const char*)mapping;
+#endif
+
+    if (data == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (data != nullptr)
+    {
+        UnmapViewOfFile(data);
+    }
+
+    if (mappingHandle != nullptr)
+    {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+
+    if (fileHandle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(fileHandle);
+        fileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (data != nullptr)
+    {
+        munmap((void*)data, size);
+    }
+
+    if (fileDescriptor >= 0)
+    {
+        close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+
+    data = nullptr;
+    size = 0;
+}
+
+const char* MappedFile::GetData() const
+{
+    return data;
+}
+
+size_t MappedFile::GetSize() const
+{
+    return size;
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
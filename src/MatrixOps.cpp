@@ -85,6 +85,20 @@ vec::mat4 MatrixOps::Rotate(float angle, const vec::vec3& v)
     return Rotate(angle, v.x, v.y, v.z);
 }
 
+vec::mat4 MatrixOps::PickMatrix(int x, int y, int screenWidth, int screenHeight)
+{
+    // Move the center of the pixel to the center of the screen, then scale the pixel up to the size of the screen.
+    float width = (float)screenWidth;
+    float height = (float)screenHeight;
+    float xCenter = 2.0f * ((float)x + 0.5f) / width - 1.0f;
+    float yCenter = 1.0f - 2.0f * ((float)y + 0.5f) / height;
+    return vec::mat4(
+        vec::vec4(width, 0.0f, 0.0f, 0.0f),
+        vec::vec4(0.0f, height, 0.0f, 0.0f),
+        vec::vec4(0.0f, 0.0f, 1.0f, 0.0f),
+        vec::vec4(-xCenter * width, -yCenter * height, 0.0f, 1.0f));
+}
+
 // Pulled from 'The Mesa 3-D graphics library', gluInvertMatrix, refactored to integrate here.
 // Computes the inverse of the provided 4x4 matrix. *Assumes the matrix is invertable*
 void MatrixOps::Inverse(const vec::mat4& matrix, vec::mat4& result)
@@ -222,3 +236,30 @@ void MatrixOps::Inverse(const vec::mat4& matrix, vec::mat4& result)
         *(&result[0][0] + i) = inv[i] * determinant;
     }
 }
+
+vec::mat4 MatrixOps::TranslateRotateScale(const vec::vec3& position, const vec::quaternion& rotation, const vec::vec3& scale)
+{
+    // The rotation matrix has no translation, so translating only replaces the last column and scaling only scales the other columns.
+    vec::mat4 result = rotation.asMatrix();
+    result[0] *= scale.x;
+    result[1] *= scale.y;
+    result[2] *= scale.z;
+    result[3] = vec::vec4(position.x, position.y, position.z, 1.0f);
+    return result;
+}
+
+void MatrixOps::MultiplyBatch(const vec::mat4& parent, const vec::mat4* matrices, vec::mat4* results, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        results[i] = parent * matrices[i];
+    }
+}
+
+void MatrixOps::TranslateRotateScaleBatch(const vec::vec3* positions, const vec::quaternion* rotations, const vec::vec3* scales, vec::mat4* results, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        results[i] = TranslateRotateScale(positions[i], rotations[i], scales[i]);
+    }
+}
@@ -0,0 +1,161 @@
+#include <cstring>
+#include "CacheFile.h"
+#include "Logger.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+
+static const char MeshFileMagic[4] = { 'T', 'F', 'M', 'S' };
+
+MeshCache::MeshCache(const char* cacheDirectory)
+    : cacheDirectory(cacheDirectory)
+{
+    cacheHits = 0;
+    cacheMisses = 0;
+}
+
+bool MeshCache::LoadModel(const char* objFilename, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices, vec::vec3* minBounds, vec::vec3* maxBounds)
+{
+    MappedFile objFile;
+    if (!objFile.Open(objFilename))
+    {
+        Logger::Log("Could not read the OBJ file!");
+        return false;
+    }
+
+    unsigned long long sourceHash = CacheFile::HashContents(objFile.GetData(), objFile.GetSize());
+    std::string bakedMeshPath = GetBakedMeshPath(objFilename);
+    if (ReadBakedMesh(bakedMeshPath, sourceHash, vertices, indices, minBounds, maxBounds))
+    {
+        ++cacheHits;
+        return true;
+    }
+
+    ++cacheMisses;
+    unsigned int firstVertex = (unsigned int)vertices.size();
+    unsigned int firstIndex = (unsigned int)indices.size();
+    parsedPositions.clear();
+    parsedUvs.clear();
+    if (!objParser.Parse(objFile.GetData(), objFile.GetData() + objFile.GetSize(), parsedPositions, parsedUvs, indices, minBounds, maxBounds))
+    {
+        return false;
+    }
+
+    vertices.resize(firstVertex + parsedPositions.size());
+    for (unsigned int i = 0; i < parsedPositions.size(); i++)
+    {
+        vertices[firstVertex + i].position = parsedPositions[i];
+        vertices[firstVertex + i].uv = parsedUvs[i];
+    }
+
+    for (unsigned int i = firstIndex; i < indices.size(); i++)
+    {
+        indices[i] += firstVertex;
+    }
+
+    // A mesh that can't be baked still loaded fine, it'll just be parsed again next time.
+    if (!WriteBakedMesh(bakedMeshPath, sourceHash, vertices, firstVertex, indices, firstIndex, *minBounds, *maxBounds))
+    {
+        Logger::LogWarn("Could not write the baked mesh ", bakedMeshPath, ".");
+    }
+
+    return true;
+}
+
+unsigned int MeshCache::GetCacheHits() const
+{
+    return cacheHits;
+}
+
+unsigned int MeshCache::GetCacheMisses() const
+{
+    return cacheMisses;
+}
+
+std::string MeshCache::GetBakedMeshPath(const char* objFilename) const
+{
+    return CacheFile::GetCacheFilePath(cacheDirectory, objFilename, ".tfmesh");
+}
+
+bool MeshCache::ReadBakedMesh(const std::string& bakedMeshPath, unsigned long long sourceHash, std::vector<MeshVertex>& vertices,
+    std::vector<unsigned int>& indices, vec::vec3* minBounds, vec::vec3* maxBounds)
+{
+    MappedFile bakedMeshFile;
+    if (!bakedMeshFile.Open(bakedMeshPath.c_str()) || bakedMeshFile.GetSize() < sizeof(MeshFileHeader))
+    {
+        return false;
+    }
+
+    MeshFileHeader header;
+    memcpy(&header, bakedMeshFile.GetData(), sizeof(MeshFileHeader));
+    size_t expectedSize = sizeof(MeshFileHeader) + (size_t)header.vertexCount * sizeof(MeshVertex) + (size_t)header.indexCount * sizeof(unsigned int);
+    if (memcmp(header.magic, MeshFileMagic, sizeof(MeshFileMagic)) != 0 || header.version != MESH_FILE_VERSION ||
+        header.sourceHash != sourceHash || bakedMeshFile.GetSize() != expectedSize)
+    {
+        return false;
+    }
+
+    const MeshVertex* bakedVertices = (const MeshVertex*)(bakedMeshFile.GetData() + sizeof(MeshFileHeader));
+    const unsigned int* bakedIndices = (const unsigned int*)(bakedVertices + header.vertexCount);
+    for (unsigned int i = 0; i < header.indexCount; i++)
+    {
+        if (bakedIndices[i] >= header.vertexCount)
+        {
+            Logger::LogWarn("The baked mesh ", bakedMeshPath, " is corrupt, rebaking it.");
+            return false;
+        }
+    }
+
+    // The vertices are stored just as they are used, so they are copied straight out of the mapping.
+    unsigned int firstVertex = (unsigned int)vertices.size();
+    vertices.insert(vertices.end(), bakedVertices, bakedVertices + header.vertexCount);
+
+    if (firstVertex == 0)
+    {
+        indices.insert(indices.end(), bakedIndices, bakedIndices + header.indexCount);
+    }
+    else
+    {
+        indices.reserve(indices.size() + header.indexCount);
+        for (unsigned int i = 0; i < header.indexCount; i++)
+        {
+            indices.push_back(firstVertex + bakedIndices[i]);
+        }
+    }
+
+    *minBounds = header.minBounds;
+    *maxBounds = header.maxBounds;
+    return true;
+}
+
+bool MeshCache::WriteBakedMesh(const std::string& bakedMeshPath, unsigned long long sourceHash, const std::vector<MeshVertex>& vertices,
+    unsigned int firstVertex, const std::vector<unsigned int>& indices, unsigned int firstIndex, const vec::vec3& minBounds, const vec::vec3& maxBounds)
+{
+    if (!CacheFile::CreateDirectories(cacheDirectory))
+    {
+        return false;
+    }
+
+    MeshFileHeader header;
+    memcpy(header.magic, MeshFileMagic, sizeof(MeshFileMagic));
+    header.version = MESH_FILE_VERSION;
+    header.sourceHash = sourceHash;
+    header.vertexCount = (unsigned int)vertices.size() - firstVertex;
+    header.indexCount = (unsigned int)indices.size() - firstIndex;
+    header.minBounds = minBounds;
+    header.maxBounds = maxBounds;
+
+    bakedMeshData.resize(header.vertexCount * sizeof(MeshVertex) + header.indexCount * sizeof(unsigned int));
+    MeshVertex* bakedVertices = (MeshVertex*)bakedMeshData.data();
+    if (header.vertexCount != 0)
+    {
+        memcpy(bakedVertices, &vertices[firstVertex], header.vertexCount * sizeof(MeshVertex));
+    }
+
+    unsigned int* bakedIndices = (unsigned int*)(bakedVertices + header.vertexCount);
+    for (unsigned int i = 0; i < header.indexCount; i++)
+    {
+        bakedIndices[i] = indices[firstIndex + i] - firstVertex;
+    }
+
+    return CacheFile::Write(bakedMeshPath, &header, sizeof(MeshFileHeader), bakedMeshData.data(), bakedMeshData.size());
+}
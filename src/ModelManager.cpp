@@ -1,232 +1,65 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstring>
-#include <limits>
 #include <sstream>
+#include "GraphicsConfig.h"
 #include "Logger.h"
 #include "ModelManager.h"
-#include "StringUtils.h"
 
-ModelManager::ModelManager(ImageManager* imageManager)
-{
-    nextModelId = 1;
-    this->imageManager = imageManager;
-}
+static const char* ModelCacheDirectory = "cache/models";
 
-unsigned int ModelManager::GetActualVertexIndex(unsigned int positionIdx, unsigned int uvIdx, universalVertices& vertices)
+// Converts the float to a half-float, rounding to the nearest half-float.
+static GLhalf FloatToHalf(float value)
 {
-    for(const PosUvPair& pair : uvVertexRemapping[positionIdx])
-    {
-        if (pair.uvId == uvIdx)
-        {
-            // Remapping already exists.
-            return pair.positionId;
-        }
-    }
-
-    // Remappings exist, but the UV coordinate listed isn't there. Add a new remapping.
-    PosUvPair newVertexRemapping;
-    newVertexRemapping.uvId = uvIdx;
-    newVertexRemapping.positionId = vertices.positions.size();
-    uvVertexRemapping[positionIdx].push_back(newVertexRemapping);
-
-    // Duplicate the vertex -- but with the new UV coordinate
-    const PosUvPair& validMapping = uvVertexRemapping[positionIdx][0];
-    vertices.positions.push_back(vertices.positions[validMapping.positionId]);
-    vertices.uvs.push_back(rawUvs[uvIdx]);
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(float));
 
-    return newVertexRemapping.positionId;
-}
-
-bool ModelManager::ParseLine(const std::vector<std::string>& line, universalVertices& vertices)
-{
-    // Skip tiny lines.
-    if (line.size() < 3)
+    unsigned int sign = (bits >> 16) & 0x8000;
+    int exponent = (int)((bits >> 23) & 0xFF) - 127 + 15;
+    unsigned int mantissa = bits & 0x7FFFFF;
+    if (exponent >= 31)
     {
-        return true;
+        // Too large (or infinite / NaN) to represent, so clamp to infinity.
+        return (GLhalf)(sign | 0x7C00);
     }
-
-    if (strncmp(line[0].c_str(), "v", 1) == 0 && line[0].size() == 1)
+    else if (exponent <= 0)
     {
-        // Positions
-        if (line.size() != 4)
+        // Subnormal half-float, or too small and flushed to zero.
+        if (exponent < -10)
         {
-            Logger::Log("Line did not have 3 elements for a vertex position.");
-            return false;
-        }
-
-        vec::vec3 vector;
-        if (!StringUtils::ParseFloatFromString(line[1], vector.x) ||
-            !StringUtils::ParseFloatFromString(line[2], vector.y) ||
-            !StringUtils::ParseFloatFromString(line[3], vector.z))
-        {
-            Logger::Log("Line had an improper floating-point value.");
-            return false;
+            return (GLhalf)sign;
         }
 
-        vertices.positions.push_back(vector);
-    }
-    else if (strncmp(line[0].c_str(), "vt", 2) == 0 && line[0].size() == 2)
-    {
-        // UV coordinates
-        if (line.size() != 3)
-        {
-            Logger::Log("Line did not have 2 elements for a UV coordinate.");
-            return false;
-        }
-
-        vec::vec2 vector;
-        if (!StringUtils::ParseFloatFromString(line[1], vector.x) ||
-            !StringUtils::ParseFloatFromString(line[2], vector.y))
-        {
-            Logger::Log("Line had an improper floating-point value.");
-            return false;
-        }
-
-        rawUvs.push_back(vector);
-    }
-    else if (strncmp(line[0].c_str(), "f", 1) == 0 && line[0].size() == 1)
-    {
-        // Indices
-        if (line.size() != 4)
-        {
-            Logger::Log("Line did not have 3 elements for an index mapping.");
-            return false;
-        }
-
-        // Indicies can be processed individually.
-        for (unsigned int i = 0; i < 3; i++)
-        {
-            std::vector<std::string> separatedIndices;
-            StringUtils::Split(line[i + 1], '/', true, separatedIndices);
-            if (separatedIndices.size() != 2)
-            {
-                Logger::Log("Line did not have a position and UV coordinate for a portion of an index mapping.");
-                return false;
-            }
-
-            int positionIndex, uvIndex;
-            if (!StringUtils::ParseIntFromString(separatedIndices[0], positionIndex) ||
-                !StringUtils::ParseIntFromString(separatedIndices[1], uvIndex))
-            {
-                Logger::Log("Index had an improper integer value.");
-                return false;
-            }
-
-            // Indices should be zero-based.
-            positionIndex--;
-            uvIndex--;
-
-            PosUvPair pair;
-            pair.positionId = (unsigned int)positionIndex;
-            pair.uvId = (unsigned int)uvIndex;
-
-            rawIndices.push_back(pair);
-            indexUvMap[pair.positionId] = pair.uvId;
-        }
+        mantissa |= 0x800000;
+        unsigned int shift = (unsigned int)(14 - exponent);
+        unsigned int halfMantissa = mantissa >> shift;
+        unsigned int remainder = mantissa & ((1u << shift) - 1);
+        unsigned int halfway = 1u << (shift - 1);
+        halfMantissa += (remainder > halfway || (remainder == halfway && (halfMantissa & 1))) ? 1 : 0;
+        return (GLhalf)(sign | halfMantissa);
     }
 
-    return true;
+    // Round to nearest even. A carry out of the mantissa correctly bumps the exponent.
+    unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+    unsigned int remainder = mantissa & 0x1FFF;
+    half += (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) ? 1 : 0;
+    return (GLhalf)half;
 }
 
-bool ModelManager::LoadModel(const char* objFilename, universalVertices& vertices, vec::vec3* minBounds, vec::vec3* maxBounds)
+// Converts a value in [-1, 1] to a normalized short.
+static GLshort ToNormalizedShort(float value)
 {
-    std::string fileString;
-    if (!StringUtils::LoadStringFromFile(objFilename, fileString))
-    {
-        Logger::Log("Could not read the OBJ file!");
-        return false;
-    }
-
-    std::vector<std::string> fileLines;
-    StringUtils::Split(fileString, StringUtils::Newline, true, fileLines);
-
-    rawIndices.clear();
-    indexUvMap.clear();
-    rawUvs.clear();
-    for(const std::string& line : fileLines)
-    {
-        std::vector<std::string> splitLine;
-        StringUtils::Split(line, StringUtils::Space, true, splitLine);
-        if (!ParseLine(splitLine, vertices))
-        {
-            Logger::Log("Error parsing line in OBJ file!");
-            Logger::Log(line.c_str());
-            return false;
-        }
-    }
-
-    // Properly render out the vertices so that there is one UV per vertex.
-    uvVertexRemapping.clear();
-
-    // Also figure out the min-max bounding box while we're at it.
-    minBounds->x = std::numeric_limits<float>::max();
-    minBounds->y = std::numeric_limits<float>::max();
-    minBounds->z = std::numeric_limits<float>::max();
-    maxBounds->x = std::numeric_limits<float>::min();
-    maxBounds->y = std::numeric_limits<float>::min();
-    maxBounds->z = std::numeric_limits<float>::min();
-
-    // There's guaranteed to be a UV for each point. Find it, and set it.
-    for (unsigned int i = 0; i < vertices.positions.size(); i++)
-    {
-        if (indexUvMap.find(i) != indexUvMap.end())
-        {
-            PosUvPair pair;
-            pair.positionId = i;
-            pair.uvId = indexUvMap[i];
-            vertices.uvs.push_back(rawUvs[pair.uvId]);
-
-            // Initialize the remapping for this index.
-            uvVertexRemapping[i] = std::vector<PosUvPair>();
-            uvVertexRemapping[i].push_back(pair);
-        }
-        else
-        {
-            std::stringstream errorStream;
-            errorStream << "Failed to load in the UV for point " << i << ".";
-            Logger::Log(errorStream.str().c_str());
-            return false;
-        }
-
-        // Perform min-max bounding check.
-        if (vertices.positions[i].x < minBounds->x)
-        {
-            minBounds->x = vertices.positions[i].x;
-        }
-
-        if (vertices.positions[i].y < minBounds->y)
-        {
-            minBounds->y = vertices.positions[i].y;
-        }
-
-        if (vertices.positions[i].z < minBounds->z)
-        {
-            minBounds->z = vertices.positions[i].z;
-        }
-
-        if (vertices.positions[i].x > maxBounds->x)
-        {
-            maxBounds->x = vertices.positions[i].x;
-        }
-
-        if (vertices.positions[i].y > maxBounds->y)
-        {
-            maxBounds->y = vertices.positions[i].y;
-        }
-
-        if (vertices.positions[i].z > maxBounds->z)
-        {
-            maxBounds->z = vertices.positions[i].z;
-        }
-    }
-
-    // Now parse out the indices, as we can properly use the uvVertexRemapping list.
-    for (const PosUvPair& pair : rawIndices)
-    {
-        unsigned int vertexIndex = GetActualVertexIndex(pair.positionId, pair.uvId, vertices);
-        vertices.indices.push_back(vertexIndex);
-    }
+    value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+    return (GLshort)floorf(value * 32767.0f + 0.5f);
+}
 
-    return true;
+ModelManager::ModelManager(ImageManager* imageManager)
+{
+    nextModelId = 1;
+    this->imageManager = imageManager;
+    assetLoader = nullptr;
+    meshCaches.push_back(MeshCache(ModelCacheDirectory));
 }
 
 unsigned int ModelManager::LoadModel(const char* rootFilename)
@@ -239,8 +72,13 @@ unsigned int ModelManager::LoadModel(const char* rootFilename)
     combinationStream << rootFilename << ".obj";
     std::string objString = combinationStream.str();
 
+    if (assetLoader != nullptr)
+    {
+        return QueueModel(objString, pngString);
+    }
+
     TextureModel textureModel;
-    textureModel.textureId = imageManager->AddImage(pngString.c_str());
+    textureModel.textureId = imageManager->AddImage(pngString.c_str(), false);
     if (textureModel.textureId == 0)
     {
         Logger::Log("Error loading the texture image!");
@@ -248,7 +86,8 @@ unsigned int ModelManager::LoadModel(const char* rootFilename)
         return 0;
     }
 
-    if (!LoadModel(objString.c_str(), textureModel.vertices, &textureModel.minBounds, &textureModel.maxBounds))
+    textureModel.retainVertices = false;
+    if (!meshCaches[0].LoadModel(objString.c_str(), textureModel.vertices, textureModel.indices, &textureModel.minBounds, &textureModel.maxBounds))
     {
         Logger::Log("Error loading the OBJ model!");
         Logger::LogError(objString.c_str());
@@ -260,17 +99,88 @@ unsigned int ModelManager::LoadModel(const char* rootFilename)
     return nextModelId - 1;
 }
 
+unsigned int ModelManager::QueueModel(const std::string& objFilename, const std::string& pngFilename)
+{
+    unsigned int modelId = nextModelId;
+    ++nextModelId;
+
+    // Map elements stay in place as more models are queued, so the tasks can fill them in directly.
+    TextureModel* textureModel = &models[modelId];
+    textureModel->textureId = 0;
+    textureModel->retainVertices = false;
+
+    QueuedModel* queuedModel = &queuedModels[modelId];
+    queuedModel->objFilename = objFilename;
+    queuedModel->pngFilename = pngFilename;
+
+    queuedModel->meshTask = assetLoader->AddWorkTask("Model meshes", [this, textureModel, queuedModel](unsigned int threadIndex)
+    {
+        if (!meshCaches[threadIndex].LoadModel(queuedModel->objFilename.c_str(), textureModel->vertices, textureModel->indices,
+            &textureModel->minBounds, &textureModel->maxBounds))
+        {
+            Logger::Log("Error loading the OBJ model!");
+            Logger::LogError(queuedModel->objFilename.c_str());
+            return false;
+        }
+
+        return true;
+    }, std::vector<AssetTaskId>());
+
+    AssetTaskId imageTask = assetLoader->AddWorkTask("Model images", [queuedModel](unsigned int)
+    {
+        return ImageManager::ReadImage(queuedModel->pngFilename.c_str(), &queuedModel->image);
+    }, std::vector<AssetTaskId>());
+
+    queuedModel->textureTask = assetLoader->AddUploadTask("Model textures", [this, textureModel, queuedModel]()
+    {
+        textureModel->textureId = imageManager->AddDecodedImage(queuedModel->image, false);
+        return true;
+    }, std::vector<AssetTaskId>(1, imageTask));
+
+    return modelId;
+}
+
+void ModelManager::BeginQueuedLoading(AssetLoader* assetLoader)
+{
+    this->assetLoader = assetLoader;
+    while (meshCaches.size() < assetLoader->GetThreadCount())
+    {
+        meshCaches.push_back(MeshCache(ModelCacheDirectory));
+    }
+}
+
+void ModelManager::EndQueuedLoading()
+{
+    assetLoader = nullptr;
+    queuedModels.clear();
+}
+
+void ModelManager::GetLoadTasks(unsigned int id, std::vector<AssetTaskId>& loadTasks) const
+{
+    std::map<unsigned int, QueuedModel>::const_iterator queuedModel = queuedModels.find(id);
+    if (queuedModel != queuedModels.end())
+    {
+        loadTasks.push_back(queuedModel->second.meshTask);
+        loadTasks.push_back(queuedModel->second.textureTask);
+    }
+}
+
 const TextureModel& ModelManager::GetModel(unsigned int id)
 {
     return models[id];
 }
 
+void ModelManager::RetainCollisionData(unsigned int id)
+{
+    models[id].retainVertices = true;
+}
+
 unsigned int ModelManager::GetCurrentModelCount() const
 {
     return nextModelId;
 }
 
-void ModelManager::RenderModel(vec::mat4& projectionMatrix, unsigned int id, vec::mat4& mvMatrix, bool selected)
+void ModelManager::RenderModel(vec::mat4& projectionMatrix, unsigned int id, vec::mat4& mvMatrix, bool selected, bool hovered, unsigned int pickId)
 {
     glUseProgram(modelRenderProgram);
 
@@ -281,10 +191,15 @@ void ModelManager::RenderModel(vec::mat4& projectionMatrix, unsigned int id, vec
 
     glUniformMatrix4fv(projLocation, 1, GL_FALSE, projectionMatrix);
     glUniformMatrix4fv(mvLocation, 1, GL_FALSE, mvMatrix);
-    glUniform1f(selectionFactorLocation, selected ? 0.40f : 0.0f);
+    glUniform1f(selectionFactorLocation, selected ? 0.40f : (hovered ? 0.20f : 0.0f));
+    glUniform1ui(pickIdLocation, pickId);
+    glUniform3fv(positionOffsetLocation, 1, &models[id].positionOffset.x);
+    glUniform3fv(positionScaleLocation, 1, &models[id].positionScale.x);
 
+    // The index offset is a byte offset into the element buffer, passed as a pointer.
+    std::size_t indexByteOffset = (std::size_t)models[id].indexOffset * (std::size_t)indexSize;
     glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, models[id].vertices.indices.size(), GL_UNSIGNED_INT, (const void*)(models[id].indexOffset * sizeof(GL_UNSIGNED_INT)));
+    glDrawElementsBaseVertex(GL_TRIANGLES, models[id].indexCount, indexType, (const void*)indexByteOffset, models[id].baseVertex);
 }
 
 // Initializes the OpenGL resources
@@ -300,12 +215,14 @@ bool ModelManager::InitializeOpenGlResources(ShaderManager& shaderManager)
     mvLocation = glGetUniformLocation(modelRenderProgram, "mvMatrix");
     projLocation = glGetUniformLocation(modelRenderProgram, "projMatrix");
     selectionFactorLocation = glGetUniformLocation(modelRenderProgram, "selectionFactor");
+    pickIdLocation = glGetUniformLocation(modelRenderProgram, "modelPickId");
+    positionOffsetLocation = glGetUniformLocation(modelRenderProgram, "positionOffset");
+    positionScaleLocation = glGetUniformLocation(modelRenderProgram, "positionScale");
 
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
 
-    glGenBuffers(1, &positionBuffer);
-    glGenBuffers(1, &uvBuffer);
+    glGenBuffers(1, &vertexBuffer);
     glGenBuffers(1, &indexBuffer);
 
     return true;
@@ -314,30 +231,127 @@ bool ModelManager::InitializeOpenGlResources(ShaderManager& shaderManager)
 // Sends in the model data to OpenGL.
 void ModelManager::ResetOpenGlModelData()
 {
-    glBindVertexArray(vao);
+    // A startup with every model parsed is a cold start, one with every model baked is a warm start.
+    unsigned int cacheHits = 0;
+    unsigned int cacheMisses = 0;
+    for (const MeshCache& meshCache : meshCaches)
+    {
+        cacheHits += meshCache.GetCacheHits();
+        cacheMisses += meshCache.GetCacheMisses();
+    }
+
+    Logger::Log("Loaded ", cacheHits + cacheMisses, " models, ", cacheHits, " from baked meshes and ", cacheMisses, " parsed from OBJ files.");
+
+    // Every model goes into one vertex buffer and one index buffer. Indices stay relative to each model and are drawn from its base vertex,
+    //  so they can be 16-bit as long as no single model is too large.
+    bool isPacked = GraphicsConfig::PackedModelVertices;
+    unsigned int vertexCount = 0;
+    unsigned int totalIndexCount = 0;
+    unsigned int largestModelVertexCount = 0;
+    for (std::map<unsigned int, TextureModel>::const_iterator iterator = models.begin(); iterator != models.end(); iterator++)
+    {
+        vertexCount += (unsigned int)iterator->second.vertices.size();
+        totalIndexCount += (unsigned int)iterator->second.indices.size();
+        largestModelVertexCount = std::max(largestModelVertexCount, (unsigned int)iterator->second.vertices.size());
+    }
 
-    universalVertices temporaryCopyVertices;
+    indexType = largestModelVertexCount <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    GLsizei vertexSize = isPacked ? sizeof(PackedModelVertex) : sizeof(MeshVertex);
 
-    unsigned int indexPositionReferralOffset = 0;
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * vertexSize, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, totalIndexCount * indexSize, nullptr, GL_STATIC_DRAW);
+
+    std::vector<PackedModelVertex> packedVertices;
+    std::vector<GLushort> shortIndices;
+    size_t releasedBytes = 0;
+    unsigned int vertexOffset = 0;
     unsigned int indexOffset = 0;
-    for (unsigned int i = 0; i < models.size(); i++)
+    for (std::map<unsigned int, TextureModel>::iterator iterator = models.begin(); iterator != models.end(); iterator++)
     {
-        models[i].indexOffset = indexOffset;
-        temporaryCopyVertices.positions.insert(temporaryCopyVertices.positions.end(), models[i].vertices.positions.begin(), models[i].vertices.positions.end());
-        temporaryCopyVertices.uvs.insert(temporaryCopyVertices.uvs.end(), models[i].vertices.uvs.begin(), models[i].vertices.uvs.end());
+        TextureModel& model = iterator->second;
+        model.baseVertex = (GLint)vertexOffset;
+        model.indexOffset = indexOffset;
+        model.indexCount = (GLuint)model.indices.size();
+
+        // Packed positions span the model bounds, while float positions are used as-is.
+        model.positionOffset = isPacked ? (model.minBounds + model.maxBounds) * 0.5f : vec::vec3(0.0f);
+        model.positionScale = isPacked ? (model.maxBounds - model.minBounds) * 0.5f : vec::vec3(1.0f);
+        vec::vec3 inverseScale;
+        for (int i = 0; i < 3; i++)
+        {
+            inverseScale[i] = model.positionScale[i] > 0.0f ? 1.0f / model.positionScale[i] : 0.0f;
+        }
 
-        for (unsigned int j = 0; j < models[i].vertices.indices.size(); j++)
+        if (model.vertices.size() != 0)
         {
-            temporaryCopyVertices.indices.push_back(models[i].vertices.indices[j] + indexPositionReferralOffset);
+            if (isPacked)
+            {
+                packedVertices.resize(model.vertices.size());
+                for (unsigned int i = 0; i < model.vertices.size(); i++)
+                {
+                    for (int j = 0; j < 3; j++)
+                    {
+                        packedVertices[i].position[j] = ToNormalizedShort((model.vertices[i].position[j] - model.positionOffset[j]) * inverseScale[j]);
+                    }
+
+                    packedVertices[i].position[3] = 0;
+                    packedVertices[i].uv[0] = FloatToHalf(model.vertices[i].uv.x);
+                    packedVertices[i].uv[1] = FloatToHalf(model.vertices[i].uv.y);
+                }
+
+                glBufferSubData(GL_ARRAY_BUFFER, vertexOffset * vertexSize, model.vertices.size() * vertexSize, &packedVertices[0]);
+            }
+            else
+            {
+                glBufferSubData(GL_ARRAY_BUFFER, vertexOffset * vertexSize, model.vertices.size() * vertexSize, &model.vertices[0]);
+            }
+        }
+
+        if (model.indices.size() != 0)
+        {
+            if (indexType == GL_UNSIGNED_SHORT)
+            {
+                shortIndices.assign(model.indices.begin(), model.indices.end());
+                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset * indexSize, model.indices.size() * indexSize, &shortIndices[0]);
+            }
+            else
+            {
+                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset * indexSize, model.indices.size() * indexSize, &model.indices[0]);
+            }
+        }
+
+        vertexOffset += (unsigned int)model.vertices.size();
+        indexOffset += (unsigned int)model.indices.size();
+
+        // OpenGL has its own copy now.
+        if (!model.retainVertices)
+        {
+            releasedBytes += model.vertices.capacity() * sizeof(MeshVertex) + model.indices.capacity() * sizeof(unsigned int);
+            std::vector<MeshVertex>().swap(model.vertices);
+            std::vector<unsigned int>().swap(model.indices);
         }
+    }
 
-        indexPositionReferralOffset += models[i].vertices.positions.size();
-        indexOffset += models[i].vertices.indices.size();
+    if (isPacked)
+    {
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, vertexSize, (const void*)offsetof(PackedModelVertex, position));
+        glVertexAttribPointer(3, 2, GL_HALF_FLOAT, GL_FALSE, vertexSize, (const void*)offsetof(PackedModelVertex, uv));
     }
+    else
+    {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexSize, (const void*)offsetof(MeshVertex, position));
+        glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, vertexSize, (const void*)offsetof(MeshVertex, uv));
+    }
+
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(3);
 
-    temporaryCopyVertices.TransferPositionToOpenGl(positionBuffer);
-    temporaryCopyVertices.TransferUvsToOpenGl(uvBuffer);
-    temporaryCopyVertices.TransferIndicesToOpenGl(indexBuffer);
+    Logger::Log("Sent ", vertexCount, " model vertices (", (vertexCount * vertexSize) / 1024, " kB) and ", totalIndexCount, " indices (",
+        (totalIndexCount * indexSize) / 1024, " kB) to OpenGL, releasing ", releasedBytes / 1024, " kB of model data.");
 }
 
 // Deletes all initialized OpenGL resources.
@@ -345,7 +359,6 @@ ModelManager::~ModelManager()
 {
     glDeleteVertexArrays(1, &vao);
 
-    glDeleteBuffers(1, &positionBuffer);
-    glDeleteBuffers(1, &uvBuffer);
+    glDeleteBuffers(1, &vertexBuffer);
     glDeleteBuffers(1, &indexBuffer);
 }
@@ -0,0 +1,357 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include "Logger.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+
+// Exact powers of ten, so numbers with few enough digits convert with a single correctly-rounded multiply or divide.
+static const double ExactPowersOfTen[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const unsigned int NoUv = std::numeric_limits<unsigned int>::max();
+static const unsigned long long EmptyVertexKey = std::numeric_limits<unsigned long long>::max();
+
+ObjParser::ObjParser()
+{
+    firstVertex = 0;
+    vertexHashShift = 64;
+}
+
+bool ObjParser::ParseFile(const char* objFilename, std::vector<vec::vec3>& positions, std::vector<vec::vec2>& uvs, std::vector<unsigned int>& indices,
+    vec::vec3* minBounds, vec::vec3* maxBounds)
+{
+    MappedFile file;
+    if (!file.Open(objFilename))
+    {
+        Logger::Log("Could not read the OBJ file!");
+        return false;
+    }
+
+    return Parse(file.GetData(), file.GetData() + file.GetSize(), positions, uvs, indices, minBounds, maxBounds);
+}
+
+bool ObjParser::Parse(const char* text, const char* textEnd, std::vector<vec::vec3>& positions, std::vector<vec::vec2>& uvs, std::vector<unsigned int>& indices,
+    vec::vec3* minBounds, vec::vec3* maxBounds)
+{
+    rawUvs.clear();
+    rawIndices.clear();
+    positionUvs.clear();
+
+    firstVertex = (unsigned int)positions.size();
+    unsigned int lineNumber = 1;
+    const char* cursor = text;
+    while (cursor < textEnd)
+    {
+        SkipSpaces(cursor, textEnd);
+        const char* keyword = cursor;
+        while (cursor < textEnd && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n')
+        {
+            ++cursor;
+        }
+
+        size_t keywordLength = cursor - keyword;
+        bool isValid = true;
+        if (keywordLength == 1 && keyword[0] == 'v')
+        {
+            vec::vec3 position;
+            isValid = ReadFloat(cursor, textEnd, position.x) && ReadFloat(cursor, textEnd, position.y) && ReadFloat(cursor, textEnd, position.z) &&
+                AtLineEnd(cursor, textEnd);
+            positions.push_back(position);
+            positionUvs.push_back(NoUv);
+        }
+        else if (keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 't')
+        {
+            vec::vec2 uv;
+            isValid = ReadFloat(cursor, textEnd, uv.x) && ReadFloat(cursor, textEnd, uv.y) && AtLineEnd(cursor, textEnd);
+            rawUvs.push_back(uv);
+        }
+        else if (keywordLength == 1 && keyword[0] == 'f')
+        {
+            PosUvPair corners[3];
+            isValid = ReadFaceCorner(cursor, textEnd, corners[0]) && ReadFaceCorner(cursor, textEnd, corners[1]) && ReadFaceCorner(cursor, textEnd, corners[2]) &&
+                AtLineEnd(cursor, textEnd);
+
+            // Indices are one-based in the file.
+            for (int i = 0; i < 3 && isValid; i++)
+            {
+                --corners[i].positionId;
+                --corners[i].uvId;
+                if (corners[i].positionId >= positionUvs.size() || corners[i].uvId >= rawUvs.size())
+                {
+                    Logger::Log("Face on line ", lineNumber, " refers to a position or UV coordinate that hasn't been defined.");
+                    return false;
+                }
+
+                rawIndices.push_back(corners[i]);
+                positionUvs[corners[i].positionId] = corners[i].uvId;
+            }
+        }
+
+        if (!isValid)
+        {
+            Logger::Log("Error parsing line ", lineNumber, " in the OBJ file!");
+            return false;
+        }
+
+        // Skip the rest of the line, which is everything for lines that aren't read.
+        while (cursor < textEnd && *cursor != '\n')
+        {
+            ++cursor;
+        }
+
+        ++cursor;
+        ++lineNumber;
+    }
+
+    // Each position keeps the last UV it was used with, and the other UVs it was used with duplicate it.
+    ResetVertexHash(positionUvs.size() + rawIndices.size());
+
+    // Also figure out the min-max bounding box while we're at it.
+    minBounds->x = std::numeric_limits<float>::max();
+    minBounds->y = std::numeric_limits<float>::max();
+    minBounds->z = std::numeric_limits<float>::max();
+    maxBounds->x = std::numeric_limits<float>::min();
+    maxBounds->y = std::numeric_limits<float>::min();
+    maxBounds->z = std::numeric_limits<float>::min();
+
+    for (unsigned int i = 0; i < positionUvs.size(); i++)
+    {
+        if (positionUvs[i] == NoUv)
+        {
+            Logger::Log("Failed to load in the UV for point ", i, ".");
+            return false;
+        }
+
+        uvs.push_back(rawUvs[positionUvs[i]]);
+
+        PosUvPair pair;
+        pair.positionId = i;
+        pair.uvId = positionUvs[i];
+        GetVertexIndex(pair, positions, uvs);
+
+        const vec::vec3& position = positions[firstVertex + i];
+        minBounds->x = std::min(minBounds->x, position.x);
+        minBounds->y = std::min(minBounds->y, position.y);
+        minBounds->z = std::min(minBounds->z, position.z);
+        maxBounds->x = std::max(maxBounds->x, position.x);
+        maxBounds->y = std::max(maxBounds->y, position.y);
+        maxBounds->z = std::max(maxBounds->z, position.z);
+    }
+
+    indices.reserve(indices.size() + rawIndices.size());
+    for (const PosUvPair& pair : rawIndices)
+    {
+        indices.push_back(firstVertex + GetVertexIndex(pair, positions, uvs));
+    }
+
+    return true;
+}
+
+bool ObjParser::ReadFloat(const char*& cursor, const char* textEnd, float& value)
+{
+    SkipSpaces(cursor, textEnd);
+    const char* start = cursor;
+
+    bool isNegative = false;
+    if (cursor < textEnd && (*cursor == '-' || *cursor == '+'))
+    {
+        isNegative = *cursor == '-';
+        ++cursor;
+    }
+
+    // Read up to 19 significant digits into an integer, tracking where the decimal point goes.
+    unsigned long long mantissa = 0;
+    int digitCount = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool isTruncated = false;
+    for (int part = 0; part < 2; part++)
+    {
+        while (cursor < textEnd && *cursor >= '0' && *cursor <= '9')
+        {
+            if (significantDigits < 19)
+            {
+                mantissa = mantissa * 10 + (unsigned long long)(*cursor - '0');
+                significantDigits += mantissa != 0 ? 1 : 0;
+                exponent -= part;
+            }
+            else
+            {
+                isTruncated = isTruncated || *cursor != '0';
+                exponent += 1 - part;
+            }
+
+            ++digitCount;
+            ++cursor;
+        }
+
+        if (part == 0 && cursor < textEnd && *cursor == '.')
+        {
+            ++cursor;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (digitCount == 0)
+    {
+        return false;
+    }
+
+    if (cursor < textEnd && (*cursor == 'e' || *cursor == 'E'))
+    {
+        ++cursor;
+        bool isExponentNegative = false;
+        if (cursor < textEnd && (*cursor == '-' || *cursor == '+'))
+        {
+            isExponentNegative = *cursor == '-';
+            ++cursor;
+        }
+
+        if (cursor >= textEnd || *cursor < '0' || *cursor > '9')
+        {
+            return false;
+        }
+
+        int writtenExponent = 0;
+        while (cursor < textEnd && *cursor >= '0' && *cursor <= '9')
+        {
+            writtenExponent = std::min(writtenExponent * 10 + (*cursor - '0'), 100000);
+            ++cursor;
+        }
+
+        exponent += isExponentNegative ? -writtenExponent : writtenExponent;
+    }
+
+    if (cursor < textEnd && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n')
+    {
+        return false;
+    }
+
+    // Numbers are read as doubles and then narrowed, as atof did. With up to 15 digits and a small exponent, both the mantissa and
+    //  the power of ten are exact, so one operation gives the correctly-rounded double. Anything else falls back to strtod.
+    double result;
+    if (!isTruncated && significantDigits <= 15 && exponent >= -22 && exponent <= 22)
+    {
+        result = (double)mantissa;
+        result = exponent < 0 ? result / ExactPowersOfTen[-exponent] : result * ExactPowersOfTen[exponent];
+    }
+    else
+    {
+        char number[64];
+        size_t length = std::min((size_t)(cursor - start), sizeof(number) - 1);
+        std::copy(start, start + length, number);
+        number[length] = '\0';
+        result = std::abs(strtod(number, nullptr));
+    }
+
+    value = (float)(isNegative ? -result : result);
+    return true;
+}
+
+bool ObjParser::ReadIndex(const char*& cursor, const char* textEnd, unsigned int& index)
+{
+    const char* start = cursor;
+    unsigned long long readIndex = 0;
+    while (cursor < textEnd && *cursor >= '0' && *cursor <= '9' && readIndex <= std::numeric_limits<unsigned int>::max())
+    {
+        readIndex = readIndex * 10 + (unsigned long long)(*cursor - '0');
+        ++cursor;
+    }
+
+    index = (unsigned int)readIndex;
+    return cursor != start && readIndex != 0 && readIndex <= std::numeric_limits<unsigned int>::max();
+}
+
+bool ObjParser::ReadFaceCorner(const char*& cursor, const char* textEnd, PosUvPair& corner)
+{
+    SkipSpaces(cursor, textEnd);
+    if (!ReadIndex(cursor, textEnd, corner.positionId) || cursor >= textEnd || *cursor != '/')
+    {
+        return false;
+    }
+
+    ++cursor;
+    if (!ReadIndex(cursor, textEnd, corner.uvId))
+    {
+        return false;
+    }
+
+    // Skip the normal, if there is one.
+    if (cursor < textEnd && *cursor == '/')
+    {
+        ++cursor;
+        while (cursor < textEnd && *cursor >= '0' && *cursor <= '9')
+        {
+            ++cursor;
+        }
+    }
+
+    return cursor >= textEnd || *cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n';
+}
+
+void ObjParser::SkipSpaces(const char*& cursor, const char* textEnd)
+{
+    while (cursor < textEnd && (*cursor == ' ' || *cursor == '\t'))
+    {
+        ++cursor;
+    }
+}
+
+bool ObjParser::AtLineEnd(const char* cursor, const char* textEnd)
+{
+    SkipSpaces(cursor, textEnd);
+    return cursor >= textEnd || *cursor == '\r' || *cursor == '\n';
+}
+
+void ObjParser::ResetVertexHash(size_t vertexCount)
+{
+    // At most half full, so probe sequences stay short.
+    size_t size = 16;
+    vertexHashShift = 60;
+    while (size < vertexCount * 2)
+    {
+        size *= 2;
+        --vertexHashShift;
+    }
+
+    vertexKeys.assign(size, EmptyVertexKey);
+    vertexIndices.resize(size);
+}
+
+unsigned int ObjParser::GetVertexIndex(const PosUvPair& pair, std::vector<vec::vec3>& positions, std::vector<vec::vec2>& uvs)
+{
+    unsigned long long key = ((unsigned long long)pair.positionId << 32) | pair.uvId;
+    size_t mask = vertexKeys.size() - 1;
+    size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ull) >> vertexHashShift);
+    while (vertexKeys[slot] != EmptyVertexKey)
+    {
+        if (vertexKeys[slot] == key)
+        {
+            return vertexIndices[slot];
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    // A position used with the UV it keeps is the position itself, and other UVs duplicate it.
+    unsigned int vertexIndex = pair.positionId;
+    if (pair.uvId != positionUvs[pair.positionId])
+    {
+        vertexIndex = (unsigned int)positions.size() - firstVertex;
+        vec::vec3 position = positions[firstVertex + pair.positionId];
+        positions.push_back(position);
+        uvs.push_back(rawUvs[pair.uvId]);
+    }
+
+    vertexKeys[slot] = key;
+    vertexIndices[slot] = vertexIndex;
+    return vertexIndex;
+}
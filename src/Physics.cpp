@@ -3,47 +3,74 @@
 #include "Constants.h"
 #include "Logger.h"
 #include "MathOps.h"
-#include "PhysicsOps.h"
 #include "PhysicsConfig.h"
 #include "Unit.h"
 #include "Physics.h"
 
 Physics::Physics()
+    : unitHash(MapInfo::SPACING)
 {
     isAlive = true;
     isPaused = false;
-
-    isLeftMouseClicked = true;
 }
 
 void Physics::Initialize(SyncBuffer* syncBuffer)
 {
     this->syncBuffer = syncBuffer;
+    camera.SetPerspective(Constants::FOV_Y, Constants::ASPECT, Constants::NEAR_PLANE, Constants::FAR_PLANE);
+
+    unsigned int workerCount = PhysicsConfig::PhysicsWorkerThreads < 0 ? JobSystem::DefaultWorkerCount() : (unsigned int)PhysicsConfig::PhysicsWorkerThreads;
+    jobSystem.Initialize(workerCount);
+    Logger::Log("Physics running with ", jobSystem.GetThreadCount(), " thread(s).");
+
+    // A projectile can hit at most one thing per tick, so the hit list never needs more room than the pool.
+    projectilePool.Initialize(PhysicsConfig::MaxProjectiles);
+    projectileHits.reserve(PhysicsConfig::MaxProjectiles);
+    syncBuffer->InitializeProjectiles(PhysicsConfig::MaxProjectiles);
+    combatResolver.Initialize(PhysicsConfig::MaxProjectiles);
+    turretTargeting.Initialize(PhysicsConfig::TurretScanTicks < 1 ? 1 : (unsigned int)PhysicsConfig::TurretScanTicks);
 }
 
 // Queues a mouse click for manipulation with the physics thread.
 void Physics::QueueLeftMouseClick(int x, int y, int xSize, int ySize)
 {
-    leftMouseClickData.x = x;
-    leftMouseClickData.y = y;
-    leftMouseClickData.xSize = xSize;
-    leftMouseClickData.ySize = ySize;
-    isLeftMouseClicked = true;
+    InputEvent clickEvent;
+    clickEvent.type = InputEvent::LEFT_CLICK;
+    clickEvent.x = x;
+    clickEvent.y = y;
+    clickEvent.endX = x;
+    clickEvent.endY = y;
+    clickEvent.xSize = xSize;
+    clickEvent.ySize = ySize;
+    inputQueue.QueueEvent(clickEvent);
+}
+
+// Queues a drag-box selection for manipulation with the physics thread.
+void Physics::QueueDragSelect(int startX, int startY, int endX, int endY, int xSize, int ySize)
+{
+    InputEvent dragEvent;
+    dragEvent.type = InputEvent::DRAG_SELECT;
+    dragEvent.x = startX;
+    dragEvent.y = startY;
+    dragEvent.endX = endX;
+    dragEvent.endY = endY;
+    dragEvent.xSize = xSize;
+    dragEvent.ySize = ySize;
+    inputQueue.QueueEvent(dragEvent);
 }
 
 // Handles left mouse clicks from the physics thread.
-void Physics::HandleLeftMouseClicked()
+void Physics::HandleLeftMouseClicked(const InputEvent& clickEvent)
 {
-    vec::vec2 mousePos = vec::vec2((float)leftMouseClickData.x, (float)leftMouseClickData.y);
-    vec::vec2 screenSize = vec::vec2((float)leftMouseClickData.xSize, (float)leftMouseClickData.ySize);
+    vec::vec2 mousePos = vec::vec2((float)clickEvent.x, (float)clickEvent.y);
+    vec::vec2 screenSize = vec::vec2((float)clickEvent.xSize, (float)clickEvent.ySize);
 
-    vec::mat4 viewRotationMatrix = viewer.GetViewOrientation().asMatrix();
-    vec::vec3 worldRay = PhysicsOps::ScreenRay(mousePos, screenSize, Constants::PerspectiveMatrix, viewRotationMatrix);
+    vec::vec3 worldRay = camera.ScreenRay(mousePos, screenSize);
     
     // Check to see if we clicked a unit. You can only select your own units (player 0);
     Player& player = syncBuffer->LockPlayer(0);
 
-    int collidedUnit = player.CollisionCheck(viewer.GetViewPosition(), worldRay);
+    int collidedUnit = player.CollisionCheck(unitHash, camera.GetPosition(), worldRay);
     if (collidedUnit != -1)
     {
         player.ToggleUnitSelection(collidedUnit);
@@ -51,7 +78,7 @@ void Physics::HandleLeftMouseClicked()
     else
     {
         vec::vec3i hitVoxel;
-        if (syncBuffer->HitByRay(mapSections, viewer.GetViewPosition(), worldRay, &hitVoxel))
+        if (syncBuffer->HitByRay(mapSections, camera.GetPosition(), worldRay, &hitVoxel))
         {
             syncBuffer->SetNewSelectedVoxel(hitVoxel);
 
@@ -72,7 +99,7 @@ void Physics::HandleLeftMouseClicked()
                     std::vector<vec::vec3i> betterRoute;
                     std::vector<vec::vec3> graphicalRoute;
                     Logger::Log("Refining route...");
-                    syncBuffer->RefineRoute(unitRouter, mapSections.GetSubsections(), start, hitVoxel, route, betterRoute, graphicalRoute);
+                    syncBuffer->RefineRoute(unitRouter, mapSections.GetSubsections(), mapSections.GetSurface(), start, hitVoxel, route, betterRoute, graphicalRoute);
 
                     Logger::Log("Updating player 0, selected unit ", selectedUnit, " with graphical route using ", graphicalRoute.size(), " segments.");
                     player.UpdateUnitRoute(selectedUnit, graphicalRoute);
@@ -85,6 +112,16 @@ void Physics::HandleLeftMouseClicked()
     syncBuffer->UnlockPlayer(0);
 }
 
+// Handles drag-box selection from the physics thread, replacing the selection with the player's units within the box.
+void Physics::HandleDragSelect(const InputEvent& dragEvent)
+{
+    Player& player = syncBuffer->LockPlayer(0);
+    player.SelectUnitsWithinRectangle(screenSelector, camera.GetProjectionMatrix(), camera.GetViewProjectionMatrix(),
+        vec::vec2((float)dragEvent.x, (float)dragEvent.y), vec::vec2((float)dragEvent.endX, (float)dragEvent.endY),
+        vec::vec2((float)dragEvent.xSize, (float)dragEvent.ySize));
+    syncBuffer->UnlockPlayer(0);
+}
+
 void Physics::Run()
 {
     sf::Clock clock;
@@ -96,20 +133,31 @@ void Physics::Run()
             // Update the viewer's position
             viewer.InputUpdate();
 
+            // The camera only recomputes its matrices if the viewer moved.
+            camera.SetView(viewer.GetViewPosition(), viewer.GetViewOrientation());
+
             // Synchronize with the GUI thread.
-            syncBuffer->UpdateViewMatrix(viewer.GetViewPosition(), viewer.GetViewOrientation());
+            syncBuffer->UpdateViewMatrix(camera.GetViewMatrix());
             syncBuffer->UpdateViewerPosition(viewer.GetViewPosition());
 
-            if (isLeftMouseClicked)
+            inputQueue.TakeEvents(inputEvents);
+            for (unsigned int i = 0; i < inputEvents.size(); i++)
             {
-                HandleLeftMouseClicked();
-                isLeftMouseClicked = false;
+                if (inputEvents[i].type == InputEvent::LEFT_CLICK)
+                {
+                    HandleLeftMouseClicked(inputEvents[i]);
+                }
+                else if (inputEvents[i].type == InputEvent::DRAG_SELECT)
+                {
+                    HandleDragSelect(inputEvents[i]);
+                }
             }
 
             if (syncBuffer->UpdateRoundMapPhysics(mapSections))
             {
                 // The round map was updated, so perform additional updates based on the map changing.
                 Logger::Log("Round map physics updated!");
+                syncBuffer->ResetVisibility(mapSections);
 
                 // TODO test code, player shouldn't start with unit, and should be toggled off of something.
 
@@ -137,7 +185,28 @@ void Physics::Run()
             }
 
             // All units move
-            syncBuffer->UpdatePlayers(physicsUpdateTime.asSeconds());
+            syncBuffer->UpdatePlayers(jobSystem, unitHash, localAvoidance, mapSections, physicsUpdateTime.asSeconds());
+
+            // Players see from where their units moved to, which determines what turrets can target.
+            syncBuffer->UpdateVisibility(jobSystem, mapSections, PhysicsConfig::VisibilityBudget);
+
+            // Turrets aim at this tick's unit positions, and what they fire moves with the other projectiles.
+            syncBuffer->UpdateTurrets(jobSystem, turretTargeting, mapSections, unitHash, projectilePool);
+
+            // Projectiles move after units, so they're swept against this tick's unit positions.
+            projectileHits.clear();
+            projectilePool.Update(mapSections, unitHash, projectileHits);
+            syncBuffer->UpdateProjectiles(projectilePool);
+
+            // Destroyed units leave the spatial hash on the next update.
+            combatResolver.Clear();
+            combatResolver.AddHits(projectileHits);
+            unitDeaths.clear();
+            syncBuffer->ResolveCombat(combatResolver, unitDeaths);
+            for (unsigned int i = 0; i < unitDeaths.size(); i++)
+            {
+                Logger::Log("Unit ", unitDeaths[i].unitId, " of player ", unitDeaths[i].playerId, " was destroyed by player ", unitDeaths[i].killingPlayerId, ".");
+            }
         }
 
         // The physics thread runs at a configurable delay, which we abide by here.
@@ -2,6 +2,10 @@
 #include "PhysicsConfig.h"
 
 int PhysicsConfig::PhysicsThreadDelay;
+int PhysicsConfig::PhysicsWorkerThreads;
+int PhysicsConfig::MaxProjectiles;
+int PhysicsConfig::TurretScanTicks;
+float PhysicsConfig::VisibilityBudget;
 float PhysicsConfig::ViewForwardsSpeed;
 float PhysicsConfig::ViewSidewaysSpeed;
 
@@ -11,6 +15,10 @@ float PhysicsConfig::ViewRotateAroundFactor;
 bool PhysicsConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
 {
     return (ReadInt(configFileLines, PhysicsThreadDelay, "Error decoding the physics thread delay!") &&
+            ReadInt(configFileLines, PhysicsWorkerThreads, "Error decoding the physics worker thread count!") &&
+            ReadInt(configFileLines, MaxProjectiles, "Error decoding the maximum projectile count!") &&
+            ReadInt(configFileLines, TurretScanTicks, "Error decoding the turret scan ticks!") &&
+            ReadFloat(configFileLines, VisibilityBudget, "Error reading in the visibility budget!") &&
             ReadFloat(configFileLines, ViewForwardsSpeed, "Error reading in the view forwards speed!") &&
             ReadFloat(configFileLines, ViewSidewaysSpeed, "Error reading in the view sideways speed!") &&
             ReadFloat(configFileLines, ViewRotateUpFactor, "Error reading in the view rotate up factor!") &&
@@ -20,6 +28,10 @@ bool PhysicsConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
 void PhysicsConfig::WriteConfigValues()
 {
 	WriteInt("PhysicsThreadDelay", PhysicsThreadDelay);
+	WriteInt("PhysicsWorkerThreads", PhysicsWorkerThreads);
+	WriteInt("MaxProjectiles", MaxProjectiles);
+	WriteInt("TurretScanTicks", TurretScanTicks);
+	WriteFloat("VisibilityBudget", VisibilityBudget);
 	WriteFloat("ViewForwardsSpeed", ViewForwardsSpeed);
 	WriteFloat("ViewSidewaysSpeed", ViewSidewaysSpeed);
 
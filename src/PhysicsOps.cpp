@@ -68,6 +68,34 @@ bool PhysicsOps::HitsSphere(const vec::vec3& rayStart, const vec::vec3& ray, con
     return first >= second; // first - second >= 0
 }
 
+bool PhysicsOps::HitsSphere(const vec::vec3& rayStart, const vec::vec3& ray, const vec::vec3& sphereCenter, float sphereRadius, float* intersectionFactor)
+{
+    vec::vec3 rayOffset = rayStart - sphereCenter;
+
+    float halfB = VecOps::Dot(ray, rayOffset);
+    float c = VecOps::Dot(rayOffset, rayOffset) - sphereRadius * sphereRadius;
+    float discriminant = halfB * halfB - c;
+    if (discriminant < 0)
+    {
+        return false;
+    }
+
+    // Use the far intersection if the ray starts within the sphere.
+    float root = sqrt(discriminant);
+    float factor = -halfB - root;
+    if (factor < 0)
+    {
+        factor = -halfB + root;
+        if (factor < 0)
+        {
+            return false;
+        }
+    }
+
+    *intersectionFactor = factor;
+    return true;
+}
+
 // Computes a ray from the current mouse position into the scene.
 vec::vec3 PhysicsOps::ScreenRay(vec::vec2 mouse, vec::vec2 screenSize, vec::mat4& perspectiveMatrix, vec::mat4& viewRotationMatrix)
 {
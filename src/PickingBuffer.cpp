@@ -0,0 +1,189 @@
+#include "Logger.h"
+#include "MatrixOps.h"
+#include "PickingBuffer.h"
+
+unsigned int PickingBuffer::GetVoxelPickId(int voxelIndex)
+{
+    return (unsigned int)voxelIndex + 1;
+}
+
+unsigned int PickingBuffer::GetUnitPickId(int playerId, unsigned int unitId)
+{
+    return UNIT_PICK_FLAG | ((unsigned int)playerId << UNIT_ID_BITS) | unitId;
+}
+
+bool PickingBuffer::IsVoxelPickId(unsigned int pickId)
+{
+    return pickId != NO_PICK_ID && (pickId & UNIT_PICK_FLAG) == 0;
+}
+
+bool PickingBuffer::IsUnitPickId(unsigned int pickId)
+{
+    return (pickId & UNIT_PICK_FLAG) != 0;
+}
+
+int PickingBuffer::GetVoxelIndex(unsigned int pickId)
+{
+    return (int)pickId - 1;
+}
+
+int PickingBuffer::GetPlayerId(unsigned int pickId)
+{
+    return (int)((pickId & ~UNIT_PICK_FLAG) >> UNIT_ID_BITS);
+}
+
+unsigned int PickingBuffer::GetUnitId(unsigned int pickId)
+{
+    return pickId & ((1u << UNIT_ID_BITS) - 1);
+}
+
+PickingBuffer::PickingBuffer()
+{
+    nextReadback = 0;
+    hoveredId = NO_PICK_ID;
+    isInitialized = false;
+    for (int i = 0; i < READBACK_BUFFERS; i++)
+    {
+        fences[i] = nullptr;
+    }
+}
+
+bool PickingBuffer::Initialize()
+{
+    glGenRenderbuffers(1, &idRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, idRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_R32UI, 1, 1);
+
+    glGenRenderbuffers(1, &depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 1, 1);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, idRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+    // Shader output 0 (the color) is dropped, and output 1 (the pick id) goes to the id renderbuffer.
+    const GLenum drawBuffers[] = { GL_NONE, GL_COLOR_ATTACHMENT0 };
+    glDrawBuffers(2, drawBuffers);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        Logger::Log("The picking framebuffer is incomplete, status ", status, ".");
+        return false;
+    }
+
+    glGenBuffers(READBACK_BUFFERS, pixelBuffers);
+    for (int i = 0; i < READBACK_BUFFERS; i++)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(GLuint), nullptr, GL_STREAM_READ);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    isInitialized = true;
+    return true;
+}
+
+bool PickingBuffer::Begin(int cursorX, int cursorY, int screenWidth, int screenHeight, vec::mat4* pickMatrix)
+{
+    if (cursorX < 0 || cursorY < 0 || cursorX >= screenWidth || cursorY >= screenHeight)
+    {
+        hoveredId = NO_PICK_ID;
+        return false;
+    }
+
+    *pickMatrix = MatrixOps::PickMatrix(cursorX, cursorY, screenWidth, screenHeight);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, 1, 1);
+
+    const GLuint noPickId = NO_PICK_ID;
+    const GLfloat farDepth = 1.0f;
+    glClearBufferuiv(GL_COLOR, 1, &noPickId);
+    glClearBufferfv(GL_DEPTH, 0, &farDepth);
+    return true;
+}
+
+void PickingBuffer::End(int screenWidth, int screenHeight)
+{
+    // Pick up the oldest readback first, so the newest id wins if both are done.
+    for (int i = 1; i <= READBACK_BUFFERS; i++)
+    {
+        TryReadback((nextReadback + i) % READBACK_BUFFERS);
+    }
+
+    // If the GPU still hasn't finished the readback in this slot, it's replaced by this frame's newer one.
+    if (fences[nextReadback] != nullptr)
+    {
+        glDeleteSync(fences[nextReadback]);
+        fences[nextReadback] = nullptr;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[nextReadback]);
+    glReadPixels(0, 0, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    fences[nextReadback] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    nextReadback = (nextReadback + 1) % READBACK_BUFFERS;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, screenWidth, screenHeight);
+}
+
+unsigned int PickingBuffer::GetHoveredId() const
+{
+    return hoveredId;
+}
+
+bool PickingBuffer::TryReadback(int readback)
+{
+    if (fences[readback] == nullptr)
+    {
+        return false;
+    }
+
+    GLenum waitResult = glClientWaitSync(fences[readback], 0, 0);
+    if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+    {
+        return false;
+    }
+
+    glDeleteSync(fences[readback]);
+    fences[readback] = nullptr;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[readback]);
+    const GLuint* pickId = (const GLuint*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(GLuint), GL_MAP_READ_BIT);
+    if (pickId != nullptr)
+    {
+        hoveredId = *pickId;
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
+PickingBuffer::~PickingBuffer()
+{
+    if (!isInitialized)
+    {
+        return;
+    }
+
+    for (int i = 0; i < READBACK_BUFFERS; i++)
+    {
+        if (fences[i] != nullptr)
+        {
+            glDeleteSync(fences[i]);
+        }
+    }
+
+    glDeleteBuffers(READBACK_BUFFERS, pixelBuffers);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &idRenderbuffer);
+    glDeleteRenderbuffers(1, &depthRenderbuffer);
+}
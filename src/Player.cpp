@@ -1,3 +1,4 @@
+#include "Constants.h"
 #include "TechConfig.h"
 #include "Player.h"
 
@@ -20,54 +21,153 @@ void Player::AddUnit(const Unit& unit)
     units.push_back(unit);
 }
 
-void Player::PerformUnitGuiUpdates(RouteVisual& routeVisuals)
+int Player::CollisionCheck(const SpatialHash& unitHash, vec::vec3 cameraPos, vec::vec3 worldRay)
 {
-    ReadLock readLock(playerUnitVectorMutex);
-    for (unsigned int i = 0; i < units.size(); i++)
+    // Hits are sorted by distance, so the first hit that belongs to this player is the closest.
+    std::vector<SpatialHashRayHit> hits;
+    unitHash.RayQuery(cameraPos, worldRay, Constants::FAR_PLANE, hits);
+    for (unsigned int i = 0; i < hits.size(); i++)
     {
-        units[i].PerformGuiThreadUpdates(routeVisuals);
+        if (hits[i].playerId == (unsigned int)id)
+        {
+            return (int)hits[i].unitId;
+        }
     }
+
+    return -1;
+}
+
+vec::vec3 Player::GetUnitPosition(unsigned int unitId)
+{
+    ReadLock readLock(playerUnitVectorMutex);
+    return units[unitId].GetPosition();
+}
+
+void Player::UpdateUnitRoute(int unitId, const std::vector<vec::vec3>& route)
+{
+    ReadLock readLock(playerUnitVectorMutex);
+    units[unitId].UpdateAssignedRoute(route);
+}
+
+void Player::MoveUnits(JobSystem& jobSystem)
+{
+    // Each unit only moves itself, so the result doesn't depend on how the units are split across threads.
+    ReadLock readLock(playerUnitVectorMutex);
+    jobSystem.ParallelFor(0, (unsigned int)units.size(), 16, [&](unsigned int startIndex, unsigned int endIndex)
+    {
+        for (unsigned int i = startIndex; i < endIndex; i++)
+        {
+            units[i].MoveAlongRoute();
+        }
+    });
 }
 
-void Player::RenderUnits(ModelManager& modelManager, RouteVisual& routeVisual, vec::mat4& projectionMatrix)
+void Player::AddAvoidanceAgents(LocalAvoidance& localAvoidance)
 {
     ReadLock readLock(playerUnitVectorMutex);
-    ReadLock readLock2(unitSelectionMutex);
+    AvoidanceAgent* agents = localAvoidance.AddPlayerAgents(id, (unsigned int)units.size());
     for (unsigned int i = 0; i < units.size(); i++)
     {
-        units[i].Render(modelManager, routeVisual, selectedUnits.find(i) != selectedUnits.end(), projectionMatrix);
+        units[i].FillAvoidanceAgent(agents[i]);
     }
 }
 
-int Player::CollisionCheck(vec::vec3 cameraPos, vec::vec3 worldRay)
+void Player::ApplyAvoidance(JobSystem& jobSystem, const LocalAvoidance& localAvoidance, const MapSections& mapSections)
 {
     ReadLock readLock(playerUnitVectorMutex);
-    for (unsigned int i = 0; i < units.size(); i++)
+    jobSystem.ParallelFor(0, (unsigned int)units.size(), 16, [&](unsigned int startIndex, unsigned int endIndex)
+    {
+        for (unsigned int i = startIndex; i < endIndex; i++)
+        {
+            units[i].ApplyAvoidance(localAvoidance.GetAgent(id, i), mapSections);
+        }
+    });
+}
+
+void Player::ResetVisibility(const MapSections& mapSections)
+{
+    visibility.Reset(mapSections);
+}
+
+void Player::UpdateVisibility(const MapSections& mapSections, float budgetMs)
+{
     {
-        if (units[i].InRayPath(cameraPos, worldRay))
+        // Only units that moved to another column are queued for recomputation, so this is cheap for idle units.
+        ReadLock readLock(playerUnitVectorMutex);
+        for (unsigned int i = 0; i < units.size(); i++)
         {
-            return i;
+            if (units[i].IsDestroyed())
+            {
+                visibility.RemoveViewer(i);
+            }
+            else
+            {
+                visibility.UpdateViewer(i, units[i].GetPosition(), units[i].GetSensorRadius());
+            }
         }
     }
 
-    return -1;
+    visibility.Update(mapSections, budgetMs);
 }
 
-void Player::UpdateUnitRoute(int unitId, const std::vector<vec::vec3>& route)
+VisibilityGrid& Player::GetVisibility()
+{
+    return visibility;
+}
+
+void Player::UpdateTurrets(JobSystem& jobSystem, TurretTargeting& turretTargeting, const MapSections& mapSections, const SpatialHash& unitHash)
 {
     ReadLock readLock(playerUnitVectorMutex);
-    units[unitId].UpdateAssignedRoute(route);
+    turretSearchBuffers.resize(jobSystem.GetThreadCount());
+    jobSystem.ParallelFor(0, (unsigned int)units.size(), 16, [&](unsigned int startIndex, unsigned int endIndex)
+    {
+        TurretTargeting::SearchBuffers& searchBuffers = turretSearchBuffers[jobSystem.GetCurrentThreadIndex()];
+        for (unsigned int i = startIndex; i < endIndex; i++)
+        {
+            units[i].UpdateTurrets(id, i, turretTargeting, mapSections, unitHash, visibility, searchBuffers);
+        }
+    });
+}
+
+unsigned int Player::FireTurrets(ProjectilePool& projectilePool)
+{
+    ReadLock readLock(playerUnitVectorMutex);
+    unsigned int firedCount = 0;
+    for (unsigned int i = 0; i < units.size(); i++)
+    {
+        firedCount += units[i].FireTurrets(id, projectilePool);
+    }
+
+    return firedCount;
 }
 
-void Player::MoveUnits()
+void Player::UpdateSpatialHash(SpatialHash& unitHash)
 {
     ReadLock readLock(playerUnitVectorMutex);
     for (unsigned int i = 0; i < units.size(); i++)
     {
-        units[i].MoveAlongRoute();
+        if (units[i].IsDestroyed())
+        {
+            unitHash.RemoveEntry(id, i);
+        }
+        else
+        {
+            unitHash.UpdateEntry(id, i, units[i].GetPosition(), units[i].GetRadius());
+        }
     }
 }
 
+bool Player::ApplyUnitHits(unsigned int unitId, const CombatHit* hits, unsigned int hitCount, unsigned int* killingPlayerId)
+{
+    ReadLock readLock(playerUnitVectorMutex);
+    if (unitId >= units.size())
+    {
+        return false;
+    }
+
+    return units[unitId].ApplyHits(hits, hitCount, killingPlayerId);
+}
+
 bool Player::SwitchResearch(unsigned int techId)
 {
     WriteLock writeLock(techProgressMutex);
@@ -142,6 +242,29 @@ void Player::ToggleUnitSelection(int unitId)
     }
 }
 
+void Player::SelectUnitsWithinRectangle(ScreenSelector& screenSelector, const vec::mat4& projectionMatrix, const vec::mat4& viewProjectionMatrix,
+    vec::vec2 firstCorner, vec::vec2 secondCorner, vec::vec2 screenSize)
+{
+    std::vector<unsigned int> unitsWithinRectangle;
+    {
+        ReadLock readLock(playerUnitVectorMutex);
+        screenSelector.Clear();
+        for (unsigned int i = 0; i < units.size(); i++)
+        {
+            if (!units[i].IsDestroyed())
+            {
+                screenSelector.AddSphere(i, units[i].GetPosition(), units[i].GetRadius());
+            }
+        }
+    }
+
+    screenSelector.FindWithinRectangle(projectionMatrix, viewProjectionMatrix, firstCorner, secondCorner, screenSize, unitsWithinRectangle);
+
+    WriteLock writeLock(unitSelectionMutex);
+    selectedUnits.clear();
+    selectedUnits.insert(unitsWithinRectangle.begin(), unitsWithinRectangle.end());
+}
+
 // Returns the players selected units. 
 const std::set<int>& Player::GetSelectedUnits() const
 {
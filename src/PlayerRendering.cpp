@@ -0,0 +1,33 @@
+#include "ModelManager.h"
+#include "PickingBuffer.h"
+#include "RouteVisual.h"
+#include "Player.h"
+
+void Player::PerformUnitGuiUpdates(RouteVisual& routeVisuals)
+{
+    ReadLock readLock(playerUnitVectorMutex);
+    for (unsigned int i = 0; i < units.size(); i++)
+    {
+        units[i].PerformGuiThreadUpdates(routeVisuals);
+    }
+}
+
+void Player::RenderUnits(ModelManager& modelManager, RouteVisual& routeVisual, unsigned int hoveredPickId, vec::mat4& projectionMatrix)
+{
+    ReadLock readLock(playerUnitVectorMutex);
+    ReadLock readLock2(unitSelectionMutex);
+    for (unsigned int i = 0; i < units.size(); i++)
+    {
+        unsigned int pickId = PickingBuffer::GetUnitPickId(id, i);
+        units[i].Render(modelManager, routeVisual, selectedUnits.find(i) != selectedUnits.end(), pickId == hoveredPickId, pickId, projectionMatrix);
+    }
+}
+
+void Player::RenderUnitPicking(ModelManager& modelManager, vec::mat4& projectionMatrix)
+{
+    ReadLock readLock(playerUnitVectorMutex);
+    for (unsigned int i = 0; i < units.size(); i++)
+    {
+        units[i].RenderPicking(modelManager, PickingBuffer::GetUnitPickId(id, i), projectionMatrix);
+    }
+}
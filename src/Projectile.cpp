@@ -1,11 +0,0 @@
-#include "Projectile.h"
-
-Projectile::Projectile()
-{
-    //ctor
-}
-
-Projectile::~Projectile()
-{
-    //dtor
-}
@@ -0,0 +1,165 @@
+#include <cmath>
+#include "ProjectilePool.h"
+
+float ProjectilePool::Gravity = 0.01f;
+
+ProjectilePool::ProjectilePool()
+{
+    count = 0;
+    capacity = 0;
+}
+
+void ProjectilePool::Initialize(unsigned int capacity)
+{
+    this->capacity = capacity;
+    count = 0;
+
+    xPositions.resize(capacity);
+    yPositions.resize(capacity);
+    zPositions.resize(capacity);
+    xVelocities.resize(capacity);
+    yVelocities.resize(capacity);
+    zVelocities.resize(capacity);
+    firingPlayerIds.resize(capacity);
+    damageTypes.resize(capacity);
+    damages.resize(capacity);
+    remainingTicks.resize(capacity);
+
+    // Ray queries rarely hit more than a few units within a single tick of travel.
+    rayHits.reserve(64);
+}
+
+bool ProjectilePool::Fire(unsigned int firingPlayerId, const vec::vec3& position, const vec::vec3& velocity, DamageType damageType, float damage, unsigned int lifetimeTicks)
+{
+    if (count == capacity || lifetimeTicks == 0)
+    {
+        return false;
+    }
+
+    xPositions[count] = position.x;
+    yPositions[count] = position.y;
+    zPositions[count] = position.z;
+    xVelocities[count] = velocity.x;
+    yVelocities[count] = velocity.y;
+    zVelocities[count] = velocity.z;
+    firingPlayerIds[count] = firingPlayerId;
+    damageTypes[count] = (unsigned char)damageType;
+    damages[count] = damage;
+    remainingTicks[count] = lifetimeTicks;
+    ++count;
+    return true;
+}
+
+void ProjectilePool::Update(const MapSections& mapSections, const SpatialHash& unitHash, std::vector<ProjectileHit>& hits)
+{
+    unsigned int i = 0;
+    while (i < count)
+    {
+        // Semi-implicit Euler integration, which is stable for the constant gravity projectiles are under.
+        zVelocities[i] -= Gravity;
+
+        vec::vec3 start(xPositions[i], yPositions[i], zPositions[i]);
+        vec::vec3 travel(xVelocities[i], yVelocities[i], zVelocities[i]);
+        vec::vec3 end = start + travel;
+
+        // Sweep the path travelled this tick, so fast projectiles can't skip over thin voxels or units.
+        float hitFactor = 2.0f;
+        bool hitMap = mapSections.TraceSegment(start, end, &hitFactor);
+
+        bool hitUnit = false;
+        unsigned int hitPlayerId = 0;
+        unsigned int hitUnitId = 0;
+        float travelLength = std::sqrt(travel.x * travel.x + travel.y * travel.y + travel.z * travel.z);
+        if (travelLength > 0.0f)
+        {
+            unitHash.RayQuery(start, travel / travelLength, travelLength, rayHits);
+            for (unsigned int j = 0; j < rayHits.size(); j++)
+            {
+                // Projectiles pass through friendly units, which also avoids hitting the firing unit.
+                if (rayHits[j].playerId != firingPlayerIds[i])
+                {
+                    float unitHitFactor = rayHits[j].distance / travelLength;
+                    if (unitHitFactor < hitFactor)
+                    {
+                        hitFactor = unitHitFactor;
+                        hitUnit = true;
+                        hitPlayerId = rayHits[j].playerId;
+                        hitUnitId = rayHits[j].unitId;
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        if (hitMap || hitUnit)
+        {
+            ProjectileHit hit;
+            hit.firingPlayerId = firingPlayerIds[i];
+            hit.hitUnit = hitUnit;
+            hit.playerId = hitPlayerId;
+            hit.unitId = hitUnitId;
+            hit.position = start + travel * hitFactor;
+            hit.damageType = (DamageType)damageTypes[i];
+            hit.damage = damages[i];
+            hits.push_back(hit);
+
+            Remove(i);
+            continue;
+        }
+
+        // Projectiles that fall below the map can never hit anything.
+        --remainingTicks[i];
+        if (remainingTicks[i] == 0 || end.z < 0.0f)
+        {
+            Remove(i);
+            continue;
+        }
+
+        xPositions[i] = end.x;
+        yPositions[i] = end.y;
+        zPositions[i] = end.z;
+        ++i;
+    }
+}
+
+void ProjectilePool::Clear()
+{
+    count = 0;
+}
+
+unsigned int ProjectilePool::GetCount() const
+{
+    return count;
+}
+
+unsigned int ProjectilePool::GetCapacity() const
+{
+    return capacity;
+}
+
+unsigned int ProjectilePool::CopyVisualData(vec::vec4* visualData, unsigned int maxCount) const
+{
+    unsigned int copyCount = count < maxCount ? count : maxCount;
+    for (unsigned int i = 0; i < copyCount; i++)
+    {
+        visualData[i] = vec::vec4(xPositions[i], yPositions[i], zPositions[i], (float)damageTypes[i]);
+    }
+
+    return copyCount;
+}
+
+void ProjectilePool::Remove(unsigned int index)
+{
+    --count;
+    xPositions[index] = xPositions[count];
+    yPositions[index] = yPositions[count];
+    zPositions[index] = zPositions[count];
+    xVelocities[index] = xVelocities[count];
+    yVelocities[index] = yVelocities[count];
+    zVelocities[index] = zVelocities[count];
+    firingPlayerIds[index] = firingPlayerIds[count];
+    damageTypes[index] = damageTypes[count];
+    damages[index] = damages[count];
+    remainingTicks[index] = remainingTicks[count];
+}
@@ -0,0 +1,81 @@
+#include "Logger.h"
+#include "ProjectileVisual.h"
+
+ProjectileVisual::ProjectileVisual()
+{
+    shapeVertexCount = 0;
+    capacity = 0;
+}
+
+bool ProjectileVisual::Initialize(ShaderManager& shaderManager, unsigned int capacity)
+{
+    if (!shaderManager.CreateShaderProgram("projectileRender", &projectileProgram))
+    {
+        Logger::Log("Failure creating the projectile shader program!");
+        return false;
+    }
+
+    projMatrixLocation = glGetUniformLocation(projectileProgram, "projMatrix");
+    this->capacity = capacity;
+
+    // Every projectile is drawn as the same small octahedron, which the shader sizes and colors by damage type.
+    const vec::vec3 corners[6] = { vec::vec3(1.0f, 0.0f, 0.0f), vec::vec3(0.0f, 1.0f, 0.0f), vec::vec3(-1.0f, 0.0f, 0.0f),
+        vec::vec3(0.0f, -1.0f, 0.0f), vec::vec3(0.0f, 0.0f, 1.0f), vec::vec3(0.0f, 0.0f, -1.0f) };
+    std::vector<vec::vec3> shapeVertices;
+    for (int i = 0; i < 4; i++)
+    {
+        shapeVertices.push_back(corners[i]);
+        shapeVertices.push_back(corners[(i + 1) % 4]);
+        shapeVertices.push_back(corners[4]);
+
+        shapeVertices.push_back(corners[(i + 1) % 4]);
+        shapeVertices.push_back(corners[i]);
+        shapeVertices.push_back(corners[5]);
+    }
+
+    shapeVertexCount = (GLsizei)shapeVertices.size();
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glGenBuffers(1, &shapeBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, shapeBuffer);
+    glBufferData(GL_ARRAY_BUFFER, shapeVertices.size() * sizeof(vec::vec3), &shapeVertices[0], GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    // Per-projectile data advances once per instance. The buffer is sized once, and only the live projectiles are updated each frame.
+    glGenBuffers(1, &instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(vec::vec4), nullptr, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glVertexAttribDivisor(1, 1);
+
+    return true;
+}
+
+void ProjectileVisual::Render(const vec::mat4& projectionMatrix, const std::vector<vec::vec4>& projectiles, unsigned int count)
+{
+    count = count < capacity ? count : capacity;
+    if (count == 0)
+    {
+        return;
+    }
+
+    glUseProgram(projectileProgram);
+    glBindVertexArray(vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(vec::vec4), &projectiles[0]);
+
+    glUniformMatrix4fv(projMatrixLocation, 1, GL_FALSE, projectionMatrix);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, shapeVertexCount, count);
+}
+
+ProjectileVisual::~ProjectileVisual()
+{
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &shapeBuffer);
+    glDeleteBuffers(1, &instanceBuffer);
+}
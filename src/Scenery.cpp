@@ -7,11 +7,12 @@
 Scenery::Scenery(ModelManager* modelManager)
 {
     this->modelManager = modelManager;
+    rawImage = nullptr;
 
     groundOrientation = vec::mat4::identity();
 }
 
-bool Scenery::Initialize(ShaderManager& shaderManager)
+bool Scenery::Initialize(ShaderManager& shaderManager, AssetLoader& assetLoader)
 {
     // Load the ground
     groundModelId = modelManager->LoadModel("models/scenery/ground");
@@ -34,13 +35,19 @@ bool Scenery::Initialize(ShaderManager& shaderManager)
     skyCubeMapLocation = glGetUniformLocation(skyCubeProgram, "skyCubeMap");
 
     // Sky Image
-    int width;
-    int height;
-    if (!GetRawImage("images/scenery/sky.png", &rawImage, &width, &height))
+    AssetTaskId skyImageTask = assetLoader.AddWorkTask("Sky image", [this](unsigned int)
     {
-        return false;
-    }
+        return GetRawImage("images/scenery/sky.png", &rawImage, &rawImageWidth, &rawImageHeight);
+    }, std::vector<AssetTaskId>());
+
+    assetLoader.AddUploadTask("Sky image", [this]() { return CreateSkyCube(); }, std::vector<AssetTaskId>(1, skyImageTask));
+    return true;
+}
 
+bool Scenery::CreateSkyCube()
+{
+    int width = rawImageWidth;
+    int height = rawImageHeight;
     if (height != 6 * width)
     {
         Logger::Log("There are not six square sky images in a vertical row in the skybox image!");
@@ -69,7 +76,7 @@ bool Scenery::Initialize(ShaderManager& shaderManager)
 void Scenery::Render(vec::mat4& viewMatrix, vec::mat4& projectionMatrix)
 {
     // Render the ground plane
-    modelManager->RenderModel(projectionMatrix, groundModelId, groundOrientation, false);
+    modelManager->RenderModel(projectionMatrix, groundModelId, groundOrientation, false, false, 0);
 
     // Render the sky
     glUseProgram(skyCubeProgram);
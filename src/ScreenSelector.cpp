@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cmath>
+#include "ScreenSelector.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SCREEN_SELECTOR_USE_SSE
+#endif
+
+// Spheres closer to the eye than this (in clip-space w) are behind the viewer or too close to select.
+static const float MinimumClipW = 0.0001f;
+
+ScreenSelector::ScreenSelector()
+{
+}
+
+void ScreenSelector::Clear()
+{
+    ids.clear();
+    xPositions.clear();
+    yPositions.clear();
+    zPositions.clear();
+    radii.clear();
+}
+
+void ScreenSelector::AddSphere(unsigned int id, const vec::vec3& center, float radius)
+{
+    ids.push_back(id);
+    xPositions.push_back(center.x);
+    yPositions.push_back(center.y);
+    zPositions.push_back(center.z);
+    radii.push_back(radius);
+}
+
+void ScreenSelector::FindWithinRectangle(const vec::mat4& projectionMatrix, const vec::mat4& viewProjectionMatrix,
+    vec::vec2 firstCorner, vec::vec2 secondCorner, vec::vec2 screenSize, std::vector<unsigned int>& selectedIds)
+{
+    selectedIds.clear();
+
+    // Convert the rectangle to normalized device coordinates, inverting Y.
+    float minX = std::min(firstCorner.x, secondCorner.x) * 2.0f / screenSize.x - 1.0f;
+    float maxX = std::max(firstCorner.x, secondCorner.x) * 2.0f / screenSize.x - 1.0f;
+    float minY = 1.0f - std::max(firstCorner.y, secondCorner.y) * 2.0f / screenSize.y;
+    float maxY = 1.0f - std::min(firstCorner.y, secondCorner.y) * 2.0f / screenSize.y;
+
+    // The projected sphere radius in NDC is radius * scale / w, so comparisons are done in clip space (scaled by w) to avoid divides.
+    float xScale = std::abs(projectionMatrix[0][0]);
+    float yScale = std::abs(projectionMatrix[1][1]);
+
+    const vec::mat4& m = viewProjectionMatrix;
+    unsigned int count = (unsigned int)ids.size();
+    withinRectangle.resize(count);
+
+    unsigned int i = 0;
+#ifdef SCREEN_SELECTOR_USE_SSE
+    // Column c, row r of the matrix, splatted across all four lanes.
+    __m128 matrix[4][4];
+    for (int c = 0; c < 4; c++)
+    {
+        for (int r = 0; r < 4; r++)
+        {
+            matrix[c][r] = _mm_set1_ps(m[c][r]);
+        }
+    }
+
+    const __m128 minXs = _mm_set1_ps(minX);
+    const __m128 maxXs = _mm_set1_ps(maxX);
+    const __m128 minYs = _mm_set1_ps(minY);
+    const __m128 maxYs = _mm_set1_ps(maxY);
+    const __m128 xScales = _mm_set1_ps(xScale);
+    const __m128 yScales = _mm_set1_ps(yScale);
+    const __m128 minimumWs = _mm_set1_ps(MinimumClipW);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(&xPositions[i]);
+        __m128 y = _mm_loadu_ps(&yPositions[i]);
+        __m128 z = _mm_loadu_ps(&zPositions[i]);
+        __m128 radius = _mm_loadu_ps(&radii[i]);
+
+        __m128 clipX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(matrix[0][0], x), _mm_mul_ps(matrix[1][0], y)), _mm_add_ps(_mm_mul_ps(matrix[2][0], z), matrix[3][0]));
+        __m128 clipY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(matrix[0][1], x), _mm_mul_ps(matrix[1][1], y)), _mm_add_ps(_mm_mul_ps(matrix[2][1], z), matrix[3][1]));
+        __m128 clipW = _mm_add_ps(_mm_add_ps(_mm_mul_ps(matrix[0][3], x), _mm_mul_ps(matrix[1][3], y)), _mm_add_ps(_mm_mul_ps(matrix[2][3], z), matrix[3][3]));
+
+        __m128 xReach = _mm_mul_ps(radius, xScales);
+        __m128 yReach = _mm_mul_ps(radius, yScales);
+
+        __m128 inside = _mm_cmpgt_ps(clipW, minimumWs);
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(clipX, xReach), _mm_mul_ps(minXs, clipW)));
+        inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_sub_ps(clipX, xReach), _mm_mul_ps(maxXs, clipW)));
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(clipY, yReach), _mm_mul_ps(minYs, clipW)));
+        inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_sub_ps(clipY, yReach), _mm_mul_ps(maxYs, clipW)));
+
+        int mask = _mm_movemask_ps(inside);
+        withinRectangle[i] = mask & 1;
+        withinRectangle[i + 1] = (mask >> 1) & 1;
+        withinRectangle[i + 2] = (mask >> 2) & 1;
+        withinRectangle[i + 3] = (mask >> 3) & 1;
+    }
+#endif
+
+    // Scalar path for the remainder (or everything, without SSE).
+    for (; i < count; i++)
+    {
+        float x = xPositions[i];
+        float y = yPositions[i];
+        float z = zPositions[i];
+
+        float clipX = m[0][0] * x + m[1][0] * y + m[2][0] * z + m[3][0];
+        float clipY = m[0][1] * x + m[1][1] * y + m[2][1] * z + m[3][1];
+        float clipW = m[0][3] * x + m[1][3] * y + m[2][3] * z + m[3][3];
+
+        float xReach = radii[i] * xScale;
+        float yReach = radii[i] * yScale;
+        withinRectangle[i] = clipW > MinimumClipW &&
+            clipX + xReach >= minX * clipW && clipX - xReach <= maxX * clipW &&
+            clipY + yReach >= minY * clipW && clipY - yReach <= maxY * clipW;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (withinRectangle[i])
+        {
+            selectedIds.push_back(ids[i]);
+        }
+    }
+}
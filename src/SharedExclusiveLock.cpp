@@ -1,4 +1,5 @@
-#include <SFML\System.hpp>
+#include <chrono>
+#include <thread>
 #include "SharedExclusiveLock.h"
 
 ReadLock::ReadLock(SharedExclusiveLock& lock) : lock(lock)
@@ -58,7 +59,7 @@ void SharedExclusiveLock::WriteLock()
             mutex.unlock();
         }
 
-        sf::sleep(sf::microseconds(100)); // 0.1 ms
+        std::this_thread::sleep_for(std::chrono::microseconds(100)); // 0.1 ms
     }
 }
 
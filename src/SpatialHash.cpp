@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "PhysicsOps.h"
+#include "SpatialHash.h"
+
+SpatialHash::SpatialHash(float cellSize)
+{
+    this->cellSize = cellSize;
+    currentQueryStamp = 0;
+    Clear();
+}
+
+long long SpatialHash::GetEntryKey(unsigned int playerId, unsigned int unitId)
+{
+    return ((long long)playerId << 32) | (long long)unitId;
+}
+
+long long SpatialHash::GetCellKey(int x, int y)
+{
+    return ((long long)x << 32) | (long long)(unsigned int)y;
+}
+
+vec::vec2i SpatialHash::GetCell(const vec::vec3& position) const
+{
+    return vec::vec2i((int)std::floor(position.x / cellSize), (int)std::floor(position.y / cellSize));
+}
+
+// Number of neighboring cells a unit stored in one cell can reach into.
+int SpatialHash::GetCellMargin() const
+{
+    return (int)std::ceil(maxEntryRadius / cellSize);
+}
+
+void SpatialHash::UpdateEntry(unsigned int playerId, unsigned int unitId, const vec::vec3& position, float radius)
+{
+    maxEntryRadius = std::max(maxEntryRadius, radius);
+
+    vec::vec2i cell = GetCell(position);
+    long long cellKey = GetCellKey(cell.x, cell.y);
+
+    std::unordered_map<long long, unsigned int>::const_iterator lookupResult = entryLookup.find(GetEntryKey(playerId, unitId));
+    if (lookupResult == entryLookup.end())
+    {
+        StoredEntry storedEntry;
+        storedEntry.entry.playerId = playerId;
+        storedEntry.entry.unitId = unitId;
+        storedEntry.entry.position = position;
+        storedEntry.entry.radius = radius;
+        storedEntry.cellKey = cellKey;
+
+        unsigned int entryIndex = (unsigned int)entries.size();
+        entries.push_back(storedEntry);
+        queryStamps.push_back(0);
+        entryLookup[GetEntryKey(playerId, unitId)] = entryIndex;
+        AddToCell(entryIndex);
+    }
+    else
+    {
+        unsigned int entryIndex = lookupResult->second;
+        StoredEntry& storedEntry = entries[entryIndex];
+        storedEntry.entry.position = position;
+        storedEntry.entry.radius = radius;
+
+        // Most updates are small moves that stay within the same cell.
+        if (storedEntry.cellKey != cellKey)
+        {
+            RemoveFromCell(entryIndex);
+            storedEntry.cellKey = cellKey;
+            AddToCell(entryIndex);
+        }
+    }
+
+    minCell.x = std::min(minCell.x, cell.x);
+    minCell.y = std::min(minCell.y, cell.y);
+    maxCell.x = std::max(maxCell.x, cell.x);
+    maxCell.y = std::max(maxCell.y, cell.y);
+}
+
+void SpatialHash::RemoveEntry(unsigned int playerId, unsigned int unitId)
+{
+    std::unordered_map<long long, unsigned int>::iterator lookupResult = entryLookup.find(GetEntryKey(playerId, unitId));
+    if (lookupResult == entryLookup.end())
+    {
+        return;
+    }
+
+    unsigned int entryIndex = lookupResult->second;
+    RemoveFromCell(entryIndex);
+    entryLookup.erase(lookupResult);
+
+    // Move the last entry into the freed slot, updating the references to it.
+    unsigned int lastIndex = (unsigned int)entries.size() - 1;
+    if (entryIndex != lastIndex)
+    {
+        entries[entryIndex] = entries[lastIndex];
+        entryLookup[GetEntryKey(entries[entryIndex].entry.playerId, entries[entryIndex].entry.unitId)] = entryIndex;
+        cells[entries[entryIndex].cellKey][entries[entryIndex].cellSlot] = entryIndex;
+    }
+
+    entries.pop_back();
+    queryStamps.pop_back();
+}
+
+void SpatialHash::Clear()
+{
+    entries.clear();
+    entryLookup.clear();
+    cells.clear();
+    queryStamps.clear();
+
+    maxEntryRadius = 0.0f;
+    minCell = vec::vec2i(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+    maxCell = vec::vec2i(std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
+}
+
+bool SpatialHash::GetEntry(unsigned int playerId, unsigned int unitId, SpatialHashEntry* entry) const
+{
+    std::unordered_map<long long, unsigned int>::const_iterator lookupResult = entryLookup.find(GetEntryKey(playerId, unitId));
+    if (lookupResult == entryLookup.end())
+    {
+        return false;
+    }
+
+    *entry = entries[lookupResult->second].entry;
+    return true;
+}
+
+unsigned int SpatialHash::GetEntryCount() const
+{
+    return (unsigned int)entries.size();
+}
+
+void SpatialHash::AddToCell(unsigned int entryIndex)
+{
+    std::vector<unsigned int>& cell = cells[entries[entryIndex].cellKey];
+    entries[entryIndex].cellSlot = (unsigned int)cell.size();
+    cell.push_back(entryIndex);
+}
+
+void SpatialHash::RemoveFromCell(unsigned int entryIndex)
+{
+    std::unordered_map<long long, std::vector<unsigned int>>::iterator cellResult = cells.find(entries[entryIndex].cellKey);
+    std::vector<unsigned int>& cell = cellResult->second;
+
+    unsigned int cellSlot = entries[entryIndex].cellSlot;
+    cell[cellSlot] = cell.back();
+    entries[cell[cellSlot]].cellSlot = cellSlot;
+    cell.pop_back();
+
+    if (cell.empty())
+    {
+        cells.erase(cellResult);
+    }
+}
+
+unsigned int SpatialHash::BeginQuery() const
+{
+    ++currentQueryStamp;
+    if (currentQueryStamp == 0)
+    {
+        // Wrapped around, so old stamps could collide with new ones.
+        std::fill(queryStamps.begin(), queryStamps.end(), 0);
+        currentQueryStamp = 1;
+    }
+
+    return currentQueryStamp;
+}
+
+template <typename T>
+void SpatialHash::VisitCellNeighborhood(int x, int y, int margin, unsigned int stamp, T& testFunction) const
+{
+    for (int i = x - margin; i <= x + margin; i++)
+    {
+        for (int j = y - margin; j <= y + margin; j++)
+        {
+            std::unordered_map<long long, std::vector<unsigned int>>::const_iterator cellResult = cells.find(GetCellKey(i, j));
+            if (cellResult == cells.end())
+            {
+                continue;
+            }
+
+            for (unsigned int entryIndex : cellResult->second)
+            {
+                if (queryStamps[entryIndex] != stamp)
+                {
+                    queryStamps[entryIndex] = stamp;
+                    testFunction(entries[entryIndex].entry);
+                }
+            }
+        }
+    }
+}
+
+// Walks the cells under the ray in the XY plane (a 2D DDA), testing the units near each cell.
+void SpatialHash::RayQuery(const vec::vec3& rayStart, const vec::vec3& rayVector, float maxDistance, std::vector<SpatialHashRayHit>& hits) const
+{
+    hits.clear();
+    if (entries.empty())
+    {
+        return;
+    }
+
+    // Clip the ray to the region that has held units, so rays through empty space don't walk empty cells.
+    int margin = GetCellMargin();
+    float regionMin[2] = { (minCell.x - margin) * cellSize, (minCell.y - margin) * cellSize };
+    float regionMax[2] = { (maxCell.x + margin + 1) * cellSize, (maxCell.y + margin + 1) * cellSize };
+    float start[2] = { rayStart.x, rayStart.y };
+    float direction[2] = { rayVector.x, rayVector.y };
+
+    float startDistance = 0.0f;
+    float endDistance = maxDistance;
+    for (int axis = 0; axis < 2; axis++)
+    {
+        if (direction[axis] == 0.0f)
+        {
+            if (start[axis] < regionMin[axis] || start[axis] > regionMax[axis])
+            {
+                return;
+            }
+        }
+        else
+        {
+            float nearDistance = (regionMin[axis] - start[axis]) / direction[axis];
+            float farDistance = (regionMax[axis] - start[axis]) / direction[axis];
+            if (nearDistance > farDistance)
+            {
+                std::swap(nearDistance, farDistance);
+            }
+
+            startDistance = std::max(startDistance, nearDistance);
+            endDistance = std::min(endDistance, farDistance);
+        }
+    }
+
+    if (startDistance > endDistance)
+    {
+        return;
+    }
+
+    auto testFunction = [&](const SpatialHashEntry& entry)
+    {
+        float distance;
+        if (PhysicsOps::HitsSphere(rayStart, rayVector, entry.position, entry.radius, &distance) && distance <= maxDistance)
+        {
+            SpatialHashRayHit hit;
+            hit.playerId = entry.playerId;
+            hit.unitId = entry.unitId;
+            hit.distance = distance;
+            hits.push_back(hit);
+        }
+    };
+
+    // Setup the DDA from where the ray enters the region.
+    int cell[2];
+    int step[2];
+    float nextBoundary[2];
+    float boundaryDelta[2];
+    for (int axis = 0; axis < 2; axis++)
+    {
+        float position = start[axis] + direction[axis] * startDistance;
+        cell[axis] = (int)std::floor(position / cellSize);
+        if (direction[axis] > 0.0f)
+        {
+            step[axis] = 1;
+            nextBoundary[axis] = ((cell[axis] + 1) * cellSize - start[axis]) / direction[axis];
+            boundaryDelta[axis] = cellSize / direction[axis];
+        }
+        else if (direction[axis] < 0.0f)
+        {
+            step[axis] = -1;
+            nextBoundary[axis] = (cell[axis] * cellSize - start[axis]) / direction[axis];
+            boundaryDelta[axis] = -cellSize / direction[axis];
+        }
+        else
+        {
+            step[axis] = 0;
+            nextBoundary[axis] = std::numeric_limits<float>::max();
+            boundaryDelta[axis] = 0.0f;
+        }
+    }
+
+    unsigned int stamp = BeginQuery();
+    float distance = startDistance;
+    while (distance <= endDistance)
+    {
+        VisitCellNeighborhood(cell[0], cell[1], margin, stamp, testFunction);
+        if (step[0] == 0 && step[1] == 0)
+        {
+            // Vertical ray, which only crosses a single cell.
+            break;
+        }
+
+        int axis = nextBoundary[0] < nextBoundary[1] ? 0 : 1;
+        distance = nextBoundary[axis];
+        nextBoundary[axis] += boundaryDelta[axis];
+        cell[axis] += step[axis];
+    }
+
+    std::sort(hits.begin(), hits.end(), [](const SpatialHashRayHit& first, const SpatialHashRayHit& second)
+    {
+        if (first.distance != second.distance)
+        {
+            return first.distance < second.distance;
+        }
+
+        return first.playerId != second.playerId ? first.playerId < second.playerId : first.unitId < second.unitId;
+    });
+}
+
+void SpatialHash::RadiusQuery(const vec::vec3& center, float radius, std::vector<SpatialHashEntry>& results) const
+{
+    results.clear();
+    if (entries.empty())
+    {
+        return;
+    }
+
+    auto testFunction = [&](const SpatialHashEntry& entry)
+    {
+        vec::vec3 offset = entry.position - center;
+        float reach = radius + entry.radius;
+        if (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z <= reach * reach)
+        {
+            results.push_back(entry);
+        }
+    };
+
+    VisitCellRange(GetCell(center - vec::vec3(radius, radius, 0.0f)), GetCell(center + vec::vec3(radius, radius, 0.0f)), testFunction);
+}
+
+void SpatialHash::BoxQuery(const vec::vec3& minPosition, const vec::vec3& maxPosition, std::vector<SpatialHashEntry>& results) const
+{
+    results.clear();
+    if (entries.empty())
+    {
+        return;
+    }
+
+    auto testFunction = [&](const SpatialHashEntry& entry)
+    {
+        if (entry.position.x + entry.radius >= minPosition.x && entry.position.x - entry.radius <= maxPosition.x &&
+            entry.position.y + entry.radius >= minPosition.y && entry.position.y - entry.radius <= maxPosition.y &&
+            entry.position.z + entry.radius >= minPosition.z && entry.position.z - entry.radius <= maxPosition.z)
+        {
+            results.push_back(entry);
+        }
+    };
+
+    VisitCellRange(GetCell(minPosition), GetCell(maxPosition), testFunction);
+}
+
+template <typename T>
+void SpatialHash::VisitCellRange(const vec::vec2i& minRangeCell, const vec::vec2i& maxRangeCell, T& testFunction) const
+{
+    // Units can reach into the range from the margin around it, but only the part that has held units needs to be visited.
+    int margin = GetCellMargin();
+    int startX = std::max(minRangeCell.x - margin, minCell.x);
+    int startY = std::max(minRangeCell.y - margin, minCell.y);
+    int endX = std::min(maxRangeCell.x + margin, maxCell.x);
+    int endY = std::min(maxRangeCell.y + margin, maxCell.y);
+
+    // Each cell is visited once, so no entry stamps are needed, which keeps these queries safe to run concurrently.
+    for (int i = startX; i <= endX; i++)
+    {
+        for (int j = startY; j <= endY; j++)
+        {
+            std::unordered_map<long long, std::vector<unsigned int>>::const_iterator cellResult = cells.find(GetCellKey(i, j));
+            if (cellResult != cells.end())
+            {
+                for (unsigned int entryIndex : cellResult->second)
+                {
+                    testFunction(entries[entryIndex].entry);
+                }
+            }
+        }
+    }
+}
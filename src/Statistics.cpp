@@ -1,4 +1,4 @@
-#include <sstream>
+#include <cstdio>
 #include <string>
 #include "MatrixOps.h"
 #include "Statistics.h"
@@ -12,6 +12,12 @@ Statistics::Statistics()
     runTime.posRotMatrix = MatrixOps::Translate(-0.821f, -0.221f, -1.0f) * MatrixOps::Scale(0.015f, 0.015f, 0.015f);
     runTime.color = vec::vec3(0.8f, 0.8f, 0.8f);
 
+    textureMemory.posRotMatrix = MatrixOps::Translate(-0.821f, -0.421f, -1.0f) * MatrixOps::Scale(0.015f, 0.015f, 0.015f);
+    textureMemory.color = vec::vec3(0.8f, 0.8f, 0.8f);
+
+    overlayAllocations.posRotMatrix = MatrixOps::Translate(-0.821f, -0.521f, -1.0f) * MatrixOps::Scale(0.015f, 0.015f, 0.015f);
+    overlayAllocations.color = vec::vec3(0.8f, 0.8f, 0.8f);
+
     xPosition.posRotMatrix = MatrixOps::Translate(-0.821f, -0.321f, -1.0f) * textScale;
     yPosition.posRotMatrix = MatrixOps::Translate(-0.659f, -0.321f, -1.0f) * textScale;
     zPosition.posRotMatrix = MatrixOps::Translate(-0.508f, -0.321f, -1.0f) * textScale;
@@ -28,6 +34,8 @@ bool Statistics::Initialize(FontManager* fontManager)
     // Create the sentence objects to perform font manipulations on.
     playerCount.sentenceId = fontManager->CreateNewSentence();
     runTime.sentenceId = fontManager->CreateNewSentence();
+    textureMemory.sentenceId = fontManager->CreateNewSentence();
+    overlayAllocations.sentenceId = fontManager->CreateNewSentence();
 
     playerName.sentenceId = fontManager->CreateNewSentence();
     playerMinTechLevel.sentenceId = fontManager->CreateNewSentence();
@@ -42,18 +50,13 @@ bool Statistics::Initialize(FontManager* fontManager)
 
 void Statistics::UpdateRunTime(float currentTime)
 {
-    std::stringstream textStream;
-
     int hours = (int)(currentTime / 3600);
-    int minutes = (int)((currentTime - hours) / 60);
-    int seconds = (int)currentTime - (3600 * hours + 60 * minutes);
-
-    // Do some fancy stuff so values < 10 render similar to '00' instead of just '0'
-    textStream << "Running for " <<
-        (hours < 10 ? "0" : "") << hours << ":" <<
-        (minutes < 10 ? "0" : "") << minutes << ":" <<
-        (seconds < 10 ? "0" : "") << seconds;
-    fontManager->UpdateSentence(runTime.sentenceId, textStream.str(), textPixelHeight, runTime.color);
+    int minutes = (int)(currentTime / 60) % 60;
+    int seconds = (int)currentTime % 60;
+
+    // Values < 10 render similar to '00' instead of just '0'
+    snprintf(textBuffer, sizeof(textBuffer), "Running for %02d:%02d:%02d", hours, minutes, seconds);
+    fontManager->UpdateSentence(runTime.sentenceId, textBuffer, textPixelHeight, runTime.color);
 }
 
 
@@ -67,34 +70,42 @@ void Statistics::UpdatePlayerDetails(std::string& playerName)
     // TODO
 }
 
-void Statistics::UpdateViewPos(vec::vec3& position)
+void Statistics::UpdateTextureMemory(size_t textureBytes)
 {
-    std::stringstream textStream;
-    textStream.precision(2);
-    textStream << std::fixed;
-
-    textStream << "X: " << position.x;
-    fontManager->UpdateSentence(xPosition.sentenceId, textStream.str(), textPixelHeight, xPosition.color);
-
-    textStream.str("");
-    textStream << "Y: " << position.y;
-    fontManager->UpdateSentence(yPosition.sentenceId, textStream.str(), textPixelHeight, yPosition.color);
+    snprintf(textBuffer, sizeof(textBuffer), "Textures: %.2f MB", (float)textureBytes / (1024.0f * 1024.0f));
+    fontManager->UpdateSentence(textureMemory.sentenceId, textBuffer, textPixelHeight, textureMemory.color);
+}
 
-    textStream.str("");
-    textStream << "Z: " << position.z;
-    fontManager->UpdateSentence(zPosition.sentenceId, textStream.str(), textPixelHeight, zPosition.color);
+void Statistics::UpdateOverlayAllocations(unsigned long long allocationCount)
+{
+    snprintf(textBuffer, sizeof(textBuffer), "Overlay allocations: %llu", allocationCount);
+    fontManager->UpdateSentence(overlayAllocations.sentenceId, textBuffer, textPixelHeight, overlayAllocations.color);
 }
 
-void Statistics::RenderStats(vec::mat4& perspectiveMatrix)
+void Statistics::UpdateViewPos(const vec::vec3& position)
 {
-    fontManager->RenderSentence(playerCount.sentenceId, perspectiveMatrix, playerCount.posRotMatrix);
-    fontManager->RenderSentence(runTime.sentenceId, perspectiveMatrix, runTime.posRotMatrix);
+    snprintf(textBuffer, sizeof(textBuffer), "X: %.2f", position.x);
+    fontManager->UpdateSentence(xPosition.sentenceId, textBuffer, textPixelHeight, xPosition.color);
 
-    fontManager->RenderSentence(playerName.sentenceId, perspectiveMatrix, playerName.posRotMatrix);
-    fontManager->RenderSentence(playerMinTechLevel.sentenceId, perspectiveMatrix, playerMinTechLevel.posRotMatrix);
-    fontManager->RenderSentence(playerMaxTechLevel.sentenceId, perspectiveMatrix, playerMaxTechLevel.posRotMatrix);
+    snprintf(textBuffer, sizeof(textBuffer), "Y: %.2f", position.y);
+    fontManager->UpdateSentence(yPosition.sentenceId, textBuffer, textPixelHeight, yPosition.color);
 
-    fontManager->RenderSentence(xPosition.sentenceId, perspectiveMatrix, xPosition.posRotMatrix);
-    fontManager->RenderSentence(yPosition.sentenceId, perspectiveMatrix, yPosition.posRotMatrix);
-    fontManager->RenderSentence(zPosition.sentenceId, perspectiveMatrix, zPosition.posRotMatrix);
+    snprintf(textBuffer, sizeof(textBuffer), "Z: %.2f", position.z);
+    fontManager->UpdateSentence(zPosition.sentenceId, textBuffer, textPixelHeight, zPosition.color);
+}
+
+void Statistics::RenderStats()
+{
+    fontManager->RenderSentence(playerCount.sentenceId, playerCount.posRotMatrix);
+    fontManager->RenderSentence(runTime.sentenceId, runTime.posRotMatrix);
+    fontManager->RenderSentence(textureMemory.sentenceId, textureMemory.posRotMatrix);
+    fontManager->RenderSentence(overlayAllocations.sentenceId, overlayAllocations.posRotMatrix);
+
+    fontManager->RenderSentence(playerName.sentenceId, playerName.posRotMatrix);
+    fontManager->RenderSentence(playerMinTechLevel.sentenceId, playerMinTechLevel.posRotMatrix);
+    fontManager->RenderSentence(playerMaxTechLevel.sentenceId, playerMaxTechLevel.posRotMatrix);
+
+    fontManager->RenderSentence(xPosition.sentenceId, xPosition.posRotMatrix);
+    fontManager->RenderSentence(yPosition.sentenceId, yPosition.posRotMatrix);
+    fontManager->RenderSentence(zPosition.sentenceId, zPosition.posRotMatrix);
 }
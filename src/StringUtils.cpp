@@ -21,6 +21,12 @@ bool StringUtils::LoadConfigurationFile(const std::string& filename, std::vector
     StringUtils::Split(entireFile, Newline, false, lines);
     for (unsigned int i = 0; i < lines.size(); i++)
     {
+        // Files have Windows line endings, which are only converted when read on Windows.
+        if (!lines[i].empty() && lines[i].back() == '\r')
+        {
+            lines[i].pop_back();
+        }
+
         std::string commentString = std::string(Comment);
         if (StringUtils::StartsWith(lines[i], commentString))
         {
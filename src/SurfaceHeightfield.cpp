@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cmath>
+#include "SurfaceHeightfield.h"
+
+// Indexes into the voxel plane table. Slants with orientations beyond 3 are flat, like cubes.
+enum VoxelPlaneIndex
+{
+    FLAT = 0,
+    SLANT_DOWN_X = 1,
+    SLANT_DOWN_Y = 2,
+    SLANT_UP_X = 3,
+    SLANT_UP_Y = 4
+};
+
+// Planes on top of each kind of voxel, with the height in voxels. Slants rise a voxel over the width of a voxel.
+static const SurfacePlane VoxelPlanes[] =
+{
+    { 1.0f, 0.0f, 0.0f, vec::vec3(0.0f, 0.0f, 1.0f) },
+    { 1.0f, -1.0f, 0.0f, vec::normalize(vec::vec3(1.0f, 0.0f, 1.0f)) },
+    { 1.0f, 0.0f, -1.0f, vec::normalize(vec::vec3(0.0f, 1.0f, 1.0f)) },
+    { 0.0f, 1.0f, 0.0f, vec::normalize(vec::vec3(-1.0f, 0.0f, 1.0f)) },
+    { 0.0f, 0.0f, 1.0f, vec::normalize(vec::vec3(0.0f, -1.0f, 1.0f)) }
+};
+
+SurfaceHeightfield::SurfaceHeightfield()
+{
+    // A single flat column, so lookups before the first rebuild don't need to check for an empty heightfield.
+    xSize = 1;
+    ySize = 1;
+    columns.assign(1, GetVoxelPlane(MapInfo::VoxelTypes::CUBE, 0));
+    columns[0].height = 0.0f;
+}
+
+void SurfaceHeightfield::Rebuild(const MapInfo& mapInfo)
+{
+    xSize = std::max((int)mapInfo.xSize, 1);
+    ySize = std::max((int)mapInfo.ySize, 1);
+    columns.resize(xSize * ySize);
+    UpdateColumns(mapInfo, 0, 0, xSize - 1, ySize - 1);
+}
+
+void SurfaceHeightfield::UpdateColumns(const MapInfo& mapInfo, int minX, int minY, int maxX, int maxY)
+{
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, std::min((int)mapInfo.xSize, xSize) - 1);
+    maxY = std::min(maxY, std::min((int)mapInfo.ySize, ySize) - 1);
+    for (int y = minY; y <= maxY; y++)
+    {
+        for (int x = minX; x <= maxX; x++)
+        {
+            RebuildColumn(mapInfo, x, y);
+        }
+    }
+}
+
+SurfaceSample SurfaceHeightfield::GetSurface(const vec::vec3& position) const
+{
+    // Clamping before converting to an integer keeps the column on the map, and makes truncation match flooring.
+    float inverseSpacing = 1.0f / MapInfo::SPACING;
+    int x = (int)std::min(std::max(position.x * inverseSpacing, 0.0f), (float)(xSize - 1));
+    int y = (int)std::min(std::max(position.y * inverseSpacing, 0.0f), (float)(ySize - 1));
+    const SurfacePlane& plane = columns[y * xSize + x];
+
+    // Positions off the map stay on the plane at the edge of the nearest column.
+    float xOffset = std::min(std::max(position.x - (float)x * MapInfo::SPACING, 0.0f), MapInfo::SPACING);
+    float yOffset = std::min(std::max(position.y - (float)y * MapInfo::SPACING, 0.0f), MapInfo::SPACING);
+
+    SurfaceSample sample;
+    sample.height = plane.height + plane.xSlope * xOffset + plane.ySlope * yOffset;
+    sample.normal = plane.normal;
+    return sample;
+}
+
+SurfacePlane SurfaceHeightfield::GetVoxelPlane(int type, int orientation)
+{
+    int planeIndex = (type == MapInfo::VoxelTypes::SLANT && orientation >= 0 && orientation <= 3) ? orientation + 1 : FLAT;
+
+    SurfacePlane plane = VoxelPlanes[planeIndex];
+    plane.height *= MapInfo::SPACING;
+    return plane;
+}
+
+void SurfaceHeightfield::RebuildColumn(const MapInfo& mapInfo, int x, int y)
+{
+    SurfacePlane& column = columns[y * xSize + x];
+    for (int z = (int)mapInfo.zSize - 1; z >= 0; z--)
+    {
+        int index = mapInfo.GetIndex(x, y, z);
+        if (mapInfo.blockType[index] != MapInfo::VoxelTypes::AIR)
+        {
+            column = GetVoxelPlane(mapInfo.blockType[index], mapInfo.blockOrientation[index]);
+            column.height += (float)z * MapInfo::SPACING;
+            return;
+        }
+    }
+
+    // Nothing to stand on, so the surface is the bottom of the map.
+    column = GetVoxelPlane(MapInfo::VoxelTypes::CUBE, 0);
+    column.height = 0.0f;
+}
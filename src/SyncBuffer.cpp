@@ -1,4 +1,4 @@
-#include "MatrixOps.h"
+#include <algorithm>
 #include "SyncBuffer.h"
 
 SyncBuffer::SyncBuffer()
@@ -6,6 +6,12 @@ SyncBuffer::SyncBuffer()
     roundMapUpdatedVisuals = false;
     roundMapUpdatedPhysics = false;
     newSelectedVoxel = false;
+    projectileCount = 0;
+
+    visibilityWidth = 0;
+    visibilityHeight = 0;
+    visibilityMinRow = 0;
+    visibilityMaxRow = -1;
 }
 
 // Adds the player to the players in the round.
@@ -29,28 +35,113 @@ void SyncBuffer::UnlockPlayer(unsigned int playerId)
     playerVectorMutex.ReadUnlock();
 }
 
-void SyncBuffer::RenderPlayers(ModelManager& modelManager, RouteVisual& routeVisuals, vec::mat4& projectionMatrix)
+void SyncBuffer::RenderPlayers(ModelManager& modelManager, RouteVisual& routeVisuals, unsigned int hoveredPickId, vec::mat4& projectionMatrix)
 {
     ReadLock readLock(playerVectorMutex);
     for (unsigned int i = 0; i < gameRound.players.size(); i++)
     {
         gameRound.players[i].PerformUnitGuiUpdates(routeVisuals);
-        gameRound.players[i].RenderUnits(modelManager, routeVisuals, projectionMatrix);
+        gameRound.players[i].RenderUnits(modelManager, routeVisuals, hoveredPickId, projectionMatrix);
     }
 }
 
-void SyncBuffer::UpdatePlayers(float lastElapsedTime)
+void SyncBuffer::RenderPlayerPicking(ModelManager& modelManager, vec::mat4& projectionMatrix)
 {
     ReadLock readLock(playerVectorMutex);
-    
-    // Current player receives a technology update.
-    gameRound.players[0].UpdateResearchProgress(lastElapsedTime);
-
-    // Move units.
     for (unsigned int i = 0; i < gameRound.players.size(); i++)
     {
-        gameRound.players[i].MoveUnits();
+        gameRound.players[i].RenderUnitPicking(modelManager, projectionMatrix);
+    }
+}
+
+void SyncBuffer::UpdatePlayers(JobSystem& jobSystem, SpatialHash& unitHash, LocalAvoidance& localAvoidance, const MapSections& mapSections, float lastElapsedTime)
+{
+    ReadLock readLock(playerVectorMutex);
+    gameRound.UpdatePlayers(jobSystem, unitHash, localAvoidance, mapSections, lastElapsedTime);
+}
+
+void SyncBuffer::ResetVisibility(const MapSections& mapSections)
+{
+    ReadLock readLock(playerVectorMutex);
+    gameRound.ResetVisibility(mapSections);
+}
+
+void SyncBuffer::UpdateVisibility(JobSystem& jobSystem, const MapSections& mapSections, float budgetMs)
+{
+    ReadLock readLock(playerVectorMutex);
+    gameRound.UpdateVisibility(jobSystem, mapSections, budgetMs);
+
+    // The local player is player 0. Only rows that changed are copied.
+    if (gameRound.players.size() == 0)
+    {
+        return;
     }
+
+    VisibilityGrid& visibility = gameRound.players[0].GetVisibility();
+    int minRow;
+    int maxRow;
+    if (visibility.TakeChangedRows(&minRow, &maxRow))
+    {
+        WriteLock writeLock(visibilityMutex);
+        if (visibility.GetWidth() != visibilityWidth || visibility.GetHeight() != visibilityHeight)
+        {
+            visibilityWidth = visibility.GetWidth();
+            visibilityHeight = visibility.GetHeight();
+            visibilityTexels.resize(visibilityWidth * visibilityHeight);
+            minRow = 0;
+            maxRow = visibilityHeight - 1;
+        }
+
+        const std::vector<unsigned char>& texels = visibility.GetTexels();
+        std::copy(texels.begin() + minRow * visibilityWidth, texels.begin() + (maxRow + 1) * visibilityWidth, visibilityTexels.begin() + minRow * visibilityWidth);
+        visibilityMinRow = std::min(visibilityMinRow, minRow);
+        visibilityMaxRow = std::max(visibilityMaxRow, maxRow);
+    }
+}
+
+bool SyncBuffer::UpdateVisibilityDisplay(VoxelMap& voxelMap)
+{
+    WriteLock writeLock(visibilityMutex);
+    if (visibilityMinRow > visibilityMaxRow || !voxelMap.UpdateVisibility(visibilityTexels.data(), visibilityWidth, visibilityHeight, visibilityMinRow, visibilityMaxRow))
+    {
+        // Nothing changed, or the voxel map hasn't received the matching map yet, in which case changes are kept for later.
+        return false;
+    }
+
+    visibilityMinRow = visibilityHeight;
+    visibilityMaxRow = -1;
+    return true;
+}
+
+void SyncBuffer::UpdateTurrets(JobSystem& jobSystem, TurretTargeting& turretTargeting, const MapSections& mapSections, const SpatialHash& unitHash, ProjectilePool& projectilePool)
+{
+    ReadLock readLock(playerVectorMutex);
+    gameRound.UpdateTurrets(jobSystem, turretTargeting, mapSections, unitHash, projectilePool);
+}
+
+void SyncBuffer::ResolveCombat(CombatResolver& combatResolver, std::vector<UnitDeath>& unitDeaths)
+{
+    ReadLock readLock(playerVectorMutex);
+    gameRound.ResolveCombat(combatResolver, unitDeaths);
+}
+
+void SyncBuffer::InitializeProjectiles(unsigned int capacity)
+{
+    WriteLock writeLock(projectileMutex);
+    projectileVisualData.resize(capacity);
+    projectileCount = 0;
+}
+
+void SyncBuffer::UpdateProjectiles(const ProjectilePool& projectilePool)
+{
+    WriteLock writeLock(projectileMutex);
+    projectileCount = projectileVisualData.empty() ? 0 : projectilePool.CopyVisualData(&projectileVisualData[0], (unsigned int)projectileVisualData.size());
+}
+
+void SyncBuffer::RenderProjectiles(ProjectileVisual& projectileVisual, const vec::mat4& projectionMatrix)
+{
+    ReadLock readLock(projectileMutex);
+    projectileVisual.Render(projectionMatrix, projectileVisualData, projectileCount);
 }
 
 // Sets the round map.
@@ -85,11 +176,11 @@ bool SyncBuffer::HitByRay(MapSections& mapSections, const vec::vec3& rayStart, c
     return mapSections.HitByRay(&gameRound.map, rayStart, rayVector, voxelId);
 }
 
-void SyncBuffer::RefineRoute(UnitRouter& unitRouter, const voxelSubsectionsMap& voxelSubsections, const vec::vec3i start, const vec::vec3i destination,
+void SyncBuffer::RefineRoute(UnitRouter& unitRouter, const voxelSubsectionsMap& voxelSubsections, const SurfaceHeightfield& surface, const vec::vec3i start, const vec::vec3i destination,
     const std::vector<vec::vec3i>& givenPath, std::vector<vec::vec3i>& refinedPath, std::vector<vec::vec3>& visualPath)
 {
     ReadLock readLock(mapUpdateMutex);
-    return unitRouter.RefineRoute(&gameRound.map, voxelSubsections, start, destination, givenPath, refinedPath, visualPath);
+    return unitRouter.RefineRoute(&gameRound.map, voxelSubsections, surface, start, destination, givenPath, refinedPath, visualPath);
 }
 
 // Updates the round map display. Returns true if an update was performed.
@@ -109,11 +200,11 @@ bool SyncBuffer::UpdateRoundMapDisplay(VoxelMap& voxelMap)
     return false;
 }
 
-// Updates the view matrix given the viewer position and rotation.
-void SyncBuffer::UpdateViewMatrix(const vec::vec3& position, const vec::quaternion& rotation)
+// Updates the view matrix, as computed by the physics thread's camera.
+void SyncBuffer::UpdateViewMatrix(const vec::mat4& viewMatrix)
 {
     WriteLock writeLock(viewMatrixMutex);
-    viewMatrix = rotation.asMatrix() * MatrixOps::Translate(-position);
+    this->viewMatrix = viewMatrix;
 }
 
 // Retrives a copy of the current view matrix.
@@ -5,7 +5,6 @@
 #include "StringUtils.h"
 
 std::vector<Tech> TechConfig::Techs;
-sf::Image TechConfig::NoCurrentTechImage;
 
 bool TechConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
 {
@@ -41,15 +40,7 @@ bool TechConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
             return false;
         }
 
-        std::stringstream imageName;
-        imageName << "images/techs/" << resources[0] << ".png";
         tech.internalName = resources[0];
-        if (!tech.techImage.loadFromFile(imageName.str()))
-        {
-            Logger::LogError("Error reading in the image for the technology.");
-            return false;
-        }
-
         if (!StringUtils::ParseIntFromString(resources[1], tech.researchTimeSeconds) ||
             !StringUtils::ParseFloatFromString(resources[2], tech.researchResources))
         {
@@ -96,14 +87,6 @@ bool TechConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
 
     CombineIdenticalTechs();
     AssignTechLevels();
-
-    // Load the 'NoCurrentTech' image.
-    if (!NoCurrentTechImage.loadFromFile("images/techs/NoCurrentTechImage.png"))
-    {
-        Logger::LogError("Error reading in the image for when a technology has not been selected!");
-        return false;
-    }
-
     return true;
 }
 
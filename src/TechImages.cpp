@@ -0,0 +1,32 @@
+#include <sstream>
+#include "Logger.h"
+#include "TechConfig.h"
+#include "TechImages.h"
+
+std::vector<sf::Image> TechImages::Images;
+sf::Image TechImages::NoCurrentTechImage;
+
+bool TechImages::LoadImages()
+{
+    Images.clear();
+    Images.resize(TechConfig::Techs.size());
+    for (unsigned int i = 0; i < TechConfig::Techs.size(); i++)
+    {
+        std::stringstream imageName;
+        imageName << "images/techs/" << TechConfig::Techs[i].internalName << ".png";
+        if (!Images[i].loadFromFile(imageName.str()))
+        {
+            Logger::LogError("Error reading in the image for the technology \"", TechConfig::Techs[i].internalName, "\".");
+            return false;
+        }
+    }
+
+    // Load the 'NoCurrentTech' image.
+    if (!NoCurrentTechImage.loadFromFile("images/techs/NoCurrentTechImage.png"))
+    {
+        Logger::LogError("Error reading in the image for when a technology has not been selected!");
+        return false;
+    }
+
+    return true;
+}
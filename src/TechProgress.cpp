@@ -1,3 +1,4 @@
+#include <cstring>
 #include <limits>
 #include "Logger.h"
 #include "TechConfig.h"
@@ -1,5 +1,6 @@
 #include <sstream>
 #include "TechConfig.h"
+#include "TechImages.h"
 #include "TechProgressWindow.h"
 
 TechProgressWindow::TechProgressWindow()
@@ -14,7 +15,7 @@ bool TechProgressWindow::Setup()
     window->SetPosition(sf::Vector2f(10.0f, 20.0f));
 
     techName = sfg::Label::Create(NoCurrentResearch);
-    techImage = sfg::Image::Create(TechConfig::NoCurrentTechImage);
+    techImage = sfg::Image::Create(TechImages::NoCurrentTechImage);
 
     researchProgress = sfg::ProgressBar::Create(sfg::ProgressBar::Orientation::HORIZONTAL);
     
@@ -62,7 +63,7 @@ void TechProgressWindow::SetToNoResearch()
 {
     lastKnownTech = -1;
     techName->SetText(NoCurrentResearch);
-    techImage->SetImage(TechConfig::NoCurrentTechImage);
+    techImage->SetImage(TechImages::NoCurrentTechImage);
     researchProgress->SetFraction(0.10f);
     researchProgressText->SetText(NoCurrentEta);
 }
@@ -71,7 +72,7 @@ void TechProgressWindow::SetToResearch(unsigned int currentTech)
 {
     lastKnownTech = currentTech;
     techName->SetText(TechConfig::Techs[currentTech].names[0]);
-    techImage->SetImage(TechConfig::Techs[currentTech].techImage);
+    techImage->SetImage(TechImages::Images[currentTech]);
     researchProgress->SetFraction(0.0f);
     researchProgressText->SetText(NoCurrentEta);
 }
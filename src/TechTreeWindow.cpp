@@ -1,6 +1,7 @@
 #include <sstream>
 #include "Logger.h"
 #include "TechConfig.h"
+#include "TechImages.h"
 #include "TechTreeWindow.h"
 
 TechTreeWindow::TechTreeWindow()
@@ -55,7 +56,7 @@ void TechTreeWindow::LoadTechTilesAndFillTechLevels()
     for (unsigned int i = 0; i < TechConfig::Techs.size(); i++)
     {
         TechTile techTile;
-        techTile.image = sfg::Image::Create(TechConfig::Techs[i].techImage);
+        techTile.image = sfg::Image::Create(TechImages::Images[i]);
 
         techTile.frame = sfg::Frame::Create(GetFullTechName(TechConfig::Techs[i]));
         techTile.frame->SetRequisition(sf::Vector2f(120.0f, 120.0f));
@@ -1,3 +1,4 @@
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -6,6 +7,9 @@
 #include <SFML/OpenGL.hpp>
 #include <SFML/Graphics.hpp>
 // #include <vld.h> // Enable for memory debugging.
+#include "AllocationCounter.h"
+#include "AssetLoader.h"
+#include "JobSystem.h"
 #include "Logger.h"
 #include "TemperFine.h"
 #include "../version.h"
@@ -40,6 +44,8 @@ TemperFine::TemperFine()
       armorConfig(&modelManager, "config/armors.txt"), bodyConfig(&modelManager, "config/bodies.txt"), turretConfig(&modelManager, "config/turrets.txt"),
       physics(), scenery(&modelManager), physicsThread(&Physics::Run, &physics)
 {
+    isLeftMouseDown = false;
+    overlayAllocations = 0;
 }
 
 void TemperFine::LogGraphicsSettings()
@@ -108,6 +114,13 @@ Constants::Status TemperFine::Initialize()
         return Constants::Status::BAD_CONFIG;
     }
 
+    Logger::Log("Loading technology images...");
+    if (!TechImages::LoadImages())
+    {
+        Logger::Log("Bad technology images!");
+        return Constants::Status::BAD_IMAGES;
+    }
+
     Logger::Log("Configuration loaded!");
     return Constants::Status::OK;
 }
@@ -159,23 +172,92 @@ Constants::Status TemperFine::LoadGraphics(sfg::Desktop* desktop)
 
 Constants::Status TemperFine::LoadAssets(sfg::Desktop* desktop)
 {
-    // Game Data configuration files.
+    // File reads, image decoding and model parsing run on worker threads while this thread compiles shaders,
+    //  with the decoded textures and models sent to OpenGL by this thread once each is ready.
+    AssetLoader assetLoader;
+    assetLoader.Initialize(JobSystem::DefaultWorkerCount());
+    modelManager.BeginQueuedLoading(&assetLoader);
+
+    // Queued model loads run on the asset loader's workers and refer to the model manager, so the workers are stopped
+    //  before queued loading ends, whether or not every stage succeeded.
+    Constants::Status status = LoadQueuedAssets(assetLoader);
+    assetLoader.Cancel();
+    modelManager.EndQueuedLoading();
+    if (status != Constants::Status::OK)
+    {
+        return status;
+    }
+
+    // TODO we start at a menu, not inside a game. This can be called from the physics thread!
+    physicsSyncBuffer.SetRoundMap(testMap);
+
+    // Load the current player, who is always the first element in the players list. TODO name should be from config.
+    physicsSyncBuffer.AddPlayer("Default Player");
+
+    // Now that *all* the models have loaded, prepare for rendering models by initializing OpenGL and sending the model data to OpenGL
+    Logger::Log("Sending model VAO to OpenGL...");
+    if (!assetLoader.RunStage("Model buffers", [this]() { return modelManager.InitializeOpenGlResources(shaderManager); }))
+    {
+        return Constants::Status::BAD_SHADERS;
+    }
+
+    assetLoader.RunStage("Model buffers", [this]() { modelManager.ResetOpenGlModelData(); return true; });
+    assetLoader.LogStageTimes();
+
+    Logger::Log("Textures use ", imageManager.GetTextureMemory() / 1024, " kB of GPU memory.");
+    statistics.UpdateTextureMemory(imageManager.GetTextureMemory());
+
+    // UI
+    if (!techTreeWindow.Initialize(desktop))
+    {
+        return Constants::Status::BAD_UI;
+    }
+    else if (!techProgressWindow.Initialize(desktop))
+    {
+        return Constants::Status::BAD_UI;
+    }
+    else if (!resourcesWindow.Initialize(desktop))
+    {
+        return Constants::Status::BAD_UI;
+    }
+    else if (!buildingsWindow.Initialize(desktop))
+    {
+        return Constants::Status::BAD_UI;
+    }
+    else if (!escapeConfigWindow.Initialize(desktop))
+    {
+        return Constants::Status::BAD_UI;
+    }
+
+    // Physics
+    Logger::Log("Physics loading...");
+    physics.Initialize(&physicsSyncBuffer);
+
+    physicsThread.launch();
+    Logger::Log("Physics Thread Started!");
+
+    return Constants::Status::OK;
+}
+
+Constants::Status TemperFine::LoadQueuedAssets(AssetLoader& assetLoader)
+{
+    // Game Data configuration files. Unit models are queued as the configs are read.
     Logger::Log("Loading armor config file...");
-    if (!armorConfig.ReadConfiguration())
+    if (!assetLoader.RunStage("Armor config", [this]() { return armorConfig.ReadConfiguration(); }))
     {
         Logger::Log("Bad armor config file!");
         return Constants::Status::BAD_CONFIG;
     }
 
     Logger::Log("Loading body config file...");
-    if (!bodyConfig.ReadConfiguration())
+    if (!assetLoader.RunStage("Body config", [this]() { return bodyConfig.ReadConfiguration(); }))
     {
         Logger::Log("Bad body config file!");
         return Constants::Status::BAD_CONFIG;
     }
 
     Logger::Log("Loading turret config file...");
-    if (!turretConfig.ReadConfiguration())
+    if (!assetLoader.RunStage("Turret config", [this]() { return turretConfig.ReadConfiguration(); }))
     {
         Logger::Log("Bad turret config file!");
         return Constants::Status::BAD_CONFIG;
@@ -183,17 +265,17 @@ Constants::Status TemperFine::LoadAssets(sfg::Desktop* desktop)
 
     // Scenery
     Logger::Log("Scenery loading...");
-    if (!scenery.Initialize(shaderManager))
+    if (!assetLoader.RunStage("Scenery shader", [&]() { return scenery.Initialize(shaderManager, assetLoader); }))
     {
         Logger::Log("Bad scenery");
         return Constants::Status::BAD_SCENERY;
     }
 
-    Logger::Log("Scenery loading done!");
+    Logger::Log("Scenery loading queued!");
 
     // Unit router and  visualization
     Logger::Log("Unit router and visualizer loading...");
-    if (!routeVisuals.Initialize(shaderManager))
+    if (!assetLoader.RunStage("Route visuals", [this]() { return routeVisuals.Initialize(shaderManager); }))
     {
         Logger::Log("Bad unit router!");
         return Constants::Status::BAD_ROUTER;
@@ -201,9 +283,19 @@ Constants::Status TemperFine::LoadAssets(sfg::Desktop* desktop)
 
     Logger::Log("Unit router and visualizer loaded!");
 
+    // Projectile visualization
+    Logger::Log("Projectile visualizer loading...");
+    if (!assetLoader.RunStage("Projectile visuals", [this]() { return projectileVisual.Initialize(shaderManager, PhysicsConfig::MaxProjectiles); }))
+    {
+        Logger::Log("Bad projectile visualizer!");
+        return Constants::Status::BAD_SHADERS;
+    }
+
+    Logger::Log("Projectile visualizer loaded!");
+
     // Fonts
     Logger::Log("Font loading...");
-    if (!fontManager.LoadFont(&shaderManager, "fonts/DejaVuSans.ttf"))
+    if (!assetLoader.RunStage("Font", [this]() { return fontManager.LoadFont(&shaderManager, "fonts/DejaVuSans.ttf"); }))
     {
         return Constants::Status::BAD_FONT;
     }
@@ -212,70 +304,47 @@ Constants::Status TemperFine::LoadAssets(sfg::Desktop* desktop)
 
     // Statistics
     Logger::Log("Statistics loading...");
-    if (!statistics.Initialize(&fontManager))
+    if (!assetLoader.RunStage("Statistics", [this]() { return statistics.Initialize(&fontManager); }))
     {
         return Constants::Status::BAD_STATS;
     }
 
-    // Voxel Map
+    // Voxel Map. It is combined on this thread once only its own textures and models have loaded.
     Logger::Log("Voxel map loading...");
-    if (!voxelMap.Initialize(imageManager, modelManager, shaderManager))
+    if (!assetLoader.RunStage("Voxel map shader", [&]() { return voxelMap.Initialize(modelManager, shaderManager, assetLoader); }))
     {
         return Constants::Status::BAD_VOXEL_MAP;
     }
 
-    // TODO this should be some menu code, once the UI bugs are fixed.
-    Logger::Log("Loading maps...");
-    if (!mapManager.ReadMap("maps/test.txt", testMap))
+    if (GraphicsConfig::HoverPicking)
     {
-        Logger::Log("Bad test map!");
-        return Constants::Status::BAD_MAP;
+        Logger::Log("Picking buffer loading...");
+        if (!assetLoader.RunStage("Picking buffer", [this]() { return pickingBuffer.Initialize(); }))
+        {
+            return Constants::Status::BAD_PICKING;
+        }
     }
 
-    // TODO we start at a menu, not inside a game. This can be called from the physics thread!
-    physicsSyncBuffer.SetRoundMap(testMap);
-
-    // Load the current player, who is always the first element in the players list. TODO name should be from config.
-    physicsSyncBuffer.AddPlayer("Default Player");
-
-    // Now that *all* the models have loaded, prepare for rendering models by initializing OpenGL and sending the model data to OpenGL
-    Logger::Log("Sending model VAO to OpenGL...");
-    if (!modelManager.InitializeOpenGlResources(shaderManager))
+    // TODO this should be some menu code, once the UI bugs are fixed.
+    Logger::Log("Loading maps...");
+    assetLoader.AddWorkTask("Test map", [this](unsigned int)
     {
-        return Constants::Status::BAD_SHADERS;
-    }
+        if (!mapManager.ReadMap("maps/test.txt", testMap))
+        {
+            Logger::Log("Bad test map!");
+            return false;
+        }
 
-    modelManager.ResetOpenGlModelData();
+        return true;
+    }, std::vector<AssetTaskId>());
 
-    // UI
-    if (!techTreeWindow.Initialize(desktop))
-    {
-        return Constants::Status::BAD_UI;
-    }
-    else if (!techProgressWindow.Initialize(desktop))
-    {
-        return Constants::Status::BAD_UI;
-    }
-    else if (!resourcesWindow.Initialize(desktop))
-    {
-        return Constants::Status::BAD_UI;
-    }
-    else if (!buildingsWindow.Initialize(desktop))
-    {
-        return Constants::Status::BAD_UI;
-    }
-    else if (!escapeConfigWindow.Initialize(desktop))
+    Logger::Log("Waiting for queued assets...");
+    if (!assetLoader.Finish())
     {
-        return Constants::Status::BAD_UI;
+        assetLoader.LogStageTimes();
+        return Constants::Status::BAD_ASSETS;
     }
 
-    // Physics
-    Logger::Log("Physics loading...");
-    physics.Initialize(&physicsSyncBuffer);
-
-    physicsThread.launch();
-    Logger::Log("Physics Thread Started!");
-
     return Constants::Status::OK;
 }
 
@@ -294,6 +363,9 @@ void TemperFine::PerformGuiThreadUpdates(float currentGameTime)
         Logger::Log("Voxel Map Display updated!");
     }
 
+    // Update the fog of war from what the player can now see.
+    physicsSyncBuffer.UpdateVisibilityDisplay(voxelMap);
+
     // Update the progress of the current research and stored resources
     int currentlyResearchingTech;
     float currentTechProgress = 0.0f;
@@ -307,9 +379,13 @@ void TemperFine::PerformGuiThreadUpdates(float currentGameTime)
     techProgressWindow.UpdateResearchProgress(currentlyResearchingTech, currentTechProgress);
     resourcesWindow.UpdateStoredResources(researchAmount, fuelAmount);
 
-    // Update useful statistics that are fancier than the standard GUI
+    // Update useful statistics that are fancier than the standard GUI. These should only allocate when their text changes.
+    vec::vec3 viewerPosition = physicsSyncBuffer.GetViewerPosition();
+    unsigned long long startAllocations = AllocationCounter::GetThreadAllocations();
+    statistics.UpdateOverlayAllocations(overlayAllocations);
     statistics.UpdateRunTime(currentGameTime);
-    statistics.UpdateViewPos(physicsSyncBuffer.GetViewerPosition());
+    statistics.UpdateViewPos(viewerPosition);
+    overlayAllocations = AllocationCounter::GetThreadAllocations() - startAllocations;
 }
 
 void TemperFine::HandleEvents(sfg::Desktop& desktop, sf::RenderWindow& window, bool& alive, bool& focusPaused, bool& escapePaused)
@@ -369,7 +445,26 @@ void TemperFine::HandleEvents(sfg::Desktop& desktop, sf::RenderWindow& window, b
                 !buildingsWindow.WithinVisibleBounds(event.mouseButton.x, event.mouseButton.y) &&
                 !escapeConfigWindow.WithinVisibleBounds(event.mouseButton.x, event.mouseButton.y))
             {
-                physics.QueueLeftMouseClick(event.mouseButton.x, event.mouseButton.y, window.getSize().x, window.getSize().y);
+                isLeftMouseDown = true;
+                leftMouseDownPosition = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+            }
+        }
+        else if (event.type == sf::Event::MouseButtonReleased)
+        {
+            if (event.mouseButton.button == sf::Mouse::Left && isLeftMouseDown)
+            {
+                // Moving far enough while the button is held turns the click into a drag-box selection.
+                isLeftMouseDown = false;
+                if (std::abs(event.mouseButton.x - leftMouseDownPosition.x) >= Constants::DRAG_SELECT_THRESHOLD ||
+                    std::abs(event.mouseButton.y - leftMouseDownPosition.y) >= Constants::DRAG_SELECT_THRESHOLD)
+                {
+                    physics.QueueDragSelect(leftMouseDownPosition.x, leftMouseDownPosition.y, event.mouseButton.x, event.mouseButton.y,
+                        window.getSize().x, window.getSize().y);
+                }
+                else
+                {
+                    physics.QueueLeftMouseClick(leftMouseDownPosition.x, leftMouseDownPosition.y, window.getSize().x, window.getSize().y);
+                }
             }
         }
     }
@@ -425,14 +520,45 @@ void TemperFine::Render(sfg::Desktop& desktop, sf::RenderWindow& window, vec::ma
     scenery.Render(viewMatrix, projectionMatrix);
 
     // Renders each players' units.
-    physicsSyncBuffer.RenderPlayers(modelManager, routeVisuals, projectionMatrix);
+    physicsSyncBuffer.RenderPlayers(modelManager, routeVisuals, pickingBuffer.GetHoveredId(), projectionMatrix);
+
+    // Renders all the projectiles in flight.
+    physicsSyncBuffer.RenderProjectiles(projectileVisual, projectionMatrix);
 
     // Renders the voxel map
     // TODO needs a semaphore to prevent inadvertent updates.
     voxelMap.Render(projectionMatrix);
 
-    // Renders the statistics. Note that this just takes the perspective matrix, not accounting for the viewer position.
-    statistics.RenderStats(Constants::PerspectiveMatrix);
+    // Renders the statistics, and any other text, in one batch. Note that this just takes the perspective matrix, not accounting for the viewer position.
+    unsigned long long startAllocations = AllocationCounter::GetThreadAllocations();
+    statistics.RenderStats();
+    fontManager.RenderSentences(Constants::PerspectiveMatrix);
+    overlayAllocations += AllocationCounter::GetThreadAllocations() - startAllocations;
+
+    if (GraphicsConfig::HoverPicking)
+    {
+        RenderPicking(window, viewMatrix);
+    }
+}
+
+void TemperFine::RenderPicking(sf::RenderWindow& window, vec::mat4& viewMatrix)
+{
+    // The id read back this frame is used for highlighting next frame, so the highlight lags the cursor by a frame or two.
+    sf::Vector2i mousePosition = sf::Mouse::getPosition(window);
+    int screenWidth = (int)window.getSize().x;
+    int screenHeight = (int)window.getSize().y;
+
+    vec::mat4 pickMatrix;
+    if (pickingBuffer.Begin(mousePosition.x, mousePosition.y, screenWidth, screenHeight, &pickMatrix))
+    {
+        vec::mat4 pickProjectionMatrix = pickMatrix * Constants::PerspectiveMatrix * viewMatrix;
+        voxelMap.Render(pickProjectionMatrix);
+        physicsSyncBuffer.RenderPlayerPicking(modelManager, pickProjectionMatrix);
+        pickingBuffer.End(screenWidth, screenHeight);
+    }
+
+    unsigned int hoveredId = pickingBuffer.GetHoveredId();
+    voxelMap.SetHoveredVoxel(PickingBuffer::IsVoxelPickId(hoveredId) ? PickingBuffer::GetVoxelIndex(hoveredId) : -1);
 }
 
 Constants::Status TemperFine::Run()
@@ -501,6 +627,9 @@ void TemperFine::Deinitialize()
     // TODO Test code remove.
     mapManager.ClearMap(testMap);
 
+    // Logged on the way out, as the atlas fills up (and evicts) while the game is played.
+    fontManager.LogAtlasUsage();
+
     Logger::Log("Music Thread Stopping...");
     //musicManager.Stop();
 
@@ -1,5 +1,6 @@
 #include <sstream>
 #include "Logger.h"
+#include "MathOps.h"
 #include "TurretConfig.h"
 #include "StringUtils.h"
 
@@ -10,7 +11,7 @@ bool TurretConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
     // Move from the ConfigVersion line to actual data.
     ++lineCounter;
 
-    int linesPerTurret = 2;
+    int linesPerTurret = 3;
     while (lineCounter + linesPerTurret <= (int)configFileLines.size())
     {
         // Load in the turret name.
@@ -43,10 +44,43 @@ bool TurretConfig::LoadConfigValues(std::vector<std::string>& configFileLines)
             return false;
         }
 
+        // Load in how the turret targets and fires.
+        std::vector<std::string> targetingLines;
+        StringUtils::Split(configFileLines[lineCounter + 2], StringUtils::Space, true, targetingLines);
+        if (targetingLines.size() != 6)
+        {
+            Logger::LogError("Expected 6 elements for a turret targeting configuration line.");
+            return false;
+        }
+
+        float slewRateDegrees;
+        int reloadTicks;
+        int damageType;
+        if (!StringUtils::ParseFloatFromString(targetingLines[0], turretType.range) ||
+            !StringUtils::ParseFloatFromString(targetingLines[1], slewRateDegrees) ||
+            !StringUtils::ParseIntFromString(targetingLines[2], reloadTicks) ||
+            !StringUtils::ParseIntFromString(targetingLines[3], damageType) ||
+            !StringUtils::ParseFloatFromString(targetingLines[4], turretType.damage) ||
+            !StringUtils::ParseFloatFromString(targetingLines[5], turretType.projectileSpeed))
+        {
+            Logger::LogError("Error parsing the turret targeting details.");
+            return false;
+        }
+
+        if (reloadTicks < 0 || damageType < MACHINE_GUN || damageType > CANNON || turretType.projectileSpeed <= 0.0f)
+        {
+            Logger::LogError("Turret reload ticks, damage type, or projectile speed is out of range.");
+            return false;
+        }
+
+        turretType.slewRate = MathOps::Radians(slewRateDegrees);
+        turretType.reloadTicks = (unsigned int)reloadTicks;
+        turretType.damageType = (DamageType)damageType;
+
         // Finally, given the model name, load in the turret model.
         std::stringstream turretFileName;
         turretFileName << "models/turrets/" << modelLines[0];
-        turretType.turretModelId = modelManager->LoadModel(turretFileName.str().c_str());
+        turretType.turretModelId = modelLoader->LoadModel(turretFileName.str().c_str());
         if (turretType.turretModelId == 0)
         {
             Logger::Log("Turret model loading failed!");
@@ -66,7 +100,7 @@ void TurretConfig::WriteConfigValues()
 	// Cannot write to unit-type configuration files.
 }
 
-TurretConfig::TurretConfig(ModelManager *modelManager, const char* configName)
-	: ConfigManager(configName), modelManager(modelManager)
+TurretConfig::TurretConfig(ModelLoader* modelLoader, const char* configName)
+	: ConfigManager(configName), modelLoader(modelLoader)
 {
 }
@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <cmath>
+#include "VecOps.h"
+#include "TurretTargeting.h"
+
+float TurretTargeting::AimTolerance = 0.05f;
+
+static const float Epsilon = 0.00001f;
+static const float Pi = 3.14159265f;
+
+// Rotates the vector the same way as the quaternion's rotation matrix, so turrets aim the way they are rendered.
+// Rotating by a product of quaternions applies the leftmost rotation first.
+static vec::vec3 Rotate(const vec::quaternion& rotation, const vec::vec3& vector)
+{
+    vec::quaternion result = rotation.conjugate() * (vec::quaternion(vector.x, vector.y, vector.z, 0.0f) * rotation);
+    return vec::vec3(result.x, result.y, result.z);
+}
+
+// Undoes Rotate.
+static vec::vec3 InverseRotate(const vec::quaternion& rotation, const vec::vec3& vector)
+{
+    return Rotate(rotation.conjugate(), vector);
+}
+
+// Removes the part of the vector along the (unit) axis.
+static vec::vec3 ProjectOntoPlane(const vec::vec3& vector, const vec::vec3& axis)
+{
+    return vector - axis * VecOps::Dot(vector, axis);
+}
+
+// Turrets turn about whichever axis of the turret points up in the world, measuring their yaw from the forward (x) axis.
+static void GetTurretAxes(const vec::quaternion& turretFrame, vec::vec3* up, vec::vec3* forward)
+{
+    *up = vec::normalize(InverseRotate(turretFrame, vec::vec3(0.0f, 0.0f, 1.0f)));
+
+    *forward = ProjectOntoPlane(vec::vec3(1.0f, 0.0f, 0.0f), *up);
+    if (vec::length(*forward) < Epsilon)
+    {
+        // The turret points straight up, so measure from the y axis instead.
+        *forward = ProjectOntoPlane(vec::vec3(0.0f, 1.0f, 0.0f), *up);
+    }
+
+    *forward = vec::normalize(*forward);
+}
+
+// Wraps an angle into [-pi, pi].
+static float WrapAngle(float angle)
+{
+    while (angle > Pi)
+    {
+        angle -= 2.0f * Pi;
+    }
+
+    while (angle < -Pi)
+    {
+        angle += 2.0f * Pi;
+    }
+
+    return angle;
+}
+
+TurretTargeting::TurretTargeting()
+    : scanInterval(1), currentSlot(0), scanCount(0)
+{
+}
+
+void TurretTargeting::Initialize(unsigned int scanInterval)
+{
+    this->scanInterval = std::max(scanInterval, 1u);
+    currentSlot = 0;
+    scanCount = 0;
+}
+
+void TurretTargeting::BeginTick()
+{
+    currentSlot = (currentSlot + 1) % scanInterval;
+    scanCount = 0;
+}
+
+bool TurretTargeting::IsScanTick(unsigned int playerId, unsigned int unitId, unsigned int turretIndex) const
+{
+    // Consecutive units land in consecutive slots, so turrets are spread evenly over the interval.
+    return (playerId + unitId + turretIndex) % scanInterval == currentSlot;
+}
+
+unsigned int TurretTargeting::GetScanCount() const
+{
+    return scanCount;
+}
+
+void TurretTargeting::ResetTurret(Turret& turret)
+{
+    turret.currentTranslation = vec::vec3(0.0f, 0.0f, 0.0f);
+    turret.currentRotation = vec::quaternion::fromAxisAngle(0.0f, vec::vec3(1, 0, 0));
+    turret.currentYaw = 0.0f;
+    turret.hasTarget = false;
+    turret.targetPlayerId = 0;
+    turret.targetUnitId = 0;
+    turret.targetPosition = vec::vec3(0.0f, 0.0f, 0.0f);
+    turret.isAimed = false;
+    turret.remainingReloadTicks = 0;
+}
+
+void TurretTargeting::UpdateTurret(Turret& turret, const TurretType& turretType, unsigned int playerId, unsigned int unitId, unsigned int turretIndex,
+    const vec::vec3& bodyPosition, const vec::quaternion& bodyRotation, const MapSections& mapSections, const SpatialHash& unitHash,
+    const VisibilityGrid* visibility, SearchBuffers& searchBuffers)
+{
+    if (turret.remainingReloadTicks > 0)
+    {
+        --turret.remainingReloadTicks;
+    }
+
+    vec::vec3 turretPosition = GetTurretPosition(turret, turretType, bodyPosition);
+    if (IsScanTick(playerId, unitId, turretIndex))
+    {
+        ++scanCount;
+        if (!AcquireTarget(turret, turretType, playerId, turretPosition, mapSections, unitHash, visibility, searchBuffers))
+        {
+            turret.hasTarget = false;
+        }
+    }
+    else if (turret.hasTarget)
+    {
+        // Follow the target between scans, dropping it if it's destroyed or leaves range. Line of sight is rechecked on the next scan.
+        SpatialHashEntry target;
+        if (unitHash.GetEntry(turret.targetPlayerId, turret.targetUnitId, &target) &&
+            vec::length(target.position - turretPosition) <= turretType.range + target.radius)
+        {
+            turret.targetPosition = target.position;
+        }
+        else
+        {
+            turret.hasTarget = false;
+        }
+    }
+
+    turret.isAimed = false;
+    if (!turret.hasTarget)
+    {
+        return;
+    }
+
+    // Rendering rotates the turret by its current rotation, then its rotation offset, then the body rotation.
+    vec::quaternion turretFrame = turretType.rotationOffset * bodyRotation;
+    vec::vec3 up;
+    vec::vec3 forward;
+    GetTurretAxes(turretFrame, &up, &forward);
+
+    vec::vec3 targetDirection = ProjectOntoPlane(InverseRotate(turretFrame, turret.targetPosition - turretPosition), up);
+    if (vec::length(targetDirection) < Epsilon)
+    {
+        // The target is directly above or below, so any heading works.
+        turret.isAimed = true;
+        return;
+    }
+
+    // Turn towards the target, no faster than the slew rate.
+    float targetYaw = std::atan2(VecOps::Dot(VecOps::Cross(forward, targetDirection), up), VecOps::Dot(forward, targetDirection));
+    float yawChange = WrapAngle(targetYaw - turret.currentYaw);
+    yawChange = std::min(std::max(yawChange, -turretType.slewRate), turretType.slewRate);
+
+    turret.currentYaw = WrapAngle(turret.currentYaw + yawChange);
+    turret.currentRotation = vec::quaternion::fromAxisAngle(-turret.currentYaw, up);
+    turret.isAimed = std::abs(WrapAngle(targetYaw - turret.currentYaw)) <= AimTolerance;
+}
+
+bool TurretTargeting::FireTurret(Turret& turret, const TurretType& turretType, unsigned int playerId,
+    const vec::vec3& bodyPosition, const vec::quaternion& bodyRotation, ProjectilePool& projectilePool)
+{
+    if (!turret.hasTarget || !turret.isAimed || turret.remainingReloadTicks > 0)
+    {
+        return false;
+    }
+
+    vec::vec3 turretPosition = GetTurretPosition(turret, turretType, bodyPosition);
+    vec::vec3 heading = Rotate(turret.currentRotation * turretType.rotationOffset * bodyRotation, vec::vec3(1.0f, 0.0f, 0.0f));
+    vec::vec3 flatHeading = vec::vec3(heading.x, heading.y, 0.0f);
+    if (vec::length(flatHeading) < Epsilon)
+    {
+        return false;
+    }
+
+    vec::vec3 targetOffset = turret.targetPosition - turretPosition;
+    float targetDistance = std::sqrt(targetOffset.x * targetOffset.x + targetOffset.y * targetOffset.y);
+
+    // Projectiles fall by gravity * n * (n + 1) / 2 over n ticks, so lift the shot to land at the target's height after reaching its distance.
+    float flightTicks = std::max(targetDistance / turretType.projectileSpeed, 1.0f);
+    float verticalSpeed = (targetOffset.z + ProjectilePool::Gravity * flightTicks * (flightTicks + 1.0f) * 0.5f) / flightTicks;
+
+    vec::vec3 velocity = vec::normalize(flatHeading) * turretType.projectileSpeed + vec::vec3(0.0f, 0.0f, verticalSpeed);
+    unsigned int lifetimeTicks = (unsigned int)(2.0f * turretType.range / turretType.projectileSpeed) + 1;
+    if (!projectilePool.Fire(playerId, turretPosition, velocity, turretType.damageType, turretType.damage, lifetimeTicks))
+    {
+        return false;
+    }
+
+    turret.remainingReloadTicks = turretType.reloadTicks;
+    return true;
+}
+
+vec::vec3 TurretTargeting::GetTurretPosition(const Turret& turret, const TurretType& turretType, const vec::vec3& bodyPosition)
+{
+    // Matches rendering, where the turret offset is applied in world space.
+    return bodyPosition + turretType.translationOffset + turret.currentTranslation;
+}
+
+bool TurretTargeting::HasLineOfSight(const MapSections& mapSections, const vec::vec3& start, const vec::vec3& end)
+{
+    float hitFactor;
+    return !mapSections.TraceSegment(start, end, &hitFactor);
+}
+
+bool TurretTargeting::AcquireTarget(Turret& turret, const TurretType& turretType, unsigned int playerId, const vec::vec3& turretPosition,
+    const MapSections& mapSections, const SpatialHash& unitHash, const VisibilityGrid* visibility, SearchBuffers& searchBuffers)
+{
+    unitHash.RadiusQuery(turretPosition, turretType.range, searchBuffers.nearbyUnits);
+
+    // Sort the enemies the player can see by distance, breaking ties by query order so the result is deterministic.
+    searchBuffers.candidates.clear();
+    for (unsigned int i = 0; i < searchBuffers.nearbyUnits.size(); i++)
+    {
+        const SpatialHashEntry& nearbyUnit = searchBuffers.nearbyUnits[i];
+        if (nearbyUnit.playerId != playerId && (visibility == nullptr || visibility->IsVisible(nearbyUnit.position)))
+        {
+            vec::vec3 offset = nearbyUnit.position - turretPosition;
+            searchBuffers.candidates.push_back(std::make_pair(VecOps::Dot(offset, offset), i));
+        }
+    }
+
+    unsigned int checkCount = std::min((unsigned int)searchBuffers.candidates.size(), (unsigned int)MaxLineOfSightChecks);
+    std::partial_sort(searchBuffers.candidates.begin(), searchBuffers.candidates.begin() + checkCount, searchBuffers.candidates.end());
+    for (unsigned int i = 0; i < checkCount; i++)
+    {
+        const SpatialHashEntry& candidate = searchBuffers.nearbyUnits[searchBuffers.candidates[i].second];
+        if (HasLineOfSight(mapSections, turretPosition, candidate.position))
+        {
+            turret.hasTarget = true;
+            turret.targetPlayerId = candidate.playerId;
+            turret.targetUnitId = candidate.unitId;
+            turret.targetPosition = candidate.position;
+            return true;
+        }
+    }
+
+    return false;
+}
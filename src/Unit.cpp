@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include "ArmorConfig.h"
 #include "BodyConfig.h"
 #include "Logger.h"
@@ -5,12 +7,34 @@
 #include "PhysicsOps.h"
 #include "TurretConfig.h"
 #include "VecOps.h"
+#include "UnitRouter.h"
 #include "Unit.h"
 
+// Returns the rotation (as used for rendering) that tilts the unit's up direction to the surface normal.
+static vec::quaternion GetTiltRotation(const vec::vec3& normal)
+{
+    vec::vec3 axis = VecOps::Cross(vec::vec3(0.0f, 0.0f, 1.0f), normal);
+    float axisLength = vec::length(axis);
+    if (axisLength < 0.00001f)
+    {
+        // Flat ground, so there's no tilt.
+        return vec::quaternion::fromAxisAngle(0.0f, vec::vec3(1, 0, 0));
+    }
+
+    // Rotation matrices rotate by the inverse of the quaternion, so the angle is reversed.
+    float angle = std::acos(std::min(std::max(normal.z, -1.0f), 1.0f));
+    return vec::quaternion::fromAxisAngle(-angle, axis / axisLength);
+}
+
 Unit::Unit()
 {
     routeVisualId = -1;
     routeNeedsVisualUpdate = false;
+
+    preferredVelocity = vec::vec3(0.0f, 0.0f, 0.0f);
+    velocity = vec::vec2(0.0f, 0.0f);
+    hasRoutePosition = false;
+    isDestroyed = false;
 }
 
 // Creates a new unit, with full armor.
@@ -20,6 +44,7 @@ Unit::Unit(unsigned int armorTypeId, unsigned int bodyTypeId, std::vector<unsign
 {
     this->position = position;
     this->rotation = rotation;
+    this->headingRotation = rotation;
 
     // Armor has taken no damage.
     armor.armorTypeId = armorTypeId;
@@ -35,70 +60,26 @@ Unit::Unit(unsigned int armorTypeId, unsigned int bodyTypeId, std::vector<unsign
     {
         Turret turret;
         turret.turretTypeId = turretTypeIds[i];
-        turret.currentTranslation = vec::vec3(0.0f, 0.0f, 0.0f);
-        turret.currentRotation = vec::quaternion::fromAxisAngle(0.0f, vec::vec3(1, 0, 0));
+        TurretTargeting::ResetTurret(turret);
 
         turrets.push_back(turret);
     }
 }
 
-// Performs rendering updates that need to be done in the physics thread that don't draw anything.
-void Unit::PerformGuiThreadUpdates(RouteVisual& routeVisual)
+vec::vec3 Unit::GetPosition()
 {
-    ReadLock readLock(assignedRouteLock);
-
-    // Update the route visual if the physics system has recomputed it.
-    if (routeNeedsVisualUpdate)
-    {
-        if (routeVisualId != -1)
-        {
-            routeVisual.DeleteRouteVisual(routeVisualId);
-        }
-
-        routeVisualId = routeVisual.CreateRouteVisual(assignedRoute);
-        routeNeedsVisualUpdate = false;
-    }
+    ReadLock readLock(unitPhysicsLock);
+    return position;
 }
 
-void Unit::Render(ModelManager& modelManager, RouteVisual& routeVisual, bool isSelected, vec::mat4& projectionMatrix)
+float Unit::GetRadius() const
 {
-    ReadLock readLock(unitPhysicsLock);
-    
-    if (routeVisualId != -1)
-    {
-        // We have an active route, so render it.
-        routeVisual.Render(projectionMatrix, routeVisualId, isSelected);
-    }
-
-    // We do a bunch of matrix math (but nothing to complex) to properly draw armor, bodies, and turrets.
-    vec::mat4 unitOrientation = MatrixOps::Translate(position) * rotation.asMatrix();
-
-    const BodyType& bodyType = BodyConfig::Bodies[bodyTypeId];
-
-    vec::mat4 bodyMatrix = unitOrientation * MatrixOps::Scale(bodyType.scale, bodyType.scale, bodyType.scale);
-    modelManager.RenderModel(projectionMatrix, bodyType.bodyModelId, bodyMatrix, isSelected);
-
-    const ArmorType& armorType = ArmorConfig::Armors[armor.armorTypeId];
-
-    vec::mat4 armorMatrix = MatrixOps::Translate(armorType.translationOffset) * bodyMatrix * armorType.rotationOffset.asMatrix();
-    modelManager.RenderModel(projectionMatrix, armorType.armorModelId, armorMatrix, isSelected);
-
-    for (unsigned int i = 0; i < turrets.size(); i++)
-    {
-        const TurretType& turretType = TurretConfig::Turrets[turrets[i].turretTypeId];
-
-        vec::mat4 turretDefaultMatrix = MatrixOps::Translate(turretType.translationOffset) * bodyMatrix * turretType.rotationOffset.asMatrix();
-        vec::mat4 turretMatrix = MatrixOps::Translate(turrets[i].currentTranslation) * turretDefaultMatrix * turrets[i].currentRotation.asMatrix();
-        modelManager.RenderModel(projectionMatrix, turretType.turretModelId, turretMatrix, isSelected);
-    }
+    return BodyConfig::Bodies[bodyTypeId].radius;
 }
 
-bool Unit::InRayPath(const vec::vec3& rayStart, const vec::vec3& rayVector)
+float Unit::GetSensorRadius() const
 {
-    // TODO improve this to do something *drastically* better. Also store unit size data in the unit itself.
-    ReadLock readLock(unitPhysicsLock);
-    float sphereRadius = 1.0f;
-    return PhysicsOps::HitsSphere(rayStart, rayVector, position, sphereRadius);
+    return BodyConfig::Bodies[bodyTypeId].sensorRadius;
 }
 
 void Unit::UpdateAssignedRoute(std::vector<vec::vec3> newAssignedRoute)
@@ -109,6 +90,12 @@ void Unit::UpdateAssignedRoute(std::vector<vec::vec3> newAssignedRoute)
 
     currentSegment = 0;
     currentSegmentPercentage = 0.0f;
+
+    hasRoutePosition = assignedRoute.size() != 0;
+    if (hasRoutePosition)
+    {
+        routePosition = assignedRoute[0];
+    }
 }
 
 void Unit::MoveAlongRoute()
@@ -116,10 +103,21 @@ void Unit::MoveAlongRoute()
     ReadLock readLock(assignedRouteLock);
     WriteLock writeLock(unitPhysicsLock);
 
-    // TODO speed needs to be defined here.
+    // The route advances at the unit's top speed, so a unit that isn't held up keeps up with it.
     // TODO unit needs to rotate while it moves.
-    float travelAmountPerStep = 0.10f;
-    if (assignedRoute.size() != 0 && currentSegment != assignedRoute.size() - 1)
+    const float maxSpeed = BodyConfig::Bodies[bodyTypeId].maxSpeed;
+    float travelAmountPerStep = maxSpeed;
+
+    preferredVelocity = vec::vec3(0.0f, 0.0f, 0.0f);
+    if (isDestroyed)
+    {
+        return;
+    }
+
+    // Units held up by other units wait for the route to catch up, instead of having the route run away from them.
+    const float maxRouteLag = GetRadius();
+    bool keepingUpWithRoute = hasRoutePosition && vec::length(routePosition - position) < maxRouteLag;
+    if (keepingUpWithRoute && assignedRoute.size() != 0 && currentSegment != assignedRoute.size() - 1)
     {
         bool finishedTravelling = false;
         while (!finishedTravelling)
@@ -132,7 +130,7 @@ void Unit::MoveAlongRoute()
             {
                 // Length small enough that we don't span segments.
                 currentSegmentPercentage = newPercentage;
-                position = currentSegmentVector * currentSegmentPercentage + assignedRoute[currentSegment];
+                routePosition = currentSegmentVector * currentSegmentPercentage + assignedRoute[currentSegment];
                 finishedTravelling = true;
             }
             else
@@ -143,12 +141,106 @@ void Unit::MoveAlongRoute()
                 currentSegment++;
                 if (currentSegment == assignedRoute.size() - 1)
                 {
-                    position = assignedRoute[assignedRoute.size() - 1];
+                    routePosition = assignedRoute[assignedRoute.size() - 1];
                     finishedTravelling = true;
                 }
             }
         }
     }
+
+    if (hasRoutePosition)
+    {
+        preferredVelocity = routePosition - position;
+        float preferredSpeed = vec::length(preferredVelocity);
+        if (preferredSpeed > maxSpeed)
+        {
+            preferredVelocity = preferredVelocity * (maxSpeed / preferredSpeed);
+        }
+    }
+}
+
+void Unit::FillAvoidanceAgent(AvoidanceAgent& agent)
+{
+    ReadLock readLock(unitPhysicsLock);
+    agent.position = vec::vec2(position.x, position.y);
+    agent.height = position.z;
+    if (isDestroyed)
+    {
+        // Destroyed units don't take part in collisions, so they're left out of avoidance.
+        agent.velocity = vec::vec2(0.0f, 0.0f);
+        agent.preferredVelocity = vec::vec2(0.0f, 0.0f);
+        agent.radius = 0.0f;
+        agent.maxSpeed = 0.0f;
+        return;
+    }
+
+    agent.velocity = velocity;
+    agent.preferredVelocity = vec::vec2(preferredVelocity.x, preferredVelocity.y);
+    agent.radius = GetRadius();
+    agent.maxSpeed = BodyConfig::Bodies[bodyTypeId].maxSpeed;
+}
+
+void Unit::ApplyAvoidance(const AvoidanceAgent& agent, const MapSections& mapSections)
+{
+    WriteLock writeLock(unitPhysicsLock);
+    if (isDestroyed)
+    {
+        return;
+    }
+
+    // Avoidance only works in the XY plane, so the unit keeps following the route's height.
+    vec::vec3 newPosition = position + preferredVelocity;
+    if (agent.avoidanceVelocity.x != preferredVelocity.x || agent.avoidanceVelocity.y != preferredVelocity.y)
+    {
+        vec::vec3 avoidingPosition = position + vec::vec3(agent.avoidanceVelocity.x, agent.avoidanceVelocity.y, preferredVelocity.z);
+        if (mapSections.CanTraverse(position, avoidingPosition))
+        {
+            newPosition = avoidingPosition;
+        }
+    }
+
+    velocity = vec::vec2(newPosition.x - position.x, newPosition.y - position.y);
+
+    // Tilting is applied after the heading, so a ramp tilts the unit the same way whichever way it faces.
+    SurfaceSample surface = mapSections.GetSurface().GetSurface(newPosition);
+    position = vec::vec3(newPosition.x, newPosition.y, surface.height + UnitRouter::GetHoverHeight());
+    rotation = headingRotation * GetTiltRotation(surface.normal);
+}
+
+void Unit::UpdateTurrets(unsigned int playerId, unsigned int unitId, TurretTargeting& turretTargeting, const MapSections& mapSections,
+    const SpatialHash& unitHash, const VisibilityGrid& visibility, TurretTargeting::SearchBuffers& searchBuffers)
+{
+    WriteLock writeLock(unitPhysicsLock);
+    if (isDestroyed)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < turrets.size(); i++)
+    {
+        turretTargeting.UpdateTurret(turrets[i], TurretConfig::Turrets[turrets[i].turretTypeId], playerId, unitId, i,
+            position, rotation, mapSections, unitHash, &visibility, searchBuffers);
+    }
+}
+
+unsigned int Unit::FireTurrets(unsigned int playerId, ProjectilePool& projectilePool)
+{
+    WriteLock writeLock(unitPhysicsLock);
+    if (isDestroyed)
+    {
+        return 0;
+    }
+
+    unsigned int firedCount = 0;
+    for (unsigned int i = 0; i < turrets.size(); i++)
+    {
+        if (TurretTargeting::FireTurret(turrets[i], TurretConfig::Turrets[turrets[i].turretTypeId], playerId, position, rotation, projectilePool))
+        {
+            ++firedCount;
+        }
+    }
+
+    return firedCount;
 }
 
 void Unit::Move(vec::vec3 pos)
@@ -156,3 +248,26 @@ void Unit::Move(vec::vec3 pos)
     WriteLock writeLock(unitPhysicsLock);
     position = pos;
 }
+
+bool Unit::ApplyHits(const CombatHit* hits, unsigned int hitCount, unsigned int* killingPlayerId)
+{
+    WriteLock writeLock(unitPhysicsLock);
+    if (isDestroyed)
+    {
+        return false;
+    }
+
+    unsigned int destroyingHit;
+    isDestroyed = CombatResolver::ApplyHits(armor, ArmorConfig::Armors[armor.armorTypeId], hits, hitCount, &destroyingHit);
+    if (isDestroyed)
+    {
+        *killingPlayerId = hits[destroyingHit].firingPlayerId;
+    }
+
+    return isDestroyed;
+}
+
+bool Unit::IsDestroyed() const
+{
+    return isDestroyed;
+}
@@ -0,0 +1,74 @@
+#include "ArmorConfig.h"
+#include "BodyConfig.h"
+#include "MatrixOps.h"
+#include "ModelManager.h"
+#include "RouteVisual.h"
+#include "TurretConfig.h"
+#include "Unit.h"
+
+// Performs rendering updates that need to be done in the physics thread that don't draw anything.
+void Unit::PerformGuiThreadUpdates(RouteVisual& routeVisual)
+{
+    ReadLock readLock(assignedRouteLock);
+
+    // Update the route visual if the physics system has recomputed it.
+    if (routeNeedsVisualUpdate)
+    {
+        if (routeVisualId != -1)
+        {
+            routeVisual.DeleteRouteVisual(routeVisualId);
+        }
+
+        routeVisualId = routeVisual.CreateRouteVisual(assignedRoute);
+        routeNeedsVisualUpdate = false;
+    }
+}
+
+void Unit::Render(ModelManager& modelManager, RouteVisual& routeVisual, bool isSelected, bool isHovered, unsigned int pickId, vec::mat4& projectionMatrix)
+{
+    ReadLock readLock(unitPhysicsLock);
+    if (isDestroyed)
+    {
+        return;
+    }
+    
+    if (routeVisualId != -1)
+    {
+        // We have an active route, so render it.
+        routeVisual.Render(projectionMatrix, routeVisualId, isSelected);
+    }
+
+    RenderModels(modelManager, isSelected, isHovered, pickId, projectionMatrix);
+}
+
+void Unit::RenderPicking(ModelManager& modelManager, unsigned int pickId, vec::mat4& projectionMatrix)
+{
+    ReadLock readLock(unitPhysicsLock);
+    if (!isDestroyed)
+    {
+        RenderModels(modelManager, false, false, pickId, projectionMatrix);
+    }
+}
+
+void Unit::RenderModels(ModelManager& modelManager, bool isSelected, bool isHovered, unsigned int pickId, vec::mat4& projectionMatrix)
+{
+    // We do a bunch of matrix math (but nothing to complex) to properly draw armor, bodies, and turrets.
+    const BodyType& bodyType = BodyConfig::Bodies[bodyTypeId];
+
+    vec::mat4 bodyMatrix = MatrixOps::TranslateRotateScale(position, rotation, vec::vec3(bodyType.scale));
+    modelManager.RenderModel(projectionMatrix, bodyType.bodyModelId, bodyMatrix, isSelected, isHovered, pickId);
+
+    const ArmorType& armorType = ArmorConfig::Armors[armor.armorTypeId];
+
+    vec::mat4 armorMatrix = MatrixOps::Translate(armorType.translationOffset) * bodyMatrix * armorType.rotationOffset.asMatrix();
+    modelManager.RenderModel(projectionMatrix, armorType.armorModelId, armorMatrix, isSelected, isHovered, pickId);
+
+    for (unsigned int i = 0; i < turrets.size(); i++)
+    {
+        const TurretType& turretType = TurretConfig::Turrets[turrets[i].turretTypeId];
+
+        vec::mat4 turretDefaultMatrix = MatrixOps::Translate(turretType.translationOffset) * bodyMatrix * turretType.rotationOffset.asMatrix();
+        vec::mat4 turretMatrix = MatrixOps::Translate(turrets[i].currentTranslation) * turretDefaultMatrix * turrets[i].currentRotation.asMatrix();
+        modelManager.RenderModel(projectionMatrix, turretType.turretModelId, turretMatrix, isSelected, isHovered, pickId);
+    }
+}
@@ -6,7 +6,7 @@ UnitRouter::UnitRouter()
 {
 }
 
-void UnitRouter::RefineRoute(MapInfo* mapInfo, const voxelSubsectionsMap& voxelSubsections, const vec::vec3i start, const vec::vec3i destination,
+void UnitRouter::RefineRoute(MapInfo* mapInfo, const voxelSubsectionsMap& voxelSubsections, const SurfaceHeightfield& surface, const vec::vec3i start, const vec::vec3i destination,
     const std::vector<vec::vec3i>& givenPath, std::vector<vec::vec3i>& refinedPath, std::vector<vec::vec3>& visualPath)
 {
     const vec::vec3 offsetSpacing = vec::vec3(MapInfo::SPACING / 2.0f, MapInfo::SPACING / 2.0f, MapInfo::SPACING * 1.10f);
@@ -40,7 +40,7 @@ void UnitRouter::RefineRoute(MapInfo* mapInfo, const voxelSubsectionsMap& voxelS
         subdividedPath.reserve(givenPath.size() * 4);
 
         vec::vec3 start = vec::vec3((float)givenPath[0].x, (float)givenPath[0].y, (float)givenPath[0].z) * MapInfo::SPACING + centeredOffset;
-        start.z = GetHeightForVoxel(mapInfo, givenPath[0], start);
+        start.z = surface.GetSurface(start).height;
         subdividedPath.push_back(start);
         for (unsigned int i = 1; i < givenPath.size(); i++)
         {
@@ -62,12 +62,11 @@ void UnitRouter::RefineRoute(MapInfo* mapInfo, const voxelSubsectionsMap& voxelS
         PerformStringRefinement(mapInfo, voxelSubsections, subdividedPath, refinedPath);
 
         // Save the (updated) integer path (for viability calculations) and move the actual path to be on-top of the voxel.
-        const float hoverOffset = MapInfo::SPACING * 0.10f;
+        const float hoverOffset = GetHoverHeight();
         for (const vec::vec3& point : subdividedPath)
         {
             vec::vec3 actualPoint = point;
-            vec::vec3i voxelId = vec::vec3i((int)(point.x / MapInfo::SPACING), (int)(point.y / MapInfo::SPACING), (int)(point.z / MapInfo::SPACING));
-            actualPoint.z = GetHeightForVoxel(mapInfo, voxelId, actualPoint) + hoverOffset;
+            actualPoint.z = surface.GetSurface(actualPoint).height + hoverOffset;
             visualPath.push_back(actualPoint);
         }
     }
@@ -86,35 +85,12 @@ float UnitRouter::GetHeightForVoxel(MapInfo* voxelMap, const vec::vec3i& voxelId
         if (difference.x >= 0 && difference.y >= 0 && difference.z >= 0 &&
             difference.x <= MapInfo::SPACING && difference.y <= MapInfo::SPACING && difference.z <= MapInfo::SPACING)
         {
-            // In-bounds of given voxel, perform height calculation.
+            // In-bounds of given voxel, perform height calculation. Air voxels have nothing to stand on.
             int type = voxelMap->GetType(voxelId);
-            bool cubeType = (type == MapInfo::VoxelTypes::CUBE) || (type == MapInfo::VoxelTypes::SLANT && voxelMap->GetOrientation(voxelId) > 3);
-            if (cubeType)
+            if (type != MapInfo::VoxelTypes::AIR)
             {
-                // Flat plane.
-                return voxelMinPosition.z + MapInfo::SPACING;
-            }
-            else if (type == MapInfo::SLANT)
-            {
-                // We know the orientation can only be 0-3 now.
-                int orientation = voxelMap->GetOrientation(voxelId);
-                switch (orientation)
-                {
-                case 0:
-                    // Moving along X+ lowers height.
-                    return voxelMinPosition.z + MapInfo::SPACING - difference.x;
-                case 1:
-                    // Moving along Y+ lowers height.
-                    return voxelMinPosition.z + MapInfo::SPACING - difference.y;
-                case 2:
-                    // Reverse of 0
-                    return voxelMinPosition.z + difference.x;
-                case 3:
-                    // Reverse of 2
-                    return voxelMinPosition.z + difference.y;
-                default:
-                    break;
-                }
+                SurfacePlane plane = SurfaceHeightfield::GetVoxelPlane(type, voxelMap->GetOrientation(voxelId));
+                return voxelMinPosition.z + plane.height + plane.xSlope * difference.x + plane.ySlope * difference.y;
             }
         }
     }
@@ -123,6 +99,11 @@ float UnitRouter::GetHeightForVoxel(MapInfo* voxelMap, const vec::vec3i& voxelId
     return MapInfo::SPACING * (voxelMap->zSize + 2);
 }
 
+float UnitRouter::GetHoverHeight()
+{
+    return MapInfo::SPACING * 0.10f;
+}
+
 
 // Performs a spring-mass 'string' refinement to make our routes look nice
 // Updates the string route and refined integer path based on our string route.
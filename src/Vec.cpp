@@ -2,612 +2,9 @@
 
 namespace vec
 {
-    // --------------------------------------------------------------------
-    // vec2T --------------------------------------------------------------
-
-    // Copy constructor
-    template<typename T>
-    vec2T<T>::vec2T(const vec2T<T>& other)
-    {
-        x = other.x;
-        y = other.y;
-    }
-
-    // Assignment operator
-    template<typename T>
-    vec2T<T>& vec2T<T>::operator=(const vec2T<T>& other)
-    {
-        x = other.x;
-        y = other.y;
-        return *this;
-    }
-
-    // Dual-value construction.
-    template<typename T>
-    vec2T<T>::vec2T(T x, T y)
-    {
-        this->x = x;
-        this->y = y;
-    }
-
-    // Single-value construction.
-    template<typename T>
-    vec2T<T>::vec2T(T value)
-    {
-        x = value;
-        y = value;
-    }
-
-    // Overriden +-= operators
-    template<typename T>
-    vec2T<T>& vec2T<T>::operator+=(const vec2T<T>& other)
-    {
-        x += other.x;
-        y += other.y;
-        return *this;
-    }
-
-    template<typename T>
-    vec2T<T>& vec2T<T>::operator-=(const vec2T<T>& other)
-    {
-        x -= other.x;
-        y -= other.y;
-        return *this;
-    }
-
-    // Overriden +- operators
-    template<typename T>
-    vec2T<T> vec2T<T>::operator+(const vec2T<T>& other) const
-    {
-        return vec2T<T>(x + other.x, y + other.y);
-    }
-
-    template<typename T>
-    vec2T<T> vec2T<T>::operator-() const
-    {
-        return vec2T<T>(-x, -y);
-    }
-
-    template<typename T>
-    vec2T<T> vec2T<T>::operator-(const vec2T<T>& other) const
-    {
-        return vec2T<T>(x - other.x, y - other.y);
-    }
-
-    // Overridden * operators
-    template<typename T>
-    vec2T<T> vec2T<T>::operator*(const vec2T<T>& other) const
-    {
-        return vec2T(x * other.x, y * other.y);
-    }
-
-    template<typename T>
-    vec2T<T> vec2T<T>::operator*(const T& other) const
-    {
-        return vec2T<T>(x * other, y * other);
-    }
-
-    // Overridden *= operators
-    template<typename T>
-    vec2T<T>& vec2T<T>::operator*=(const vec2T<T>& other)
-    {
-        x *= other.x;
-        y *= other.y;
-        return *this;
-    }
-
-    template<typename T>
-    vec2T<T>& vec2T<T>::operator*=(const T& other)
-    {
-        x *= other;
-        y *= other;
-        return *this;
-    }
-
-    // Overridden / operators.
-    template<typename T>
-    vec2T<T> vec2T<T>::operator/(const vec2T<T>& other) const
-    {
-        return vec2T<T>(x / other.x, y / other.y);
-    }
-
-    template<typename T>
-    vec2T<T> vec2T<T>::operator/(const T& other) const
-    {
-        return vec2T<T>(x / other, y / other);
-    }
-
-    // Overridden /= operators.
-    template<typename T>
-    vec2T<T>& vec2T<T>::operator/=(const vec2T<T>& other)
-    {
-        x /= other.x;
-        y /= other.y;
-        return *this;
-    }
-
-    template<typename T>
-    vec2T<T>& vec2T<T>::operator/=(const T& other)
-    {
-        x /= other;
-        y /= other;
-        return *this;
-    }
-
-    // Strong template float and int definitions.
-
-    // Copy constructor
-    template vec2T<float>::vec2T(const vec2T<float>& other);
-    template vec2T<int>::vec2T(const vec2T<int>& other);
-
-    // Assignment operator
-    template vec2T<float>& vec2T<float>::operator=(const vec2T<float>& other);
-    template vec2T<int>& vec2T<int>::operator=(const vec2T<int>& other);
-
-    // Dual-value construction.
-    template vec2T<float>::vec2T(float x, float y);
-    template vec2T<int>::vec2T(int x, int y);
-
-    // Single-value construction.
-    template vec2T<float>::vec2T(float value);
-    template vec2T<int>::vec2T(int value);
-
-    // Overriden +-= operators
-    template vec2T<float>& vec2T<float>::operator+=(const vec2T<float>& other);
-    template vec2T<float>& vec2T<float>::operator-=(const vec2T<float>& other);
-    template vec2T<int>& vec2T<int>::operator+=(const vec2T<int>& other);
-    template vec2T<int>& vec2T<int>::operator-=(const vec2T<int>& other);
-
-    // Overriden +- operators
-    template vec2T<float> vec2T<float>::operator+(const vec2T<float>& other) const;
-    template vec2T<float> vec2T<float>::operator-() const;
-    template vec2T<float> vec2T<float>::operator-(const vec2T<float>& other) const;
-    template vec2T<int> vec2T<int>::operator+(const vec2T<int>& other) const;
-    template vec2T<int> vec2T<int>::operator-() const;
-    template vec2T<int> vec2T<int>::operator-(const vec2T<int>& other) const;
-
-    // Overriden * operators
-    template vec2T<float> vec2T<float>::operator*(const vec2T<float>& other) const;
-    template vec2T<float> vec2T<float>::operator*(const float& other) const;
-    template vec2T<int> vec2T<int>::operator*(const vec2T<int>& other) const;
-    template vec2T<int> vec2T<int>::operator*(const int& other) const;
-
-    // Overriden *= operators
-    template vec2T<float>& vec2T<float>::operator*=(const vec2T<float>& other);
-    template vec2T<float>& vec2T<float>::operator*=(const float& other);
-    template vec2T<int>& vec2T<int>::operator*=(const vec2T<int>& other);
-    template vec2T<int>& vec2T<int>::operator*=(const int& other);
-
-    // Overriden / operators.
-    template vec2T<float> vec2T<float>::operator/(const vec2T<float>& other) const;
-    template vec2T<float> vec2T<float>::operator/(const float& other) const;
-    template vec2T<int> vec2T<int>::operator/(const vec2T<int>& other) const;
-    template vec2T<int> vec2T<int>::operator/(const int& other) const;
-
-    // Overriden /= operators.
-    template vec2T<float>& vec2T<float>::operator/=(const vec2T<float>& other);
-    template vec2T<float>& vec2T<float>::operator/=(const float& other);
-    template vec2T<int>& vec2T<int>::operator/=(const vec2T<int>& other);
-    template vec2T<int>& vec2T<int>::operator/=(const int& other);
-
-    // --------------------------------------------------------------------
-    // vec3T --------------------------------------------------------------
-
-    // Copy constructor
-    template<typename T>
-    vec3T<T>::vec3T(const vec3T<T>& other)
-    {
-        x = other.x;
-        y = other.y;
-        z = other.z;
-    }
-
-    // Assignment operator
-    template<typename T>
-    vec3T<T>& vec3T<T>::operator=(const vec3T<T>& other)
-    {
-        x = other.x;
-        y = other.y;
-        z = other.z;
-        return *this;
-    }
-
-    // Triple-value construction.
-    template<typename T>
-    vec3T<T>::vec3T(T x, T y, T z)
-    {
-        this->x = x;
-        this->y = y;
-        this->z = z;
-    }
-
-    // Single-value construction.
-    template<typename T>
-    vec3T<T>::vec3T(T value)
-    {
-        x = value;
-        y = value;
-        z = value;
-    }
-
-    // Overriden +-= operators
-    template<typename T>
-    vec3T<T>& vec3T<T>::operator+=(const vec3T<T>& other)
-    {
-        x += other.x;
-        y += other.y;
-        z += other.z;
-        return *this;
-    }
-
-    template<typename T>
-    vec3T<T>& vec3T<T>::operator-=(const vec3T<T>& other)
-    {
-        x -= other.x;
-        y -= other.y;
-        z -= other.z;
-        return *this;
-    }
-
-    // Overriden +- operators
-    template<typename T>
-    vec3T<T> vec3T<T>::operator+(const vec3T<T>& other) const
-    {
-        return vec3T<T>(x + other.x, y + other.y, z + other.z);
-    }
-
-    template<typename T>
-    vec3T<T> vec3T<T>::operator-() const
-    {
-        return vec3T<T>(-x, -y, -z);
-    }
-
-    template<typename T>
-    vec3T<T> vec3T<T>::operator-(const vec3T<T>& other) const
-    {
-        return vec3T<T>(x - other.x, y - other.y, z - other.z);
-    }
-
-    // Overridden * operators
-    template<typename T>
-    vec3T<T> vec3T<T>::operator*(const vec3T<T>& other) const
-    {
-        return vec3T(x * other.x, y * other.y, z * other.z);
-    }
-
-    template<typename T>
-    vec3T<T> vec3T<T>::operator*(const T& other) const
-    {
-        return vec3T<T>(x * other, y * other, z * other);
-    }
-
-    // Overridden *= operators
-    template<typename T>
-    vec3T<T>& vec3T<T>::operator*=(const vec3T<T>& other)
-    {
-        x *= other.x;
-        y *= other.y;
-        z *= other.z;
-        return *this;
-    }
-
-    template<typename T>
-    vec3T<T>& vec3T<T>::operator*=(const T& other)
-    {
-        x *= other;
-        y *= other;
-        z *= other;
-        return *this;
-    }
-
-    // Overridden / operators.
-    template<typename T>
-    vec3T<T> vec3T<T>::operator/(const vec3T<T>& other) const
-    {
-        return vec3T<T>(x / other.x, y / other.y, z / other.z);
-    }
-
-    template<typename T>
-    vec3T<T> vec3T<T>::operator/(const T& other) const
-    {
-        return vec3T<T>(x / other, y / other, z / other);
-    }
-
-    // Overridden /= operators.
-    template<typename T>
-    vec3T<T>& vec3T<T>::operator/=(const vec3T<T>& other)
-    {
-        x /= other.x;
-        y /= other.y;
-        z /= other.z;
-        return *this;
-    }
-
-    template<typename T>
-    vec3T<T>& vec3T<T>::operator/=(const T& other)
-    {
-        x /= other;
-        y /= other;
-        z /= other;
-        return *this;
-    }
-
-    // Strong template float and int definitions.
-
-    // Copy constructor
-    template vec3T<float>::vec3T(const vec3T<float>& other);
-    template vec3T<int>::vec3T(const vec3T<int>& other);
-
-    // Assignment operator
-    template vec3T<float>& vec3T<float>::operator=(const vec3T<float>& other);
-    template vec3T<int>& vec3T<int>::operator=(const vec3T<int>& other);
-
-    // Dual-value construction.
-    template vec3T<float>::vec3T(float x, float y, float z);
-    template vec3T<int>::vec3T(int x, int y, int z);
-
-    // Single-value construction.
-    template vec3T<float>::vec3T(float value);
-    template vec3T<int>::vec3T(int value);
-
-    // Overriden +-= operators
-    template vec3T<float>& vec3T<float>::operator+=(const vec3T<float>& other);
-    template vec3T<float>& vec3T<float>::operator-=(const vec3T<float>& other);
-    template vec3T<int>& vec3T<int>::operator+=(const vec3T<int>& other);
-    template vec3T<int>& vec3T<int>::operator-=(const vec3T<int>& other);
-
-    // Overriden +- operators
-    template vec3T<float> vec3T<float>::operator+(const vec3T<float>& other) const;
-    template vec3T<float> vec3T<float>::operator-() const;
-    template vec3T<float> vec3T<float>::operator-(const vec3T<float>& other) const;
-    template vec3T<int> vec3T<int>::operator+(const vec3T<int>& other) const;
-    template vec3T<int> vec3T<int>::operator-() const;
-    template vec3T<int> vec3T<int>::operator-(const vec3T<int>& other) const;
-
-    // Overriden * operators
-    template vec3T<float> vec3T<float>::operator*(const vec3T<float>& other) const;
-    template vec3T<float> vec3T<float>::operator*(const float& other) const;
-    template vec3T<int> vec3T<int>::operator*(const vec3T<int>& other) const;
-    template vec3T<int> vec3T<int>::operator*(const int& other) const;
-
-    // Overriden *= operators
-    template vec3T<float>& vec3T<float>::operator*=(const vec3T<float>& other);
-    template vec3T<float>& vec3T<float>::operator*=(const float& other);
-    template vec3T<int>& vec3T<int>::operator*=(const vec3T<int>& other);
-    template vec3T<int>& vec3T<int>::operator*=(const int& other);
-
-    // Overriden / operators.
-    template vec3T<float> vec3T<float>::operator/(const vec3T<float>& other) const;
-    template vec3T<float> vec3T<float>::operator/(const float& other) const;
-    template vec3T<int> vec3T<int>::operator/(const vec3T<int>& other) const;
-    template vec3T<int> vec3T<int>::operator/(const int& other) const;
-
-    // Overriden /= operators.
-    template vec3T<float>& vec3T<float>::operator/=(const vec3T<float>& other);
-    template vec3T<float>& vec3T<float>::operator/=(const float& other);
-    template vec3T<int>& vec3T<int>::operator/=(const vec3T<int>& other);
-    template vec3T<int>& vec3T<int>::operator/=(const int& other);
-
-    // --------------------------------------------------------------------
-    // vec4T --------------------------------------------------------------
-
-    // Copy constructor
-    template<typename T>
-    vec4T<T>::vec4T(const vec4T<T>& other)
-    {
-        x = other.x;
-        y = other.y;
-        z = other.z;
-        w = other.w;
-    }
-
-    // Assignment operator
-    template<typename T>
-    vec4T<T>& vec4T<T>::operator=(const vec4T<T>& other)
-    {
-        x = other.x;
-        y = other.y;
-        z = other.z;
-        w = other.w;
-        return *this;
-    }
-
-    // Quad-value construction.
-    template<typename T>
-    vec4T<T>::vec4T(T x, T y, T z, T w)
-    {
-        this->x = x;
-        this->y = y;
-        this->z = z;
-        this->w = w;
-    }
-
-    // Single-value construction.
-    template<typename T>
-    vec4T<T>::vec4T(T value)
-    {
-        x = value;
-        y = value;
-        z = value;
-        w = value;
-    }
-
-    // Overriden +-= operators
-    template<typename T>
-    vec4T<T>& vec4T<T>::operator+=(const vec4T<T>& other)
-    {
-        x += other.x;
-        y += other.y;
-        z += other.z;
-        w += other.w;
-        return *this;
-    }
-
-    template<typename T>
-    vec4T<T>& vec4T<T>::operator-=(const vec4T<T>& other)
-    {
-        x -= other.x;
-        y -= other.y;
-        z -= other.z;
-        w -= other.w;
-        return *this;
-    }
-
-    // Overriden +- operators
-    template<typename T>
-    vec4T<T> vec4T<T>::operator+(const vec4T<T>& other) const
-    {
-        return vec4T<T>(x + other.x, y + other.y, z + other.z, w + other.w);
-    }
-
-    template<typename T>
-    vec4T<T> vec4T<T>::operator-() const
-    {
-        return vec4T<T>(-x, -y, -z, -w);
-    }
-
-    template<typename T>
-    vec4T<T> vec4T<T>::operator-(const vec4T<T>& other) const
-    {
-        return vec4T<T>(x - other.x, y - other.y, z - other.z, w - other.w);
-    }
-
-    // Overridden * operators
-    template<typename T>
-    vec4T<T> vec4T<T>::operator*(const vec4T<T>& other) const
-    {
-        return vec4T(x * other.x, y * other.y, z * other.z, w * other.w);
-    }
-
-    template<typename T>
-    vec4T<T> vec4T<T>::operator*(const T& other) const
-    {
-        return vec4T<T>(x * other, y * other, z * other, w * other);
-    }
-
-    // Overridden *= operators
-    template<typename T>
-    vec4T<T>& vec4T<T>::operator*=(const vec4T<T>& other)
-    {
-        x *= other.x;
-        y *= other.y;
-        z *= other.z;
-        w *= other.z;
-        return *this;
-    }
-
-    template<typename T>
-    vec4T<T>& vec4T<T>::operator*=(const T& other)
-    {
-        x *= other;
-        y *= other;
-        z *= other;
-        w *= other;
-        return *this;
-    }
-
-    // Overridden / operators.
-    template<typename T>
-    vec4T<T> vec4T<T>::operator/(const vec4T<T>& other) const
-    {
-        return vec4T<T>(x / other.x, y / other.y, z / other.z, w / other.w);
-    }
-
-    template<typename T>
-    vec4T<T> vec4T<T>::operator/(const T& other) const
-    {
-        return vec4T<T>(x / other, y / other, z / other, w / other);
-    }
-
-    // Overridden /= operators.
-    template<typename T>
-    vec4T<T>& vec4T<T>::operator/=(const vec4T<T>& other)
-    {
-        x /= other.x;
-        y /= other.y;
-        z /= other.z;
-        w /= other.w;
-        return *this;
-    }
-
-    template<typename T>
-    vec4T<T>& vec4T<T>::operator/=(const T& other)
-    {
-        x /= other;
-        y /= other;
-        z /= other;
-        w /= other;
-        return *this;
-    }
-
-    // Strong template float and int definitions.
-
-    // Copy constructor
-    template vec4T<float>::vec4T(const vec4T<float>& other);
-    template vec4T<int>::vec4T(const vec4T<int>& other);
-
-    // Assignment operator
-    template vec4T<float>& vec4T<float>::operator=(const vec4T<float>& other);
-    template vec4T<int>& vec4T<int>::operator=(const vec4T<int>& other);
-
-    // Dual-value construction.
-    template vec4T<float>::vec4T(float x, float y, float z, float w);
-    template vec4T<int>::vec4T(int x, int y, int z, int w);
-
-    // Single-value construction.
-    template vec4T<float>::vec4T(float value);
-    template vec4T<int>::vec4T(int value);
-
-    // Overriden +-= operators
-    template vec4T<float>& vec4T<float>::operator+=(const vec4T<float>& other);
-    template vec4T<float>& vec4T<float>::operator-=(const vec4T<float>& other);
-    template vec4T<int>& vec4T<int>::operator+=(const vec4T<int>& other);
-    template vec4T<int>& vec4T<int>::operator-=(const vec4T<int>& other);
-
-    // Overriden +- operators
-    template vec4T<float> vec4T<float>::operator+(const vec4T<float>& other) const;
-    template vec4T<float> vec4T<float>::operator-() const;
-    template vec4T<float> vec4T<float>::operator-(const vec4T<float>& other) const;
-    template vec4T<int> vec4T<int>::operator+(const vec4T<int>& other) const;
-    template vec4T<int> vec4T<int>::operator-() const;
-    template vec4T<int> vec4T<int>::operator-(const vec4T<int>& other) const;
-
-    // Overriden * operators
-    template vec4T<float> vec4T<float>::operator*(const vec4T<float>& other) const;
-    template vec4T<float> vec4T<float>::operator*(const float& other) const;
-    template vec4T<int> vec4T<int>::operator*(const vec4T<int>& other) const;
-    template vec4T<int> vec4T<int>::operator*(const int& other) const;
-
-    // Overriden *= operators
-    template vec4T<float>& vec4T<float>::operator*=(const vec4T<float>& other);
-    template vec4T<float>& vec4T<float>::operator*=(const float& other);
-    template vec4T<int>& vec4T<int>::operator*=(const vec4T<int>& other);
-    template vec4T<int>& vec4T<int>::operator*=(const int& other);
-
-    // Overriden / operators.
-    template vec4T<float> vec4T<float>::operator/(const vec4T<float>& other) const;
-    template vec4T<float> vec4T<float>::operator/(const float& other) const;
-    template vec4T<int> vec4T<int>::operator/(const vec4T<int>& other) const;
-    template vec4T<int> vec4T<int>::operator/(const int& other) const;
-
-    // Overriden /= operators.
-    template vec4T<float>& vec4T<float>::operator/=(const vec4T<float>& other);
-    template vec4T<float>& vec4T<float>::operator/=(const float& other);
-    template vec4T<int>& vec4T<int>::operator/=(const vec4T<int>& other);
-    template vec4T<int>& vec4T<int>::operator/=(const int& other);
-
     // --------------------------------------------------------------------
     // mat4, non-templated ------------------------------------------------
 
-    // Copy constructor
-    mat4::mat4(const mat4& other)
-    {
-        for (unsigned int n = 0; n < 4; n++)
-        {
-            data[n] = other.data[n];
-        }
-    }
-
     mat4::mat4(const vec4& v0,
         const vec4& v1,
         const vec4& v2,
@@ -628,17 +25,6 @@ namespace vec
         }
     }
 
-    // Assignment operator
-    mat4& mat4::operator=(const mat4& other)
-    {
-        for (unsigned int n = 0; n < 4; n++)
-        {
-            data[n] = other.data[n];
-        }
-
-        return *this;
-    }
-
     mat4 mat4::operator+(const mat4& other) const
     {
         mat4 result;
@@ -688,28 +74,6 @@ namespace vec
         return *this;
     }
 
-    // Matrix multiply.
-    mat4 mat4::operator*(const mat4& other) const
-    {
-        mat4 result(vec4(0, 0, 0, 0));
-
-        for (int j = 0; j < 4; j++)
-        {
-            for (int i = 0; i < 4; i++)
-            {
-                float sum = 0.0f;
-                for (int n = 0; n < 4; n++)
-                {
-                    sum += data[n][i] * other[j][n];
-                }
-
-                result[j][i] = sum;
-            }
-        }
-
-        return result;
-    }
-
     mat4& mat4::operator*=(const mat4& other)
     {
         return (*this = *this * other);
@@ -742,49 +106,6 @@ namespace vec
     // --------------------------------------------------------------------
     // quaternion, non-templated ------------------------------------------
 
-    // Assignment operator
-    quaternion& quaternion::operator=(const quaternion& other)
-    {
-        x = other.x;
-        y = other.y;
-        z = other.z;
-        w = other.w;
-        return *this;
-    }
-
-    // Copy operator
-    quaternion::quaternion(const quaternion& other)
-    {
-        x = other.x;
-        y = other.y;
-        z = other.z;
-        w = other.w;
-    }
-
-    // Quad-assignment setup.
-    quaternion::quaternion(float x, float y, float z, float w)
-    {
-        this->x = x;
-        this->y = y;
-        this->z = z;
-        this->w = w;
-    }
-
-    // Performs special quaternion multiplication.
-    quaternion quaternion::operator*(const quaternion& q) const
-    {
-        const float x2 = q.x;
-        const float y2 = q.y;
-        const float z2 = q.z;
-        const float w2 = q.w;
-
-        return quaternion(
-            w * x2 + x * w2 + y * z2 - z * y2,
-            w * y2 + y * w2 + z * x2 - x * z2,
-            w * z2 + z * w2 + x * y2 - y * x2,
-            w * w2 - x * x2 - y * y2 - z * z2);
-    }
-
     // Normalizes this vector
     void quaternion::normalize()
     {
@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include "MapInfo.h"
+#include "VisibilityGrid.h"
+
+// Viewers see from slightly above their center, in voxels, so they can see over flat ground.
+static const float SensorHeight = 0.5f;
+
+// How far (in voxels) a viewer can move up or down before it is recomputed.
+static const float EyeHeightTolerance = 0.5f;
+
+VisibilityGrid::VisibilityGrid()
+    : width(0), height(0), changedMinRow(0), changedMaxRow(-1), currentStamp(0), raySensorCells(-1)
+{
+}
+
+void VisibilityGrid::Reset(const MapSections& mapSections)
+{
+    width = mapSections.GetMapSize().x;
+    height = mapSections.GetMapSize().y;
+
+    viewers.clear();
+    pendingViewers.clear();
+    viewerCounts.assign(width * height, 0);
+    texels.assign(width * height, UNEXPLORED);
+    // Everything changed, so the whole texture needs an update.
+    changedMinRow = 0;
+    changedMaxRow = height - 1;
+}
+
+void VisibilityGrid::UpdateViewer(unsigned int viewerId, const vec::vec3& position, float sensorRadius)
+{
+    if (viewerId >= viewers.size())
+    {
+        Viewer newViewer;
+        newViewer.isActive = false;
+        newViewer.isPending = false;
+        viewers.resize(viewerId + 1, newViewer);
+    }
+
+    Viewer& viewer = viewers[viewerId];
+    vec::vec2i column((int)std::floor(position.x / MapInfo::SPACING), (int)std::floor(position.y / MapInfo::SPACING));
+    float eyeHeight = position.z / MapInfo::SPACING + SensorHeight;
+    int sensorCells = (int)std::ceil(sensorRadius / MapInfo::SPACING);
+
+    // Viewers that stay within a column see the same cells, so they don't need to be recomputed.
+    if (viewer.isActive && column.x == viewer.column.x && column.y == viewer.column.y && std::abs(eyeHeight - viewer.eyeHeight) < EyeHeightTolerance && sensorCells == viewer.sensorCells)
+    {
+        return;
+    }
+
+    viewer.isActive = true;
+    viewer.column = column;
+    viewer.eyeHeight = eyeHeight;
+    viewer.sensorCells = sensorCells;
+    QueueViewer(viewerId);
+}
+
+void VisibilityGrid::RemoveViewer(unsigned int viewerId)
+{
+    if (viewerId >= viewers.size() || !viewers[viewerId].isActive)
+    {
+        return;
+    }
+
+    Viewer& viewer = viewers[viewerId];
+    RemoveCells(viewer.visibleCells);
+    viewer.visibleCells.clear();
+    viewer.isActive = false;
+}
+
+bool VisibilityGrid::Update(const MapSections& mapSections, float budgetMs)
+{
+    const std::vector<unsigned char>& columnHeights = mapSections.GetColumnHeights();
+    if (columnHeights.size() != viewerCounts.size())
+    {
+        // The grid doesn't match the map, so wait for a reset.
+        return pendingViewers.empty();
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::chrono::duration<float, std::milli> budget(budgetMs);
+
+    // At least one viewer is recomputed per update, so viewers always catch up eventually.
+    unsigned int processedCount = 0;
+    while (processedCount < pendingViewers.size())
+    {
+        if (processedCount != 0 && std::chrono::steady_clock::now() - startTime >= budget)
+        {
+            break;
+        }
+
+        Viewer& viewer = viewers[pendingViewers[processedCount]];
+        ++processedCount;
+
+        viewer.isPending = false;
+        if (viewer.isActive)
+        {
+            RecomputeViewer(viewer, columnHeights);
+        }
+    }
+
+    pendingViewers.erase(pendingViewers.begin(), pendingViewers.begin() + processedCount);
+    return pendingViewers.empty();
+}
+
+bool VisibilityGrid::IsVisible(const vec::vec3& position) const
+{
+    int x = (int)std::floor(position.x / MapInfo::SPACING);
+    int y = (int)std::floor(position.y / MapInfo::SPACING);
+    if (x < 0 || y < 0 || x >= width || y >= height)
+    {
+        return false;
+    }
+
+    return viewerCounts[y * width + x] != 0;
+}
+
+unsigned int VisibilityGrid::GetPendingViewerCount() const
+{
+    return (unsigned int)pendingViewers.size();
+}
+
+int VisibilityGrid::GetWidth() const
+{
+    return width;
+}
+
+int VisibilityGrid::GetHeight() const
+{
+    return height;
+}
+
+const std::vector<unsigned char>& VisibilityGrid::GetTexels() const
+{
+    return texels;
+}
+
+bool VisibilityGrid::TakeChangedRows(int* minRow, int* maxRow)
+{
+    if (changedMinRow > changedMaxRow)
+    {
+        return false;
+    }
+
+    *minRow = changedMinRow;
+    *maxRow = changedMaxRow;
+    changedMinRow = height;
+    changedMaxRow = -1;
+    return true;
+}
+
+void VisibilityGrid::QueueViewer(unsigned int viewerId)
+{
+    if (!viewers[viewerId].isPending)
+    {
+        viewers[viewerId].isPending = true;
+        pendingViewers.push_back(viewerId);
+    }
+}
+
+// Builds rays from the viewer to every cell on the edge of the square around the sensor radius, which together cover every cell in range.
+void VisibilityGrid::BuildRays(int sensorCells)
+{
+    raySteps.clear();
+    rayEnds.clear();
+    for (int i = -sensorCells; i <= sensorCells; i++)
+    {
+        AddRay(i, -sensorCells, sensorCells);
+        AddRay(i, sensorCells, sensorCells);
+    }
+
+    for (int i = -sensorCells + 1; i < sensorCells; i++)
+    {
+        AddRay(-sensorCells, i, sensorCells);
+        AddRay(sensorCells, i, sensorCells);
+    }
+
+    raySensorCells = sensorCells;
+    cellStamps.assign((2 * sensorCells + 1) * (2 * sensorCells + 1), 0);
+    currentStamp = 0;
+}
+
+// Steps along the ray one cell at a time in its longest direction, stopping at the edge of the sensor circle.
+void VisibilityGrid::AddRay(int xOffset, int yOffset, int sensorCells)
+{
+    int steps = std::max(std::abs(xOffset), std::abs(yOffset));
+    float xStep = (float)xOffset / (float)steps;
+    float yStep = (float)yOffset / (float)steps;
+    float stepLength = std::sqrt(xStep * xStep + yStep * yStep);
+    float radiusSquared = ((float)sensorCells + 0.5f) * ((float)sensorCells + 0.5f);
+    for (int i = 1; i <= steps; i++)
+    {
+        RayStep step;
+        step.xOffset = (int)std::floor(xStep * (float)i + 0.5f);
+        step.yOffset = (int)std::floor(yStep * (float)i + 0.5f);
+        step.inverseDistance = 1.0f / (stepLength * (float)i);
+        step.squareIndex = (unsigned int)((step.yOffset + sensorCells) * (2 * sensorCells + 1) + (step.xOffset + sensorCells));
+        if ((float)(step.xOffset * step.xOffset + step.yOffset * step.yOffset) > radiusSquared)
+        {
+            break;
+        }
+
+        raySteps.push_back(step);
+    }
+
+    rayEnds.push_back((unsigned int)raySteps.size());
+}
+
+void VisibilityGrid::RecomputeViewer(Viewer& viewer, const std::vector<unsigned char>& columnHeights)
+{
+    if (viewer.sensorCells != raySensorCells)
+    {
+        BuildRays(viewer.sensorCells);
+    }
+
+    ++currentStamp;
+    if (currentStamp == 0)
+    {
+        // The stamp wrapped around, so old stamps could match again.
+        std::fill(cellStamps.begin(), cellStamps.end(), 0);
+        currentStamp = 1;
+    }
+
+    previousCells.swap(viewer.visibleCells);
+    viewer.visibleCells.clear();
+
+    if (viewer.column.x >= 0 && viewer.column.y >= 0 && viewer.column.x < width && viewer.column.y < height)
+    {
+        AddVisibleCell(viewer, viewer.column.x, viewer.column.y, (unsigned int)(viewer.sensorCells * (2 * viewer.sensorCells + 1) + viewer.sensorCells));
+    }
+
+    unsigned int rayStart = 0;
+    for (unsigned int i = 0; i < rayEnds.size(); i++)
+    {
+        CastRay(viewer, rayStart, rayEnds[i], columnHeights);
+        rayStart = rayEnds[i];
+    }
+
+    RemoveCells(previousCells);
+}
+
+// Walks out from the viewer, tracking the steepest terrain seen so far. A cell is visible if its top is at or above that horizon.
+void VisibilityGrid::CastRay(Viewer& viewer, unsigned int rayStart, unsigned int rayEnd, const std::vector<unsigned char>& columnHeights)
+{
+    float horizonSlope = -std::numeric_limits<float>::max();
+    for (unsigned int i = rayStart; i < rayEnd; i++)
+    {
+        const RayStep& step = raySteps[i];
+        int x = viewer.column.x + step.xOffset;
+        int y = viewer.column.y + step.yOffset;
+        if (x < 0 || y < 0 || x >= width || y >= height)
+        {
+            break;
+        }
+
+        float slope = ((float)columnHeights[y * width + x] - viewer.eyeHeight) * step.inverseDistance;
+        if (slope >= horizonSlope)
+        {
+            AddVisibleCell(viewer, x, y, step.squareIndex);
+            horizonSlope = slope;
+        }
+    }
+}
+
+void VisibilityGrid::AddVisibleCell(Viewer& viewer, int x, int y, unsigned int squareIndex)
+{
+    if (cellStamps[squareIndex] == currentStamp)
+    {
+        return;
+    }
+
+    cellStamps[squareIndex] = currentStamp;
+    unsigned int cell = (unsigned int)(y * width + x);
+    viewer.visibleCells.push_back(cell);
+    if (viewerCounts[cell]++ == 0)
+    {
+        SetTexel(cell, VISIBLE);
+    }
+}
+
+void VisibilityGrid::RemoveCells(const std::vector<unsigned int>& cells)
+{
+    for (unsigned int i = 0; i < cells.size(); i++)
+    {
+        if (--viewerCounts[cells[i]] == 0)
+        {
+            SetTexel(cells[i], EXPLORED);
+        }
+    }
+}
+
+void VisibilityGrid::SetTexel(unsigned int cell, VisibilityState state)
+{
+    if (texels[cell] != state)
+    {
+        texels[cell] = (unsigned char)state;
+
+        int row = (int)cell / width;
+        changedMinRow = std::min(changedMinRow, row);
+        changedMaxRow = std::max(changedMaxRow, row);
+    }
+}
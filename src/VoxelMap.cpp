@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <sstream>
 #include "GraphicsConfig.h"
 #include "Logger.h"
@@ -6,6 +7,7 @@
 VoxelMap::VoxelMap()
 {
     selectedVoxel = vec::vec3i(0, 0, 0);
+    hoveredVoxelIndex = -1;
     hasValidMap = false;
 }
 
@@ -15,11 +17,12 @@ void VoxelMap::InitOpenGl()
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
 
-    glGenBuffers(1, &positionBuffer);
+    glGenBuffers(1, &vertexBuffer);
     glGenBuffers(1, &indexBuffer);
-    glGenBuffers(1, &uvBuffer);
+    glGenBuffers(1, &instanceBuffer);
 
-    glGenTextures(1, &voxelTopTexture);
+    glGenTextures(1, &voxelTextureArray);
+    glGenTextures(1, &visibilityTexture);
 }
 
 bool VoxelMap::CreateVoxelShader(ShaderManager& shaderManager)
@@ -33,36 +36,71 @@ bool VoxelMap::CreateVoxelShader(ShaderManager& shaderManager)
 
     projLocation = glGetUniformLocation(voxelMapRenderProgram, "projMatrix");
     xyLengthsLocation = glGetUniformLocation(voxelMapRenderProgram, "xyLengths");
-    currentVoxelIdLocation = glGetUniformLocation(voxelMapRenderProgram, "currentVoxelId");
 
     selectedIndexLocation = glGetUniformLocation(voxelMapRenderProgram, "selectedIndex");
+    hoveredIndexLocation = glGetUniformLocation(voxelMapRenderProgram, "hoveredIndex");
 
     textureLocation = glGetUniformLocation(voxelMapRenderProgram, "voxelTextures");
-    voxelTopTextureLocation = glGetUniformLocation(voxelMapRenderProgram, "voxelTopTexture");
+    textureLayerLocation = glGetUniformLocation(voxelMapRenderProgram, "voxelTextureLayer");
+    visibilityTextureLocation = glGetUniformLocation(voxelMapRenderProgram, "visibilityTexture");
     Logger::Log("Voxel Map shader creation successful!");
     return true;
 }
 
-std::vector<GLuint> VoxelMap::LoadVoxelTextures(ImageManager& imageManager)
+void VoxelMap::QueueVoxelTextures(AssetLoader& assetLoader, std::vector<AssetTaskId>& loadTasks)
 {
-    Logger::Log("Voxel texture loading...");
-
-    std::vector<GLuint> voxelTextureIds;
+    // Sized up-front, so the tasks can fill in their own elements.
+    voxelImages.assign(GraphicsConfig::VoxelTypes, DecodedImage());
     for (int i = 0; i < GraphicsConfig::VoxelTypes; i++)
     {
         std::stringstream voxelModelTextureName;
         voxelModelTextureName << "models/voxels/voxel_" << i << ".png";
 
-        GLuint textureId = imageManager.AddImage(voxelModelTextureName.str().c_str());
-        if (textureId == 0)
+        std::string textureName = voxelModelTextureName.str();
+        loadTasks.push_back(assetLoader.AddWorkTask("Voxel images", [this, i, textureName](unsigned int)
+        {
+            return ImageManager::DecodeImage(textureName.c_str(), &voxelImages[i]);
+        }, std::vector<AssetTaskId>()));
+    }
+}
+
+bool VoxelMap::CreateVoxelTextureArray()
+{
+    // Texture array layers share a size, so images *must* all be the same size.
+    int width = voxelImages[0].width;
+    int height = voxelImages[0].height;
+    for (unsigned int i = 1; i < voxelImages.size(); i++)
+    {
+        if (voxelImages[i].width != width || voxelImages[i].height != height)
         {
-            return std::vector<GLuint>();
+            Logger::LogError("Voxel texture ", i, " is ", voxelImages[i].width, "x", voxelImages[i].height, ", not ", width, "x", height, " like the others!");
+            return false;
         }
-        voxelTextureIds.push_back(textureId);
     }
 
-    Logger::Log("Voxel texture loading successful.");
-    return voxelTextureIds;
+    // Each layer is mipmapped on its own, so distant voxels don't shimmer or bleed into their neighbors.
+    int mipmapLevels = ImageManager::GetMipmapLevels(width, height);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, voxelTextureArray);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, mipmapLevels, GL_RGBA8, width, height, (GLsizei)voxelImages.size());
+    for (unsigned int i = 0; i < voxelImages.size(); i++)
+    {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, voxelImages[i].imageData);
+    }
+
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // OpenGL has its own copy now.
+    for (DecodedImage& voxelImage : voxelImages)
+    {
+        ImageManager::FreeDecodedImage(&voxelImage);
+    }
+
+    std::vector<DecodedImage>().swap(voxelImages);
+    return true;
 }
 
 std::vector<int> VoxelMap::LoadModels(ModelManager& modelManager)
@@ -87,7 +125,7 @@ std::vector<int> VoxelMap::LoadModels(ModelManager& modelManager)
     return voxelModelIds;
 }
 
-bool VoxelMap::Initialize(ImageManager& imageManager, ModelManager& modelManager, ShaderManager& shaderManager)
+bool VoxelMap::Initialize(ModelManager& modelManager, ShaderManager& shaderManager, AssetLoader& assetLoader)
 {
     // Shaders, raw model/image data
     if (!CreateVoxelShader(shaderManager))
@@ -95,11 +133,9 @@ bool VoxelMap::Initialize(ImageManager& imageManager, ModelManager& modelManager
         return false; // Bad shader!
     }
 
-    std::vector<GLuint> voxelTextureIds = LoadVoxelTextures(imageManager);
-    if (voxelTextureIds.size() == 0)
-    {
-        return false; // No textures loaded!
-    }
+    // The voxel map is combined as soon as its own textures and models have loaded, regardless of any other assets.
+    std::vector<AssetTaskId> loadTasks;
+    QueueVoxelTextures(assetLoader, loadTasks);
 
     std::vector<int> voxelModelIds = LoadModels(modelManager);
     if (voxelModelIds.size() == 0)
@@ -107,80 +143,61 @@ bool VoxelMap::Initialize(ImageManager& imageManager, ModelManager& modelManager
         return false; // No models loaded!
     }
 
-    // At this point, we need to combine the texture images into one larger image (and scale UVs accordingly)
-    //  and combine vertex data into one universal array (and scale indices appropriately).
-    Logger::Log("Combining voxel images and models into a composite structure...");
-
-    // Combine together the images. Images *must* all be the same size squares.
-    int edgeLength = imageManager.GetImage(voxelTextureIds[0]).width;
-    int width = GraphicsConfig::VoxelsPerRow * edgeLength;
-    int height = (int)voxelTextureIds.size() / GraphicsConfig::VoxelsPerRow;
-    if (height == 0 || height * GraphicsConfig::VoxelsPerRow < (int)voxelTextureIds.size())
+    for (int voxelModelId : voxelModelIds)
     {
-        ++height;
+        modelManager.GetLoadTasks(voxelModelId, loadTasks);
     }
 
-    height *= edgeLength;
-    const ImageTexture& voxelTexture = imageManager.GetImage(imageManager.LoadEmpty(width, height));
-    voxelTextureId = voxelTexture.textureId;
+    assetLoader.AddUploadTask("Voxel map", [this, &modelManager, voxelModelIds]()
+    {
+        return CombineVoxels(modelManager, voxelModelIds);
+    }, loadTasks);
 
-    // Store the UV offsets so we can modify them later below for proper texture mapping.
-    std::vector<vec::vec2> newUvMin;
-    std::vector<vec::vec2> newUvMax;
+    return true;
+}
 
-    int xP = 0;
-    int yP = 0;
-    for (unsigned int i = 0; i < voxelTextureIds.size(); i++)
+bool VoxelMap::CombineVoxels(ModelManager& modelManager, const std::vector<int>& voxelModelIds)
+{
+    // At this point, we need to send the texture images to their texture array, indexed by voxel model,
+    //  and combine vertex data into one universal array (and scale indices appropriately).
+    Logger::Log("Combining voxel images and models into a composite structure...");
+    InitOpenGl();
+    if (!CreateVoxelTextureArray())
     {
-        imageManager.CopyToImage(voxelTextureIds[i], voxelTexture.textureId, xP * edgeLength, yP * edgeLength);
-        newUvMin.push_back(vec::vec2((float)(xP * edgeLength) / (float)width, (float)(yP * edgeLength) / (float) height));
-        newUvMax.push_back(vec::vec2((float)((xP + 1) * edgeLength) / (float)width, (float)((yP + 1) * edgeLength) / (float) height));
-
-        xP++;
-        if (xP == GraphicsConfig::VoxelsPerRow)
-        {
-            xP = 0;
-            yP++;
-        }
+        return false;
     }
 
-    // Combine together the vertex data.
-    unsigned int indexPositionReferralOffset = 0;
-    unsigned int indexOffset = 0;
+    // Combine together the vertex data. This runs before the model manager sends its models to OpenGL, so the model vertices are still around.
+    std::vector<MeshVertex> voxelVertices;
+    std::vector<unsigned int> voxelIndices;
     for (unsigned int i = 0; i < voxelModelIds.size(); i++)
     {
         const TextureModel& model = modelManager.GetModel(voxelModelIds[i]);
-        voxelIndexOffsets.push_back(indexOffset);
-        voxelIndexCounts.push_back(model.vertices.indices.size());
-
-        voxelVertices.positions.insert(voxelVertices.positions.end(), model.vertices.positions.begin(), model.vertices.positions.end());
-
-        // Update the UVs appropriately, with a minor bit of vector math.
-        for (unsigned int j = 0; j < model.vertices.uvs.size(); j++)
-        {
-            vec::vec2 newUv = newUvMin[i] + model.vertices.uvs[j] * (newUvMax[i] - newUvMin[i]);
-            voxelVertices.uvs.push_back(newUv);
-        }
+        voxelIndexOffsets.push_back(voxelIndices.size());
+        voxelIndexCounts.push_back(model.indices.size());
 
-        // Update the indices appropriately
-        for (unsigned int j = 0; j < model.vertices.indices.size(); j++)
+        // Update the indices appropriately. The UVs are used as-is, as each voxel model has its own texture layer.
+        unsigned int indexPositionReferralOffset = voxelVertices.size();
+        for (unsigned int j = 0; j < model.indices.size(); j++)
         {
-            voxelVertices.indices.push_back(model.vertices.indices[j] + indexPositionReferralOffset);
+            voxelIndices.push_back(model.indices[j] + indexPositionReferralOffset);
         }
 
-        indexPositionReferralOffset += model.vertices.positions.size();
-        indexOffset += model.vertices.indices.size();
+        voxelVertices.insert(voxelVertices.end(), model.vertices.begin(), model.vertices.end());
     }
 
     Logger::Log("Combination complete!");
 
-    // Send our combined data to OpenGL.
-    imageManager.ResendToOpenGl(voxelTextureId);
-    InitOpenGl();
+    // Send our combined data to OpenGL, interleaved in a single buffer.
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, voxelVertices.size() * sizeof(MeshVertex), &voxelVertices[0], GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (const void*)offsetof(MeshVertex, position));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (const void*)offsetof(MeshVertex, uv));
 
-    voxelVertices.TransferPositionToOpenGl(positionBuffer);
-    voxelVertices.TransferUvsToOpenGl(uvBuffer);
-    voxelVertices.TransferIndicesToOpenGl(indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, voxelIndices.size() * sizeof(unsigned int), &voxelIndices[0], GL_STATIC_DRAW);
 
     return true;
 }
@@ -189,37 +206,97 @@ void VoxelMap::SetupFromMap(const MapInfo& mapInfo)
 {
     xMapSize = (int)mapInfo.xSize;
     yMapSize = (int)mapInfo.ySize;
-    totalVoxelSize = mapInfo.GetVoxelCount();
 
-    Logger::Log("Creating 1D texture for voxel type, orientation, and property data.");
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_1D, voxelTopTexture);
-    glTexStorage1D(GL_TEXTURE_1D, 1, GL_RGBA8, totalVoxelSize);
-
-    Logger::Log("Interlacing the map data...");
-    unsigned char* interlacedData = new unsigned char[totalVoxelSize * 4];
+    // Voxel type N is drawn with voxel model N - 1, so air (type 0) and types without a model aren't drawn at all.
+    Logger::Log("Computing the voxel instances...");
+    std::vector<std::vector<VoxelInstance>> voxelTypeInstances(voxelIndexCounts.size());
+    for (int z = 0; z < (int)mapInfo.zSize; z++)
+    {
+        for (int y = 0; y < yMapSize; y++)
+        {
+            for (int x = 0; x < xMapSize; x++)
+            {
+                int index = mapInfo.GetIndex(x, y, z);
+                int modelIndex = (int)mapInfo.blockType[index] - 1;
+                if (modelIndex < 0 || modelIndex >= (int)voxelTypeInstances.size())
+                {
+                    continue;
+                }
+
+                // Orientations past 7 wrap around like rotations, but stay flipped.
+                int orientation = (int)mapInfo.blockOrientation[index];
+                orientation = orientation < 8 ? orientation : 4 + (orientation & 3);
+
+                VoxelInstance instance;
+                instance.translation = vec::vec3(((float)x + 0.5f) * MapInfo::SPACING, ((float)y + 0.5f) * MapInfo::SPACING, ((float)z + 0.5f) * MapInfo::SPACING);
+                instance.indexOrientation[0] = (GLshort)x;
+                instance.indexOrientation[1] = (GLshort)y;
+                instance.indexOrientation[2] = (GLshort)z;
+                instance.indexOrientation[3] = (GLshort)orientation;
+                voxelTypeInstances[modelIndex].push_back(instance);
+            }
+        }
+    }
 
-    for (int i = 0; i < totalVoxelSize; i++)
+    std::vector<VoxelInstance> instances;
+    voxelInstanceOffsets.clear();
+    voxelInstanceCounts.clear();
+    for (unsigned int i = 0; i < voxelTypeInstances.size(); i++)
     {
-        interlacedData[i * 4] = mapInfo.blockType[i];
-        interlacedData[i * 4 + 1] = mapInfo.blockOrientation[i];
-        interlacedData[i * 4 + 2] = mapInfo.blockProperty[i];
-        interlacedData[i * 4 + 3] = 128; // Some data can go here as it is an RGBA 8-bit image.
+        voxelInstanceOffsets.push_back((int)instances.size());
+        voxelInstanceCounts.push_back((int)voxelTypeInstances[i].size());
+        instances.insert(instances.end(), voxelTypeInstances[i].begin(), voxelTypeInstances[i].end());
     }
 
-    Logger::Log("Sending the data to OpenGL...");
-    glTexSubImage1D(GL_TEXTURE_1D, 0, 0, totalVoxelSize, GL_RGBA, GL_UNSIGNED_BYTE, &interlacedData[0]);
+    Logger::Log("Sending the ", instances.size(), " voxel instances to OpenGL...");
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(VoxelInstance), instances.empty() ? nullptr : &instances[0], GL_STATIC_DRAW);
+    glEnableVertexAttribArray(5);
+    glVertexAttribDivisor(5, 1);
+    glEnableVertexAttribArray(6);
+    glVertexAttribDivisor(6, 1);
+
+    // Everything starts unexplored, until the physics thread sends what the player can see.
+    Logger::Log("Creating the fog of war texture...");
+    std::vector<unsigned char> unexploredData(xMapSize * yMapSize, 0);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, visibilityTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, xMapSize, yMapSize);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, xMapSize, yMapSize, GL_RED, GL_UNSIGNED_BYTE, &unexploredData[0]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
-    delete[] interlacedData;
     hasValidMap = true;
 }
 
+bool VoxelMap::UpdateVisibility(const unsigned char* visibilityTexels, int width, int height, int minRow, int maxRow)
+{
+    if (!hasValidMap || width != xMapSize || height != yMapSize)
+    {
+        return false;
+    }
+
+    // Only the changed rows are sent. Rows are a single byte per texel, so they aren't 4-byte aligned.
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, visibilityTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, minRow, width, maxRow - minRow + 1, GL_RED, GL_UNSIGNED_BYTE, visibilityTexels + minRow * width);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    return true;
+}
+
 // Sets the currently-selected voxel, which renders specially.
 void VoxelMap::SetSelectedVoxel(const vec::vec3i& selectedVoxel)
 {
     this->selectedVoxel = selectedVoxel;
 }
 
+void VoxelMap::SetHoveredVoxel(int hoveredVoxelIndex)
+{
+    this->hoveredVoxelIndex = hoveredVoxelIndex;
+}
+
 void VoxelMap::Render(const vec::mat4& projectionMatrix)
 {
     if (!hasValidMap)
@@ -232,33 +309,54 @@ void VoxelMap::Render(const vec::mat4& projectionMatrix)
 
     // Bind our textures
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, voxelTextureId);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, voxelTextureArray);
     glUniform1i(textureLocation, 0);
 
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_1D, voxelTopTexture);
-    glUniform1i(voxelTopTextureLocation, 1);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, visibilityTexture);
+    glUniform1i(visibilityTextureLocation, 2);
 
     // Bind our vertex data
     glBindVertexArray(vao);
     glUniformMatrix4fv(projLocation, 1, GL_FALSE, projectionMatrix);
     glUniform3iv(selectedIndexLocation, 1, &selectedVoxel[0]);
+    glUniform1i(hoveredIndexLocation, hoveredVoxelIndex);
 
     glUniform2i(xyLengthsLocation, xMapSize, yMapSize);
 
-    for (unsigned int i = 0; i < (unsigned int)GraphicsConfig::VoxelTypes; i++)
+    for (unsigned int i = 0; i < voxelInstanceCounts.size(); i++)
     {
-        glUniform1ui(currentVoxelIdLocation, i + 1);
-        glDrawElementsInstanced(GL_TRIANGLES, voxelIndexCounts[i], GL_UNSIGNED_INT, (const void*)(voxelIndexOffsets[i] * sizeof(GL_UNSIGNED_INT)), totalVoxelSize);
+        if (voxelInstanceCounts[i] != 0)
+        {
+            BindInstances(voxelInstanceOffsets[i]);
+            glUniform1i(textureLayerLocation, i);
+            glDrawElementsInstanced(GL_TRIANGLES, voxelIndexCounts[i], GL_UNSIGNED_INT, (const void*)(voxelIndexOffsets[i] * sizeof(GL_UNSIGNED_INT)), voxelInstanceCounts[i]);
+        }
     }
 }
 
+void VoxelMap::BindInstances(int instanceOffset)
+{
+    // Base instances need OpenGL 4.2, so the attributes are moved to the first instance instead.
+    size_t firstInstance = instanceOffset * sizeof(VoxelInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(VoxelInstance), (const void*)(firstInstance + offsetof(VoxelInstance, translation)));
+    glVertexAttribIPointer(6, 4, GL_SHORT, sizeof(VoxelInstance), (const void*)(firstInstance + offsetof(VoxelInstance, indexOrientation)));
+}
+
 VoxelMap::~VoxelMap()
 {
     glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &positionBuffer);
+    glDeleteBuffers(1, &vertexBuffer);
     glDeleteBuffers(1, &indexBuffer);
-    glDeleteBuffers(1, &uvBuffer);
+    glDeleteBuffers(1, &instanceBuffer);
 
-    glDeleteTextures(1, &voxelTopTexture);
+    glDeleteTextures(1, &voxelTextureArray);
+    glDeleteTextures(1, &visibilityTexture);
+
+    // Only left if loading failed before the texture array was created.
+    for (DecodedImage& voxelImage : voxelImages)
+    {
+        ImageManager::FreeDecodedImage(&voxelImage);
+    }
 }